@@ -0,0 +1,229 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Logic/ColorManager/ColorKernels.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace ColorKernels
+{
+	namespace
+	{
+		// 距離の比較で同値とみなす幅（KINDA_SMALL_NUMBER と同じ）
+		static constexpr float DISTANCE_EPSILON = 1.e-4f;
+
+		// 明度差による補正を始める差と、超えた分に掛ける角度
+		static constexpr float VALUE_DIFFERENCE_THRESHOLD = 0.5f;
+		static constexpr float VALUE_DIFFERENCE_PENALTY = 60.0f;
+
+		// 強度比率の基準にする最大の角度差
+		static constexpr float MAX_HUE_DISTANCE = 180.0f;
+
+		// 補色の彩度と、輝度・成分の下限
+		static constexpr float COMPLEMENTARY_SATURATION = 0.3f;
+		static constexpr float COMPLEMENTARY_MIN_LIGHTNESS = 0.8f;
+		static constexpr float COMPLEMENTARY_MIN_COMPONENT = 0.8f;
+
+		float Clamp01(float Value)
+		{
+			return std::min(std::max(Value, 0.0f), 1.0f);
+		}
+
+		float Max3(float A, float B, float C)
+		{
+			return std::max(std::max(A, B), C);
+		}
+
+		float Min3(float A, float B, float C)
+		{
+			return std::min(std::min(A, B), C);
+		}
+
+		// HSL→RGB の1成分
+		float HueToRGB(float p, float q, float t)
+		{
+			if (t < 0.0f) t += 1.0f;
+			if (t > 1.0f) t -= 1.0f;
+			if (t < 1.0f / 6.0f) return p + (q - p) * 6.0f * t;
+			if (t < 1.0f / 2.0f) return q;
+			if (t < 2.0f / 3.0f) return p + (q - p) * (2.0f / 3.0f - t) * 6.0f;
+			return p;
+		}
+	}
+
+	// 処理の流れ:
+	// 1. 最大・最小成分から範囲を求める
+	// 2. 最大成分に応じて色相を計算（無彩色は0）
+	// 3. 彩度と明度を計算
+	FHsv RGBToHSV(const FRgb& Color)
+	{
+		const float RGBMin = Min3(Color.R, Color.G, Color.B);
+		const float RGBMax = Max3(Color.R, Color.G, Color.B);
+		const float RGBRange = RGBMax - RGBMin;
+
+		FHsv HSV;
+		if (RGBMax == RGBMin)
+		{
+			HSV.H = 0.0f;
+		}
+		else if (RGBMax == Color.R)
+		{
+			HSV.H = std::fmod((((Color.G - Color.B) / RGBRange) * 60.0f) + 360.0f, 360.0f);
+		}
+		else if (RGBMax == Color.G)
+		{
+			HSV.H = (((Color.B - Color.R) / RGBRange) * 60.0f) + 120.0f;
+		}
+		else
+		{
+			HSV.H = (((Color.R - Color.G) / RGBRange) * 60.0f) + 240.0f;
+		}
+
+		HSV.S = RGBMax == 0.0f ? 0.0f : RGBRange / RGBMax;
+		HSV.V = RGBMax;
+		return HSV;
+	}
+
+	// 処理の流れ:
+	// 1. 最大・最小成分から輝度を計算
+	// 2. 差が0の場合は無彩色として処理
+	// 3. それ以外の場合は彩度と色相を計算
+	FHsl RGBToHSL(const FRgb& Color)
+	{
+		const float Max = Max3(Color.R, Color.G, Color.B);
+		const float Min = Min3(Color.R, Color.G, Color.B);
+		const float Delta = Max - Min;
+
+		FHsl HSL;
+		HSL.L = (Max + Min) / 2.0f;
+
+		if (Delta == 0.0f)
+		{
+			return HSL;
+		}
+
+		HSL.S = (HSL.L < 0.5f) ? (Delta / (Max + Min)) : (Delta / (2.0f - Max - Min));
+
+		if (Max == Color.R)
+			HSL.H = (Color.G - Color.B) / Delta + (Color.G < Color.B ? 6.0f : 0.0f);
+		else if (Max == Color.G)
+			HSL.H = (Color.B - Color.R) / Delta + 2.0f;
+		else
+			HSL.H = (Color.R - Color.G) / Delta + 4.0f;
+
+		HSL.H /= 6.0f;
+		return HSL;
+	}
+
+	// 処理の流れ:
+	// 1. 彩度が0の場合は輝度をそのまま各成分にする
+	// 2. それ以外の場合は色相を1/3ずつずらして各成分を計算
+	FRgb HSLToRGB(const FHsl& HSL)
+	{
+		if (HSL.S == 0.0f)
+		{
+			return FRgb(HSL.L, HSL.L, HSL.L);
+		}
+
+		const float q = (HSL.L < 0.5f) ? (HSL.L * (1.0f + HSL.S)) : (HSL.L + HSL.S - HSL.L * HSL.S);
+		const float p = 2.0f * HSL.L - q;
+
+		return FRgb(
+			HueToRGB(p, q, HSL.H + 1.0f / 3.0f),
+			HueToRGB(p, q, HSL.H),
+			HueToRGB(p, q, HSL.H - 1.0f / 3.0f));
+	}
+
+	FEffectReference MakeEffectReference(const FRgb& Color)
+	{
+		const FHsv HSV = RGBToHSV(Color);
+
+		FEffectReference Reference;
+		Reference.Color = Color;
+		Reference.Hue = HSV.H;
+		Reference.Value = Clamp01(HSV.V);
+		return Reference;
+	}
+
+	float HueAngleDistance(float HueA, float HueB)
+	{
+		const float Delta = std::fabs(HueA - HueB);
+		return std::min(Delta, 360.0f - Delta);
+	}
+
+	float HueAngleDistance(const FRgb& ColorA, const FRgb& ColorB)
+	{
+		return HueAngleDistance(RGBToHSV(ColorA).H, RGBToHSV(ColorB).H);
+	}
+
+	// 処理の流れ:
+	// 1. 入力色をHSVに変換（基準色側は登録時に変換済み）
+	// 2. 各基準色との色相角度差を計算
+	// 3. 明度差が大きい場合は補正値を加算
+	// 4. 最小距離の基準色を特定し、強度比率を計算
+	FEffectMatch ClosestEffectByHue(const FRgb& InputColor, const FEffectReference* References, int32_t NumReferences)
+	{
+		const FHsv InputHSV = RGBToHSV(InputColor);
+		const float InputValue = Clamp01(InputHSV.V);
+
+		FEffectMatch Result;
+		float MinDistance = std::numeric_limits<float>::max();
+
+		for (int32_t i = 0; i < NumReferences; ++i)
+		{
+			const FEffectReference& Reference = References[i];
+
+			float HueDistance = HueAngleDistance(InputHSV.H, Reference.Hue);
+
+			// 明度差による補正(差が0.5以上の場合、最大30度加算)
+			const float ValueDifference = std::fabs(InputValue - Reference.Value);
+			if (ValueDifference > VALUE_DIFFERENCE_THRESHOLD)
+			{
+				HueDistance += (ValueDifference - VALUE_DIFFERENCE_THRESHOLD) * VALUE_DIFFERENCE_PENALTY;
+			}
+
+			if (HueDistance + DISTANCE_EPSILON < MinDistance)
+			{
+				MinDistance = HueDistance;
+				Result.Index = i;
+			}
+		}
+
+		Result.Distance = MinDistance;
+		Result.StrengthRatio = Clamp01(1.0f - (MinDistance / MAX_HUE_DISTANCE));
+		return Result;
+	}
+
+	// 処理の流れ:
+	// 1. RGB→HSLに変換
+	// 2. 色相を180度反転（補色化）
+	// 3. 彩度を固定し輝度を下限以上にクランプ（パステル調）
+	// 4. HSL→RGBに変換
+	// 5. 最大成分を1.0に強制し、他の成分を下限以上にクランプ
+	FRgb ComplementaryColor(const FRgb& Color)
+	{
+		FHsl HSL = RGBToHSL(Color);
+
+		HSL.H += 0.5f;
+		if (HSL.H > 1.0f) HSL.H -= 1.0f;
+
+		HSL.S = COMPLEMENTARY_SATURATION;
+		HSL.L = std::min(std::max(HSL.L, COMPLEMENTARY_MIN_LIGHTNESS), 1.0f);
+
+		FRgb Complementary = HSLToRGB(HSL);
+
+		const float MaxComponent = Max3(Complementary.R, Complementary.G, Complementary.B);
+
+		if (Complementary.R == MaxComponent) Complementary.R = 1.0f;
+		if (Complementary.G == MaxComponent) Complementary.G = 1.0f;
+		if (Complementary.B == MaxComponent) Complementary.B = 1.0f;
+
+		if (Complementary.R != 1.0f) Complementary.R = std::min(std::max(Complementary.R, COMPLEMENTARY_MIN_COMPONENT), 1.0f);
+		if (Complementary.G != 1.0f) Complementary.G = std::min(std::max(Complementary.G, COMPLEMENTARY_MIN_COMPONENT), 1.0f);
+		if (Complementary.B != 1.0f) Complementary.B = std::min(std::max(Complementary.B, COMPLEMENTARY_MIN_COMPONENT), 1.0f);
+
+		return Complementary;
+	}
+}
@@ -0,0 +1,122 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+// エンジンに依存しない色判定（色相・補色・色差）の計算部
+// UEffectColorMatcher / UColorReactiveComponent から使うほか、
+// エディタ無しのベンチマークからも使えるように標準ライブラリだけで実装する
+
+#include <cstdint>
+
+namespace ColorKernels
+{
+	// =======================
+	// 色型
+	// =======================
+
+	// リニアRGB（アルファは扱わない）
+	struct FRgb
+	{
+		float R = 0.0f;
+		float G = 0.0f;
+		float B = 0.0f;
+
+		FRgb() = default;
+		FRgb(float InR, float InG, float InB) : R(InR), G(InG), B(InB) {}
+	};
+
+	// HSV（色相は0～360度）
+	struct FHsv
+	{
+		float H = 0.0f;
+		float S = 0.0f;
+		float V = 0.0f;
+	};
+
+	// HSL（各成分とも0～1）
+	struct FHsl
+	{
+		float H = 0.0f;
+		float S = 0.0f;
+		float L = 0.0f;
+	};
+
+	// =======================
+	// 色空間の変換
+	// =======================
+
+	/** RGBをHSVに変換する（FLinearColor::LinearRGBToHSV と同じ結果） @param Color 変換する色 */
+	FHsv RGBToHSV(const FRgb& Color);
+
+	/** RGBをHSLに変換する @param Color 変換する色 */
+	FHsl RGBToHSL(const FRgb& Color);
+
+	/** HSLをRGBに変換する @param HSL 変換する色 */
+	FRgb HSLToRGB(const FHsl& HSL);
+
+	// =======================
+	// 色相による判定
+	// =======================
+
+	// 判定に使うエフェクトの基準色（色相と明度は登録時に計算しておく）
+	struct FEffectReference
+	{
+		FRgb Color;
+		float Hue = 0.0f;
+		float Value = 0.0f;
+	};
+
+	// 判定結果
+	struct FEffectMatch
+	{
+		// 最も近い基準色の番号（基準色が無い場合は -1）
+		int32_t Index = -1;
+		float Distance = 0.0f;
+		float StrengthRatio = 0.0f;
+	};
+
+	/** 基準色を作る @param Color エフェクトの色 */
+	FEffectReference MakeEffectReference(const FRgb& Color);
+
+	/**
+	 * 2つの色相の角度差（0～180度）
+	 * @param HueA 色相1（度）
+	 * @param HueB 色相2（度）
+	 */
+	float HueAngleDistance(float HueA, float HueB);
+
+	/** 2色間の色相の角度差（0～180度） @param ColorA 比較する色1 @param ColorB 比較する色2 */
+	float HueAngleDistance(const FRgb& ColorA, const FRgb& ColorB);
+
+	/**
+	 * 入力色に最も近い基準色を色相と明度から判定する
+	 * @param InputColor 判定対象の色
+	 * @param References 基準色の配列
+	 * @param NumReferences 基準色の数
+	 * @return 判定結果
+	 */
+	FEffectMatch ClosestEffectByHue(const FRgb& InputColor, const FEffectReference* References, int32_t NumReferences);
+
+	// =======================
+	// 補色・色差
+	// =======================
+
+	/** パステル調の補色を返す（最大成分は1、他の成分は0.8～1） @param Color 元の色 */
+	FRgb ComplementaryColor(const FRgb& Color);
+
+	/**
+	 * 輝度で重み付けした色差が許容誤差以下か
+	 * @param ColorA 比較する色1
+	 * @param ColorB 比較する色2
+	 * @param Tolerance 許容誤差
+	 */
+	inline bool IsColorMatch(const FRgb& ColorA, const FRgb& ColorB, float Tolerance)
+	{
+		const float dR = ColorA.R - ColorB.R;
+		const float dG = ColorA.G - ColorB.G;
+		const float dB = ColorA.B - ColorB.B;
+
+		const float ColorDifference = 0.299f * dR * dR + 0.587f * dG * dG + 0.114f * dB * dB;
+		return ColorDifference <= Tolerance * Tolerance;
+	}
+}
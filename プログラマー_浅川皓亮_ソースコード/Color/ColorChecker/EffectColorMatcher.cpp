@@ -13,48 +13,29 @@ UEffectColorMatcher::UEffectColorMatcher()
         { EBuffEffect::Yellow, FLinearColor(1.00f, 1.00f, 0.65f, 1.0f) },
         { EBuffEffect::Black,  FLinearColor(0.0f, 0.0f, 0.0f, 1.0f) },
     };
-}
-
-// 1. 入力色をHSV色空間に変換し明度を取得
-// 2. 各エフェクト色との色相角度差を計算
-// 3. 明度差が大きい場合は補正値を加算
-// 4. 最小距離のエフェクトを特定し結果を返す
-FEffectMatchResult UEffectColorMatcher::GetClosestEffectByHue(const FLinearColor& InputColor)
-{
-    FEffectMatchResult Result;
-
-    FLinearColor InputHSV = InputColor.LinearRGBToHSV();
-    float InputValue = FMath::Clamp(InputHSV.B, 0.0f, 1.0f);
-
-    float MinDistance = TNumericLimits<float>::Max();
-    EBuffEffect ClosestEffect = EBuffEffect::Red;
 
+    // 判定のたびに基準色をHSVへ変換しないよう、マップと同じ順で計算しておく
     for (const auto& Elem : EffectColorMap)
     {
-        const FLinearColor& EffectColor = Elem.Value;
-
-        FLinearColor EffectHSV = EffectColor.LinearRGBToHSV();
-        float EffectValue = FMath::Clamp(EffectHSV.B, 0.0f, 1.0f);
-
-        float HueDistance = GetHueAngleDistance(InputColor, EffectColor);
-
-        // 明度差による補正(差が0.5以上の場合、最大30度加算)
-        float ValueDifference = FMath::Abs(InputValue - EffectValue);
-        if (ValueDifference > 0.5f)
-        {
-            HueDistance += (ValueDifference - 0.5f) * 60.0f;
-        }
-
-        if (HueDistance + KINDA_SMALL_NUMBER < MinDistance)
-        {
-            MinDistance = HueDistance;
-            ClosestEffect = Elem.Key;
-        }
+        EffectReferences.Add(ColorKernels::MakeEffectReference(ColorKernels::FRgb(Elem.Value.R, Elem.Value.G, Elem.Value.B)));
+        EffectTypes.Add(Elem.Key);
     }
+}
 
-    Result.ClosestEffect = ClosestEffect;
-    Result.Distance = MinDistance;
-    Result.StrengthRatio = FMath::Clamp(1.0f - (MinDistance / 180.0f), 0.0f, 1.0f);
+// 1. 入力色と各基準色の色相角度差を計算(ColorKernels)
+// 2. 明度差が大きい場合は補正値を加算
+// 3. 最小距離のエフェクトを特定し結果を返す(基準色が無ければ赤)
+FEffectMatchResult UEffectColorMatcher::GetClosestEffectByHue(const FLinearColor& InputColor)
+{
+    const ColorKernels::FEffectMatch Match = ColorKernels::ClosestEffectByHue(
+        ColorKernels::FRgb(InputColor.R, InputColor.G, InputColor.B),
+        EffectReferences.GetData(),
+        EffectReferences.Num());
+
+    FEffectMatchResult Result;
+    Result.ClosestEffect = EffectTypes.IsValidIndex(Match.Index) ? EffectTypes[Match.Index] : EBuffEffect::Red;
+    Result.Distance = Match.Distance;
+    Result.StrengthRatio = Match.StrengthRatio;
 
     return Result;
 }
@@ -64,16 +45,9 @@ FEffectMatchResult UEffectColorMatcher::GetClosestEffectByHue(const FLinearColor
 // 3. 最短の角度差を返す(0〜180度)
 float UEffectColorMatcher::GetHueAngleDistance(const FLinearColor& ColorA, const FLinearColor& ColorB)
 {
-    FLinearColor HSV_A = ColorA.LinearRGBToHSV();
-    FLinearColor HSV_B = ColorB.LinearRGBToHSV();
-
-    float HueA = HSV_A.R;
-    float HueB = HSV_B.R;
-
-    float Delta = FMath::Abs(HueA - HueB);
-    float Distance = FMath::Min(Delta, 360.0f - Delta);
-
-    return Distance;
+    return ColorKernels::HueAngleDistance(
+        ColorKernels::FRgb(ColorA.R, ColorA.G, ColorA.B),
+        ColorKernels::FRgb(ColorB.R, ColorB.G, ColorB.B));
 }
 
 // 1. マップから指定エフェクトの色を検索
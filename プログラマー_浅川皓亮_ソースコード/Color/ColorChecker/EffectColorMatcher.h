@@ -5,6 +5,7 @@
 #include "CoreMinimal.h"
 #include "UObject/NoExportTypes.h"
 #include "DataContainer/EffectMatchResult.h"
+#include "Logic/ColorManager/ColorKernels.h"
 #include "EffectColorMatcher.generated.h"
 
 /**
@@ -44,4 +45,8 @@ public:
 private:
 	// 各エフェクトタイプに対応する基準色のマップ
 	TMap<EBuffEffect, FLinearColor> EffectColorMap;
+
+	// 判定用の基準色（色相・明度は計算済み）と、同じ並びのエフェクトタイプ
+	TArray<ColorKernels::FEffectReference> EffectReferences;
+	TArray<EBuffEffect> EffectTypes;
 };
\ No newline at end of file
@@ -6,7 +6,7 @@
 #include "FunctionLibrary.h"
 #include "UI/ColorLens.h"
 #include "UI/UIManager.h"
-#include "Manager/LevelManager.h"
+#include "Manager/GameServicesSubsystem.h"
 #include "Manager/ColorManager.h"
 
 // 処理の流れ:
@@ -103,7 +103,7 @@ void UColorControllerComponent::ChangeMode(int Direction)
 }
 
 // 処理の流れ:
-// 1. LevelManager と ColorManager を取得
+// 1. GameServices から ColorManager と UIManager を取得
 // 2. 最も近い変更可能なターゲットを検索
 // 3. ターゲットが見つからない場合はモード変更をキャンセル
 // 4. モードを NextMode に変更
@@ -112,11 +112,12 @@ void UColorControllerComponent::ChangeMode(int Direction)
 // 7. アニメーションデリゲートを実行
 void UColorControllerComponent::HandleObjectColorMode(int Direction, EColorTargetType NextMode)
 {
-    ALevelManager* LevelManager = ALevelManager::GetInstance(GetWorld());
-    UColorManager* ColorManager = LevelManager ? LevelManager->GetColorManager() : nullptr;
-    if (!LevelManager || !ColorManager)
+    const UGameServicesSubsystem* Services = UGameServicesSubsystem::Get(this);
+    UColorManager* ColorManager = Services ? Services->GetColorManager() : nullptr;
+    UUIManager* UIManager = Services ? Services->GetUIManager() : nullptr;
+    if (!ColorManager)
     {
-        UE_LOG(LogTemp, Warning, TEXT("LevelManager または ColorManager が取得できませんでした"));
+        UE_LOG(LogTemp, Warning, TEXT("ColorManager が取得できませんでした"));
         return;
     }
 
@@ -134,29 +135,30 @@ void UColorControllerComponent::HandleObjectColorMode(int Direction, EColorTarge
     ColorManager->SetColorTarget(ClosestTarget);
     UE_LOG(LogTemp, Warning, TEXT("ColorTarget を ColorManager に設定しました"));
 
-    if (TargetActor)
-        LevelManager->GetUIManager()->ShowMarker(TEXT("ChangeColorTarget"), TargetActor);
+    if (TargetActor && UIManager)
+        UIManager->ShowMarker(TEXT("ChangeColorTarget"), TargetActor);
 
     if (AnimationDelegate.IsBound())
         AnimationDelegate.Execute(Direction);
 }
 
 // 処理の流れ:
-// 1. LevelManager と ColorManager を取得
+// 1. GameServices から ColorManager と UIManager を取得
 // 2. モードを NextMode に変更
 // 3. ColorManager のターゲットをリセット
 // 4. UIマーカーを非表示
 // 5. アニメーションデリゲートを実行
 void UColorControllerComponent::HandleSimpleMode(int Direction, EColorTargetType NextMode)
 {
-    ALevelManager* LevelManager = ALevelManager::GetInstance(GetWorld());
-    UColorManager* ColorManager = LevelManager ? LevelManager->GetColorManager() : nullptr;
+    const UGameServicesSubsystem* Services = UGameServicesSubsystem::Get(this);
+    UColorManager* ColorManager = Services ? Services->GetColorManager() : nullptr;
+    UUIManager* UIManager = Services ? Services->GetUIManager() : nullptr;
 
     CurrentColorMode = NextMode;
     UE_LOG(LogTemp, Warning, TEXT("New Mode: %d"), static_cast<int32>(CurrentColorMode));
 
     if (ColorManager) ColorManager->ResetColorTarget();
-    if (LevelManager) LevelManager->GetUIManager()->HideMarker(TEXT("ChangeColorTarget"));
+    if (UIManager) UIManager->HideMarker(TEXT("ChangeColorTarget"));
     if (AnimationDelegate.IsBound())
         AnimationDelegate.Execute(Direction);
 }
@@ -5,6 +5,7 @@
 #include "FunctionLibrary.h"
 #include "Components/StaticMeshComponent.h"
 #include "Components/BoxComponent.h"
+#include "Manager/PhysicsBatchSubsystem.h"
 #include "NiagaraActor.h"
 #include "NiagaraComponent.h"
 #include "NiagaraFunctionLibrary.h"
@@ -54,8 +55,9 @@ void UColorProximitySpawner::Init(bool bIsColorVariable)
 // 4. PrimitiveComponentの場合、表示とコリジョンを無効化
 // 5. アクティブなコンポーネントを非アクティブ化
 // 6. Tickを無効化
-// 7. 出現エフェクトを再生
-// 8. bIsHiddenをtrueに設定
+// 7. 消した範囲の上で眠っている物理ボディを起こす
+// 8. 出現エフェクトを再生
+// 9. bIsHiddenをtrueに設定
 void UColorProximitySpawner::HideMesh()
 {
 	if (bIsHidden) return;
@@ -63,6 +65,8 @@ void UColorProximitySpawner::HideMesh()
 	AActor* Owner = GetOwner();
 	if (!Owner) return;
 
+	FBox HiddenBounds(ForceInit);
+
 	for (UActorComponent* Component : Owner->GetComponents())
 	{
 		if (Component->ComponentHasTag("HideTarget"))
@@ -71,6 +75,7 @@ void UColorProximitySpawner::HideMesh()
 			{
 				Primitive->SetVisibility(false, false);
 				Primitive->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+				HiddenBounds += Primitive->Bounds.GetBox();
 			}
 
 			if (Component->IsActive())
@@ -82,6 +87,12 @@ void UColorProximitySpawner::HideMesh()
 		}
 	}
 
+	// 足場が消えると眠っているボディは落下しないため、ここで起こす
+	if (UPhysicsBatchSubsystem* Physics = GetWorld() ? GetWorld()->GetSubsystem<UPhysicsBatchSubsystem>() : nullptr)
+	{
+		Physics->WakeBodiesInBox(HiddenBounds);
+	}
+
 	PlayAppearEffect();
 	bIsHidden = true;
 }
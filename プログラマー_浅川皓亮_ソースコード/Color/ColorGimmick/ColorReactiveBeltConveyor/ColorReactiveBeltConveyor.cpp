@@ -1,6 +1,7 @@
 #include "Objects/Color/ColorReactiveBeltConveyor.h"
 #include "Components/Color/ColorConfigurator.h"
 #include "Components/PhysicsCalculator.h"
+#include "Manager/PhysicsBatchSubsystem.h"
 #include "Components/BoxComponent.h"
 #include "DataContainer/EffectMatchResult.h"
 #include "Manager/LevelManager.h"
@@ -9,8 +10,8 @@
 
 AColorReactiveBeltConveyor::AColorReactiveBeltConveyor()
 {
-    // Tickを有効化
-    PrimaryActorTick.bCanEverTick = true;
+    // 押し出しは UPhysicsBatchSubsystem が力場として行うためTickしない
+    PrimaryActorTick.bCanEverTick = false;
 
     // Boxコンポーネントを作成してルートにアタッチ
     BoxComponent = CreateDefaultSubobject<UBoxComponent>(TEXT("Collision"));
@@ -23,68 +24,121 @@ AColorReactiveBeltConveyor::AColorReactiveBeltConveyor()
 
 // 1. 親クラスの初期化を実行
 // 2. 初期方向と推進力を設定
+// 3. ボックスの範囲を力場として登録し、方向と推進力を反映
 void AColorReactiveBeltConveyor::Init()
 {
     AColorReactiveObject::Init();
 
     CurrentDirection = direction;
     CurrentPower = DefaultPower;
+
+    if (ForceFieldId == INDEX_NONE)
+    {
+        PhysicsSubsystem = GetWorld() ? GetWorld()->GetSubsystem<UPhysicsBatchSubsystem>() : nullptr;
+        if (PhysicsSubsystem)
+        {
+            ForceFieldId = PhysicsSubsystem->RegisterForceField(BoxComponent);
+        }
+    }
+
+    ApplyForceFieldMotion();
 }
 
-// 1. コリジョンが無効な場合はオブジェクトリストをクリアして終了
-// 2. bOnlyClosestがtrueの場合、最も近いオブジェクトのみに力を加える
-//    - レイキャストで遮蔽物チェックを行い、遮蔽物がない場合のみ力を加える
-// 3. bOnlyClosestがfalseの場合、すべてのオブジェクトに力を加える
-void AColorReactiveBeltConveyor::Tick(float DeltaTime)
+// 1. 遮蔽物チェックのタイマーを停止
+// 2. 力場の登録を解除
+void AColorReactiveBeltConveyor::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
-    if (!BoxComponent->IsCollisionEnabled())
+    GetWorldTimerManager().ClearTimer(LineOfSightTimer);
+
+    if (PhysicsSubsystem && ForceFieldId != INDEX_NONE)
     {
-        hitObject.Empty();
-        return;
+        PhysicsSubsystem->UnregisterForceField(ForceFieldId);
+    }
+    PhysicsSubsystem = nullptr;
+    ForceFieldId = INDEX_NONE;
+
+    Super::EndPlay(EndPlayReason);
+}
+
+// 1. 力場に現在の方向と推進力を反映
+// 2. 停止・稼働の切り替えに合わせて遮蔽物チェックのタイマーを更新
+void AColorReactiveBeltConveyor::ApplyForceFieldMotion()
+{
+    if (PhysicsSubsystem && ForceFieldId != INDEX_NONE)
+    {
+        PhysicsSubsystem->SetForceFieldMotion(ForceFieldId, CurrentDirection, CurrentPower, bUseLocalOffset);
     }
 
-    if (bOnlyClosest)
+    UpdateLineOfSightTimer();
+}
+
+// 1. ベルト上の各オブジェクトへレイキャストし、遮蔽物があるものを集める
+// 2. 遮られているオブジェクトには力を加えないよう力場に通知
+void AColorReactiveBeltConveyor::RefreshLineOfSight()
+{
+    if (!PhysicsSubsystem || ForceFieldId == INDEX_NONE)
+        return;
+
+    const FVector MyLocation = GetActorLocation();
+    TArray<UPhysicsCalculator*> Blocked;
+
+    for (UPhysicsCalculator* Target : hitObject)
     {
-        FVector MyLocation = GetActorLocation();
+        if (!Target)
+            continue;
+
+        AActor* TargetActor = Target->GetOwner();
+        if (!TargetActor)
+            continue;
+
+        FHitResult HitResult;
+        FCollisionQueryParams Params;
+        Params.AddIgnoredActor(this);
+        Params.AddIgnoredActor(TargetActor);
+
+        const bool bHit = GetWorld()->LineTraceSingleByChannel(
+            HitResult,
+            MyLocation,
+            TargetActor->GetActorLocation(),
+            ECC_Visibility,
+            Params
+        );
+
+        if (bHit)
+        {
+            Blocked.Add(Target);
+        }
+    }
+
+    PhysicsSubsystem->SetForceFieldBlockedBodies(ForceFieldId, Blocked);
+}
+
+// 1. bOnlyClosestが有効で、稼働中かつベルト上に物がある時だけタイマーを動かす
+// 2. 動かす時はすぐに1回調べ、以降は一定間隔で更新
+// 3. 止める時は遮られている一覧を空にする
+void AColorReactiveBeltConveyor::UpdateLineOfSightTimer()
+{
+    FTimerManager& TimerManager = GetWorldTimerManager();
 
-        for (UPhysicsCalculator* Target : hitObject)
+    const bool bStopped = CurrentDirection.IsNearlyZero() || FMath::IsNearlyZero(CurrentPower);
+    const bool bNeedCheck = bOnlyClosest && !bStopped && hitObject.Num() > 0;
+
+    if (bNeedCheck)
+    {
+        if (!TimerManager.IsTimerActive(LineOfSightTimer))
         {
-            if (Target)
-            {
-                AActor* TargetActor = Target->GetOwner();
-                if (!TargetActor)
-                    continue;
-
-                FVector TargetLocation = TargetActor->GetActorLocation();
-
-                FHitResult HitResult;
-                FCollisionQueryParams Params;
-                Params.AddIgnoredActor(this);
-                Params.AddIgnoredActor(TargetActor);
-
-                bool bHit = GetWorld()->LineTraceSingleByChannel(
-                    HitResult,
-                    MyLocation,
-                    TargetLocation,
-                    ECC_Visibility,
-                    Params
-                );
-
-                if (!bHit)
-                {
-                    Target->AddForce(CurrentDirection, CurrentPower, true, bUseLocalOffset);
-                }
-            }
+            RefreshLineOfSight();
+            TimerManager.SetTimer(LineOfSightTimer, this, &AColorReactiveBeltConveyor::RefreshLineOfSight, LineOfSightInterval, true);
         }
+        return;
     }
-    else
+
+    if (TimerManager.IsTimerActive(LineOfSightTimer))
     {
-        for (UPhysicsCalculator* Target : hitObject)
+        TimerManager.ClearTimer(LineOfSightTimer);
+        if (PhysicsSubsystem && ForceFieldId != INDEX_NONE)
         {
-            if (Target)
-            {
-                Target->AddForce(CurrentDirection, CurrentPower, true, bUseLocalOffset);
-            }
+            PhysicsSubsystem->SetForceFieldBlockedBodies(ForceFieldId, TArray<UPhysicsCalculator*>());
         }
     }
 }
@@ -96,6 +150,7 @@ void AColorReactiveBeltConveyor::Tick(float DeltaTime)
 //    - IsReversがtrueなら逆方向に設定
 //    - IsReversがfalseなら停止(ゼロベクトル)
 // 5. 色不一致時: 通常方向に設定
+// 6. 力場に反映
 void AColorReactiveBeltConveyor::ColorAction(const FLinearColor InColor, FEffectMatchResult Result)
 {
     if (!ColorConfigurator)
@@ -120,11 +175,14 @@ void AColorReactiveBeltConveyor::ColorAction(const FLinearColor InColor, FEffect
     {
         CurrentDirection = direction;
     }
+
+    ApplyForceFieldMotion();
 }
 
 // 1. アクターの有効性を確認
 // 2. PhysicsCalculatorコンポーネントを検索
 // 3. 見つかった場合、まだリストに含まれていなければ追加
+// 4. 遮蔽物チェックを開始（新しく乗ったオブジェクトもすぐに調べる）
 void AColorReactiveBeltConveyor::OnOverlapBegin(UPrimitiveComponent* OverlappedComp, AActor* OtherActor,
     UPrimitiveComponent* OtherComp, int32 OtherBodyIndex,
     bool bFromSweep, const FHitResult& SweepResult)
@@ -140,11 +198,18 @@ void AColorReactiveBeltConveyor::OnOverlapBegin(UPrimitiveComponent* OverlappedC
     {
         hitObject.Add(PhysicsCalculator);
     }
+
+    if (GetWorldTimerManager().IsTimerActive(LineOfSightTimer))
+    {
+        RefreshLineOfSight();
+    }
+    UpdateLineOfSightTimer();
 }
 
 // 1. アクターの有効性を確認
 // 2. PhysicsCalculatorコンポーネントを検索
 // 3. 見つかった場合、リストから削除
+// 4. ベルト上に何も無くなったら遮蔽物チェックを止める
 void AColorReactiveBeltConveyor::OnOverlapEnd(UPrimitiveComponent* OverlappedComp, AActor* OtherActor,
     UPrimitiveComponent* OtherComp, int32 OtherBodyIndex)
 {
@@ -156,4 +221,5 @@ void AColorReactiveBeltConveyor::OnOverlapEnd(UPrimitiveComponent* OverlappedCom
         return;
 
     hitObject.Remove(PhysicsCalculator);
+    UpdateLineOfSightTimer();
 }
\ No newline at end of file
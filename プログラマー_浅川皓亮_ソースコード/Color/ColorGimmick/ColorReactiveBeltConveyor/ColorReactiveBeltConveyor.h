@@ -9,11 +9,12 @@
 
 class UBoxComponent;
 class UPhysicsCalculator;
+class UPhysicsBatchSubsystem;
 
 /**
  * 色によって挙動が変化するベルトコンベアクラス
  * 色の一致・不一致に応じて進行方向や停止を切り替える
- * オーバーラップしたアクターに物理的な力を加える
+ * ボックスの範囲を力場として UPhysicsBatchSubsystem に登録し、範囲内のボディを押し出す
  */
 UCLASS()
 class PACHIO_API AColorReactiveBeltConveyor : public AColorReactiveObject
@@ -25,16 +26,17 @@ public:
 
 	/**
 	 * ベルトコンベアの初期化処理
-	 * 親クラスの初期化とビート検出のバインドを実行
+	 * 親クラスの初期化と力場の登録を実行
 	 */
 	virtual void Init() override;
 
+protected:
 	/**
-	 * 毎フレーム呼ばれる処理
-	 * ベルト上のオブジェクトに力を加える
-	 * @param DeltaTime フレーム間の経過時間
+	 * 終了時の処理
+	 * 力場の登録を解除し、遮蔽物チェックのタイマーを止める
+	 * @param EndPlayReason 終了理由
 	 */
-	virtual void Tick(float DeltaTime) override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 private:
 	/**
@@ -70,6 +72,21 @@ private:
 	UFUNCTION()
 	void OnOverlapEnd(UPrimitiveComponent* OverlappedComp, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex);
 
+	/**
+	 * 現在の方向と推進力を力場に反映する
+	 */
+	void ApplyForceFieldMotion();
+
+	/**
+	 * ベルト上のオブジェクトとの間の遮蔽物を調べ、遮られているものを力場に通知する
+	 */
+	void RefreshLineOfSight();
+
+	/**
+	 * 遮蔽物チェックのタイマーを、必要な時（稼働中でベルト上に物がある）だけ動かす
+	 */
+	void UpdateLineOfSightTimer();
+
 private:
 	// ベルトの当たり判定用Boxコリジョン
 	UPROPERTY(VisibleAnywhere, Category = "Collision")
@@ -104,4 +121,16 @@ private:
 	// 最も近いオブジェクトのみに力を加えるか
 	UPROPERTY(EditAnywhere, Category = "Belt Settings")
 	bool bOnlyClosest = false;
+
+	// 遮蔽物チェックの間隔（秒）
+	UPROPERTY(EditAnywhere, Category = "Belt Settings", meta = (EditCondition = "bOnlyClosest", ClampMin = "0.01"))
+	float LineOfSightInterval = 0.1f;
+
+	// 力場を登録したサブシステムと力場の番号
+	UPROPERTY(Transient)
+	UPhysicsBatchSubsystem* PhysicsSubsystem = nullptr;
+	int32 ForceFieldId = INDEX_NONE;
+
+	// 遮蔽物チェックのタイマー
+	FTimerHandle LineOfSightTimer;
 };
\ No newline at end of file
@@ -0,0 +1,192 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Manager/KinematicPlatformSubsystem.h"
+#include "Objects/MovingObject.h"
+#include "Curves/CurveFloat.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Moving Platforms"), STAT_KinematicMovingPlatforms, STATGROUP_Game);
+
+// =======================
+// SoA コンテナ
+// =======================
+
+void FKinematicPlatformArrays::AddDefaulted()
+{
+	ElapsedTimes.Add(0.0f);
+	Durations.Add(1.0f);
+	Alphas.Add(0.0f);
+	StartDistances.Add(0.0f);
+	TargetDistances.Add(0.0f);
+	StartOffsets.Add(FVector::ZeroVector);
+	NewLocations.Add(FVector::ZeroVector);
+}
+
+void FKinematicPlatformArrays::RemoveAtSwap(int32 Index)
+{
+	ElapsedTimes.RemoveAtSwap(Index);
+	Durations.RemoveAtSwap(Index);
+	Alphas.RemoveAtSwap(Index);
+	StartDistances.RemoveAtSwap(Index);
+	TargetDistances.RemoveAtSwap(Index);
+	StartOffsets.RemoveAtSwap(Index);
+	NewLocations.RemoveAtSwap(Index);
+}
+
+// =======================
+// 登録・解除
+// =======================
+
+void UKinematicPlatformSubsystem::Deinitialize()
+{
+	for (AMovingObject* Platform : Platforms)
+	{
+		if (Platform)
+		{
+			Platform->PlatformIndex = INDEX_NONE;
+		}
+	}
+
+	Platforms.Empty();
+	Arrays = FKinematicPlatformArrays();
+
+	Super::Deinitialize();
+}
+
+// 処理の流れ:
+// 1. 移動中でなければ配列の末尾に追加
+// 2. 開始・目標の距離と移動時間を設定し、経過時間をリセット
+void UKinematicPlatformSubsystem::StartMove(AMovingObject* Platform, float StartDistance, float TargetDistance, const FVector& StartOffset, float Duration)
+{
+	if (!Platform)
+		return;
+
+	int32 Index = Platform->PlatformIndex;
+	if (!Platforms.IsValidIndex(Index) || Platforms[Index] != Platform)
+	{
+		Arrays.AddDefaulted();
+		Index = Platforms.Add(Platform);
+		Platform->PlatformIndex = Index;
+	}
+
+	Arrays.ElapsedTimes[Index] = 0.0f;
+	Arrays.Durations[Index] = FMath::Max(Duration, KINDA_SMALL_NUMBER);
+	Arrays.Alphas[Index] = 0.0f;
+	Arrays.StartDistances[Index] = StartDistance;
+	Arrays.TargetDistances[Index] = TargetDistance;
+	Arrays.StartOffsets[Index] = StartOffset;
+}
+
+void UKinematicPlatformSubsystem::StopMove(AMovingObject* Platform)
+{
+	if (!Platform || !Platforms.IsValidIndex(Platform->PlatformIndex) || Platforms[Platform->PlatformIndex] != Platform)
+		return;
+
+	RemovePlatformAt(Platform->PlatformIndex);
+}
+
+// 処理の流れ:
+// 1. 末尾の要素を外す位置へ移動して配列を詰める
+// 2. 移動した足場に新しい番号を通知
+void UKinematicPlatformSubsystem::RemovePlatformAt(int32 Index)
+{
+	if (Platforms[Index])
+	{
+		Platforms[Index]->PlatformIndex = INDEX_NONE;
+	}
+
+	Arrays.RemoveAtSwap(Index);
+	Platforms.RemoveAtSwap(Index);
+
+	if (Platforms.IsValidIndex(Index) && Platforms[Index])
+	{
+		Platforms[Index]->PlatformIndex = Index;
+	}
+}
+
+// =======================
+// 更新処理
+// =======================
+
+TStatId UKinematicPlatformSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UKinematicPlatformSubsystem, STATGROUP_Tickables);
+}
+
+// 処理の流れ:
+// 1. 全足場の進み具合をまとめて進める
+// 2. 進み具合から新しい位置をまとめて求める
+// 3. 足場と乗っているアクターへまとめて反映
+// 4. 移動が終わった足場を外す
+void UKinematicPlatformSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	const double TickStartTime = FPlatformTime::Seconds();
+
+	AdvancePlatforms(DeltaTime);
+	EvaluatePlatforms();
+	ApplyPlatforms();
+	RemoveFinishedPlatforms();
+
+	TickSeconds += FPlatformTime::Seconds() - TickStartTime;
+
+	SET_DWORD_STAT(STAT_KinematicMovingPlatforms, Platforms.Num());
+}
+
+// 分岐の無い連続した配列へのループ（コンパイラの自動ベクトル化を想定）
+void UKinematicPlatformSubsystem::AdvancePlatforms(float DeltaTime)
+{
+	float* RESTRICT Elapsed = Arrays.ElapsedTimes.GetData();
+	float* RESTRICT Alphas = Arrays.Alphas.GetData();
+	const float* RESTRICT Durations = Arrays.Durations.GetData();
+	const int32 Count = Arrays.ElapsedTimes.Num();
+
+	for (int32 i = 0; i < Count; ++i)
+	{
+		Elapsed[i] += DeltaTime;
+		Alphas[i] = FMath::Min(Elapsed[i] / Durations[i], 1.0f);
+	}
+}
+
+// 処理の流れ（足場ごと）:
+// 1. カーブがあれば進み具合を補正
+// 2. 経路上の距離を補間して位置を求める（開始時のずれは徐々に0へ）
+void UKinematicPlatformSubsystem::EvaluatePlatforms()
+{
+	for (int32 i = 0; i < Platforms.Num(); ++i)
+	{
+		const AMovingObject* Platform = Platforms[i];
+		if (!Platform)
+			continue;
+
+		const float Alpha = Arrays.Alphas[i];
+		const float Progress = Platform->MoveCurve ? Platform->MoveCurve->GetFloatValue(Alpha) : Alpha;
+		const float Distance = FMath::Lerp(Arrays.StartDistances[i], Arrays.TargetDistances[i], Progress);
+
+		Arrays.NewLocations[i] = Platform->EvaluatePath(Distance) + Arrays.StartOffsets[i] * (1.0f - Progress);
+	}
+}
+
+void UKinematicPlatformSubsystem::ApplyPlatforms()
+{
+	for (int32 i = 0; i < Platforms.Num(); ++i)
+	{
+		if (AMovingObject* Platform = Platforms[i])
+		{
+			Platform->ApplyPlatformLocation(Arrays.NewLocations[i]);
+		}
+	}
+}
+
+// 末尾と入れ替えて外すため後ろから走査する
+void UKinematicPlatformSubsystem::RemoveFinishedPlatforms()
+{
+	for (int32 i = Platforms.Num() - 1; i >= 0; --i)
+	{
+		if (!Platforms[i] || Arrays.Alphas[i] >= 1.0f)
+		{
+			RemovePlatformAt(i);
+		}
+	}
+}
@@ -0,0 +1,103 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "KinematicPlatformSubsystem.generated.h"
+
+class AMovingObject;
+
+/**
+ * 移動中の足場ごとの状態（SoA）
+ * インデックスが同じ要素が1つの足場を表す
+ */
+struct FKinematicPlatformArrays
+{
+	// 経過時間と移動にかける時間
+	TArray<float> ElapsedTimes;
+	TArray<float> Durations;
+
+	// 進み具合（0～1）
+	TArray<float> Alphas;
+
+	// 経路上の開始・目標の距離と、開始時の経路からのずれ
+	TArray<float> StartDistances;
+	TArray<float> TargetDistances;
+	TArray<FVector> StartOffsets;
+
+	// このフレームの新しい位置
+	TArray<FVector> NewLocations;
+
+	/** 末尾に足場を1つ追加 */
+	void AddDefaulted();
+
+	/** 指定インデックスの要素を末尾と入れ替えて削除 */
+	void RemoveAtSwap(int32 Index);
+};
+
+/**
+ * 移動中の全ての AMovingObject をまとめて動かすワールドサブシステム
+ * 進み具合の計算を連続した配列に対する1つのループで行い、位置の反映もまとめて行う
+ * 移動が終わった足場は配列から外れるため、止まっている足場の処理コストはかからない
+ */
+UCLASS()
+class PACHIO_API UKinematicPlatformSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	// 移動中の足場がある時だけTickする
+	virtual ETickableTickType GetTickableTickType() const override { return ETickableTickType::Conditional; }
+	virtual bool IsTickable() const override { return Platforms.Num() > 0; }
+
+	/**
+	 * 足場の移動を開始する（移動中なら今の位置から目標を差し替える）
+	 * @param Platform 移動させる足場
+	 * @param StartDistance 経路上の開始距離
+	 * @param TargetDistance 経路上の目標距離
+	 * @param StartOffset 開始時の経路からのずれ
+	 * @param Duration 移動にかける時間（秒）
+	 */
+	void StartMove(AMovingObject* Platform, float StartDistance, float TargetDistance, const FVector& StartOffset, float Duration);
+
+	/** 足場の移動を止めて配列から外す @param Platform 対象の足場 */
+	void StopMove(AMovingObject* Platform);
+
+	// 移動中の足場の数
+	int32 GetNumMovingPlatforms() const { return Platforms.Num(); }
+
+	// 前回の取得以降に Tick で使った時間（秒）を返してリセットする（計測用）
+	double ConsumeTickSeconds() { const double Seconds = TickSeconds; TickSeconds = 0.0; return Seconds; }
+
+private:
+	/** 全足場の経過時間と進み具合をまとめて進める @param DeltaTime 経過時間 */
+	void AdvancePlatforms(float DeltaTime);
+
+	// 進み具合から全足場の新しい位置を求める
+	void EvaluatePlatforms();
+
+	// 新しい位置を全足場と乗っているアクターにまとめて反映
+	void ApplyPlatforms();
+
+	// 移動が終わった足場を配列から外す
+	void RemoveFinishedPlatforms();
+
+	/** 指定インデックスの足場を配列から外す（末尾の足場が空いた番号に移動する） */
+	void RemovePlatformAt(int32 Index);
+
+private:
+	// 足場の状態（SoA）
+	FKinematicPlatformArrays Arrays;
+
+	// 状態と同じ並びの足場
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<AMovingObject>> Platforms;
+
+	// Tick で使った時間の累計（計測用）
+	double TickSeconds = 0.0;
+};
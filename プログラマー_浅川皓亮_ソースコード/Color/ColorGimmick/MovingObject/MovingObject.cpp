@@ -5,12 +5,13 @@
 #include "Sound/SoundManager.h"
 #include "Components/BoxComponent.h"
 #include "Components/Color/ColorConfigurator.h"
+#include "Manager/KinematicPlatformSubsystem.h"
 #include"Manager/LevelManager.h"
 
 AMovingObject::AMovingObject()
 {
-	// Tickを有効化
-	PrimaryActorTick.bCanEverTick = true;
+	// 移動は UKinematicPlatformSubsystem がまとめて更新するためTickしない
+	PrimaryActorTick.bCanEverTick = false;
 
 	// 足元トリガーを作成してルートに設定
 	FootTrigger = CreateDefaultSubobject<UBoxComponent>(TEXT("FootTrigger"));
@@ -29,70 +30,144 @@ AMovingObject::AMovingObject()
 
 // 1. 親クラスの初期化を実行
 // 2. 初期ターゲット位置をOffLocationに設定
+// 3. 経路を作成
 void AMovingObject::Init()
 {
 	AColorReactiveObject::Init();
 	TargetLocation = OffLocation;
+	BuildPath();
 }
 
-// 1. 親クラスのTickを呼び出し
-// 2. 移動中の場合:
-//    - 経過時間を更新しAlpha値を計算
-//    - 開始位置と目標位置を線形補間
-//    - 移動量を計算して自身の位置を更新
-//    - 上に乗っているアクターに同じ移動量を適用
-//    - 子アクターに同じ移動量を適用
-//    - Alpha値が1.0以上になったら移動完了
-void AMovingObject::Tick(float DeltaTime)
+// 1. 移動中ならサブシステムから外す
+// 2. 親クラスの終了処理を実行
+void AMovingObject::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
-	Super::Tick(DeltaTime);
-
-	if (bIsMoving)
+	if (IsMoving())
 	{
-		ElapsedTime += DeltaTime;
-		float Alpha = FMath::Clamp(ElapsedTime / MoveDuration, 0.0f, 1.0f);
+		if (UKinematicPlatformSubsystem* Platforms = GetWorld()->GetSubsystem<UKinematicPlatformSubsystem>())
+		{
+			Platforms->StopMove(this);
+		}
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
 
-		FVector NewLocation = FMath::Lerp(StartLocation, TargetLocation, Alpha);
-		FVector DeltaMove = NewLocation - GetActorLocation();
+// 1. 移動前のトランスフォームを保持して自身の位置を更新
+// 2. 上に乗っているアクターと子アクターを相対位置を保って移動
+void AMovingObject::ApplyPlatformLocation(const FVector& NewLocation)
+{
+	const FTransform OldTransform = GetActorTransform();
+	SetActorLocation(NewLocation);
+	MoveRiders(OldTransform, GetActorTransform());
+}
 
-		SetActorLocation(NewLocation);
+// 1. 乗っているアクターを一時リストにコピー（移動中のオーバーラップ終了でリストが変わるため）
+// 2. 移動前の自身から見た相対位置を、移動後の自身に当てはめて位置を更新（スイープなし）
+// 3. 子アクターも同様に移動
+void AMovingObject::MoveRiders(const FTransform& OldTransform, const FTransform& NewTransform)
+{
+	auto MoveWithBase = [&OldTransform, &NewTransform](AActor* Rider)
+	{
+		const FVector RelativeLocation = OldTransform.InverseTransformPosition(Rider->GetActorLocation());
+		Rider->SetActorLocation(NewTransform.TransformPosition(RelativeLocation), false);
+	};
 
-		TArray<AActor*> Actors = AttachedActors;
-		for (AActor* ActorOnTop : Actors)
+	const TArray<AActor*, TInlineAllocator<8>> Riders(AttachedActors);
+	for (AActor* ActorOnTop : Riders)
+	{
+		if (ActorOnTop)
 		{
-			if (ActorOnTop)
-			{
-				ActorOnTop->AddActorWorldOffset(DeltaMove, true);
-			}
+			MoveWithBase(ActorOnTop);
 		}
+	}
 
-		for (AActor* ChildActor : Child)
+	for (AActor* ChildActor : Child)
+	{
+		if (ChildActor)
 		{
-			if (ChildActor)
-			{
-				ChildActor->AddActorWorldOffset(DeltaMove, true);
-			}
+			MoveWithBase(ChildActor);
 		}
+	}
+}
+
+// 1. OffLocation・経由地点・OnLocationの順に経路の点を並べる
+// 2. 始点から各点までの距離を累積して保持
+void AMovingObject::BuildPath()
+{
+	PathPoints.Reset(Waypoints.Num() + 2);
+	PathPoints.Add(OffLocation);
+	PathPoints.Append(Waypoints);
+	PathPoints.Add(OnLocation);
+
+	PathDistances.Reset(PathPoints.Num());
+	PathDistances.Add(0.0f);
+	for (int32 i = 1; i < PathPoints.Num(); ++i)
+	{
+		PathDistances.Add(PathDistances[i - 1] + FVector::Dist(PathPoints[i - 1], PathPoints[i]));
+	}
+}
 
-		if (Alpha >= 1.0f)
+// 1. 距離を経路の長さに収める
+// 2. 距離を含む区間を探し、区間内で線形補間
+FVector AMovingObject::EvaluatePath(float Distance) const
+{
+	if (PathPoints.Num() == 0)
+		return GetActorLocation();
+
+	const float TotalLength = PathDistances.Last();
+	Distance = FMath::Clamp(Distance, 0.0f, TotalLength);
+
+	for (int32 i = 1; i < PathPoints.Num(); ++i)
+	{
+		if (Distance <= PathDistances[i])
 		{
-			bIsMoving = false;
+			const float SegmentLength = PathDistances[i] - PathDistances[i - 1];
+			const float SegmentAlpha = SegmentLength > KINDA_SMALL_NUMBER ? (Distance - PathDistances[i - 1]) / SegmentLength : 1.0f;
+			return FMath::Lerp(PathPoints[i - 1], PathPoints[i], SegmentAlpha);
 		}
 	}
+
+	return PathPoints.Last();
+}
+
+// 各区間で最も近い点を求め、その中で最も近いものの距離を返す
+float AMovingObject::ProjectOntoPath(const FVector& Location) const
+{
+	float BestDistance = 0.0f;
+	float BestDistSquared = TNumericLimits<float>::Max();
+
+	for (int32 i = 1; i < PathPoints.Num(); ++i)
+	{
+		const FVector Closest = FMath::ClosestPointOnSegment(Location, PathPoints[i - 1], PathPoints[i]);
+		const float DistSquared = FVector::DistSquared(Location, Closest);
+		if (DistSquared < BestDistSquared)
+		{
+			BestDistSquared = DistSquared;
+			BestDistance = PathDistances[i - 1] + FVector::Dist(PathPoints[i - 1], Closest);
+		}
+	}
+
+	return BestDistance;
 }
 
 // 1. 親クラスのColorActionを実行
-// 2. 移動開始位置を現在位置に設定
-// 3. 経過時間をリセット
-// 4. 色一致時はOffLocationへ、不一致時はOnLocationへ移動
-// 5. 移動開始フラグを立てる
+// 2. 現在位置に最も近い経路上の距離を移動開始位置とし、経路からのずれを求める
+// 3. 色一致時はOffLocation（経路の始点）へ、不一致時はOnLocation（終点）へ
+// 4. サブシステムに移動を登録（移動中なら今の位置から目標を差し替える）
 void AMovingObject::ColorAction(FLinearColor InColor, FEffectMatchResult Result)
 {
 	AColorReactiveObject::ColorAction(InColor, Result);
 
-	StartLocation = GetActorLocation();
-	ElapsedTime = 0.0f;
+	if (PathPoints.Num() == 0)
+	{
+		BuildPath();
+	}
+
+	const float StartPathDistance = ProjectOntoPath(GetActorLocation());
+	const FVector StartPathOffset = GetActorLocation() - EvaluatePath(StartPathDistance);
 
+	float TargetPathDistance = 0.0f;
 	if (ColorConfigurator->IsColorMatch())
 	{
 		TargetLocation = OffLocation;
@@ -100,9 +175,14 @@ void AMovingObject::ColorAction(FLinearColor InColor, FEffectMatchResult Result)
 	else
 	{
 		TargetLocation = OnLocation;
+		TargetPathDistance = PathDistances.Last();
 	}
 
-	bIsMoving = true;
+	UKinematicPlatformSubsystem* Platforms = GetWorld()->GetSubsystem<UKinematicPlatformSubsystem>();
+	if (!Platforms)
+		return;
+
+	Platforms->StartMove(this, StartPathDistance, TargetPathDistance, StartPathOffset, MoveDuration);
 }
 
 // 1. Interactionタグを持つコンポーネントは除外
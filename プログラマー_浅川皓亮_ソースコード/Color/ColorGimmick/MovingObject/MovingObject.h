@@ -8,11 +8,14 @@
 #include "MovingObject.generated.h"
 
 class UBoxComponent;
+class UCurveFloat;
+class UKinematicPlatformSubsystem;
 
 /**
  * 色に反応して移動するオブジェクト
- * 色の一致・不一致に応じてOnLocationとOffLocationを切り替える
- * 上に乗っているアクターや子オブジェクトも一緒に移動する
+ * 色の一致・不一致に応じてOffLocation → 経由地点 → OnLocation の経路上を往復する
+ * 上に乗っているアクターや子オブジェクトは自身との相対位置を保って移動する（スイープなし）
+ * 移動の更新は UKinematicPlatformSubsystem が全ての足場をまとめて行うため、自身はTickしない
  */
 UCLASS()
 class PACHIO_API AMovingObject : public AColorReactiveObject
@@ -28,11 +31,17 @@ public:
 	virtual void Init() override;
 
 	/**
-	 * 毎フレーム呼ばれる処理
-	 * 移動中のアクターと子オブジェクトを追従させる
-	 * @param DeltaTime フレーム間の経過時間
+	 * 移動中かどうか
 	 */
-	virtual void Tick(float DeltaTime) override;
+	bool IsMoving() const { return PlatformIndex != INDEX_NONE; }
+
+protected:
+	/**
+	 * 終了時の処理
+	 * 移動中ならサブシステムから外す
+	 * @param EndPlayReason 終了理由
+	 */
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 private:
 	/**
@@ -68,9 +77,44 @@ private:
 	UFUNCTION()
 	void OnFootEndOverlap(UPrimitiveComponent* OverlappedComp, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex);
 
+	/**
+	 * OffLocation・経由地点・OnLocationから経路と各点までの距離を作成
+	 */
+	void BuildPath();
+
+	/**
+	 * 経路上の距離から位置を求める
+	 * @param Distance 経路の始点（OffLocation）からの距離
+	 * @return 経路上の位置
+	 */
+	FVector EvaluatePath(float Distance) const;
+
+	/**
+	 * 位置に最も近い経路上の距離を求める
+	 * @param Location 対象の位置
+	 * @return 経路の始点からの距離
+	 */
+	float ProjectOntoPath(const FVector& Location) const;
+
+	/**
+	 * 上に乗っているアクターと子オブジェクトを、自身との相対位置を保ったまま移動させる
+	 * @param OldTransform 移動前の自身のトランスフォーム
+	 * @param NewTransform 移動後の自身のトランスフォーム
+	 */
+	void MoveRiders(const FTransform& OldTransform, const FTransform& NewTransform);
+
+	/**
+	 * サブシステムが求めた位置へ移動し、乗っているアクターを追従させる
+	 * @param NewLocation 新しい位置
+	 */
+	void ApplyPlatformLocation(const FVector& NewLocation);
+
 private:
-	// 移動中フラグ
-	bool bIsMoving = false;
+	// 移動の更新はサブシステムがまとめて行う
+	friend class UKinematicPlatformSubsystem;
+
+	// サブシステム内での番号（移動中でなければ INDEX_NONE）
+	int32 PlatformIndex = INDEX_NONE;
 
 	// 色不一致時の目標位置(エディタで設定)
 	UPROPERTY(EditAnywhere, Category = "Movement Settings")
@@ -80,9 +124,21 @@ private:
 	UPROPERTY(EditAnywhere, Category = "Movement Settings")
 	FVector OnLocation;
 
+	// OffLocationからOnLocationまでの経由地点(エディタで設定)
+	UPROPERTY(EditAnywhere, Category = "Movement Settings")
+	TArray<FVector> Waypoints;
+
+	// 移動の進み具合(0～1)を補正するカーブ(未設定なら等速)
+	UPROPERTY(EditAnywhere, Category = "Movement Settings")
+	UCurveFloat* MoveCurve = nullptr;
+
 	// 現在の目標位置
 	FVector TargetLocation;
 
+	// 経路の各点と、始点からの距離
+	TArray<FVector> PathPoints;
+	TArray<float> PathDistances;
+
 	// 一緒に移動する子アクターのリスト(エディタで設定)
 	UPROPERTY(EditAnywhere, Category = "Movement Settings")
 	TArray<AActor*> Child;
@@ -94,13 +150,7 @@ private:
 	// 上に乗っているアクターのリスト
 	TArray<AActor*> AttachedActors;
 
-	// 移動開始時の位置
-	FVector StartLocation;
-
 	// 移動にかける時間(秒)
 	UPROPERTY(EditAnywhere, Category = "Movement Settings")
 	float MoveDuration = 1.0f;
-
-	// 移動開始からの経過時間
-	float ElapsedTime = 0.0f;
 };
\ No newline at end of file
@@ -2,9 +2,11 @@
 #include "Kismet/GameplayStatics.h"
 #include "Logic/ColorManager/ColorTargetRegistry.h"
 #include "Components/AudioComponent.h"
-#include "Manager/LevelManager.h"
+#include "Manager/GameServicesSubsystem.h"
 #include "Manager/ColorManager.h"
 #include "Manager/SaveManager.h"
+#include "Manager/BeatDispatcherSubsystem.h"
+#include "Sound/BeatMapAsset.h"
 
 #define FMOD_API_TRUE
 #define FMOD_STUDIO_API_TRUE 
@@ -20,82 +22,200 @@
 
 static FMOD_RESULT OnTimelineMarker(FMOD_STUDIO_EVENT_CALLBACK_TYPE type, FMOD_STUDIO_EVENTINSTANCE* eventInstance, void* parameters)
 {
-	// 処理の流れ:
+	// 処理の流れ（FMODのスレッドで呼ばれるため、文字列の変換やUObjectの通知は行わない）:
 	// 1. タイムラインマーカーイベントを判定
 	// 2. Beatマーカーの場合、UserDataからUSoundManagerを取得
-	// 3. Managerが存在すればOnMarkerBeatを呼ぶ
+	// 3. Managerが存在すればマーカーをキューに積む（通知はゲームスレッドで行う）
 	if (type == FMOD_STUDIO_EVENT_CALLBACK_TIMELINE_MARKER)
 	{
 		auto* Marker = static_cast<FMOD_STUDIO_TIMELINE_MARKER_PROPERTIES*>(parameters);
-		FString MarkerName = UTF8_TO_TCHAR(Marker->name);
 
-		if (MarkerName == "Beat")
+		if (Marker && Marker->name && FCStringAnsi::Strcmp(Marker->name, "Beat") == 0)
 		{
 			void* RawUserData = nullptr;
 			((FMOD::Studio::EventInstance*)eventInstance)->getUserData(&RawUserData);
 			USoundManager* Manager = static_cast<USoundManager*>(RawUserData);
 			if (Manager)
 			{
-				Manager->OnMarkerBeat(Marker->position);
+				Manager->EnqueueBeatMarker(Marker->position);
 			}
 		}
 	}
 	return FMOD_OK;
 }
 
+namespace
+{
+	// FMODのスレッドから受けるマーカーのキューの大きさ（2の累乗、1つは空きとして使われる）
+	static constexpr uint32 BEAT_MARKER_QUEUE_SIZE = 64;
+
+	// ビートマップ使用時、再生位置と時計の予測がこれ以上ずれたら合わせ直す（秒）
+	// 再生位置はFMODの更新間隔ごとにしか進まないため、それより広くして拍が揺れないようにする
+	static constexpr double SONG_SYNC_TOLERANCE = 0.03;
+}
+
 // コンストラクタ
 // 処理の流れ:
 // 1. BGM, SE 音量を初期化
 // 2. 再生中BGMは nullptr に設定
+// 3. マーカーを取り出すためにTickを有効化
 USoundManager::USoundManager()
 	: BGMVolume(1)
 	, SEVolume(1)
 	, CurrentBGMComponent(nullptr)
+	, BeatMarkerQueue(BEAT_MARKER_QUEUE_SIZE)
+{
+	PrimaryComponentTick.bCanEverTick = true;
+}
+
+// 処理の流れ:
+// 1. FMODのスレッドから受けたマーカーを全て取り出して処理
+// 2. オンセット検出のDSPをまだ挿せていなければ挿し、検出したオンセットを全て取り出して処理
+// 3. ビートマップ使用時は、再生中のBGMの位置に時計を合わせる
+// 4. 時計の拍が進んでいればOnBeatDetectedを通知（1フレームで複数拍進んでも1回）
+void USoundManager::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	FBeatMarkerEvent Marker;
+	while (BeatMarkerQueue.Dequeue(Marker))
+	{
+		OnMarkerBeat(Marker);
+	}
+
+	if (OnsetAnalyzer)
+	{
+		if (!OnsetAnalyzer->IsAttached() && EventInstance)
+		{
+			OnsetAnalyzer->Attach(EventInstance);
+		}
+
+		FBGMOnsetEvent Onset;
+		while (OnsetAnalyzer->Dequeue(Onset))
+		{
+			OnBGMOnsetDetected(Onset);
+		}
+	}
+
+	if (!BeatClock.IsRunning())
+		return;
+
+	if (BeatMap)
+	{
+		SyncBeatClockToTimeline();
+	}
+
+	const int64 BeatIndex = BeatClock.GetBeatIndex(FPlatformTime::Seconds());
+	if (BeatIndex > LastPredictedBeat)
+	{
+		LastPredictedBeat = BeatIndex;
+		OnBeatDetected.Broadcast();
+	}
+}
+
+// コールバックがこのオブジェクトを指さないようにしてから破棄する
+void USoundManager::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
+	if (EventInstance)
+	{
+		EventInstance->setCallback(nullptr);
+		EventInstance->setUserData(nullptr);
+		EventInstance = nullptr;
+	}
+
+	// DSPを外してから破棄する
+	OnsetAnalyzer.Reset();
+
+	BeatClock.Stop();
+
+	Super::EndPlay(EndPlayReason);
+}
+
+// FMODのスレッドから呼ばれる（キューが一杯の場合は捨てる。次のマーカーで補正される）
+void USoundManager::EnqueueBeatMarker(int32 MarkerPositionMs)
+{
+	FBeatMarkerEvent Marker;
+	Marker.PositionMs = MarkerPositionMs;
+	Marker.Time = FPlatformTime::Seconds();
+	BeatMarkerQueue.Enqueue(Marker);
 }
 
 // 初期化
 // 処理の流れ:
 // 1. 保存音量をロード
-// 2. 各SoundDataのAudioComponentを生成
-// 3. BGM用にEnvelopeイベントをバインド
+// 2. 種別ごとの同時発音数と、各サウンドの番号を割り当てる（AudioComponentは作らない）
+// 3. 再生中の音を止めて、AudioComponentの状態をリセット
 // 4. Beat検知用デリゲートを登録
-// 5. テストBGMを初期化
+// 5. 拍の位相を書き込むマテリアルパラメータコレクションを設定
+// 6. テストBGMを初期化
 void USoundManager::Init()
 {
 	LoadOrCreateVolumeSave();
 
+	SoundEntries.Reset();
+	SoundCategories.Reset();
+
 	for (auto& soundMap : SoundDataMap)
 	{
 		const FName dataTag = soundMap.Key;
 		FSoundData& soundData = soundMap.Value;
-		soundData.AudioComponentMap.Reset();
+		soundData.SoundIndexMap.Reset();
+
+		const int32 categoryIndex = SoundCategories.Num();
+		FSoundCategory& category = SoundCategories.AddDefaulted_GetRef();
+		category.DataID = dataTag;
+		category.MaxVoices = FMath::Max(1, soundData.MaxVoices);
 
 		for (const auto& soundAssetPair : soundData.SoundAssetMap)
 		{
 			const FName waveTag = soundAssetPair.Key;
 			USoundBase* sound = soundAssetPair.Value;
 			if (waveTag.IsNone() || !sound) continue;
-			if (soundData.AudioComponentMap.Contains(waveTag)) continue;
+			if (soundData.SoundIndexMap.Contains(waveTag)) continue;
 
-			UAudioComponent* AudioComponent = UGameplayStatics::CreateSound2D(this, sound);
-			if (!AudioComponent) continue;
+			FSoundEntry& entry = SoundEntries.AddDefaulted_GetRef();
+			entry.Sound = sound;
+			entry.Category = categoryIndex;
 
-			AudioComponent->bAutoDestroy = false;
+			soundData.SoundIndexMap.Add(waveTag, SoundEntries.Num() - 1);
+		}
+	}
 
-			if (dataTag == "BGM")
-			{
-				AudioComponent->OnAudioSingleEnvelopeValue.AddDynamic(this, &USoundManager::OnEnvelopeValue);
-			}
+	for (int32 i = 0; i < VoiceComponents.Num(); ++i)
+	{
+		if (VoiceComponents[i]) VoiceComponents[i]->Stop();
+		Voices[i] = FSoundVoice();
+	}
 
-			soundData.AudioComponentMap.Add(waveTag, AudioComponent);
-		}
+	const UGameServicesSubsystem* Services = UGameServicesSubsystem::Get(this);
+	UColorManager* colorManager = Services ? Services->GetColorManager() : nullptr;
+	if (colorManager && colorManager->GetColorTargetRegistry())
+	{
+		colorManager->GetColorTargetRegistry()->OnColorApplied.AddDynamic(this, &USoundManager::SetTmp);
 	}
 
-	ALevelManager::GetInstance(GetWorld())->GetColorManager()->GetColorTargetRegistry()->OnColorApplied.AddDynamic(this, &USoundManager::SetTmp);
+	if (UBeatDispatcherSubsystem* Dispatcher = GetWorld()->GetSubsystem<UBeatDispatcherSubsystem>())
+	{
+		Dispatcher->SetParameterCollection(BeatParameterCollection);
+	}
 	InitTestSound();
 }
 
+// ハンドル取得
+FSoundHandle USoundManager::FindSound(FName DataID, FName SoundID) const
+{
+	FSoundHandle Handle;
+
+	const FSoundData* soundData = SoundDataMap.Find(DataID);
+	if (!soundData) return Handle;
+
+	if (const int32* index = soundData->SoundIndexMap.Find(SoundID))
+	{
+		Handle.Index = *index;
+	}
+	return Handle;
+}
+
 // 音量ロード
 void USoundManager::LoadOrCreateVolumeSave()
 {
@@ -115,10 +235,8 @@ void USoundManager::SetVolume(float NewBGM, float NewSE)
 // BPM変更
 void USoundManager::SetTmp(EColorTargetType Mode, FLinearColor NewColor)
 {
-	ALevelManager* level = ALevelManager::GetInstance(GetWorld());
-	if (!level) return;
-
-	UColorManager* colorManager = level->GetColorManager();
+	const UGameServicesSubsystem* Services = UGameServicesSubsystem::Get(this);
+	UColorManager* colorManager = Services ? Services->GetColorManager() : nullptr;
 	if (!colorManager) return;
 
 	FEffectMatchResult Match = colorManager->GetClosestEffectByHue(NewColor);
@@ -131,9 +249,7 @@ void USoundManager::SetTmp(EColorTargetType Mode, FLinearColor NewColor)
 	default: MusicBPM = 120.f; break;
 	}
 
-	BeatInterval = 60.f / MusicBPM;
-	StartTime = GetWorld()->GetTimeSeconds();
-	LastPredictedBeat = -1;
+	BeatClock.SetBPM(MusicBPM, FPlatformTime::Seconds());
 }
 
 // BGM音量設定
@@ -167,61 +283,145 @@ void USoundManager::SetSEVolume(float vol)
 // サウンド再生
 bool USoundManager::PlaySound(FName DataID, FName SoundID, bool SetVolume, float Volume, bool IsSpecifyLocation, FVector place)
 {
-	float volume = SetVolume ? Volume : (DataID == "BGM" ? BGMVolume : SEVolume);
-
 	if (DataID == "BGM") return PlayBGM();
 
-	if (!SoundDataMap.Contains(DataID)) return false;
-	if (!SoundDataMap[DataID].AudioComponentMap.Contains(SoundID)) return false;
+	return PlaySoundByHandle(FindSound(DataID, SoundID), SetVolume, Volume, IsSpecifyLocation, place);
+}
+
+// ハンドルでサウンド再生
+bool USoundManager::PlaySoundByHandle(FSoundHandle Handle, bool SetVolume, float Volume, bool IsSpecifyLocation, FVector place)
+{
+	const float volume = SetVolume ? Volume : SEVolume;
+
+	UAudioComponent* AudioComponent = PrepareVoice(Handle, volume, IsSpecifyLocation, place);
+	if (!AudioComponent) return false;
+
+	AudioComponent->Play();
+	return true;
+}
+
+// 再生前の準備
+// 処理の流れ:
+// 1. ハンドルからサウンドを取得
+// 2. 鳴らすAudioComponentを選ぶ（同時発音数を超えた場合は古い音を止める）
+// 3. 初めて使う枠ならAudioComponentを作成
+// 4. サウンド・音量・位置を設定
+UAudioComponent* USoundManager::PrepareVoice(FSoundHandle Handle, float Volume, bool IsSpecifyLocation, const FVector& place)
+{
+	if (!SoundEntries.IsValidIndex(Handle.Index)) return nullptr;
 
-	UAudioComponent* AudioComponent = SoundDataMap[DataID].AudioComponentMap[SoundID];
-	if (!AudioComponent) { Init(); return false; }
+	const FSoundEntry& entry = SoundEntries[Handle.Index];
 
-	AudioComponent->SetVolumeMultiplier(FMath::Clamp(volume, 0.0f, 1.0f));
+	const int32 voiceIndex = AcquireVoice(entry.Category);
+	if (voiceIndex == INDEX_NONE) return nullptr;
+
+	UAudioComponent* AudioComponent = VoiceComponents[voiceIndex];
+	if (!AudioComponent)
+	{
+		AudioComponent = UGameplayStatics::CreateSound2D(this, entry.Sound);
+		if (!AudioComponent) return nullptr;
+
+		AudioComponent->bAutoDestroy = false;
+		VoiceComponents[voiceIndex] = AudioComponent;
+	}
+
+	AudioComponent->Stop();
+	AudioComponent->SetSound(entry.Sound);
+
+	AudioComponent->SetVolumeMultiplier(FMath::Clamp(Volume, 0.0f, 1.0f));
 
 	if (IsSpecifyLocation)
 		AudioComponent->SetWorldLocation(place);
 
-	FSoundAttenuationSettings AttenuationSettings;
-	AttenuationSettings.bAttenuate = true;
-	AttenuationSettings.FalloffDistance = 2000.0f;
+	Voices[voiceIndex].Category = entry.Category;
+	Voices[voiceIndex].StartTime = FPlatformTime::Seconds();
 
-	AudioComponent->Play();
-	return true;
+	return AudioComponent;
+}
+
+// 鳴らすAudioComponentを選ぶ
+// 処理の流れ:
+// 1. 再生中の音を種別ごとに数え、空きと最も古い音を探す
+// 2. 種別の同時発音数に達していれば、その種別で最も古い音を返す
+// 3. 空きがあればそれを返し、無ければプールの上限まで枠を増やす（AudioComponentは再生時に作成）
+// 4. プールも一杯なら全体で最も古い音を返す
+int32 USoundManager::AcquireVoice(int32 Category)
+{
+	if (!SoundCategories.IsValidIndex(Category)) return INDEX_NONE;
+
+	int32 categoryVoices = 0;
+	int32 oldestInCategory = INDEX_NONE;
+	int32 oldestOverall = INDEX_NONE;
+	int32 freeVoice = INDEX_NONE;
+
+	for (int32 i = 0; i < VoiceComponents.Num(); ++i)
+	{
+		const UAudioComponent* AudioComponent = VoiceComponents[i];
+		if (!AudioComponent || !AudioComponent->IsPlaying())
+		{
+			if (freeVoice == INDEX_NONE) freeVoice = i;
+			continue;
+		}
+
+		const FSoundVoice& voice = Voices[i];
+		if (oldestOverall == INDEX_NONE || voice.StartTime < Voices[oldestOverall].StartTime)
+		{
+			oldestOverall = i;
+		}
+
+		if (voice.Category == Category)
+		{
+			++categoryVoices;
+			if (oldestInCategory == INDEX_NONE || voice.StartTime < Voices[oldestInCategory].StartTime)
+			{
+				oldestInCategory = i;
+			}
+		}
+	}
+
+	if (categoryVoices >= SoundCategories[Category].MaxVoices) return oldestInCategory;
+	if (freeVoice != INDEX_NONE) return freeVoice;
+
+	if (VoiceComponents.Num() < VoicePoolSize)
+	{
+		VoiceComponents.Add(nullptr);
+		Voices.AddDefaulted();
+		return VoiceComponents.Num() - 1;
+	}
+
+	return oldestOverall;
 }
 
 // BGM停止
 void USoundManager::StopBGM()
 {
 	if (FMODAudioComponent) FMODAudioComponent->Stop();
+	if (OnsetAnalyzer) OnsetAnalyzer->Detach();
 }
 
 // フェードイン再生
 void USoundManager::PlaySoundWithFadeIn(FName DataID, FName SoundID, float Volume, float FadeDuration)
 {
-	if (!SoundDataMap.Contains(DataID)) return;
-	if (!SoundDataMap[DataID].AudioComponentMap.Contains(SoundID)) return;
-
-	UAudioComponent* AudioComponent = SoundDataMap[DataID].AudioComponentMap[SoundID];
+	UAudioComponent* AudioComponent = PrepareVoice(FindSound(DataID, SoundID), Volume, false, FVector::ZeroVector);
 	if (!AudioComponent) return;
 
-	AudioComponent->SetVolumeMultiplier(FMath::Clamp(Volume, 0.0f, 1.0f));
-	AudioComponent->FadeIn(FadeDuration);
-	AudioComponent->Play();
+	AudioComponent->FadeIn(FadeDuration, FMath::Clamp(Volume, 0.0f, 1.0f));
 }
 
 // フェードアウト停止（未使用のためコメント化）
 // void USoundManager::StopBGMWithFadeOut(float FadeDuration) { ... }
 
-void USoundManager::OnEnvelopeValue(const USoundWave* SoundWave, const float EnvelopeValue) {}
-
 // BGM再生
+// 処理の流れ:
+// 1. FMODのイベントを再生
+// 2. ビートマップがあれば拍の時刻の表と曲の長さ（ループ用）をビート時計に渡す
+// 3. 無ければタイムラインのマーカーで拍を受け取る
+// 4. オンセット検出が有効なら、前のBGMに挿したDSPを外す（新しいイベントには TickComponent で挿す）
+// 5. 時計を開始する（ビートマップ使用時は、実際に鳴り始めた位置に TickComponent で合わせ直す）
 bool USoundManager::PlayBGM()
 {
 	if (!BGMEventAsset) return false;
 
-	BeatInterval = 60.0f / MusicBPM;
-
 	if (!BGM)
 	{
 		BGM = NewObject<UFMODAudioComponent>(this);
@@ -232,13 +432,26 @@ bool USoundManager::PlayBGM()
 	BGM->Play();
 
 	EventInstance = BGM->StudioInstance;
-	if (EventInstance)
+	if (BeatMap)
+	{
+		BeatClock.SetBeatTable(BeatMap->BeatTimes.GetData(), BeatMap->BeatTimes.Num(), BeatMap->Duration);
+	}
+	else if (EventInstance)
 	{
 		EventInstance->setUserData(this);
 		EventInstance->setCallback(OnTimelineMarker, FMOD_STUDIO_EVENT_CALLBACK_TIMELINE_MARKER);
 	}
 
-	StartTime = GetWorld()->GetTimeSeconds();
+	if (bAnalyzeBGMOnsets)
+	{
+		if (!OnsetAnalyzer)
+		{
+			OnsetAnalyzer = MakeUnique<FBGMOnsetAnalyzer>();
+		}
+		OnsetAnalyzer->Detach();
+	}
+
+	BeatClock.Start(FPlatformTime::Seconds(), MusicBPM);
 	LastPredictedBeat = -1;
 
 	return true;
@@ -246,6 +459,25 @@ bool USoundManager::PlayBGM()
 
 void USoundManager::OnBeatTimerElapsed() {}
 
+// 処理の流れ:
+// 1. BGMのイベントが再生中でなければ何もしない（読み込み中は位置が0のまま進まない）
+// 2. タイムラインの位置を取得し、ずれていれば時計の曲の先頭の時刻を合わせ直す
+void USoundManager::SyncBeatClockToTimeline()
+{
+	if (!EventInstance || !EventInstance->isValid())
+		return;
+
+	FMOD_STUDIO_PLAYBACK_STATE State = FMOD_STUDIO_PLAYBACK_STOPPED;
+	if (EventInstance->getPlaybackState(&State) != FMOD_OK || State != FMOD_STUDIO_PLAYBACK_PLAYING)
+		return;
+
+	int TimelineMs = 0;
+	if (EventInstance->getTimelinePosition(&TimelineMs) != FMOD_OK)
+		return;
+
+	BeatClock.SyncSongTime(TimelineMs / 1000.0, FPlatformTime::Seconds(), SONG_SYNC_TOLERANCE);
+}
+
 // テストBGM初期化
 void USoundManager::InitTestSound()
 {
@@ -257,9 +489,48 @@ void USoundManager::InitTestSound()
 	}
 }
 
-// Beatマーカー処理
-void USoundManager::OnMarkerBeat(int64 MarkerPositionMs)
+// Beatマーカー処理（ゲームスレッド）
+// 処理の流れ:
+// 1. マーカーを受けた時刻で時計を補正
+// 2. 確定したBeatを通知
+void USoundManager::OnMarkerBeat(const FBeatMarkerEvent& Marker)
+{
+	LastConfirmedBeatTime = Marker.PositionMs / 1000.0f;
+	BeatClock.ConfirmBeat(Marker.Time);
+	OnConfirmedBeat.Broadcast();
+}
+
+// BGMのオンセット処理（ゲームスレッド）
+// 処理の流れ:
+// 1. オンセットを通知
+// 2. 予測した最も近い拍からのずれが OnsetBeatWindow 以内なら、その拍として時計を補正して確定を通知
+void USoundManager::OnBGMOnsetDetected(const FBGMOnsetEvent& Onset)
+{
+	OnBGMOnset.Broadcast(Onset.Strength);
+
+	if (!BeatClock.IsRunning())
+		return;
+
+	const double Position = BeatClock.GetBeatPosition(Onset.Time);
+	if (FMath::Abs(Position - FMath::RoundToDouble(Position)) > OnsetBeatWindow)
+		return;
+
+	BeatClock.ConfirmBeat(Onset.Time);
+	OnConfirmedBeat.Broadcast();
+}
+
+float USoundManager::GetBeatPhase() const
+{
+	return BeatClock.GetBeatPhase(FPlatformTime::Seconds());
+}
+
+float USoundManager::GetTimeToNextBeat() const
+{
+	const double Now = FPlatformTime::Seconds();
+	return static_cast<float>(BeatClock.GetNextBeatTime(Now) - Now);
+}
+
+int32 USoundManager::GetBeatIndex() const
 {
-	LastConfirmedBeatTime = MarkerPositionMs / 1000.0f;
-	OnBeatDetected.Broadcast();
+	return static_cast<int32>(BeatClock.GetBeatIndex(FPlatformTime::Seconds()));
 }
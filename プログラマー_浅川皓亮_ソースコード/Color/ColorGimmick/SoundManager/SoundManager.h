@@ -8,19 +8,26 @@
 #include "Components/ActorComponent.h"
 #include "Interface/Soundable.h"
 #include "DataContainer/EffectMatchResult.h"
+#include "Sound/SoundHandle.h"
+#include "Sound/BGMOnsetAnalyzer.h"
+#include "Logic/Sound/BeatClock.h"
+#include "Containers/CircularQueue.h"
 #include "fmod_studio.hpp"     // FMOD Studio APIのC++ラッパー
 #include "SoundManager.generated.h"
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnBeatDetected);  
 DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnConfirmedBeat);  // マーカーで受けた正確なビート
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnBGMOnset, float, Strength);  // BGMの音声から検出したオンセット
 
 class UAudioComponent;
 class UFMODAudioComponent;
 class UFMODEvent;
+class UMaterialParameterCollection;
+class UBeatMapAsset;
 
 /*
 * サウンドのデータを保持する構造体
-* 各サウンドのアセットと再生用AudioComponentを管理
+* 各サウンドのアセットと、種別ごとの同時発音数を管理
 */
 USTRUCT()
 struct FSoundData : public FTableRowBase
@@ -32,9 +39,49 @@ public:
     UPROPERTY(EditAnywhere, Category = "Sound")
     TMap<FName, USoundBase*> SoundAssetMap;
 
-    /* 再生用AudioComponentを保持（生成時に作成） */
+    /* この種別で同時に鳴らせる数（超えた場合は最も古い音を止めて鳴らす） */
+    UPROPERTY(EditAnywhere, Category = "Sound", meta = (ClampMin = "1"))
+    int32 MaxVoices = 4;
+
+    /* サウンド名 -> USoundManager 内のサウンド番号（Init時に作成） */
     UPROPERTY(Transient)
-    TMap<FName, UAudioComponent*> AudioComponentMap;
+    TMap<FName, int32> SoundIndexMap;
+};
+
+/* 登録されたサウンド1つ分（FSoundHandle の番号で引く） */
+struct FSoundEntry
+{
+    USoundBase* Sound = nullptr;
+
+    /* 所属する種別の番号（SoundCategories の番号） */
+    int32 Category = INDEX_NONE;
+};
+
+/* 種別ごとの同時発音数 */
+struct FSoundCategory
+{
+    FName DataID;
+    int32 MaxVoices = 1;
+};
+
+/* 再生用AudioComponent 1つ分の状態（VoiceComponents と同じ並び） */
+struct FSoundVoice
+{
+    /* 最後に鳴らした種別（未使用は INDEX_NONE） */
+    int32 Category = INDEX_NONE;
+
+    /* 再生を開始した時間（古い音から止めるため） */
+    double StartTime = 0.0;
+};
+
+/* FMODのスレッドで受けたBeatマーカー（ゲームスレッドへ渡す） */
+struct FBeatMarkerEvent
+{
+    /* タイムライン上のマーカー位置（ミリ秒） */
+    int32 PositionMs = 0;
+
+    /* マーカーを受けた時刻（FPlatformTime::Seconds） */
+    double Time = 0.0;
 };
 
 /*
@@ -56,10 +103,42 @@ public:
 
     /*
     * サウンドマネージャを初期化
-    * AudioComponentの生成やVolumeロードを行う
+    * Volumeロードとサウンド番号の割り当てを行う（AudioComponentは再生時に必要な数だけ作る）
     */
     void Init();
 
+    /*
+    * サウンドのハンドルを取得（ロード時に一度だけ呼び、再生時はハンドルを使う）
+    * @param DataID "SE"などサウンド種別
+    * @param SoundID サウンドの識別子
+    * @return 見つからない場合は無効なハンドル
+    */
+    FSoundHandle FindSound(FName DataID, FName SoundID) const;
+
+    /*
+    * ハンドルで指定したサウンドを再生
+    * @param Handle FindSound で取得したハンドル
+    * @param SetVolume 音量を固定値で設定するか
+    * @param Volume 音量倍率
+    * @param IsSpecifyLocation 位置指定で再生するか
+    * @param place 位置
+    * @return 成功したか
+    */
+    bool PlaySoundByHandle(FSoundHandle Handle, const bool SetVolume = false, float Volume = 1.f, bool IsSpecifyLocation = false, FVector place = FVector::ZeroVector);
+
+    /*
+    * 指定したサウンドを再生（名前から毎回ハンドルを引くため、頻繁に鳴らす音は PlaySoundByHandle を使う）
+    * @param DataID "BGM"や"SE"などサウンド種別
+    * @param SoundID サウンドの識別子
+    * @param SetVolume 音量を固定値で設定するか
+    * @param Volume 音量倍率
+    * @param IsSpecifyLocation 位置指定で再生するか
+    * @param place 位置
+    * @return 成功したか
+    */
+    UFUNCTION(BlueprintCallable)
+    bool PlaySound(FName DataID, FName SoundID, const bool SetVolume = false, float Volume = 1.f, bool IsSpecifyLocation = false, FVector place = FVector::ZeroVector) override;
+
     /*
     * カラーに応じてBPMを変更
     * @param Mode 使用されるカラーターゲットタイプ
@@ -72,11 +151,50 @@ public:
     UPROPERTY(BlueprintAssignable, Category = "Beat")
     FOnBeatDetected OnBeatDetected;
 
+    /* Beatマーカーの確定イベント（マーカーを受けた次のフレームに通知） */
+    UPROPERTY(BlueprintAssignable, Category = "Beat")
+    FOnConfirmedBeat OnConfirmedBeat;
+
+    /* BGMのオンセット検出イベント（bAnalyzeBGMOnsets が有効な場合、検出した次のフレームに通知） */
+    UPROPERTY(BlueprintAssignable, Category = "Beat")
+    FOnBGMOnset OnBGMOnset;
+
     /*
-    * FMODのMarkerでBeatを検知したとき呼ばれる
+    * FMODのMarkerでBeatを検知したとき呼ばれる（FMODのスレッドから呼ばれるため、キューに積むだけ）
     * @param MarkerPositionMs Marker位置（ミリ秒）
     */
-    void OnMarkerBeat(int64 MarkerPositionMs);
+    void EnqueueBeatMarker(int32 MarkerPositionMs);
+
+    /* 拍の中の位置（0～1、拍の頭で0。BGM再生前は0） */
+    UFUNCTION(BlueprintPure, Category = "Beat")
+    float GetBeatPhase() const;
+
+    /* 次の拍までの時間（秒） */
+    UFUNCTION(BlueprintPure, Category = "Beat")
+    float GetTimeToNextBeat() const;
+
+    /* BGM開始からの拍の番号 */
+    UFUNCTION(BlueprintPure, Category = "Beat")
+    int32 GetBeatIndex() const;
+
+    /* 1拍の長さ（秒） */
+    UFUNCTION(BlueprintPure, Category = "Beat")
+    float GetBeatInterval() const { return static_cast<float>(BeatClock.GetBeatInterval()); }
+
+    /* ビート時計（UBeatDispatcherSubsystem などC++側から拍の位置を読むため） */
+    const Beat::FBeatClock& GetBeatClock() const { return BeatClock; }
+
+    /*
+    * 毎フレーム、FMODから受けたマーカーを取り出してBeatを通知
+    * @param DeltaTime 経過時間
+    * @param TickType Tickの種類
+    * @param ThisTickFunction Tick関数
+    */
+    virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+protected:
+    /* BGMのコールバックを外す（破棄後にFMODのスレッドから触られないように） */
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 private:
 
@@ -91,19 +209,6 @@ private:
     UFUNCTION(BlueprintCallable)
     void SetVolume(float NewBGM, float NewSE);
 
-    /*
-    * 指定したサウンドを再生
-    * @param DataID "BGM"や"SE"などサウンド種別
-    * @param SoundID サウンドの識別子
-    * @param SetVolume 音量を固定値で設定するか
-    * @param Volume 音量倍率
-    * @param IsSpecifyLocation 位置指定で再生するか
-    * @param place 位置
-    * @return 成功したか
-    */
-    UFUNCTION(BlueprintCallable)
-    bool PlaySound(FName DataID, FName SoundID, const bool SetVolume = false, float Volume = 1.f, bool IsSpecifyLocation = false, FVector place = FVector::ZeroVector) override;
-
     /* BGM音量を設定 */
     UFUNCTION(BlueprintCallable)
     void SetBGMVolume(float Volume) override;
@@ -126,14 +231,6 @@ private:
     /* サウンドをフェードインして再生 */
     void PlaySoundWithFadeIn(FName DataID, FName SoundID, float Volume, float FadeDuration) override;
 
-    /*
-    * Envelope値を受け取るコールバック
-    * @param SoundWave 対象のSoundWave
-    * @param EnvelopeValue エンベロープ値
-    */
-    UFUNCTION()
-    void OnEnvelopeValue(const USoundWave* SoundWave, const float EnvelopeValue);
-
     /* BGM再生 */
     bool PlayBGM();
 
@@ -144,11 +241,68 @@ private:
     /* テスト用BGM初期化 */
     void InitTestSound();
 
+    /*
+    * ゲームスレッドでBeatマーカーを処理
+    * @param Marker 受けたマーカー
+    */
+    void OnMarkerBeat(const FBeatMarkerEvent& Marker);
+
+    /*
+    * ゲームスレッドでBGMのオンセットを処理
+    * 予測した拍に近いオンセットだけで時計を補正する（裏拍などで時計がずれないように）
+    * @param Onset 検出したオンセット
+    */
+    void OnBGMOnsetDetected(const FBGMOnsetEvent& Onset);
+
+    /*
+    * ビートマップ使用時、再生中のBGMのタイムラインの位置にビート時計を合わせる
+    * 時計は PlayBGM を呼んだ時刻で開始するため、実際に鳴り始めるまでの遅れとその後のずれをここで補正する
+    */
+    void SyncBeatClockToTimeline();
+
+    /*
+    * 鳴らす AudioComponent を選ぶ
+    * 1. 種別の同時発音数に達していれば、その種別で最も古い音
+    * 2. 空いている AudioComponent
+    * 3. プールに空きがあれば新しく作成
+    * 4. それも無ければ全体で最も古い音
+    * @param Category 鳴らす種別の番号
+    * @return VoiceComponents の番号（選べない場合は INDEX_NONE）
+    */
+    int32 AcquireVoice(int32 Category);
+
+    /*
+    * 鳴らす AudioComponent を選び、サウンド・音量・位置を設定する（再生はしない）
+    * @param Handle 鳴らすサウンド
+    * @param Volume 音量倍率
+    * @param IsSpecifyLocation 位置指定で再生するか
+    * @param place 位置
+    * @return 準備した AudioComponent（鳴らせない場合は nullptr）
+    */
+    UAudioComponent* PrepareVoice(FSoundHandle Handle, float Volume, bool IsSpecifyLocation, const FVector& place);
+
 private:
     /* サウンドデータを保持するマップ（DataID -> FSoundData） */
     UPROPERTY(EditAnywhere, Category = "Sound")
     TMap<FName, FSoundData> SoundDataMap;
 
+    /* 全体で同時に鳴らせる数（AudioComponentの最大数） */
+    UPROPERTY(EditAnywhere, Category = "Sound", meta = (ClampMin = "1"))
+    int32 VoicePoolSize = 16;
+
+    /* 登録されたサウンド（FSoundHandle の番号で引く） */
+    TArray<FSoundEntry> SoundEntries;
+
+    /* 種別ごとの同時発音数 */
+    TArray<FSoundCategory> SoundCategories;
+
+    /* 再生用AudioComponent（必要になった時に VoicePoolSize まで作成） */
+    UPROPERTY(Transient)
+    TArray<TObjectPtr<UAudioComponent>> VoiceComponents;
+
+    /* 再生用AudioComponentの状態 */
+    TArray<FSoundVoice> Voices;
+
     /* 現在再生中のBGM */
     UPROPERTY()
     UFMODAudioComponent* CurrentBGMComponent;
@@ -167,6 +321,22 @@ private:
     UPROPERTY(EditAnywhere, Category = "FMOD")
     UFMODEvent* BGMEventAsset;
 
+    /* 拍の位相を書き込むマテリアルパラメータコレクション（"BeatPhase" と "BeatInterval" を使う） */
+    UPROPERTY(EditAnywhere, Category = "BPM")
+    UMaterialParameterCollection* BeatParameterCollection = nullptr;
+
+    /* 事前に解析した拍の時刻（設定されていればFMODのマーカーの代わりに使う） */
+    UPROPERTY(EditAnywhere, Category = "BPM")
+    UBeatMapAsset* BeatMap = nullptr;
+
+    /* 再生中のBGMの音声からオンセットを検出して拍を補正するか（マーカーの無い曲用） */
+    UPROPERTY(EditAnywhere, Category = "BPM")
+    bool bAnalyzeBGMOnsets = false;
+
+    /* オンセットで時計を補正する、予測した拍からの範囲（拍に対する比） */
+    UPROPERTY(EditAnywhere, Category = "BPM", meta = (ClampMin = "0.0", ClampMax = "0.5", EditCondition = "bAnalyzeBGMOnsets"))
+    float OnsetBeatWindow = 0.15f;
+
     /* 曲のBPM */
     UPROPERTY(EditAnywhere, Category = "BPM")
     float MusicBPM = 166.0f;
@@ -174,21 +344,20 @@ private:
     /* Beat判定用タイマー */
     FTimerHandle BeatTimerHandle;
 
-    /* Beat間隔（秒） */
-    float BeatInterval = 0.5f;
+    /* BPMから次のBeatを予測し、マーカーで補正する時計 */
+    Beat::FBeatClock BeatClock;
 
-    /* 再生開始時間 */
-    float StartTime = 0.0f;
+    /* FMODのスレッド -> ゲームスレッドへ渡すマーカー（単一生産者・単一消費者） */
+    TCircularQueue<FBeatMarkerEvent> BeatMarkerQueue;
 
-    /* 最後に予測したBeat番号 */
-    int32 LastPredictedBeat = -1;
+    /* BGMの音声のオンセット検出（bAnalyzeBGMOnsets が有効な場合、PlayBGMで作成） */
+    TUniquePtr<FBGMOnsetAnalyzer> OnsetAnalyzer;
 
-    /* 最後に確定したBeat時間 */
-    float LastConfirmedBeatTime = 0.0f;
+    /* 最後にOnBeatDetectedを通知したBeat番号 */
+    int64 LastPredictedBeat = -1;
 
-    /* Beat確定時の通知イベント */
-    UPROPERTY(BlueprintAssignable)
-    FOnConfirmedBeat OnConfirmedBeat;
+    /* 最後に確定したBeatのタイムライン位置（秒） */
+    float LastConfirmedBeatTime = 0.0f;
 
     /* FMOD AudioComponent */
     UPROPERTY()
@@ -3,7 +3,7 @@
 
 #include "Objects/Color/ColorReactiveSwitch.h"
 #include "Components/Color/ColorConfigurator.h"
-#include "Manager/LevelManager.h"
+#include "Manager/GameServicesSubsystem.h"
 #include "Manager/ColorManager.h"
 #include "Components/Color/ColorReactiveComponent.h"
 #include "Components/BoxComponent.h"
@@ -21,9 +21,11 @@ void AColorReactiveSwitch::Init()
 {
     AColorReactiveObject::Init();
 
-    SecondColor = ALevelManager::GetInstance(GetWorld())
-        ->GetColorManager()
-        ->GetEffectColor(Second);
+    const UGameServicesSubsystem* Services = UGameServicesSubsystem::Get(this);
+    if (const UColorManager* ColorManager = Services ? Services->GetColorManager() : nullptr)
+    {
+        SecondColor = ColorManager->GetEffectColor(Second);
+    }
 }
 
 // 1. ColorConfiguratorの有効性を確認
@@ -45,13 +47,12 @@ void AColorReactiveSwitch::ColorAction(const FLinearColor InColor, FEffectMatchR
     {
         ColorConfigurator->ApplyColorToMaterial(InColor);
 
-        ALevelManager* LevelManager = ALevelManager::GetInstance(GetWorld());
-        if (LevelManager == nullptr)
-            return;
-        if (LevelManager->GetColorManager() == nullptr)
+        const UGameServicesSubsystem* Services = UGameServicesSubsystem::Get(this);
+        UColorManager* ColorManager = Services ? Services->GetColorManager() : nullptr;
+        if (ColorManager == nullptr)
             return;
 
-        LevelManager->GetColorManager()->ColorEvent(
+        ColorManager->ColorEvent(
             ColorConfigurator->GetColorEventID(),
             InColor
         );
@@ -60,13 +61,12 @@ void AColorReactiveSwitch::ColorAction(const FLinearColor InColor, FEffectMatchR
     {
         ColorConfigurator->ApplyColorToMaterial(InColor);
 
-        ALevelManager* LevelManager = ALevelManager::GetInstance(GetWorld());
-        if (LevelManager == nullptr)
-            return;
-        if (LevelManager->GetColorManager() == nullptr)
+        const UGameServicesSubsystem* Services = UGameServicesSubsystem::Get(this);
+        UColorManager* ColorManager = Services ? Services->GetColorManager() : nullptr;
+        if (ColorManager == nullptr)
             return;
 
-        LevelManager->GetColorManager()->ColorEvent(
+        ColorManager->ColorEvent(
             ColorConfigurator->GetColorEventID(),
             InColor
         );
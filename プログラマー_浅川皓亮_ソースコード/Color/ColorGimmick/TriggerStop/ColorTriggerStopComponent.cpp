@@ -6,6 +6,7 @@
 #include "Manager/LevelManager.h"
 #include "Manager/ColorManager.h"
 #include "Components/BoxComponent.h"
+#include "Manager/PhysicsBatchSubsystem.h"
 
 
 
@@ -20,9 +21,10 @@ UColorTriggerStopComponent::UColorTriggerStopComponent()
 // 4. PrimitiveComponentの場合、表示とコリジョンを無効化
 // 5. アクティブなコンポーネントを非アクティブ化
 // 6. Tickを無効化
-// 7. 出現エフェクトを再生
-// 8. エフェクトを有効化
-// 9. bIsHiddenをtrueに設定して返す
+// 7. 消した範囲の上で眠っている物理ボディを起こす
+// 8. 出現エフェクトを再生
+// 9. エフェクトを有効化
+// 10. bIsHiddenをtrueに設定して返す
 bool UColorTriggerStopComponent::OnColorMatched(const FLinearColor& FilterColor)
 {
 	if (bIsHidden) return false;
@@ -30,6 +32,8 @@ bool UColorTriggerStopComponent::OnColorMatched(const FLinearColor& FilterColor)
 	AActor* Owner = GetOwner();
 	if (!Owner) return false;
 
+	FBox HiddenBounds(ForceInit);
+
 	for (UActorComponent* Component : Owner->GetComponents())
 	{
 		if (Component->ComponentHasTag("HideTarget"))
@@ -38,6 +42,7 @@ bool UColorTriggerStopComponent::OnColorMatched(const FLinearColor& FilterColor)
 			{
 				Primitive->SetVisibility(false, false);
 				Primitive->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+				HiddenBounds += Primitive->Bounds.GetBox();
 			}
 
 			if (Component->IsActive())
@@ -49,6 +54,12 @@ bool UColorTriggerStopComponent::OnColorMatched(const FLinearColor& FilterColor)
 		}
 	}
 
+	// 足場が消えると眠っているボディは落下しないため、ここで起こす
+	if (UPhysicsBatchSubsystem* Physics = GetWorld() ? GetWorld()->GetSubsystem<UPhysicsBatchSubsystem>() : nullptr)
+	{
+		Physics->WakeBodiesInBox(HiddenBounds);
+	}
+
 	PlayAppearEffect();
 	ActiveEffect(true);
 	bIsHidden = true;
@@ -1,10 +1,9 @@
 #include "Components/Color/ColorConfigurator.h"
 #include "Components/Color/ColorReactiveComponent.h"
 #include "Interface/ColorFilterInterface.h"
-#include "Manager/LevelManager.h"
+#include "Manager/GameServicesSubsystem.h"
 #include "Manager/ColorManager.h"
 #include "Sound/SoundManager.h"
-#include "FunctionLibrary.h"
 
 
 UColorConfigurator::UColorConfigurator()
@@ -43,6 +42,15 @@ void UColorConfigurator::InitializeColorLogic()
 	ColorReactiveComponent->Init(bColorVariable);
 }
 
+// 処理の流れ:
+// 1. ColorManagerから登録を解除
+// 2. 親クラスのEndPlayを呼び出し
+void UColorConfigurator::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	UnregisterFromColorManager();
+	Super::EndPlay(EndPlayReason);
+}
+
 // 処理の流れ:
 // 1. ColorManagerの取得
 // 2. ColorTargetTypeとOwnerを使って登録
@@ -54,18 +62,30 @@ void UColorConfigurator::RegisterToColorManager()
 	}
 }
 
+// 処理の流れ:
+// 1. ColorManagerの取得
+// 2. 登録時と同じColorTargetTypeとOwnerで解除
+void UColorConfigurator::UnregisterFromColorManager()
+{
+	if (UColorManager* ColorManager = GetColorManager())
+	{
+		ColorManager->UnregisterTarget(ColorTargetType, GetOwner());
+	}
+}
+
 // 処理の流れ:
 // 1. bSetColorフラグの確認
-// 2. LevelManagerからエフェクト色を取得してStartColorに設定
+// 2. ColorManagerからエフェクト色を取得してStartColorに設定
 // 3. SkeletalMeshの取得
 // 4. カスタムデプスの設定
 // 5. マテリアルインスタンスの作成と色の適用
 void UColorConfigurator::SetupMaterial()
 {
 	if (!bSetColor) return;
-	StartColor = ALevelManager::GetInstance(GetWorld())
-		->GetColorManager()
-		->GetEffectColor(Effect);
+	if (const UColorManager* ColorManager = GetColorManager())
+	{
+		StartColor = ColorManager->GetEffectColor(Effect);
+	}
 	if (USkeletalMeshComponent* Mesh = GetStaticMesh())
 	{
 		Mesh->SetRenderCustomDepth(true);
@@ -204,16 +224,17 @@ void UColorConfigurator::ApplyColorToMaterial(FLinearColor InColor)
 
 USkeletalMeshComponent* UColorConfigurator::GetStaticMesh() const
 {
-	return UFunctionLibrary::FindComponentByName<USkeletalMeshComponent>(GetOwner(), TEXT("Mesh"));
+	return CachedMesh.Get(GetOwner());
 }
 
 ALevelManager* UColorConfigurator::GetLevelManager() const
 {
-	return ALevelManager::GetInstance(GetWorld());
+	const UGameServicesSubsystem* Services = UGameServicesSubsystem::Get(this);
+	return Services ? Services->GetLevelManager() : nullptr;
 }
 
 UColorManager* UColorConfigurator::GetColorManager() const
 {
-	const ALevelManager* LevelManager = GetLevelManager();
-	return LevelManager ? LevelManager->GetColorManager() : nullptr;
+	const UGameServicesSubsystem* Services = UGameServicesSubsystem::Get(this);
+	return Services ? Services->GetColorManager() : nullptr;
 }
\ No newline at end of file
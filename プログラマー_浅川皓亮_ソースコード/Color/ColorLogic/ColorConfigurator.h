@@ -3,6 +3,7 @@
 #include "CoreMinimal.h"
 #include "Components/ActorComponent.h"
 #include "DataContainer/EffectMatchResult.h"
+#include "Components/ComponentCache.h"
 #include "ColorConfigurator.generated.h"
 
 class ALevelManager;
@@ -10,6 +11,7 @@ class ANiagaraActor;
 class UBeatScalerComponent;
 class UColorReactiveComponent;
 class UColorManager;
+class USkeletalMeshComponent;
 
 
 
@@ -24,6 +26,15 @@ class PACHIO_API UColorConfigurator : public UActorComponent
 public:
 	UColorConfigurator();
 
+protected:
+	/**
+	 * オーナーの破棄やレベルのアンロード時にColorManagerから登録を解除する
+	 * @param EndPlayReason 終了理由
+	 */
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+public:
+
 	// =======================
 	// 初期化処理
 	// =======================
@@ -46,6 +57,12 @@ public:
 	 */
 	virtual void RegisterToColorManager();
 
+	/**
+	 * ColorManagerからの登録解除
+	 * 破棄された後に色の通知が届かないようにする
+	 */
+	virtual void UnregisterFromColorManager();
+
 	/**
 	 * マテリアルの設定
 	 * 初期色の設定とカスタムデプスの有効化
@@ -272,4 +289,7 @@ private:
 
 	UPROPERTY(EditAnywhere)
 	bool bIsPlayBeat = true;
+
+	// オーナーの "Mesh" コンポーネント（GetStaticMesh 用）
+	mutable TCachedComponent<USkeletalMeshComponent> CachedMesh { TEXT("Mesh") };
 };
\ No newline at end of file
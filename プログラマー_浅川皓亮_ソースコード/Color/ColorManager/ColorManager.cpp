@@ -1,6 +1,6 @@
 #include "Manager/ColorManager.h"
 #include "Materials/MaterialInstanceDynamic.h"
-#include "Manager/LevelManager.h"
+#include "Manager/GameServicesSubsystem.h"
 #include "UI/UIManager.h"
 #include "UI/ColorLens.h"
 #include "Kismet/GameplayStatics.h"
@@ -82,6 +82,16 @@ void UColorManager::RegisterTarget(EColorTargetType Mode, TScriptInterface<IColo
     ColorTargetRegistry->RegisterTarget(Mode, Target);
 }
 
+// 1. 自身とColorTargetRegistryの有効性を確認
+// 2. ターゲットをColorTargetRegistryから解除
+void UColorManager::UnregisterTarget(EColorTargetType Mode, TScriptInterface<IColorReactiveInterface> Target)
+{
+    if (!this || !ColorTargetRegistry)
+        return;
+
+    ColorTargetRegistry->UnregisterTarget(Mode, Target);
+}
+
 // 1. 指定された色とワールド色の色相角度距離を計算
 // 2. EffectColorMatcherに距離計算を委譲
 float UColorManager::GetColorDistanceRGB(const FLinearColor& ColorA)
@@ -143,7 +153,7 @@ FLinearColor UColorManager::GetEffectColor(EBuffEffect Effect) const
 // 1. プレイヤーPawnを取得
 // 2. ColorControllerComponentを検索
 // 3. OnColorChangedデリゲートにApplyColorをバインド
-// 4. LevelManagerからUIManagerを取得
+// 4. GameServicesからUIManagerを取得
 // 5. ColorLensのAnimationDelegateにアニメーション関数をバインド
 void UColorManager::BindController()
 {
@@ -160,16 +170,15 @@ void UColorManager::BindController()
         ColorController->OnColorChanged.AddDynamic(this, &UColorManager::ApplyColor);
     }
 
-    ALevelManager* LevelManager = ALevelManager::GetInstance(GetWorld());
-    if (LevelManager == nullptr)
-        return;
-    if (LevelManager->GetUIManager() == nullptr)
+    const UGameServicesSubsystem* Services = UGameServicesSubsystem::Get(this);
+    UUIManager* UIManager = Services ? Services->GetUIManager() : nullptr;
+    if (UIManager == nullptr)
         return;
-    if (LevelManager->GetUIManager()->GetColorLens() == nullptr)
+    if (UIManager->GetColorLens() == nullptr)
         return;
 
     ColorController->AnimationDelegate.BindUObject(
-        LevelManager->GetUIManager()->GetColorLens(),
+        UIManager->GetColorLens(),
         &UColorLens::Animation
     );
 }
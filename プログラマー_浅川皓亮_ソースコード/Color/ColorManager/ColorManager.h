@@ -61,6 +61,13 @@ public:
      */
     void RegisterTarget(EColorTargetType Mode, TScriptInterface<IColorReactiveInterface> Target);
 
+    /**
+     * 登録済みのターゲットを解除する
+     * @param Mode 登録したときのターゲットのタイプ
+     * @param Target 解除するターゲットオブジェクト
+     */
+    void UnregisterTarget(EColorTargetType Mode, TScriptInterface<IColorReactiveInterface> Target);
+
     /**
      * 2色間の色相角度距離を計算する(ワールド色との比較)
      * @param ColorA 比較する色
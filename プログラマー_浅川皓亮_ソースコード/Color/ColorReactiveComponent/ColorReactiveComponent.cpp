@@ -6,9 +6,11 @@
 #include "NiagaraComponent.h"
 #include "NiagaraFunctionLibrary.h"
 #include "NiagaraSystem.h"
-#include "Manager/LevelManager.h"
+#include "Manager/GameServicesSubsystem.h"
 #include "Manager/ColorManager.h"
-#include "FunctionLibrary.h"
+#include "Manager/GridActivationSubsystem.h"
+#include "Manager/PhysicsBatchSubsystem.h"
+#include "Logic/ColorManager/ColorKernels.h"
 
 
 // 処理の流れ:
@@ -54,8 +56,7 @@ void UColorReactiveComponent::Init(bool bIsColorVariable)
 	if (!Owner)
 		return;
 
-	USkeletalMeshComponent* MeshComp =
-		UFunctionLibrary::FindComponentByName<USkeletalMeshComponent>(Owner, TEXT("Mesh"));
+	USkeletalMeshComponent* MeshComp = CachedMesh.Get(Owner);
 	if (!MeshComp)
 		return;
 
@@ -63,9 +64,11 @@ void UColorReactiveComponent::Init(bool bIsColorVariable)
 	if (!DynMesh)
 		return;
 
-	CurrentColor = ALevelManager::GetInstance(GetWorld())
-		->GetColorManager()
-		->GetEffectColor(Effect);
+	const UGameServicesSubsystem* Services = UGameServicesSubsystem::Get(this);
+	if (const UColorManager* ColorManager = Services ? Services->GetColorManager() : nullptr)
+	{
+		CurrentColor = ColorManager->GetEffectColor(Effect);
+	}
 
 	if (!bIsColorVariable)
 	{
@@ -96,9 +99,12 @@ bool UColorReactiveComponent::CheckColorMatch(FEffectMatchResult MatchResult, co
 		UE_LOG(LogTemp, Log, TEXT("CheckColor: %s"), *CheckColor.ToString());
 	}
 
-	float Distance = ALevelManager::GetInstance(GetWorld())
-		->GetColorManager()
-		->GetColorDistanceRGB(CurrentColor, FilterColor);
+	const UGameServicesSubsystem* Services = UGameServicesSubsystem::Get(this);
+	UColorManager* ColorManager = Services ? Services->GetColorManager() : nullptr;
+	if (!ColorManager)
+		return false;
+
+	float Distance = ColorManager->GetColorDistanceRGB(CurrentColor, FilterColor);
 
 	bool bMatch;
 	if (Distance <= 30.0f)
@@ -113,112 +119,12 @@ bool UColorReactiveComponent::CheckColorMatch(FEffectMatchResult MatchResult, co
 }
 
 // 処理の流れ:
-// 1. RGBの各成分の差分を計算
-// 2. Max/Minを求めてDeltaを計算
-// 3. 輝度(L)を計算
-// 4. Deltaが0の場合、無彩色として処理
-// 5. それ以外の場合、彩度(S)と色相(H)を計算
-FHSLColor RGBToHSL(const FLinearColor& Color)
-{
-	float R = Color.R;
-	float G = Color.G;
-	float B = Color.B;
-
-	float Max = FMath::Max3(R, G, B);
-	float Min = FMath::Min3(R, G, B);
-	float Delta = Max - Min;
-
-	FHSLColor HSL;
-	HSL.L = (Max + Min) / 2.0f;
-
-	if (Delta == 0)
-	{
-		HSL.H = 0.0f;
-		HSL.S = 0.0f;
-	}
-	else
-	{
-		HSL.S = (HSL.L < 0.5f) ? (Delta / (Max + Min)) : (Delta / (2.0f - Max - Min));
-
-		if (Max == R)
-			HSL.H = (G - B) / Delta + (G < B ? 6.0f : 0.0f);
-		else if (Max == G)
-			HSL.H = (B - R) / Delta + 2.0f;
-		else
-			HSL.H = (R - G) / Delta + 4.0f;
-
-		HSL.H /= 6.0f;
-	}
-	return HSL;
-}
-
-// 処理の流れ:
-// 1. 彩度(S)が0の場合、無彩色として処理
-// 2. それ以外の場合、HueToRGBラムダ関数を使ってRGB変換
-// 3. FLinearColorを返す
-FLinearColor HSLToRGB(const FHSLColor& HSL)
-{
-	float R, G, B;
-
-	if (HSL.S == 0)
-	{
-		R = G = B = HSL.L;
-	}
-	else
-	{
-		auto HueToRGB = [](float p, float q, float t) -> float
-			{
-				if (t < 0.0f) t += 1.0f;
-				if (t > 1.0f) t -= 1.0f;
-				if (t < 1.0f / 6.0f) return p + (q - p) * 6.0f * t;
-				if (t < 1.0f / 2.0f) return q;
-				if (t < 2.0f / 3.0f) return p + (q - p) * (2.0f / 3.0f - t) * 6.0f;
-				return p;
-			};
-
-		float q = (HSL.L < 0.5f) ? (HSL.L * (1 + HSL.S)) : (HSL.L + HSL.S - HSL.L * HSL.S);
-		float p = 2 * HSL.L - q;
-
-		R = HueToRGB(p, q, HSL.H + 1.0f / 3.0f);
-		G = HueToRGB(p, q, HSL.H);
-		B = HueToRGB(p, q, HSL.H - 1.0f / 3.0f);
-	}
-
-	return FLinearColor(R, G, B, 1.0f);
-}
-
-// 処理の流れ:
-// 1. RGB→HSLに変換
-// 2. 色相を180度反転（補色化）
-// 3. 彩度を0.3fに設定（パステル調）
-// 4. 輝度を0.8~1.0の範囲にクランプ
-// 5. HSL→RGBに変換
-// 6. 最大成分を1.0に強制
-// 7. 他の成分を0.8~1.0にクランプ
+// 1. 補色の計算は ColorKernels に任せる（色相を反転し、パステル調に調整）
+// 2. アルファを1にして返す
 FLinearColor UColorReactiveComponent::GetComplementaryColor(const FLinearColor& InColor)
 {
-	FHSLColor HSL = RGBToHSL(InColor);
-
-	HSL.H += 0.5f;
-	if (HSL.H > 1.0f) HSL.H -= 1.0f;
-
-	HSL.S = 0.3f;
-	HSL.L = FMath::Clamp(HSL.L, 0.8f, 1.0f);
-
-	FLinearColor Complementary = HSLToRGB(HSL);
-
-	float MaxComponent = FMath::Max3(Complementary.R, Complementary.G, Complementary.B);
-
-	if (Complementary.R == MaxComponent) Complementary.R = 1.0f;
-	if (Complementary.G == MaxComponent) Complementary.G = 1.0f;
-	if (Complementary.B == MaxComponent) Complementary.B = 1.0f;
-
-	if (Complementary.R != 1.0f) Complementary.R = FMath::Clamp(Complementary.R, 0.8f, 1.0f);
-	if (Complementary.G != 1.0f) Complementary.G = FMath::Clamp(Complementary.G, 0.8f, 1.0f);
-	if (Complementary.B != 1.0f) Complementary.B = FMath::Clamp(Complementary.B, 0.8f, 1.0f);
-
-	Complementary.A = 1.0f;
-	return Complementary;
+	const ColorKernels::FRgb Complementary = ColorKernels::ComplementaryColor(ColorKernels::FRgb(InColor.R, InColor.G, InColor.B));
+	return FLinearColor(Complementary.R, Complementary.G, Complementary.B, 1.0f);
 }
 
 // 処理の流れ:
@@ -239,28 +145,42 @@ void UColorReactiveComponent::SetSelectMode(bool bIsNowSelected)
 
 // 処理の流れ:
 // 1. 全てのNiagaraアクターをループ
-// 2. 各Niagaraの表示/非表示、コリジョン、Tickを設定
+// 2. 各Niagaraの表示/非表示、Tickを設定（Tickは部屋の有効・無効を管理する GridActivation を通す）
+// 3. コリジョンを切り替え、上に乗っているボディを起こす
 void UColorReactiveComponent::ActiveEffect(bool bActivate)
 {
+	UGridActivationSubsystem* Grid = GetWorld() ? GetWorld()->GetSubsystem<UGridActivationSubsystem>() : nullptr;
+
 	for (ANiagaraActor* Niagara : Niagaras)
 	{
 		if (!Niagara) continue;
 
 		Niagara->SetActorHiddenInGame(bActivate);
-		Niagara->SetActorEnableCollision(bActivate);
-		Niagara->SetActorTickEnabled(bActivate);
+		if (Grid)
+		{
+			Grid->SetGimmickTickEnabled(Niagara, bActivate);
+		}
+		else
+		{
+			Niagara->SetActorTickEnabled(bActivate);
+		}
 	}
+
+	SetNiagaraCollisionEnabled(bActivate);
 }
 
 // 処理の流れ:
 // 1. Ownerの存在確認
 // 2. 全てのNiagaraアクターをループ
-// 3. 各Niagaraアクターとコンポーネントの表示状態を設定
+// 3. 各Niagaraアクターとコンポーネントの表示状態を設定（一時停止は GridActivation を通す）
+// 4. コリジョンを切り替え、上に乗っているボディを起こす
 void UColorReactiveComponent::ToggleNiagaraActiveState(bool bVisible)
 {
 	if (GetOwner() == nullptr)
 		return;
 
+	UGridActivationSubsystem* Grid = GetWorld() ? GetWorld()->GetSubsystem<UGridActivationSubsystem>() : nullptr;
+
 	TArray<ANiagaraActor*> NiagaraComponents = Niagaras;
 
 	for (ANiagaraActor* NiagaraActor : NiagaraComponents)
@@ -269,12 +189,57 @@ void UColorReactiveComponent::ToggleNiagaraActiveState(bool bVisible)
 			continue;
 
 		NiagaraActor->SetActorHiddenInGame(!bVisible);
-		NiagaraActor->SetActorEnableCollision(bVisible);
 
 		UNiagaraComponent* NiagaraComp = NiagaraActor->GetNiagaraComponent();
 
 		NiagaraComp->SetVisibility(bVisible, true);
-		NiagaraComp->SetPaused(!bVisible);
+		if (Grid)
+		{
+			Grid->SetGimmickNiagaraPaused(NiagaraComp, !bVisible);
+		}
+		else
+		{
+			NiagaraComp->SetPaused(!bVisible);
+		}
+	}
+
+	SetNiagaraCollisionEnabled(bVisible);
+}
+
+// 処理の流れ:
+// 1. Niagaraアクターのコリジョンを切り替える（無効な部屋では GridActivation が有効化の時まで保留する）
+// 2. 実際にコリジョンが変わったアクターの範囲をまとめる
+// 3. まとめた範囲で眠っているボディを起こす（コリジョンが現れた場合も、重なったボディを押し出せるよう起こす）
+void UColorReactiveComponent::SetNiagaraCollisionEnabled(bool bEnable)
+{
+	UGridActivationSubsystem* Grid = GetWorld() ? GetWorld()->GetSubsystem<UGridActivationSubsystem>() : nullptr;
+	FBox ChangedBounds(ForceInit);
+
+	for (ANiagaraActor* NiagaraActor : Niagaras)
+	{
+		if (!NiagaraActor)
+			continue;
+
+		bool bChanged = false;
+		if (Grid)
+		{
+			bChanged = Grid->SetGimmickCollisionEnabled(NiagaraActor, bEnable);
+		}
+		else if (NiagaraActor->GetActorEnableCollision() != bEnable)
+		{
+			NiagaraActor->SetActorEnableCollision(bEnable);
+			bChanged = true;
+		}
+
+		if (bChanged)
+		{
+			ChangedBounds += NiagaraActor->GetComponentsBoundingBox(true);
+		}
+	}
+
+	if (UPhysicsBatchSubsystem* Physics = GetWorld() ? GetWorld()->GetSubsystem<UPhysicsBatchSubsystem>() : nullptr)
+	{
+		Physics->WakeBodiesInBox(ChangedBounds);
 	}
 }
 
@@ -289,7 +254,7 @@ void UColorReactiveComponent::ApplyColorToMaterial(FLinearColor InColor)
 	if (!Owner)
 		return;
 
-	USkeletalMeshComponent* Mesh = UFunctionLibrary::FindComponentByName<USkeletalMeshComponent>(Owner, TEXT("Mesh"));
+	USkeletalMeshComponent* Mesh = CachedMesh.Get(Owner);
 	if (!Mesh) return;
 
 	UMaterialInstanceDynamic* DynMaterial = Mesh->CreateAndSetMaterialInstanceDynamic(0);
@@ -298,34 +263,21 @@ void UColorReactiveComponent::ApplyColorToMaterial(FLinearColor InColor)
 	DynMaterial->SetVectorParameterValue(FName("BaseColor"), InColor);
 }
 
-// 処理の流れ:
-// 1. RGB各成分の差分を計算
-// 2. 輝度ベースの重み付き色差を計算（人間の目に近い）
-// 3. 色差が許容誤差以下かを判定
+// 現在の色とフィルター色を比較する（判定は下の2色版と同じ）
 bool UColorReactiveComponent::IsColorMatch(const FLinearColor& FilterColor, const float Tolerance) const
 {
-	float dR = CurrentColor.R - FilterColor.R;
-	float dG = CurrentColor.G - FilterColor.G;
-	float dB = CurrentColor.B - FilterColor.B;
-
-	float ColorDifference = 0.299f * dR * dR + 0.587f * dG * dG + 0.114f * dB * dB;
-
-	return ColorDifference <= Tolerance * Tolerance;
+	return IsColorMatch(FilterColor, CurrentColor, Tolerance);
 }
 
 // 処理の流れ:
-// 1. RGB各成分の差分を計算
-// 2. 輝度ベースの重み付き色差を計算（人間の目に近い）
-// 3. 色差が許容誤差以下かを判定
+// 1. 輝度ベースの重み付き色差を計算（人間の目に近い）
+// 2. 色差が許容誤差以下かを判定（計算は ColorKernels に任せる）
 bool UColorReactiveComponent::IsColorMatch(const FLinearColor& FilterColor, const FLinearColor& TargetColor, const float Tolerance) const
 {
-	float dR = TargetColor.R - FilterColor.R;
-	float dG = TargetColor.G - FilterColor.G;
-	float dB = TargetColor.B - FilterColor.B;
-
-	float ColorDifference = 0.299f * dR * dR + 0.587f * dG * dG + 0.114f * dB * dB;
-
-	return ColorDifference <= Tolerance * Tolerance;
+	return ColorKernels::IsColorMatch(
+		ColorKernels::FRgb(TargetColor.R, TargetColor.G, TargetColor.B),
+		ColorKernels::FRgb(FilterColor.R, FilterColor.G, FilterColor.B),
+		Tolerance);
 }
 
 void UColorReactiveComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
@@ -369,7 +321,7 @@ void UColorReactiveComponent::ActiveNiagaraEffect(UNiagaraSystem* NiagaraSystem)
 		return;
 	}
 
-	USkeletalMeshComponent* AttachComponent = UFunctionLibrary::FindComponentByName<USkeletalMeshComponent>(GetOwner(), TEXT("Mesh"));
+	USkeletalMeshComponent* AttachComponent = CachedMesh.Get(GetOwner());
 	if (!AttachComponent)
 	{
 		UE_LOG(LogTemp, Warning, TEXT("AttachComponent is null"));
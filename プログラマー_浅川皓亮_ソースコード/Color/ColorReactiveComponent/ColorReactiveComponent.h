@@ -5,22 +5,14 @@
 #include "CoreMinimal.h"
 #include "Components/ActorComponent.h"
 #include "DataContainer/EffectMatchResult.h"
+#include "Components/ComponentCache.h"
 #include "ColorReactiveComponent.generated.h"
 
 
 class ANiagaraActor;
 class UNiagaraSystem;
 class UNiagaraComponent;
-/**
- * HSL色空間の構造体
- */
-struct FHSLColor
-{
-	float H; // 色相 (0.0~1.0)
-	float S; // 彩度 (0.0~1.0)
-	float L; // 輝度 (0.0~1.0)
-};
-
+class USkeletalMeshComponent;
 /**
  * 色に反応して視覚効果を制御するコンポーネント
  * マテリアルの色変更、エフェクト再生、色の一致判定などを管理
@@ -143,6 +135,13 @@ protected:
 	 */
 	void DeactivateAllEffects();
 
+	/**
+	 * Niagaraアクターのコリジョンを切り替える（無効な部屋では有効化の時まで保留される）
+	 * 変わった範囲で眠っているボディを起こす（消えた足場の上で宙に浮いたままにしないため）
+	 * @param bEnable コリジョンを有効にするか
+	 */
+	void SetNiagaraCollisionEnabled(bool bEnable);
+
 private:
 	/**
 	 * 色が一致したときの処理
@@ -200,4 +199,7 @@ protected:
 
 	/** 非表示状態か */
 	bool bIsHidden = false;
+
+	/** オーナーの "Mesh" コンポーネント */
+	TCachedComponent<USkeletalMeshComponent> CachedMesh { TEXT("Mesh") };
 };
\ No newline at end of file
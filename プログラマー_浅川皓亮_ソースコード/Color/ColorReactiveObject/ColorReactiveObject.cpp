@@ -22,6 +22,14 @@ void AColorReactiveObject::BeginPlay()
     Init();
 }
 
+// 1. ColorManagerから登録を解除
+// 2. 親クラスのEndPlayを呼び出し
+void AColorReactiveObject::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    UnregisterFromColorManager();
+    Super::EndPlay(EndPlayReason);
+}
+
 // 派生クラスでオーバーライドして使用
 void AColorReactiveObject::Init()
 {
@@ -48,6 +56,16 @@ void AColorReactiveObject::RegisterToColorManager()
     ColorConfigurator->RegisterToColorManager();
 }
 
+// 1. ColorConfiguratorの有効性を確認
+// 2. ColorManagerから自身の登録を解除
+void AColorReactiveObject::UnregisterFromColorManager()
+{
+    if (ColorConfigurator == nullptr)
+        return;
+
+    ColorConfigurator->UnregisterFromColorManager();
+}
+
 // 1. ColorConfiguratorの有効性を確認
 // 2. マテリアルとカスタムデプスを設定
 void AColorReactiveObject::SetupMaterial()
@@ -26,6 +26,12 @@ public:
 protected:
 	virtual void BeginPlay() override;
 
+	/**
+	 * 破棄やレベルのアンロード時にColorManagerから登録を解除する
+	 * @param EndPlayReason 終了理由
+	 */
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 public:
 	/**
 	 * 色アクション実行時の処理
@@ -99,6 +105,11 @@ protected:
 	 */
 	virtual void RegisterToColorManager();
 
+	/**
+	 * ColorManagerからの登録解除
+	 */
+	virtual void UnregisterFromColorManager();
+
 	/**
 	 * マテリアルのセットアップ
 	 */
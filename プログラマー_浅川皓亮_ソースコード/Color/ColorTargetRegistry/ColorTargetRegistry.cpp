@@ -96,6 +96,25 @@ void UColorTargetRegistry::RegisterTarget(EColorTargetType Mode, TScriptInterfac
     }
 }
 
+// 1. 有効なターゲットか確認
+// 2. モードに対応する配列からターゲットを取り除く
+// 3. 選択中の色変更対象であれば参照を外す
+void UColorTargetRegistry::UnregisterTarget(EColorTargetType Mode, TScriptInterface<IColorReactiveInterface> Target)
+{
+    if (!Target)
+        return;
+
+    if (FColorTargetInstanceArray* TargetArray = ColorResponseTargets.Find(Mode))
+    {
+        TargetArray->Instances.Remove(Target);
+    }
+
+    if (TargetObject.GetObject() == Target.GetObject())
+    {
+        TargetObject = nullptr;
+    }
+}
+
 // 1. 指定モードのターゲット配列を検索
 // 2. 配列内の各ターゲットに対してColorActionを呼び出し
 void UColorTargetRegistry::NotifyTargets(EColorTargetType Mode, const FLinearColor& Color, FEffectMatchResult Effect)
@@ -147,4 +166,15 @@ FLinearColor UColorTargetRegistry::GetPostProcessColor() const
     }
 
     return FLinearColor::Black;
+}
+
+// 各モードの配列の要素数を合計
+int32 UColorTargetRegistry::GetNumTargets() const
+{
+    int32 NumTargets = 0;
+    for (const TPair<EColorTargetType, FColorTargetInstanceArray>& Pair : ColorResponseTargets)
+    {
+        NumTargets += Pair.Value.Instances.Num();
+    }
+    return NumTargets;
 }
\ No newline at end of file
@@ -55,6 +55,14 @@ public:
 	 */
 	void RegisterTarget(EColorTargetType Mode, TScriptInterface<IColorReactiveInterface> Target);
 
+	/**
+	 * 登録済みのターゲットを解除する
+	 * 選択中の色変更対象であれば、その選択も解除する
+	 * @param Mode 登録したときのターゲットのタイプ
+	 * @param Target 解除するターゲットオブジェクト
+	 */
+	void UnregisterTarget(EColorTargetType Mode, TScriptInterface<IColorReactiveInterface> Target);
+
 	/**
 	 * ポストプロセスエフェクトを初期化する
 	 * ワールド内のPostProcessVolumeを検索してマテリアルを適用
@@ -67,6 +75,12 @@ public:
 	 */
 	FLinearColor GetPostProcessColor() const;
 
+	/**
+	 * 全モードに登録されているターゲットの数を取得する
+	 * @return 登録数
+	 */
+	int32 GetNumTargets() const;
+
 	// 色が適用された際に発火するデリゲート
 	UPROPERTY(BlueprintAssignable, Category = "Color")
 	FOnColorAppliedDelegate OnColorApplied;
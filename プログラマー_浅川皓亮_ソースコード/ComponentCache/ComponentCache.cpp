@@ -0,0 +1,6 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Components/ComponentCache.h"
+
+DEFINE_STAT(STAT_UncachedComponentLookups);
@@ -0,0 +1,103 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "Components/ActorComponent.h"
+
+// キャッシュを使わずに実際にコンポーネントを検索した回数（毎フレームリセット）
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Uncached Component Lookups"), STAT_UncachedComponentLookups, STATGROUP_Game, PACHIO_API);
+
+/**
+ * 所有Actorのコンポーネント参照を型付きで保持するキャッシュ
+ * 名前を指定した場合は名前で、指定しない場合はクラスで検索する
+ *
+ * 次の場合だけ検索し直し、それ以外は保持している参照をそのまま返す
+ * - まだ検索していない / Invalidate() が呼ばれた
+ * - 所有Actorが変わった
+ * - 保持しているコンポーネントが破棄された
+ * - 所有Actorのコンポーネント数が変わった（追加・削除）
+ */
+template<typename T>
+class TCachedComponent
+{
+public:
+	TCachedComponent() = default;
+
+	/** @param InName 検索するコンポーネント名 */
+	explicit TCachedComponent(FName InName) : Name(InName) {}
+
+	/**
+	 * コンポーネントを取得する
+	 * @param Owner 検索するActor
+	 * @return 見つかったコンポーネント（無い場合は nullptr）
+	 */
+	T* Get(const AActor* Owner)
+	{
+		if (Owner == nullptr)
+			return nullptr;
+
+		T* Cached = Component.Get();
+		const bool bStillValid = bResolved
+			&& CachedOwner == Owner
+			&& NumOwnerComponents == Owner->GetComponents().Num()
+			&& (Cached != nullptr || !bFound);
+		if (bStillValid)
+			return Cached;
+
+		return Resolve(Owner);
+	}
+
+	/** 次回の取得で検索し直す */
+	void Invalidate()
+	{
+		bResolved = false;
+	}
+
+private:
+	// 所有Actorから検索して保持する
+	T* Resolve(const AActor* Owner)
+	{
+		INC_DWORD_STAT(STAT_UncachedComponentLookups);
+
+		T* Found = nullptr;
+		if (Name.IsNone())
+		{
+			Found = Owner->FindComponentByClass<T>();
+		}
+		else
+		{
+			TInlineComponentArray<T*> Components(Owner);
+			for (T* Candidate : Components)
+			{
+				if (Candidate && Candidate->GetFName() == Name)
+				{
+					Found = Candidate;
+					break;
+				}
+			}
+		}
+
+		Component = Found;
+		CachedOwner = Owner;
+		NumOwnerComponents = Owner->GetComponents().Num();
+		bFound = Found != nullptr;
+		bResolved = true;
+		return Found;
+	}
+
+private:
+	// 検索するコンポーネント名（NAME_None ならクラスで検索）
+	FName Name = NAME_None;
+
+	// 見つかったコンポーネント
+	TWeakObjectPtr<T> Component;
+
+	// 検索した時の所有Actorとそのコンポーネント数（比較にのみ使う）
+	const AActor* CachedOwner = nullptr;
+	int32 NumOwnerComponents = 0;
+
+	bool bFound = false;
+	bool bResolved = false;
+};
@@ -0,0 +1,213 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Manager/BeatDispatcherSubsystem.h"
+#include "Manager/GameServicesSubsystem.h"
+#include "Sound/SoundManager.h"
+#include "Materials/MaterialParameterCollection.h"
+#include "Materials/MaterialParameterCollectionInstance.h"
+#include "Engine/World.h"
+
+// 1フレームで実際に OnBeat を呼んだリスナーの数（通知中に解除されたものは数えない）
+DECLARE_DWORD_COUNTER_STAT(TEXT("Beat Listeners Notified"), STAT_BeatListenersNotified, STATGROUP_Game);
+
+namespace
+{
+	// 位相オフセットを同じまとまりとみなす幅
+	static constexpr float PHASE_OFFSET_TOLERANCE = 1.e-3f;
+
+	// マテリアルパラメータコレクションのパラメータ名
+	static const FName BEAT_PHASE_PARAMETER(TEXT("BeatPhase"));
+	static const FName BEAT_INTERVAL_PARAMETER(TEXT("BeatInterval"));
+}
+
+void UBeatDispatcherSubsystem::Deinitialize()
+{
+	Groups.Reset();
+	PendingRegistrations.Reset();
+	ParameterCollection = nullptr;
+
+	Super::Deinitialize();
+}
+
+TStatId UBeatDispatcherSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UBeatDispatcherSubsystem, STATGROUP_Tickables);
+}
+
+// 処理の流れ:
+// 1. サウンドマネージャーのビート時計から現在の拍数を求める（BGM再生前は何もしない）
+// 2. BGMを最初から流し直していれば、各まとまりの番号を振り直す
+// 3. マテリアルパラメータコレクションへ位相を書き込む
+// 4. まとまりごとに拍が進んでいれば通知
+// 5. 通知中に解除されたリスナーを取り除き、通知中に登録されたリスナーを追加
+void UBeatDispatcherSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	const UGameServicesSubsystem* Services = UGameServicesSubsystem::Get(this);
+	const USoundManager* SoundManager = Services ? Services->GetSoundManager() : nullptr;
+	if (!SoundManager)
+		return;
+
+	const Beat::FBeatClock& Clock = SoundManager->GetBeatClock();
+	if (!Clock.IsRunning())
+		return;
+
+	if (Clock.GetStartCount() != LastClockStartCount)
+	{
+		LastClockStartCount = Clock.GetStartCount();
+		for (FBeatListenerGroup& Group : Groups)
+		{
+			Group.LastFiredIndex = -1;
+		}
+	}
+
+	const double BeatPosition = Clock.GetBeatPosition(FPlatformTime::Seconds());
+
+	UpdateParameterCollection(BeatPosition, static_cast<float>(Clock.GetBeatInterval()));
+
+	bDispatching = true;
+	for (FBeatListenerGroup& Group : Groups)
+	{
+		DispatchGroup(Group, BeatPosition);
+	}
+	bDispatching = false;
+
+	for (FBeatListenerGroup& Group : Groups)
+	{
+		Group.Listeners.RemoveAllSwap([](const TWeakObjectPtr<UObject>& Listener) { return !Listener.IsValid(); });
+	}
+	Groups.RemoveAllSwap([](const FBeatListenerGroup& Group) { return Group.Listeners.Num() == 0; });
+
+	for (const FPendingRegistration& Pending : PendingRegistrations)
+	{
+		AddToGroup(Pending.Listener, Pending.Subdivision, Pending.PhaseOffset);
+	}
+	PendingRegistrations.Reset();
+}
+
+// 処理の流れ:
+// 1. 分割単位の番号を求める（位相オフセット分だけ遅らせる）
+// 2. 前回から進んでいれば、まとまりの全リスナーへ1回だけ通知（1フレームで複数進んでも1回）
+//    Blueprint で実装したリスナーにも届くよう Execute_OnBeat で呼ぶ
+// 3. 実際に通知したリスナーの数を統計に加える
+void UBeatDispatcherSubsystem::DispatchGroup(FBeatListenerGroup& Group, double BeatPosition)
+{
+	const double Position = BeatPosition * static_cast<double>(Group.Subdivision) - Group.PhaseOffset;
+	const int64 Index = FMath::FloorToInt64(Position);
+	if (Index <= Group.LastFiredIndex)
+		return;
+
+	Group.LastFiredIndex = Index;
+
+	int32 NumNotified = 0;
+	for (int32 i = 0; i < Group.Listeners.Num(); ++i)
+	{
+		if (UObject* Listener = Group.Listeners[i].Get())
+		{
+			IBeatListener::Execute_OnBeat(Listener, Index, Group.Subdivision);
+			++NumNotified;
+		}
+	}
+
+	INC_DWORD_STAT_BY(STAT_BeatListenersNotified, NumNotified);
+}
+
+void UBeatDispatcherSubsystem::UpdateParameterCollection(double BeatPosition, float BeatInterval)
+{
+	if (!ParameterCollection)
+		return;
+
+	UMaterialParameterCollectionInstance* Instance = GetWorld()->GetParameterCollectionInstance(ParameterCollection);
+	if (!Instance)
+		return;
+
+	const float Phase = static_cast<float>(BeatPosition - FMath::FloorToDouble(BeatPosition));
+	Instance->SetScalarParameterValue(BEAT_PHASE_PARAMETER, Phase);
+	Instance->SetScalarParameterValue(BEAT_INTERVAL_PARAMETER, BeatInterval);
+}
+
+// Blueprint で実装したリスナーはネイティブのインターフェースを持たないため、クラスが実装しているかで確認する
+void UBeatDispatcherSubsystem::RegisterListener(TScriptInterface<IBeatListener> Listener, EBeatSubdivision Subdivision, float PhaseOffset)
+{
+	UObject* Object = Listener.GetObject();
+	if (!Object || !Object->GetClass()->ImplementsInterface(UBeatListener::StaticClass()))
+		return;
+
+	const TWeakObjectPtr<UObject> WeakListener(Object);
+	const float Offset = FMath::Clamp(PhaseOffset, 0.0f, 1.0f);
+
+	if (bDispatching)
+	{
+		PendingRegistrations.Add({ WeakListener, Subdivision, Offset });
+		return;
+	}
+
+	AddToGroup(WeakListener, Subdivision, Offset);
+}
+
+// 通知中は配列を並べ替えず、無効にしておく（通知後に取り除かれる）
+void UBeatDispatcherSubsystem::UnregisterListener(TScriptInterface<IBeatListener> Listener)
+{
+	const UObject* Object = Listener.GetObject();
+	if (!Object)
+		return;
+
+	for (FBeatListenerGroup& Group : Groups)
+	{
+		for (int32 i = Group.Listeners.Num() - 1; i >= 0; --i)
+		{
+			if (Group.Listeners[i].Get() != Object)
+				continue;
+
+			if (bDispatching)
+			{
+				Group.Listeners[i].Reset();
+			}
+			else
+			{
+				Group.Listeners.RemoveAtSwap(i);
+			}
+		}
+	}
+
+	PendingRegistrations.RemoveAllSwap([Object](const FPendingRegistration& Pending) { return Pending.Listener.Get() == Object; });
+}
+
+// 同じ分割・位相オフセットのまとまりがあれば追加し、無ければ作る
+// 新しいまとまりは現在の拍を通知済みとして始める（登録した瞬間に通知しないため）
+void UBeatDispatcherSubsystem::AddToGroup(const TWeakObjectPtr<UObject>& Listener, EBeatSubdivision Subdivision, float PhaseOffset)
+{
+	for (FBeatListenerGroup& Group : Groups)
+	{
+		if (Group.Subdivision == Subdivision && FMath::IsNearlyEqual(Group.PhaseOffset, PhaseOffset, PHASE_OFFSET_TOLERANCE))
+		{
+			Group.Listeners.AddUnique(Listener);
+			return;
+		}
+	}
+
+	FBeatListenerGroup& Group = Groups.AddDefaulted_GetRef();
+	Group.Subdivision = Subdivision;
+	Group.PhaseOffset = PhaseOffset;
+	Group.Listeners.Add(Listener);
+
+	const UGameServicesSubsystem* Services = UGameServicesSubsystem::Get(this);
+	const USoundManager* SoundManager = Services ? Services->GetSoundManager() : nullptr;
+	if (SoundManager && SoundManager->GetBeatClock().IsRunning())
+	{
+		const double BeatPosition = SoundManager->GetBeatClock().GetBeatPosition(FPlatformTime::Seconds());
+		Group.LastFiredIndex = FMath::FloorToInt64(BeatPosition * static_cast<double>(Subdivision) - PhaseOffset);
+	}
+}
+
+int32 UBeatDispatcherSubsystem::GetNumListeners() const
+{
+	int32 Num = 0;
+	for (const FBeatListenerGroup& Group : Groups)
+	{
+		Num += Group.Listeners.Num();
+	}
+	return Num;
+}
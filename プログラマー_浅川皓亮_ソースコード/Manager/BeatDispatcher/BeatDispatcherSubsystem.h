@@ -0,0 +1,117 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Interface/BeatListener.h"
+#include "BeatDispatcherSubsystem.generated.h"
+
+class UMaterialParameterCollection;
+
+/**
+ * 同じ分割・位相オフセットで登録されたリスナーのまとまり
+ * 拍が来たらまとめて通知する
+ */
+struct FBeatListenerGroup
+{
+	EBeatSubdivision Subdivision = EBeatSubdivision::Whole;
+
+	// 位相のずれ（分割単位、0～1）
+	float PhaseOffset = 0.0f;
+
+	// 最後に通知した分割単位の番号
+	int64 LastFiredIndex = -1;
+
+	// IBeatListener を実装したオブジェクト（Blueprint で実装したものはネイティブのインターフェースを持たないため UObject で持つ）
+	TArray<TWeakObjectPtr<UObject>> Listeners;
+};
+
+/**
+ * USoundManager のビート時計から、登録されたギミックへ拍を配るワールドサブシステム
+ * ギミックごとに OnBeatDetected へバインドする代わりに、同じ分割の
+ * ギミックをまとめて通知する
+ * 見た目だけの脈動はマテリアルパラメータコレクションの BeatPhase を参照すれば通知は不要
+ * 登録・解除は Blueprint からも行える（IBeatListener を Blueprint で実装したアクターも登録できる）
+ */
+UCLASS()
+class PACHIO_API UBeatDispatcherSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	/**
+	 * リスナーを登録する（同じリスナーを別の分割で重ねて登録してもよい）
+	 * @param Listener 登録するリスナー
+	 * @param Subdivision 通知する分割
+	 * @param PhaseOffset 位相のずれ（分割単位、0～1）
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Beat")
+	void RegisterListener(TScriptInterface<IBeatListener> Listener, EBeatSubdivision Subdivision, float PhaseOffset = 0.0f);
+
+	/**
+	 * リスナーの登録を全て解除する
+	 * @param Listener 解除するリスナー
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Beat")
+	void UnregisterListener(TScriptInterface<IBeatListener> Listener);
+
+	/**
+	 * 拍の位相を書き込むマテリアルパラメータコレクションを設定する
+	 * スカラーパラメータ "BeatPhase"（0～1）と "BeatInterval"（秒）を毎フレーム更新する
+	 * @param Collection 書き込むコレクション（nullptr で停止）
+	 */
+	void SetParameterCollection(UMaterialParameterCollection* Collection) { ParameterCollection = Collection; }
+
+	// 登録中のリスナー数（計測用）
+	int32 GetNumListeners() const;
+
+private:
+	/**
+	 * まとまりの拍が進んでいればリスナーへ通知する
+	 * @param Group 対象のまとまり
+	 * @param BeatPosition 現在の拍数
+	 */
+	void DispatchGroup(FBeatListenerGroup& Group, double BeatPosition);
+
+	/**
+	 * マテリアルパラメータコレクションへ位相を書き込む
+	 * @param BeatPosition 現在の拍数
+	 * @param BeatInterval 1拍の長さ（秒）
+	 */
+	void UpdateParameterCollection(double BeatPosition, float BeatInterval);
+
+	/**
+	 * まとまりにリスナーを追加する（同じ分割・位相オフセットのまとまりが無ければ作る）
+	 * @param Listener 追加するリスナー
+	 * @param Subdivision 通知する分割
+	 * @param PhaseOffset 位相のずれ（分割単位、0～1）
+	 */
+	void AddToGroup(const TWeakObjectPtr<UObject>& Listener, EBeatSubdivision Subdivision, float PhaseOffset);
+
+private:
+	// 分割・位相オフセットごとのまとまり
+	TArray<FBeatListenerGroup> Groups;
+
+	UPROPERTY(Transient)
+	TObjectPtr<UMaterialParameterCollection> ParameterCollection;
+
+	// 通知中に登録されたリスナー（通知後にまとまりへ追加する）
+	struct FPendingRegistration
+	{
+		TWeakObjectPtr<UObject> Listener;
+		EBeatSubdivision Subdivision = EBeatSubdivision::Whole;
+		float PhaseOffset = 0.0f;
+	};
+	TArray<FPendingRegistration> PendingRegistrations;
+
+	// 最後に見たビート時計の開始回数（BGMを最初から流し直したら番号を振り直す）
+	uint32 LastClockStartCount = 0;
+
+	// 通知中か（通知中の登録・解除で配列を並べ替えないため）
+	bool bDispatching = false;
+};
@@ -0,0 +1,135 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Manager/GameServicesSubsystem.h"
+#include "Manager/LevelManager.h"
+#include "Manager/ColorManager.h"
+#include "Sound/SoundManager.h"
+#include "UI/UIManager.h"
+#include "EngineUtils.h"
+
+UGameServicesSubsystem* UGameServicesSubsystem::Get(const UObject* WorldContext)
+{
+	const UWorld* World = WorldContext ? WorldContext->GetWorld() : nullptr;
+	return World ? World->GetSubsystem<UGameServicesSubsystem>() : nullptr;
+}
+
+// 処理の流れ:
+// 1. アクターの BeginPlay より前に呼ばれるため、ここでレベルマネージャーを一度だけ探して登録する
+// 2. 以降の取得はアクターの検索を行わない（サブレベルのレベルマネージャーは自身の BeginPlay で登録される）
+void UGameServicesSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	if (LevelManager)
+		return;
+
+	for (TActorIterator<ALevelManager> It(&InWorld); It; ++It)
+	{
+		RegisterLevelManager(*It);
+		break;
+	}
+
+	if (!LevelManager)
+	{
+		UE_LOG(LogTemp, Log, TEXT("GameServices: no LevelManager in %s"), *InWorld.GetName());
+	}
+}
+
+void UGameServicesSubsystem::Deinitialize()
+{
+	LevelManager = nullptr;
+	ColorManager = nullptr;
+	SoundManager = nullptr;
+	UIManager = nullptr;
+
+	Super::Deinitialize();
+}
+
+// 1. 既に別のレベルマネージャーが登録されていれば警告して無視
+// 2. 登録する
+void UGameServicesSubsystem::RegisterLevelManager(ALevelManager* InLevelManager)
+{
+	if (!InLevelManager || LevelManager == InLevelManager)
+		return;
+
+	if (LevelManager)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("GameServices: %s ignored, %s is already registered"), *InLevelManager->GetName(), *LevelManager->GetName());
+		return;
+	}
+
+	LevelManager = InLevelManager;
+}
+
+void UGameServicesSubsystem::UnregisterLevelManager(ALevelManager* InLevelManager)
+{
+	if (!InLevelManager || LevelManager != InLevelManager)
+		return;
+
+	LevelManager = nullptr;
+	ColorManager = nullptr;
+	SoundManager = nullptr;
+	UIManager = nullptr;
+}
+
+void UGameServicesSubsystem::RegisterColorManager(const ALevelManager* Owner, UColorManager* InColorManager)
+{
+	if (Owner && Owner == LevelManager)
+	{
+		ColorManager = InColorManager;
+	}
+}
+
+void UGameServicesSubsystem::RegisterSoundManager(const ALevelManager* Owner, USoundManager* InSoundManager)
+{
+	if (Owner && Owner == LevelManager)
+	{
+		SoundManager = InSoundManager;
+	}
+}
+
+void UGameServicesSubsystem::RegisterUIManager(const ALevelManager* Owner, UUIManager* InUIManager)
+{
+	if (Owner && Owner == LevelManager)
+	{
+		UIManager = InUIManager;
+	}
+}
+
+ALevelManager* UGameServicesSubsystem::GetLevelManager() const
+{
+	EnsureInitialized();
+	return LevelManager;
+}
+
+UColorManager* UGameServicesSubsystem::GetColorManager() const
+{
+	EnsureInitialized();
+	return ColorManager;
+}
+
+USoundManager* UGameServicesSubsystem::GetSoundManager() const
+{
+	EnsureInitialized();
+	return SoundManager;
+}
+
+UUIManager* UGameServicesSubsystem::GetUIManager() const
+{
+	EnsureInitialized();
+	return UIManager;
+}
+
+void UGameServicesSubsystem::EnsureInitialized() const
+{
+	if (LevelManager && !LevelManager->bInitialize)
+	{
+		LevelManager->InitializeComponents();
+	}
+}
+
+bool UGameServicesSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
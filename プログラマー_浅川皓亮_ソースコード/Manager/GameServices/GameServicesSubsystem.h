@@ -0,0 +1,85 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "GameServicesSubsystem.generated.h"
+
+class ALevelManager;
+class UColorManager;
+class USoundManager;
+class UUIManager;
+
+/**
+ * ワールドごとのマネージャー（カラー・サウンド・UI）への参照をまとめるワールドサブシステム
+ * ALevelManager が初期化時に各マネージャーを登録し、他のクラスはここから直接取得する
+ * ワールドごとに1つ作られるため、PIE の複数クライアントでも参照が混ざらない
+ *
+ * レベルマネージャーはワールド開始時に一度だけ探しておき、初期化は
+ * 自身の BeginPlay か最初の取得のどちらか早い方で行う（以前の GetInstance と同じ順序）
+ */
+UCLASS()
+class PACHIO_API UGameServicesSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/**
+	 * ワールドコンテキストからサブシステムを取得する
+	 * @param WorldContext ワールドコンテキスト
+	 * @return サブシステム（ゲームワールド以外では nullptr）
+	 */
+	static UGameServicesSubsystem* Get(const UObject* WorldContext);
+
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+
+	// 各マネージャー（レベルマネージャーが無い場合は nullptr）
+	ALevelManager* GetLevelManager() const;
+	UColorManager* GetColorManager() const;
+	USoundManager* GetSoundManager() const;
+	UUIManager* GetUIManager() const;
+
+	/**
+	 * レベルマネージャーを登録する（以降のマネージャー登録はこのレベルマネージャーからのみ受け付ける）
+	 * @param InLevelManager 登録するレベルマネージャー
+	 */
+	void RegisterLevelManager(ALevelManager* InLevelManager);
+
+	/**
+	 * レベルマネージャーの登録を解除し、そのマネージャー群も外す
+	 * @param InLevelManager 解除するレベルマネージャー
+	 */
+	void UnregisterLevelManager(ALevelManager* InLevelManager);
+
+	/** カラーマネージャーを登録する @param Owner 登録元 @param InColorManager カラーマネージャー */
+	void RegisterColorManager(const ALevelManager* Owner, UColorManager* InColorManager);
+
+	/** サウンドマネージャーを登録する @param Owner 登録元 @param InSoundManager サウンドマネージャー */
+	void RegisterSoundManager(const ALevelManager* Owner, USoundManager* InSoundManager);
+
+	/** UIマネージャーを登録する @param Owner 登録元 @param InUIManager UIマネージャー */
+	void RegisterUIManager(const ALevelManager* Owner, UUIManager* InUIManager);
+
+protected:
+	// ゲーム・PIE のワールドだけで作成する（エディタのプレビュー等には不要）
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	// レベルマネージャーがまだ BeginPlay 前なら、ここで初期化する（各マネージャーが登録される）
+	void EnsureInitialized() const;
+
+private:
+	UPROPERTY(Transient)
+	TObjectPtr<ALevelManager> LevelManager;
+
+	UPROPERTY(Transient)
+	TObjectPtr<UColorManager> ColorManager;
+
+	UPROPERTY(Transient)
+	TObjectPtr<USoundManager> SoundManager;
+
+	UPROPERTY(Transient)
+	TObjectPtr<UUIManager> UIManager;
+};
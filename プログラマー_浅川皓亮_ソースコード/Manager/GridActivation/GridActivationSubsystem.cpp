@@ -0,0 +1,482 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Manager/GridActivationSubsystem.h"
+#include "Components/CameraHandlerComponent.h"
+#include "Components/Color/ColorReactiveComponent.h"
+#include "Components/PhysicsCalculator.h"
+#include "Objects/Color/ColorReactiveObject.h"
+#include "Objects/MovingObject.h"
+#include "EngineUtils.h"
+#include "Engine/Level.h"
+#include "GameFramework/Pawn.h"
+#include "NiagaraActor.h"
+#include "NiagaraComponent.h"
+
+namespace
+{
+	// 現在の部屋から何部屋先まで有効にするか（1なら周囲8部屋）
+	static constexpr int32 ACTIVE_CELL_RADIUS = 1;
+}
+
+// =======================
+// 登録
+// =======================
+
+// 処理の流れ:
+// 1. レベルに置かれているギミックを全て登録
+// 2. 部屋の振り分けはカメラからグリッドサイズが届いた時に行う
+void UGridActivationSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	for (TActorIterator<AActor> It(&InWorld); It; ++It)
+	{
+		if (IsGimmickActor(*It))
+		{
+			RegisterGimmick(*It);
+		}
+	}
+}
+
+// 止めたものを戻してから破棄する
+void UGridActivationSubsystem::Deinitialize()
+{
+	ActivateAll();
+	Gimmicks.Empty();
+	GimmickIndices.Empty();
+	Cells.Empty();
+	ActiveCells.Empty();
+
+	Super::Deinitialize();
+}
+
+// 色に反応するギミック・エフェクト・自前物理のオブジェクトを対象とする（プレイヤー等のポーンは除く）
+// 動く足場は部屋に関係なく経路を進むため対象外（無効の部屋から入ってきた時にコリジョンが無いままになる）
+bool UGridActivationSubsystem::IsGimmickActor(const AActor* Actor)
+{
+	if (!Actor || Actor->IsA<APawn>() || Actor->IsA<AMovingObject>())
+		return false;
+
+	return Actor->IsA<AColorReactiveObject>() ||
+		Actor->IsA<ANiagaraActor>() ||
+		Actor->FindComponentByClass<UColorReactiveComponent>() != nullptr ||
+		Actor->FindComponentByClass<UPhysicsCalculator>() != nullptr;
+}
+
+// 処理の流れ:
+// 1. 登録済みなら何もしない
+// 2. 振り分け済みなら所属する部屋に追加し、有効範囲外なら無効化
+void UGridActivationSubsystem::RegisterGimmick(AActor* Actor)
+{
+	if (!Actor)
+		return;
+
+	if (GimmickIndices.Contains(Actor))
+		return;
+
+	const int32 Index = Gimmicks.AddDefaulted();
+	GimmickIndices.Add(Actor, Index);
+	FGridGimmick& Gimmick = Gimmicks[Index];
+	Gimmick.Actor = Actor;
+	Gimmick.bMovable = Actor->FindComponentByClass<UPhysicsCalculator>() != nullptr;
+
+	if (CellSize.IsZero())
+		return;
+
+	Gimmick.Cell = UCameraHandlerComponent::ComputeGrid(Actor->GetActorLocation(), CellSize);
+	Cells.FindOrAdd(Gimmick.Cell).Add(Index);
+	ReconcileGimmick(Gimmick);
+}
+
+// 処理の流れ:
+// 1. 破棄されたサブレベルのギミックを取り除く
+// 2. レベル内の対象アクターを登録（有効範囲外の部屋なら無効化される）
+void UGridActivationSubsystem::RegisterLevelGimmicks(ULevel* Level)
+{
+	if (!Level)
+		return;
+
+	if (CellSize.IsZero())
+	{
+		RemoveGimmicks([](const FGridGimmick& Gimmick) { return !Gimmick.Actor.IsValid(); });
+	}
+	else
+	{
+		RebuildCells();
+	}
+
+	for (AActor* Actor : Level->Actors)
+	{
+		if (IsGimmickActor(Actor))
+		{
+			RegisterGimmick(Actor);
+		}
+	}
+}
+
+// 処理の流れ:
+// 1. 破棄されるレベルのギミック（と破棄済みのギミック）を取り除く
+// 2. 番号が詰まるため、部屋ごとのギミック番号を振り分け済みの部屋から作り直す
+void UGridActivationSubsystem::UnregisterLevelGimmicks(const ULevel* Level)
+{
+	if (!Level)
+		return;
+
+	const int32 NumRemoved = RemoveGimmicks([Level](const FGridGimmick& Gimmick)
+		{
+			return !Gimmick.Actor.IsValid() || Gimmick.Actor->GetLevel() == Level;
+		});
+	if (NumRemoved == 0 || CellSize.IsZero())
+		return;
+
+	Cells.Reset();
+	for (int32 i = 0; i < Gimmicks.Num(); ++i)
+	{
+		Cells.FindOrAdd(Gimmicks[i].Cell).Add(i);
+	}
+}
+
+// =======================
+// 部屋の切り替え
+// =======================
+
+// 処理の流れ:
+// 1. グリッド表示でなければ全て有効に戻す
+// 2. グリッドサイズが変わっていれば全ギミックを振り分け直し、変わっていなければ動いたギミックだけ振り分け直す
+// 3. 新しく有効範囲に入った部屋を有効化し、外れた部屋を無効化
+void UGridActivationSubsystem::SetActiveGrid(FIntPoint Grid, FVector2D GridSize, bool bGridView)
+{
+	if (!bGridView || GridSize.X <= 0.0f || GridSize.Y <= 0.0f)
+	{
+		ActivateAll();
+		return;
+	}
+
+	if (!CellSize.Equals(GridSize))
+	{
+		ActivateAll();
+		CellSize = GridSize;
+		RebuildCells();
+	}
+	else
+	{
+		RebucketMovableGimmicks();
+	}
+
+	TSet<FIntPoint> NewActiveCells;
+	for (int32 Y = -ACTIVE_CELL_RADIUS; Y <= ACTIVE_CELL_RADIUS; ++Y)
+	{
+		for (int32 X = -ACTIVE_CELL_RADIUS; X <= ACTIVE_CELL_RADIUS; ++X)
+		{
+			NewActiveCells.Add(Grid + FIntPoint(X, Y));
+		}
+	}
+
+	// 初回は全ギミックが有効なので、有効範囲外の部屋を全て無効化する
+	if (ActiveCells.IsEmpty())
+	{
+		for (const TPair<FIntPoint, TArray<int32>>& Cell : Cells)
+		{
+			if (!NewActiveCells.Contains(Cell.Key))
+			{
+				SetCellActive(Cell.Key, false);
+			}
+		}
+	}
+	else
+	{
+		for (const FIntPoint& Cell : ActiveCells)
+		{
+			if (!NewActiveCells.Contains(Cell))
+			{
+				SetCellActive(Cell, false);
+			}
+		}
+		for (const FIntPoint& Cell : NewActiveCells)
+		{
+			if (!ActiveCells.Contains(Cell))
+			{
+				SetCellActive(Cell, true);
+			}
+		}
+	}
+
+	ActiveCells = MoveTemp(NewActiveCells);
+}
+
+bool UGridActivationSubsystem::IsCellActive(FIntPoint Cell) const
+{
+	return ActiveCells.IsEmpty() || ActiveCells.Contains(Cell);
+}
+
+int32 UGridActivationSubsystem::GetNumActiveGimmicks() const
+{
+	int32 Count = 0;
+	for (const FGridGimmick& Gimmick : Gimmicks)
+	{
+		if (Gimmick.bActive)
+		{
+			++Count;
+		}
+	}
+	return Count;
+}
+
+FGridGimmick* UGridActivationSubsystem::FindGimmick(AActor* Actor)
+{
+	if (!Actor)
+		return nullptr;
+
+	const int32* Index = GimmickIndices.Find(Actor);
+	return Index ? &Gimmicks[*Index] : nullptr;
+}
+
+// 取り除くと後ろのギミックの番号が詰まるため、アクターからの番号を全て作り直す
+int32 UGridActivationSubsystem::RemoveGimmicks(TFunctionRef<bool(const FGridGimmick&)> Predicate)
+{
+	const int32 NumRemoved = Gimmicks.RemoveAll(Predicate);
+	if (NumRemoved == 0)
+		return 0;
+
+	GimmickIndices.Reset();
+	for (int32 i = 0; i < Gimmicks.Num(); ++i)
+	{
+		GimmickIndices.Add(Gimmicks[i].Actor, i);
+	}
+	return NumRemoved;
+}
+
+// 処理の流れ:
+// 1. 破棄されたギミックを取り除く
+// 2. 各ギミックの位置から部屋を求めて振り分ける
+// 3. 振り分けた部屋に合わせて有効・無効を揃える
+void UGridActivationSubsystem::RebuildCells()
+{
+	RemoveGimmicks([](const FGridGimmick& Gimmick) { return !Gimmick.Actor.IsValid(); });
+	Cells.Reset();
+
+	for (int32 i = 0; i < Gimmicks.Num(); ++i)
+	{
+		FGridGimmick& Gimmick = Gimmicks[i];
+		Gimmick.Cell = UCameraHandlerComponent::ComputeGrid(Gimmick.Actor->GetActorLocation(), CellSize);
+		Cells.FindOrAdd(Gimmick.Cell).Add(i);
+		ReconcileGimmick(Gimmick);
+	}
+}
+
+// 処理の流れ:
+// 1. 有効な（眠っていない）自前物理のギミックだけ、今の位置から部屋を求める
+// 2. 部屋が変わっていれば振り分け先を移し、移った先の部屋に合わせて有効・無効を揃える
+// 無効なギミックは眠っていて動かないため対象外
+void UGridActivationSubsystem::RebucketMovableGimmicks()
+{
+	for (int32 i = 0; i < Gimmicks.Num(); ++i)
+	{
+		FGridGimmick& Gimmick = Gimmicks[i];
+		const AActor* Actor = Gimmick.Actor.Get();
+		if (!Actor || !Gimmick.bMovable || !Gimmick.bActive)
+			continue;
+
+		const FIntPoint NewCell = UCameraHandlerComponent::ComputeGrid(Actor->GetActorLocation(), CellSize);
+		if (NewCell == Gimmick.Cell)
+			continue;
+
+		if (TArray<int32>* OldIndices = Cells.Find(Gimmick.Cell))
+		{
+			OldIndices->RemoveSingleSwap(i);
+		}
+		Gimmick.Cell = NewCell;
+		Cells.FindOrAdd(NewCell).Add(i);
+		ReconcileGimmick(Gimmick);
+	}
+}
+
+// 有効な部屋が無い間は全て有効のまま
+void UGridActivationSubsystem::ReconcileGimmick(FGridGimmick& Gimmick)
+{
+	if (!ActiveCells.IsEmpty())
+	{
+		SetGimmickActive(Gimmick, ActiveCells.Contains(Gimmick.Cell));
+	}
+}
+
+void UGridActivationSubsystem::SetCellActive(FIntPoint Cell, bool bActive)
+{
+	const TArray<int32>* Indices = Cells.Find(Cell);
+	if (!Indices)
+		return;
+
+	for (const int32 Index : *Indices)
+	{
+		SetGimmickActive(Gimmicks[Index], bActive);
+	}
+}
+
+void UGridActivationSubsystem::ActivateAll()
+{
+	// 有効な部屋が無い間は全て有効のまま
+	if (ActiveCells.IsEmpty())
+		return;
+
+	for (FGridGimmick& Gimmick : Gimmicks)
+	{
+		SetGimmickActive(Gimmick, true);
+	}
+	ActiveCells.Reset();
+}
+
+// =======================
+// ギミック自身による切り替え
+// =======================
+
+// 処理の流れ:
+// 1. 登録されていない・有効なギミックはそのまま切り替える
+// 2. 無効なギミックは止めたままにし、有効化の時に戻すかどうかの記録だけ書き換える
+//    （自前物理のギミックは無効化でコリジョンを止めないため、そのまま切り替える）
+bool UGridActivationSubsystem::SetGimmickCollisionEnabled(AActor* Actor, bool bEnable)
+{
+	if (!Actor)
+		return false;
+
+	const bool bWasEnabled = Actor->GetActorEnableCollision();
+
+	FGridGimmick* Gimmick = FindGimmick(Actor);
+	if (Gimmick && !Gimmick->bActive && !Gimmick->bMovable)
+	{
+		Gimmick->bCollisionStopped = bEnable;
+		Actor->SetActorEnableCollision(false);
+	}
+	else
+	{
+		Actor->SetActorEnableCollision(bEnable);
+	}
+
+	return Actor->GetActorEnableCollision() != bWasEnabled;
+}
+
+void UGridActivationSubsystem::SetGimmickTickEnabled(AActor* Actor, bool bEnable)
+{
+	if (!Actor)
+		return;
+
+	FGridGimmick* Gimmick = FindGimmick(Actor);
+	if (Gimmick && !Gimmick->bActive)
+	{
+		Gimmick->bActorTickStopped = bEnable;
+		Actor->SetActorTickEnabled(false);
+		return;
+	}
+
+	Actor->SetActorTickEnabled(bEnable);
+}
+
+// 無効なギミックでは、再開は有効化の時に再開する一覧へ加え、一時停止はその一覧から外す
+void UGridActivationSubsystem::SetGimmickNiagaraPaused(UNiagaraComponent* Niagara, bool bPaused)
+{
+	if (!Niagara)
+		return;
+
+	FGridGimmick* Gimmick = FindGimmick(Niagara->GetOwner());
+	if (Gimmick && !Gimmick->bActive)
+	{
+		if (bPaused)
+		{
+			Gimmick->PausedNiagaras.Remove(Niagara);
+		}
+		else
+		{
+			Gimmick->PausedNiagaras.AddUnique(Niagara);
+		}
+		Niagara->SetPaused(true);
+		return;
+	}
+
+	Niagara->SetPaused(bPaused);
+}
+
+// 処理の流れ（無効化）:
+// 1. 動いているTick（アクター・コンポーネント）を止めて記録
+// 2. 再生中のNiagaraを一時停止して記録
+// 3. 自前物理は眠らせ、それ以外はコリジョンを止めて記録
+// 有効化では記録したものだけを元に戻す（ギミック自身が止めていたものには触れない）
+// 無効の間のギミック自身による切り替えは Set*（SetGimmickCollisionEnabled 等）が記録に反映している
+void UGridActivationSubsystem::SetGimmickActive(FGridGimmick& Gimmick, bool bActive)
+{
+	AActor* Actor = Gimmick.Actor.Get();
+	if (!Actor || Gimmick.bActive == bActive)
+		return;
+
+	Gimmick.bActive = bActive;
+	UPhysicsCalculator* Physics = Actor->FindComponentByClass<UPhysicsCalculator>();
+
+	if (!bActive)
+	{
+		if (Actor->IsActorTickEnabled())
+		{
+			Actor->SetActorTickEnabled(false);
+			Gimmick.bActorTickStopped = true;
+		}
+
+		for (UActorComponent* Component : Actor->GetComponents())
+		{
+			if (UNiagaraComponent* Niagara = Cast<UNiagaraComponent>(Component))
+			{
+				if (Niagara->IsActive() && !Niagara->IsPaused())
+				{
+					Niagara->SetPaused(true);
+					Gimmick.PausedNiagaras.Add(Niagara);
+				}
+			}
+
+			if (Component->IsComponentTickEnabled())
+			{
+				Component->SetComponentTickEnabled(false);
+				Gimmick.StoppedComponentTicks.Add(Component);
+			}
+		}
+
+		if (Physics)
+		{
+			Physics->Sleep();
+		}
+		else if (Actor->GetActorEnableCollision())
+		{
+			Actor->SetActorEnableCollision(false);
+			Gimmick.bCollisionStopped = true;
+		}
+		return;
+	}
+
+	if (Gimmick.bActorTickStopped)
+	{
+		Actor->SetActorTickEnabled(true);
+	}
+	if (Gimmick.bCollisionStopped)
+	{
+		Actor->SetActorEnableCollision(true);
+	}
+	for (const TWeakObjectPtr<UActorComponent>& Component : Gimmick.StoppedComponentTicks)
+	{
+		if (Component.IsValid())
+		{
+			Component->SetComponentTickEnabled(true);
+		}
+	}
+	for (const TWeakObjectPtr<UNiagaraComponent>& Niagara : Gimmick.PausedNiagaras)
+	{
+		if (Niagara.IsValid())
+		{
+			Niagara->SetPaused(false);
+		}
+	}
+	if (Physics)
+	{
+		Physics->WakeUp();
+	}
+
+	Gimmick.bActorTickStopped = false;
+	Gimmick.bCollisionStopped = false;
+	Gimmick.StoppedComponentTicks.Reset();
+	Gimmick.PausedNiagaras.Reset();
+}
@@ -0,0 +1,157 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "GridActivationSubsystem.generated.h"
+
+class UActorComponent;
+class UNiagaraComponent;
+class ULevel;
+
+/**
+ * 部屋ごとに有効・無効を切り替えるギミック1つ分の情報
+ * 無効化した時に止めたものだけを覚えておき、有効化の時に元に戻す
+ * 無効の間にギミック自身が切り替えた分（色の変化など）は記録の方を書き換え、有効化の時に反映する
+ */
+struct FGridGimmick
+{
+	TWeakObjectPtr<AActor> Actor;
+
+	// 所属する部屋（グリッド座標）
+	FIntPoint Cell = FIntPoint::ZeroValue;
+
+	// 現在有効か
+	bool bActive = true;
+
+	// 自前物理で動くか（無効化では眠らせ、部屋が変わる度に振り分け直す）
+	bool bMovable = false;
+
+	// 無効化で止めたもの
+	bool bActorTickStopped = false;
+	bool bCollisionStopped = false;
+	TArray<TWeakObjectPtr<UActorComponent>> StoppedComponentTicks;
+	TArray<TWeakObjectPtr<UNiagaraComponent>> PausedNiagaras;
+};
+
+/**
+ * カメラの部屋（グリッド）に合わせてギミックの有効範囲を切り替えるワールドサブシステム
+ * ロード時にギミックを部屋ごとに振り分け、現在の部屋と隣の部屋だけ
+ * Tick・Niagara・コリジョン・自前物理を有効にする
+ * 自前物理のギミックは部屋が変わる度に今いる部屋へ振り分け直す（動く足場は切り替えの対象外）
+ */
+UCLASS()
+class PACHIO_API UGridActivationSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+
+	/**
+	 * 現在の部屋を設定する（UCameraHandlerComponent::OnGridChanged から呼ばれる）
+	 * @param Grid 現在の部屋のグリッド座標
+	 * @param GridSize 1部屋のサイズ
+	 * @param bGridView グリッド表示中か（それ以外では全て有効にする）
+	 */
+	void SetActiveGrid(FIntPoint Grid, FVector2D GridSize, bool bGridView);
+
+	/**
+	 * ギミックを登録する（途中で生成したギミック用。ロード時に置かれているものは自動で登録）
+	 * @param Actor 登録するアクター
+	 */
+	void RegisterGimmick(AActor* Actor);
+
+	/**
+	 * 読み込まれたサブレベルのギミックをまとめて登録する（破棄済みのギミックは取り除く）
+	 * @param Level 読み込まれたレベル
+	 */
+	void RegisterLevelGimmicks(ULevel* Level);
+
+	/**
+	 * 破棄されるサブレベルのギミックをまとめて登録から外す
+	 * @param Level 破棄されるレベル
+	 */
+	void UnregisterLevelGimmicks(const ULevel* Level);
+
+	/** 部屋が有効か @param Cell 部屋のグリッド座標 */
+	bool IsCellActive(FIntPoint Cell) const;
+
+	/**
+	 * ギミック自身の都合（色の変化など）でコリジョンを切り替える
+	 * 部屋が無効の間は切り替えず、有効化の時にこの状態へ戻す
+	 * @param Actor 対象のアクター（登録されていなければそのまま切り替える）
+	 * @param bEnable コリジョンを有効にするか
+	 * @return アクターのコリジョンが実際に変わったか
+	 */
+	bool SetGimmickCollisionEnabled(AActor* Actor, bool bEnable);
+
+	/**
+	 * ギミック自身の都合でアクターのTickを切り替える（部屋が無効の間は有効化の時に反映する）
+	 * @param Actor 対象のアクター（登録されていなければそのまま切り替える）
+	 * @param bEnable Tickを有効にするか
+	 */
+	void SetGimmickTickEnabled(AActor* Actor, bool bEnable);
+
+	/**
+	 * ギミック自身の都合でNiagaraを一時停止・再開する（部屋が無効の間は有効化の時に反映する）
+	 * @param Niagara 対象のNiagara（オーナーが登録されていなければそのまま切り替える）
+	 * @param bPaused 一時停止するか
+	 */
+	void SetGimmickNiagaraPaused(UNiagaraComponent* Niagara, bool bPaused);
+
+	// 登録中のギミック数と、そのうち有効な数
+	int32 GetNumGimmicks() const { return Gimmicks.Num(); }
+	int32 GetNumActiveGimmicks() const;
+
+private:
+	// アクターが部屋ごとの切り替え対象か
+	static bool IsGimmickActor(const AActor* Actor);
+
+	// アクターの登録情報を探す（無ければ nullptr）
+	FGridGimmick* FindGimmick(AActor* Actor);
+
+	/**
+	 * 条件に合うギミックを取り除き、アクターからの番号を作り直す
+	 * （部屋ごとのギミック番号は呼び出し側で作り直す）
+	 * @param Predicate 取り除くか
+	 * @return 取り除いた数
+	 */
+	int32 RemoveGimmicks(TFunctionRef<bool(const FGridGimmick&)> Predicate);
+
+	// 現在のグリッドサイズで全ギミックを部屋に振り分け直す
+	void RebuildCells();
+
+	// 自前物理で動いたギミックを今いる部屋へ振り分け直す
+	void RebucketMovableGimmicks();
+
+	/** ギミックの有効・無効を所属する部屋に合わせる @param Gimmick 対象 */
+	void ReconcileGimmick(FGridGimmick& Gimmick);
+
+	/** 部屋内の全ギミックの有効・無効を切り替える @param Cell 部屋 @param bActive 有効にするか */
+	void SetCellActive(FIntPoint Cell, bool bActive);
+
+	/** ギミック1つの有効・無効を切り替える @param Gimmick 対象 @param bActive 有効にするか */
+	void SetGimmickActive(FGridGimmick& Gimmick, bool bActive);
+
+	// 全ギミックを有効にして切り替えを止める
+	void ActivateAll();
+
+private:
+	// 登録中のギミック
+	TArray<FGridGimmick> Gimmicks;
+
+	// アクターから Gimmicks の番号を引く（Gimmicks から取り除く度に作り直す）
+	TMap<TWeakObjectPtr<AActor>, int32> GimmickIndices;
+
+	// 部屋ごとのギミック番号
+	TMap<FIntPoint, TArray<int32>> Cells;
+
+	// 有効な部屋
+	TSet<FIntPoint> ActiveCells;
+
+	// 振り分けに使ったグリッドサイズ（未設定ならゼロ）
+	FVector2D CellSize = FVector2D::ZeroVector;
+};
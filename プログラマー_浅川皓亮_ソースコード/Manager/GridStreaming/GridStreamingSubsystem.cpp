@@ -0,0 +1,194 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Manager/GridStreamingSubsystem.h"
+#include "Manager/GridActivationSubsystem.h"
+#include "Engine/LevelStreamingDynamic.h"
+#include "Engine/Level.h"
+
+namespace
+{
+	// この距離（チェビシェフ距離）より離れた部屋は破棄する
+	static constexpr int32 UNLOAD_DISTANCE = 2;
+}
+
+void UGridStreamingSubsystem::Deinitialize()
+{
+	CellLevels.Empty();
+	LoadedCells.Empty();
+	RegisteredLevels.Empty();
+
+	Super::Deinitialize();
+}
+
+// 処理の流れ:
+// 1. 部屋ごとのサブレベルを設定し直す（空なら全て無くなる）
+// 2. サブレベルが変わった（無くなった）読み込み済みの部屋を破棄
+// 読み込みはグリッドサイズが反映された後の SetCurrentGrid / RefreshStreaming で行う
+// （ここで読み込むと切り替え前のグリッドで部屋を選んでしまう）
+void UGridStreamingSubsystem::SetStreamingCells(const TArray<FGridStreamingCell>& InCells)
+{
+	TMap<FIntPoint, TSoftObjectPtr<UWorld>> NewLevels;
+	for (const FGridStreamingCell& Cell : InCells)
+	{
+		if (!Cell.Level.IsNull())
+		{
+			NewLevels.Add(Cell.Cell, Cell.Level);
+		}
+	}
+
+	TArray<FIntPoint> Stale;
+	for (const TPair<FIntPoint, TObjectPtr<ULevelStreamingDynamic>>& Loaded : LoadedCells)
+	{
+		const TSoftObjectPtr<UWorld>* NewLevel = NewLevels.Find(Loaded.Key);
+		const TSoftObjectPtr<UWorld>* OldLevel = CellLevels.Find(Loaded.Key);
+		if (!NewLevel || !OldLevel || *NewLevel != *OldLevel)
+		{
+			Stale.Add(Loaded.Key);
+		}
+	}
+	for (const FIntPoint& Cell : Stale)
+	{
+		UnloadCell(Cell);
+	}
+
+	CellLevels = MoveTemp(NewLevels);
+}
+
+// 処理の流れ:
+// 1. グリッドサイズが変わっていれば座標の意味が変わるため移動方向を捨てる
+// 2. 同じグリッドで部屋が変わっていれば移動方向を記録
+// 3. 読み込み・破棄を更新
+void UGridStreamingSubsystem::SetCurrentGrid(FIntPoint Grid, FVector2D GridSize, bool bGridView)
+{
+	if (!CurrentGridSize.Equals(GridSize))
+	{
+		MoveDirection = FIntPoint::ZeroValue;
+	}
+	else if (bHasGrid && Grid != CurrentGrid)
+	{
+		MoveDirection = FIntPoint(
+			FMath::Clamp(Grid.X - CurrentGrid.X, -1, 1),
+			FMath::Clamp(Grid.Y - CurrentGrid.Y, -1, 1));
+	}
+
+	CurrentGrid = Grid;
+	CurrentGridSize = GridSize;
+	bHasGrid = true;
+	UpdateStreaming();
+}
+
+// 現在の部屋が分かっていれば今の対応で読み込み直す
+void UGridStreamingSubsystem::RefreshStreaming()
+{
+	if (bHasGrid)
+	{
+		UpdateStreaming();
+	}
+}
+
+// 処理の流れ:
+// 1. 現在の部屋から離れすぎた部屋を破棄
+// 2. 現在の部屋を読み込む
+// 3. 隣の部屋のうち進行方向にあるものを読み込む（まだ移動していなければ全ての隣）
+// 後ろの隣の部屋は読み込み済みなら残し、引き返した時にすぐ表示できるようにする
+void UGridStreamingSubsystem::UpdateStreaming()
+{
+	TArray<FIntPoint> FarCells;
+	for (const TPair<FIntPoint, TObjectPtr<ULevelStreamingDynamic>>& Loaded : LoadedCells)
+	{
+		const FIntPoint Delta = Loaded.Key - CurrentGrid;
+		if (FMath::Max(FMath::Abs(Delta.X), FMath::Abs(Delta.Y)) > UNLOAD_DISTANCE)
+		{
+			FarCells.Add(Loaded.Key);
+		}
+	}
+	for (const FIntPoint& Cell : FarCells)
+	{
+		UnloadCell(Cell);
+	}
+
+	LoadCell(CurrentGrid);
+
+	const bool bMoved = MoveDirection != FIntPoint::ZeroValue;
+	for (int32 Y = -1; Y <= 1; ++Y)
+	{
+		for (int32 X = -1; X <= 1; ++X)
+		{
+			if (X == 0 && Y == 0)
+				continue;
+
+			const bool bAhead = X * MoveDirection.X + Y * MoveDirection.Y > 0;
+			if (!bMoved || bAhead)
+			{
+				LoadCell(CurrentGrid + FIntPoint(X, Y));
+			}
+		}
+	}
+}
+
+void UGridStreamingSubsystem::LoadCell(FIntPoint Cell)
+{
+	if (LoadedCells.Contains(Cell))
+		return;
+
+	const TSoftObjectPtr<UWorld>* Level = CellLevels.Find(Cell);
+	if (!Level)
+		return;
+
+	// 位置はサブレベル側で配置済みのものをそのまま使う
+	bool bSuccess = false;
+	ULevelStreamingDynamic* Streaming = ULevelStreamingDynamic::LoadLevelInstanceBySoftObjectPtr(
+		this, *Level, FVector::ZeroVector, FRotator::ZeroRotator, bSuccess);
+	if (!bSuccess || !Streaming)
+		return;
+
+	Streaming->bShouldBlockOnLoad = false;
+	Streaming->OnLevelShown.AddDynamic(this, &UGridStreamingSubsystem::HandleLevelShown);
+	LoadedCells.Add(Cell, Streaming);
+}
+
+void UGridStreamingSubsystem::UnloadCell(FIntPoint Cell)
+{
+	TObjectPtr<ULevelStreamingDynamic> Streaming;
+	if (!LoadedCells.RemoveAndCopyValue(Cell, Streaming) || !Streaming)
+		return;
+
+	Streaming->OnLevelShown.RemoveDynamic(this, &UGridStreamingSubsystem::HandleLevelShown);
+
+	// 破棄されるギミックを部屋ごとの有効化から外しておく
+	if (RegisteredLevels.Contains(Streaming.Get()))
+	{
+		UGridActivationSubsystem* Activation = GetWorld() ? GetWorld()->GetSubsystem<UGridActivationSubsystem>() : nullptr;
+		if (Activation)
+		{
+			Activation->UnregisterLevelGimmicks(Streaming->GetLoadedLevel());
+		}
+	}
+
+	Streaming->SetIsRequestingUnloadAndRemoval(true);
+	RegisteredLevels.Remove(Streaming.Get());
+}
+
+// 処理の流れ:
+// 1. どのレベルが表示されたかは渡されないため、表示済みで未登録のものを探す
+// 2. そのレベルのギミックを部屋ごとの有効化に登録
+void UGridStreamingSubsystem::HandleLevelShown()
+{
+	UGridActivationSubsystem* Activation = GetWorld() ? GetWorld()->GetSubsystem<UGridActivationSubsystem>() : nullptr;
+	if (!Activation)
+		return;
+
+	for (const TPair<FIntPoint, TObjectPtr<ULevelStreamingDynamic>>& Loaded : LoadedCells)
+	{
+		ULevelStreamingDynamic* Streaming = Loaded.Value;
+		if (!Streaming || !Streaming->IsLevelVisible() || RegisteredLevels.Contains(Streaming))
+			continue;
+
+		if (ULevel* Level = Streaming->GetLoadedLevel())
+		{
+			Activation->RegisterLevelGimmicks(Level);
+			RegisteredLevels.Add(Streaming);
+		}
+	}
+}
@@ -0,0 +1,98 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "GridStreamingSubsystem.generated.h"
+
+class ULevelStreamingDynamic;
+
+/**
+ * 部屋（グリッド）1つ分のストリーミング設定
+ * 座標はカメラのグリッドと同じ（AConfigTriggerZone の GridSize で区切った YZ 平面）
+ */
+USTRUCT(BlueprintType)
+struct FGridStreamingCell
+{
+	GENERATED_BODY()
+
+	// 部屋のグリッド座標
+	UPROPERTY(EditAnywhere, Category = "Streaming")
+	FIntPoint Cell = FIntPoint::ZeroValue;
+
+	// 部屋の中身を置いたサブレベル
+	UPROPERTY(EditAnywhere, Category = "Streaming")
+	TSoftObjectPtr<UWorld> Level;
+};
+
+/**
+ * カメラの部屋に合わせてサブレベルを読み込み・破棄するワールドサブシステム
+ * 現在の部屋と進行方向の隣の部屋を非同期で読み込み、離れた部屋は破棄する
+ * 部屋とサブレベルの対応は AConfigTriggerZone から設定される
+ */
+UCLASS()
+class PACHIO_API UGridStreamingSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	/**
+	 * 部屋とサブレベルの対応を設定する（対応が変わった読み込み済みの部屋は破棄、空なら全て破棄）
+	 * 読み込みは次の SetCurrentGrid か RefreshStreaming で行う
+	 * @param InCells 部屋ごとのサブレベル
+	 */
+	void SetStreamingCells(const TArray<FGridStreamingCell>& InCells);
+
+	// 現在の部屋のまま、今の対応で読み込み直す（グリッドが変わらない時に SetStreamingCells の後で呼ぶ）
+	void RefreshStreaming();
+
+	/**
+	 * 現在の部屋を設定する（UCameraHandlerComponent::OnGridChanged から呼ばれる）
+	 * @param Grid 現在の部屋のグリッド座標
+	 * @param GridSize 1部屋のサイズ
+	 * @param bGridView グリッド表示中か
+	 */
+	void SetCurrentGrid(FIntPoint Grid, FVector2D GridSize, bool bGridView);
+
+	/** 部屋のサブレベルを読み込んでいるか（読み込み中を含む） @param Cell 部屋のグリッド座標 */
+	bool IsCellLoaded(FIntPoint Cell) const { return LoadedCells.Contains(Cell); }
+
+	// 読み込んでいる（読み込み中を含む）部屋の数
+	int32 GetNumLoadedCells() const { return LoadedCells.Num(); }
+
+private:
+	// 現在の部屋と進行方向から読み込み・破棄する部屋を決める
+	void UpdateStreaming();
+
+	/** 部屋のサブレベルを非同期で読み込む @param Cell 部屋のグリッド座標 */
+	void LoadCell(FIntPoint Cell);
+
+	/** 部屋のサブレベルを破棄する @param Cell 部屋のグリッド座標 */
+	void UnloadCell(FIntPoint Cell);
+
+	// サブレベルが表示された時にギミックを部屋ごとの有効化に登録する
+	UFUNCTION()
+	void HandleLevelShown();
+
+private:
+	// 部屋ごとのサブレベル
+	TMap<FIntPoint, TSoftObjectPtr<UWorld>> CellLevels;
+
+	// 読み込んだ部屋のストリーミングレベル
+	UPROPERTY(Transient)
+	TMap<FIntPoint, TObjectPtr<ULevelStreamingDynamic>> LoadedCells;
+
+	// ギミックを登録済みのストリーミングレベル
+	TSet<TWeakObjectPtr<ULevelStreamingDynamic>> RegisteredLevels;
+
+	// 現在の部屋と、直前に移動した方向（各成分 -1～1）
+	FIntPoint CurrentGrid = FIntPoint::ZeroValue;
+	FIntPoint MoveDirection = FIntPoint::ZeroValue;
+	bool bHasGrid = false;
+
+	// 現在の部屋を求めたグリッドサイズ
+	FVector2D CurrentGridSize = FVector2D::ZeroVector;
+};
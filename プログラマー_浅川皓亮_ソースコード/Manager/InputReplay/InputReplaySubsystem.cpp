@@ -0,0 +1,300 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Manager/InputReplaySubsystem.h"
+#include "Player/PlayerCharacter.h"
+#include "InputActionValue.h"
+#include "Misc/App.h"
+#include "Misc/CommandLine.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+#include "HAL/PlatformMisc.h"
+
+namespace
+{
+	// 記録時の固定ステップ（秒）
+	static constexpr float RECORD_FIXED_DELTA_TIME = 1.0f / 60.0f;
+
+	// 入力値の種類ごとに量子化する軸（ボタンはX軸のみ）
+	FIntPoint QuantizeValue(const FInputActionValue& Value)
+	{
+		const FVector Axis = Value.Get<FVector>();
+		return FIntPoint(InputTrace::Quantize(Axis.X), InputTrace::Quantize(Axis.Y));
+	}
+
+	// 記録した軸を入力の種類に合った値に戻す
+	FInputActionValue MakeValue(InputTrace::EChannel Channel, int32 X, int32 Y)
+	{
+		switch (Channel)
+		{
+		case InputTrace::EChannel::Move:
+		case InputTrace::EChannel::StickMove:
+			return FInputActionValue(FVector2D(InputTrace::Dequantize(X), InputTrace::Dequantize(Y)));
+		case InputTrace::EChannel::MouseScroll:
+			return FInputActionValue(InputTrace::Dequantize(X));
+		default:
+			return FInputActionValue(X != 0);
+		}
+	}
+}
+
+// 処理の流れ:
+// 1. コマンドラインで再生が指定されていれば再生を開始
+// 2. 記録が指定されていれば記録を開始
+void UInputReplaySubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	FString Path;
+	if (FParse::Value(FCommandLine::Get(), TEXT("-InputReplay="), Path))
+	{
+		bExitOnReplayEnd = FParse::Param(FCommandLine::Get(), TEXT("InputReplayExit"));
+		StartReplay(Path);
+	}
+	else if (FParse::Value(FCommandLine::Get(), TEXT("-InputRecord="), Path))
+	{
+		StartRecording(Path);
+	}
+}
+
+void UInputReplaySubsystem::Deinitialize()
+{
+	if (IsRecording())
+	{
+		StopRecording();
+	}
+	else if (IsReplaying())
+	{
+		FinishReplay();
+	}
+
+	Super::Deinitialize();
+}
+
+// =======================
+// 記録
+// =======================
+
+void UInputReplaySubsystem::StartRecording(const FString& Path)
+{
+	Trace = InputTrace::FTrace();
+	Trace.FixedDeltaTime = RECORD_FIXED_DELTA_TIME;
+	PendingFrame = InputTrace::FFrame();
+	TracePath = Path;
+	Mode = EMode::Recording;
+
+	BeginFixedStep(Trace.FixedDeltaTime);
+}
+
+// 処理の流れ:
+// 1. 記録をバイト列に変換
+// 2. ファイルに保存し、固定ステップを戻す
+void UInputReplaySubsystem::StopRecording()
+{
+	if (!IsRecording())
+		return;
+
+	std::vector<uint8_t> Bytes;
+	InputTrace::Encode(Trace, Bytes);
+
+	const TArrayView<const uint8> View(Bytes.data(), static_cast<int32>(Bytes.size()));
+	if (!FFileHelper::SaveArrayToFile(View, *TracePath))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Failed to save input trace: %s"), *TracePath);
+	}
+	else
+	{
+		UE_LOG(LogTemp, Log, TEXT("Saved input trace: %s (%d frames, %d bytes)"),
+			*TracePath, static_cast<int32>(Trace.Frames.size()), View.Num());
+	}
+
+	Mode = EMode::Idle;
+	Trace = InputTrace::FTrace();
+	EndFixedStep();
+}
+
+// =======================
+// 再生
+// =======================
+
+// 処理の流れ:
+// 1. ファイルを読み込んで復元
+// 2. 記録時の固定ステップに切り替えて先頭から再生
+bool UInputReplaySubsystem::StartReplay(const FString& Path)
+{
+	TArray<uint8> Bytes;
+	if (!FFileHelper::LoadFileToArray(Bytes, *Path) ||
+		!InputTrace::Decode(Bytes.GetData(), Bytes.Num(), Trace))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Failed to load input trace: %s"), *Path);
+		return false;
+	}
+
+	TracePath = Path;
+	FrameIndex = 0;
+	MismatchCount = 0;
+	FirstMismatchFrame = INDEX_NONE;
+	Mode = EMode::Replaying;
+
+	BeginFixedStep(Trace.FixedDeltaTime);
+	return true;
+}
+
+void UInputReplaySubsystem::FinishReplay()
+{
+	UE_LOG(LogTemp, Log, TEXT("Input replay finished: %s frames=%d mismatches=%d first_mismatch=%d"),
+		*TracePath, FrameIndex, MismatchCount, FirstMismatchFrame);
+
+	Mode = EMode::Idle;
+	Trace = InputTrace::FTrace();
+	EndFixedStep();
+
+	if (bExitOnReplayEnd)
+	{
+		FPlatformMisc::RequestExitWithStatus(false, MismatchCount > 0 ? 1 : 0);
+	}
+}
+
+// =======================
+// 入力の受け渡し
+// =======================
+
+bool UInputReplaySubsystem::FilterInput(InputTrace::EChannel Channel, FInputActionValue& Value)
+{
+	if (bDispatching || Mode == EMode::Idle)
+		return true;
+
+	if (IsReplaying())
+		return false;
+
+	// 再生時と同じ値で処理するため、量子化した値に置き換えてから記録する
+	const FIntPoint Quantized = QuantizeValue(Value);
+	Value = MakeValue(Channel, Quantized.X, Quantized.Y);
+
+	InputTrace::FEvent Event;
+	Event.Channel = Channel;
+	Event.X = Quantized.X;
+	Event.Y = Quantized.Y;
+	PendingFrame.Events.push_back(Event);
+	return true;
+}
+
+// 処理の流れ:
+// 1. 記録・再生していなければ値をそのまま使う
+// 2. 再生中は記録した値に置き換える
+// 3. 記録中は再生時と同じ値で処理するため、量子化した値に置き換えてから記録する
+void UInputReplaySubsystem::FilterMouseDelta(float& DeltaX, float& DeltaY)
+{
+	if (Mode == EMode::Idle)
+		return;
+
+	if (IsReplaying())
+	{
+		if (FrameIndex < static_cast<int32>(Trace.Frames.size()))
+		{
+			const InputTrace::FFrame& Frame = Trace.Frames[FrameIndex];
+			DeltaX = InputTrace::Dequantize(Frame.MouseX);
+			DeltaY = InputTrace::Dequantize(Frame.MouseY);
+		}
+		return;
+	}
+
+	PendingFrame.MouseX = InputTrace::Quantize(DeltaX);
+	PendingFrame.MouseY = InputTrace::Quantize(DeltaY);
+	DeltaX = InputTrace::Dequantize(PendingFrame.MouseX);
+	DeltaY = InputTrace::Dequantize(PendingFrame.MouseY);
+}
+
+// 処理の流れ:
+// 1. 再生中でなければ何もしない（記録中の入力はTickの前に届いている）
+// 2. 最後まで再生したら終了
+// 3. このフレームの入力を記録時と同じ順でプレイヤーに流す
+void UInputReplaySubsystem::BeginPlayerFrame(APlayerCharacter* Player)
+{
+	if (!IsReplaying() || !Player)
+		return;
+
+	if (FrameIndex >= static_cast<int32>(Trace.Frames.size()))
+	{
+		FinishReplay();
+		return;
+	}
+
+	TGuardValue<bool> DispatchGuard(bDispatching, true);
+	for (const InputTrace::FEvent& Event : Trace.Frames[FrameIndex].Events)
+	{
+		const FInputActionValue Value = MakeValue(Event.Channel, Event.X, Event.Y);
+		switch (Event.Channel)
+		{
+		case InputTrace::EChannel::Move:        Player->Movement(Value);      break;
+		case InputTrace::EChannel::Jump:        Player->Jump(Value);          break;
+		case InputTrace::EChannel::Action:      Player->Action(Value);        break;
+		case InputTrace::EChannel::MouseScroll: Player->OnMouseScroll(Value); break;
+		case InputTrace::EChannel::StickMove:   Player->OnStickMove(Value);   break;
+		default: break;
+		}
+	}
+}
+
+// 処理の流れ:
+// 1. プレイヤーの状態ハッシュを求める
+// 2. 記録中はフレームを確定し、再生中は記録時のハッシュと比較する
+void UInputReplaySubsystem::EndPlayerFrame(APlayerCharacter* Player)
+{
+	if (Mode == EMode::Idle || !Player)
+		return;
+
+	const uint32 Hash = Player->ComputeReplayStateHash();
+
+	if (IsRecording())
+	{
+		PendingFrame.StateHash = Hash;
+		Trace.Frames.push_back(MoveTemp(PendingFrame));
+		PendingFrame = InputTrace::FFrame();
+		return;
+	}
+
+	if (FrameIndex >= static_cast<int32>(Trace.Frames.size()))
+		return;
+
+	if (Trace.Frames[FrameIndex].StateHash != Hash)
+	{
+		if (MismatchCount == 0)
+		{
+			FirstMismatchFrame = FrameIndex;
+			UE_LOG(LogTemp, Warning, TEXT("Input replay diverged at frame %d."), FrameIndex);
+		}
+		++MismatchCount;
+	}
+	++FrameIndex;
+}
+
+// 処理の流れ:
+// 1. 切り替え前の設定を保存（既に保存していれば最初の値を残す）
+// 2. 固定ステップに切り替える（0以下なら切り替えない）
+void UInputReplaySubsystem::BeginFixedStep(float DeltaTime)
+{
+	if (!bFixedStepSaved)
+	{
+		bPrevUseFixedTimeStep = FApp::UseFixedTimeStep();
+		PrevFixedDeltaTime = FApp::GetFixedDeltaTime();
+		bFixedStepSaved = true;
+	}
+
+	if (DeltaTime > 0.0f)
+	{
+		FApp::SetUseFixedTimeStep(true);
+		FApp::SetFixedDeltaTime(DeltaTime);
+	}
+}
+
+// 保存しておいた設定に戻す（-UseFixedTimeStep 等で元から固定ステップの場合もそのまま残る）
+void UInputReplaySubsystem::EndFixedStep()
+{
+	if (!bFixedStepSaved)
+		return;
+
+	FApp::SetUseFixedTimeStep(bPrevUseFixedTimeStep);
+	FApp::SetFixedDeltaTime(PrevFixedDeltaTime);
+	bFixedStepSaved = false;
+}
@@ -0,0 +1,116 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Logic/Input/InputTrace.h"
+#include "InputReplaySubsystem.generated.h"
+
+class APlayerCharacter;
+struct FInputActionValue;
+
+/**
+ * プレイヤー入力を固定ステップで記録・再生するワールドサブシステム
+ * 実際のプレイを計測用の再現可能な負荷として流し直すために使う
+ *
+ * 記録: -InputRecord=<ファイル>
+ * 再生: -InputReplay=<ファイル> [-InputReplayExit]
+ *   例) UnrealEditor-Cmd Pachio.uproject <マップ> -game -nullrhi -unattended -InputReplay=Saved/Replays/Run.pitr -InputReplayExit
+ *
+ * フレームの区切りは APlayerCharacter::Tick の開始・終了で、終了時の状態ハッシュを比べて再生のずれを検出する
+ */
+UCLASS()
+class PACHIO_API UInputReplaySubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+
+	/**
+	 * 記録を開始する（固定ステップに切り替える）
+	 * @param Path 保存先のファイル
+	 */
+	void StartRecording(const FString& Path);
+
+	// 記録を終了してファイルに保存する
+	void StopRecording();
+
+	/**
+	 * 記録したファイルの再生を開始する（記録時の固定ステップに切り替える）
+	 * @param Path 読み込むファイル
+	 * @return 読み込めた場合true
+	 */
+	bool StartReplay(const FString& Path);
+
+	bool IsRecording() const { return Mode == EMode::Recording; }
+	bool IsReplaying() const { return Mode == EMode::Replaying; }
+
+	/**
+	 * 入力を記録・再生に通す（入力処理の先頭で呼ぶ）
+	 * 記録中は量子化した値に置き換えて記録し、再生中は実際の入力を捨てる
+	 * @param Channel 入力の種類
+	 * @param Value 入力値（記録中は量子化後の値に置き換わる）
+	 * @return 入力を処理してよい場合true
+	 */
+	bool FilterInput(InputTrace::EChannel Channel, FInputActionValue& Value);
+
+	/**
+	 * Tick中に読み取るマウス移動量を記録・再生に通す
+	 * @param DeltaX 横方向の移動量（再生中は記録値に置き換わる）
+	 * @param DeltaY 縦方向の移動量（再生中は記録値に置き換わる）
+	 */
+	void FilterMouseDelta(float& DeltaX, float& DeltaY);
+
+	/** フレーム開始（再生中はこのフレームの入力を流す） @param Player 対象のプレイヤー */
+	void BeginPlayerFrame(APlayerCharacter* Player);
+
+	/** フレーム終了（状態ハッシュを記録・比較する） @param Player 対象のプレイヤー */
+	void EndPlayerFrame(APlayerCharacter* Player);
+
+private:
+	enum class EMode : uint8
+	{
+		Idle,
+		Recording,
+		Replaying,
+	};
+
+	/** 元の設定を保存して固定ステップに切り替える @param DeltaTime 固定ステップ（0以下なら切り替えない） */
+	void BeginFixedStep(float DeltaTime);
+
+	// 固定ステップを切り替える前の設定に戻す
+	void EndFixedStep();
+
+	// 再生を終了して結果を出力する
+	void FinishReplay();
+
+private:
+	EMode Mode = EMode::Idle;
+
+	InputTrace::FTrace Trace;
+
+	// 記録中のフレーム
+	InputTrace::FFrame PendingFrame;
+
+	// 再生中のフレーム番号とずれたフレーム数
+	int32 FrameIndex = 0;
+	int32 MismatchCount = 0;
+	int32 FirstMismatchFrame = INDEX_NONE;
+
+	// 記録・再生するファイル
+	FString TracePath;
+
+	// 再生した入力を流している間だけ true（FilterInput を素通しにする）
+	bool bDispatching = false;
+
+	// 再生終了時にゲームを終了するか
+	bool bExitOnReplayEnd = false;
+
+	// 記録・再生を始める前の固定ステップの設定
+	bool bFixedStepSaved = false;
+	bool bPrevUseFixedTimeStep = false;
+	double PrevFixedDeltaTime = 0.0;
+};
@@ -1,29 +1,25 @@
 #include "Manager/LevelManager.h"
+#include "Manager/GameServicesSubsystem.h"
 #include "Manager/ColorManager.h"
 #include "Manager/SaveManager.h"
 #include "Manager/WeatherEffectManager.h"
 #include "Kismet/GameplayStatics.h" 
 #include "UI/UIManager.h"
-#include "EngineUtils.h"
 #include "Engine/DataTable.h"
 #include "Sound/SoundManager.h"
 
 
-TWeakObjectPtr<ALevelManager> ALevelManager::Instance = nullptr;
-
 ALevelManager::ALevelManager()
 {
     PrimaryActorTick.bCanEverTick = true;
 }
 
 // 1. 親クラスのBeginPlayを呼び出し
-// 2. シングルトンインスタンスを設定
-// 3. 各種マネージャーを初期化
-// 4. テスト用のセーブデータを保存
+// 2. 各種マネージャーを初期化（通常はワールド開始時に UGameServicesSubsystem から初期化済み）
+// 3. テスト用のセーブデータを保存（内容が変わらなければ書き込まない）
 void ALevelManager::BeginPlay()
 {
     Super::BeginPlay();
-    Instance = this;
 
     InitializeComponents();
 
@@ -36,22 +32,40 @@ void ALevelManager::BeginPlay()
     USaveManager::SaveStageData(TEXT("Stage1"), SaveData);
 }
 
-// 1. 初期化済みフラグをチェック
-// 2. ColorManagerを生成して初期化
-// 3. SoundManagerを取得してBGMを再生
-// 4. UIManagerを生成して初期化
+// 1. 初期化済みフラグをチェックして立てる
+// 2. UGameServicesSubsystem に自身を登録
+// 3. ColorManagerを生成して初期化・登録
+// 4. SoundManagerを取得・登録してBGMを再生（初期化でColorManagerを参照するため後）
+// 5. UIManagerを生成・登録して初期化
 void ALevelManager::InitializeComponents()
 {
     if (bInitialize)
         return;
 
+    // 初期化中に各マネージャーから取得されても再び初期化しないよう先に立てる
+    bInitialize = true;
+
+    UGameServicesSubsystem* Services = UGameServicesSubsystem::Get(this);
+    if (Services)
+    {
+        Services->RegisterLevelManager(this);
+    }
+
     if (ColorManagerClass)
     {
         ColorManager = NewObject<UColorManager>(this, ColorManagerClass);
         ColorManager->Init();
     }
+    if (Services)
+    {
+        Services->RegisterColorManager(this, ColorManager);
+    }
 
     SoundManager = GetComponentByClass<USoundManager>();
+    if (Services)
+    {
+        Services->RegisterSoundManager(this, SoundManager);
+    }
     if (SoundManager)
     {
         SoundManager->Init();
@@ -62,12 +76,25 @@ void ALevelManager::InitializeComponents()
     {
         UIManager = NewObject<UUIManager>(this, UIManagerClass);
     }
+    if (Services)
+    {
+        Services->RegisterUIManager(this, UIManager);
+    }
     if (UIManager)
     {
         UIManager->Init(this);
     }
+}
 
-    bInitialize = true;
+// ワールドから外れる時にマネージャーの登録を解除
+void ALevelManager::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    if (UGameServicesSubsystem* Services = UGameServicesSubsystem::Get(this))
+    {
+        Services->UnregisterLevelManager(this);
+    }
+
+    Super::EndPlay(EndPlayReason);
 }
 
 void ALevelManager::Tick(float DeltaTime)
@@ -75,31 +102,12 @@ void ALevelManager::Tick(float DeltaTime)
     Super::Tick(DeltaTime);
 }
 
-// 1. インスタンスが有効かチェック
-// 2. 無効な場合はワールドから検索
-// 3. 見つからない場合は新規生成
-// 4. 初期化処理を実行してインスタンスを返す
+// ワールドごとに UGameServicesSubsystem が保持しているLevelManagerを返す
+// （アクターの検索や生成は行わない）
 ALevelManager* ALevelManager::GetInstance(UObject* WorldContext)
 {
-    if (!Instance.IsValid())
-    {
-        UWorld* World = WorldContext ? WorldContext->GetWorld() : nullptr;
-        if (!World)
-            return nullptr;
-
-        for (TActorIterator<ALevelManager> It(World); It; ++It)
-        {
-            Instance = *It;
-            Instance->InitializeComponents();
-            return *It;
-        }
-
-        ALevelManager* NewInstance = World->SpawnActor<ALevelManager>();
-        Instance = NewInstance;
-        Instance->InitializeComponents();
-    }
-
-    return Instance.Get();
+    const UGameServicesSubsystem* Services = UGameServicesSubsystem::Get(WorldContext);
+    return Services ? Services->GetLevelManager() : nullptr;
 }
 
 // 1. SoundManagerの有効性を確認
@@ -26,11 +26,15 @@ class PACHIO_API ALevelManager : public AActor
 {
     GENERATED_BODY()
 
+    // 最初の取得時に InitializeComponents を呼ぶため
+    friend class UGameServicesSubsystem;
+
 public:
     ALevelManager();
 
 protected:
     virtual void BeginPlay() override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 public:
     /**
@@ -63,9 +67,10 @@ public:
     TScriptInterface<ISoundable> GetSoundManager() const;
 
     /**
-     * グローバルから取得できるLevelManagerのシングルトンインスタンス
+     * ワールドのLevelManagerを取得する（Blueprint用）
+     * C++からは UGameServicesSubsystem の各マネージャーを直接取得すること
      * @param WorldContext ワールドコンテキスト
-     * @return LevelManagerのインスタンス
+     * @return LevelManagerのインスタンス（無い場合は nullptr）
      */
     UFUNCTION(BlueprintCallable, Category = "LevelManager")
     static ALevelManager* GetInstance(UObject* WorldContext);
@@ -128,7 +133,4 @@ private:
     // カラーマネージャーのインスタンス
     UPROPERTY()
     TObjectPtr<UColorManager> ColorManager;
-
-    // シングルトンアクセス用の静的インスタンス
-    static TWeakObjectPtr<ALevelManager> Instance;
 };
\ No newline at end of file
@@ -0,0 +1,559 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Manager/PerfScenarioSubsystem.h"
+#include "Manager/GameServicesSubsystem.h"
+#include "Manager/ColorManager.h"
+#include "Logic/ColorManager/ColorTargetRegistry.h"
+#include "Manager/PhysicsBatchSubsystem.h"
+#include "Manager/KinematicPlatformSubsystem.h"
+#include "Components/BoxComponent.h"
+#include "Components/PhysicsCalculator.h"
+#include "Objects/Color/ColorReactiveObject.h"
+#include "Objects/Color/ColorReactiveBeltConveyor.h"
+#include "Objects/MovingObject.h"
+#include "Engine/World.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformMemory.h"
+#include "Misc/CommandLine.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+#include "UObject/UObjectArray.h"
+
+namespace
+{
+	// 生成直後の安定待ち（計測に含めない）フレーム数
+	static constexpr int32 WARMUP_FRAMES = 60;
+
+	// ワールド色を変える間隔（フレーム）
+	static constexpr int32 COLOR_CHANGE_INTERVAL = 30;
+
+	// 色を変えるたびに進める色相（度）
+	static constexpr float COLOR_HUE_STEP = 37.0f;
+
+	// 格子状に並べる間隔と、ボディを落とす高さ
+	static constexpr float SPAWN_SPACING = 300.0f;
+	static constexpr float BODY_SPAWN_HEIGHT = 200.0f;
+
+	// コンベア1台の上に置くボディ数と、その間隔
+	static constexpr int32 BODIES_PER_CONVEYOR = 4;
+	static constexpr float CONVEYOR_BODY_SPACING = 50.0f;
+
+	// 自前物理のボディの大きさ（半分）
+	static constexpr float BODY_HALF_EXTENT = 20.0f;
+
+	// ボディを受け止める床の厚み・奥行き（半分）
+	static constexpr float SURFACE_HALF_THICKNESS = 10.0f;
+	static constexpr float SURFACE_HALF_DEPTH = 200.0f;
+
+	static constexpr double BYTES_PER_MB = 1024.0 * 1024.0;
+
+	static const TCHAR* SUMMARY_HEADER =
+		TEXT("scenario,count,frames,avg_frame_ms,p95_frame_ms,avg_physics_ms,avg_platform_ms,avg_color_ms,uobject_delta,memory_delta_mb");
+
+	// 集計の1行分
+	struct FPerfSummary
+	{
+		FString Scenario;
+		int32 Count = 0;
+		TArray<double> Values;
+	};
+
+	bool ParseSummaryLine(const FString& Line, FPerfSummary& OutSummary)
+	{
+		TArray<FString> Columns;
+		Line.ParseIntoArray(Columns, TEXT(","));
+		if (Columns.Num() < 4 || !Columns[1].IsNumeric())
+			return false;
+
+		OutSummary.Scenario = Columns[0];
+		OutSummary.Count = FCString::Atoi(*Columns[1]);
+		OutSummary.Values.Reset();
+		for (int32 i = 2; i < Columns.Num(); ++i)
+		{
+			OutSummary.Values.Add(FCString::Atod(*Columns[i]));
+		}
+		return true;
+	}
+
+	// Pachio.Perf.Run <種類> [数] [フレーム数] [基準ファイル]
+	static FAutoConsoleCommandWithWorldAndArgs PerfRunCommand(
+		TEXT("Pachio.Perf.Run"),
+		TEXT("Run a perf scenario: Pachio.Perf.Run <Color|Physics|Conveyor|Platform> [Count] [Frames] [BaselineCsv]"),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+		{
+			UPerfScenarioSubsystem* Runner = World ? World->GetSubsystem<UPerfScenarioSubsystem>() : nullptr;
+			if (!Runner || Args.Num() < 1)
+				return;
+
+			FPerfScenarioSettings Settings;
+			if (!UPerfScenarioSubsystem::ParseScenario(Args[0], Settings.Scenario))
+				return;
+
+			if (Args.Num() > 1) Settings.Count = FMath::Max(1, FCString::Atoi(*Args[1]));
+			if (Args.Num() > 2) Settings.Frames = FMath::Max(1, FCString::Atoi(*Args[2]));
+			if (Args.Num() > 3) Settings.BaselinePath = Args[3];
+
+			Runner->StartScenario(Settings);
+		}));
+}
+
+// 処理の流れ:
+// 1. 起動引数でシナリオが指定されていなければ何もしない
+// 2. 数・フレーム数・クラス・基準ファイルを読み込んで開始
+void UPerfScenarioSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	FString ScenarioName;
+	if (!FParse::Value(FCommandLine::Get(), TEXT("-PerfScenario="), ScenarioName))
+		return;
+
+	FPerfScenarioSettings NewSettings;
+	if (!ParseScenario(ScenarioName, NewSettings.Scenario))
+		return;
+
+	FParse::Value(FCommandLine::Get(), TEXT("-PerfCount="), NewSettings.Count);
+	FParse::Value(FCommandLine::Get(), TEXT("-PerfFrames="), NewSettings.Frames);
+	FParse::Value(FCommandLine::Get(), TEXT("-PerfBaseline="), NewSettings.BaselinePath);
+
+	FString ClassPath;
+	if (FParse::Value(FCommandLine::Get(), TEXT("-PerfClass="), ClassPath))
+	{
+		NewSettings.ActorClass = LoadClass<AActor>(nullptr, *ClassPath);
+	}
+
+	bExitOnFinish = FParse::Param(FCommandLine::Get(), TEXT("PerfExit"));
+	StartScenario(NewSettings);
+}
+
+void UPerfScenarioSubsystem::Deinitialize()
+{
+	SpawnedActors.Empty();
+	Samples.Empty();
+	bRunning = false;
+
+	Super::Deinitialize();
+}
+
+TStatId UPerfScenarioSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UPerfScenarioSubsystem, STATGROUP_Tickables);
+}
+
+bool UPerfScenarioSubsystem::ParseScenario(const FString& Name, EPerfScenario& OutScenario)
+{
+	static const TPair<const TCHAR*, EPerfScenario> Names[] =
+	{
+		{ TEXT("Color"), EPerfScenario::Color },
+		{ TEXT("Physics"), EPerfScenario::Physics },
+		{ TEXT("Conveyor"), EPerfScenario::Conveyor },
+		{ TEXT("Platform"), EPerfScenario::Platform },
+	};
+
+	for (const TPair<const TCHAR*, EPerfScenario>& Pair : Names)
+	{
+		if (Name.Equals(Pair.Key, ESearchCase::IgnoreCase))
+		{
+			OutScenario = Pair.Value;
+			return true;
+		}
+	}
+
+	UE_LOG(LogTemp, Warning, TEXT("Unknown perf scenario: %s"), *Name);
+	return false;
+}
+
+FString UPerfScenarioSubsystem::GetScenarioName() const
+{
+	switch (Settings.Scenario)
+	{
+	case EPerfScenario::Physics:  return TEXT("Physics");
+	case EPerfScenario::Conveyor: return TEXT("Conveyor");
+	case EPerfScenario::Platform: return TEXT("Platform");
+	default:                      return TEXT("Color");
+	}
+}
+
+// 処理の流れ:
+// 1. ColorManager と ColorTargetRegistry を取得
+// 2. 全モードの登録数を返す
+int32 UPerfScenarioSubsystem::GetNumColorTargets() const
+{
+	const UGameServicesSubsystem* Services = UGameServicesSubsystem::Get(this);
+	const UColorManager* ColorManager = Services ? Services->GetColorManager() : nullptr;
+	const UColorTargetRegistry* Registry = ColorManager ? ColorManager->GetColorTargetRegistry() : nullptr;
+	return Registry ? Registry->GetNumTargets() : INDEX_NONE;
+}
+
+// =======================
+// 実行
+// =======================
+
+// 処理の流れ:
+// 1. 実行中なら何もしない
+// 2. 設定を保持し、色ターゲットの数を控えてからアクターを生成
+// 3. 計測値をリセットしてTickを開始
+bool UPerfScenarioSubsystem::StartScenario(const FPerfScenarioSettings& InSettings)
+{
+	if (bRunning || !GetWorld())
+		return false;
+
+	Settings = InSettings;
+	Settings.Count = FMath::Max(1, Settings.Count);
+	Settings.Frames = FMath::Max(1, Settings.Frames);
+
+	ColorTargetsBeforeSpawn = GetNumColorTargets();
+	SpawnActors();
+
+	Samples.Reset(Settings.Frames);
+	FrameIndex = 0;
+	ColorChangeCount = 0;
+	LastFrameTime = FPlatformTime::Seconds();
+	bRunning = true;
+
+	UE_LOG(LogTemp, Log, TEXT("Perf scenario started: %s count=%d frames=%d"),
+		*GetScenarioName(), Settings.Count, Settings.Frames);
+	return true;
+}
+
+// 処理の流れ:
+// 1. 前フレームからの経過時間と各サブシステムの時間を取得
+// 2. 一定間隔でワールド色を変える
+// 3. 安定待ちを過ぎていれば計測値を記録
+// 4. 指定フレーム数に達したら終了
+void UPerfScenarioSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	const double Now = FPlatformTime::Seconds();
+	const double FrameSeconds = Now - LastFrameTime;
+	LastFrameTime = Now;
+
+	UPhysicsBatchSubsystem* PhysicsBatch = GetWorld()->GetSubsystem<UPhysicsBatchSubsystem>();
+	UKinematicPlatformSubsystem* Platforms = GetWorld()->GetSubsystem<UKinematicPlatformSubsystem>();
+	const double PhysicsSeconds = PhysicsBatch ? PhysicsBatch->ConsumeTickSeconds() : 0.0;
+	const double PlatformSeconds = Platforms ? Platforms->ConsumeTickSeconds() : 0.0;
+
+	const double ColorSeconds = (FrameIndex % COLOR_CHANGE_INTERVAL == 0) ? ApplyScriptedColor() : 0.0;
+
+	if (FrameIndex >= WARMUP_FRAMES)
+	{
+		FPerfFrameSample& Sample = Samples.AddDefaulted_GetRef();
+		Sample.FrameMs = static_cast<float>(FrameSeconds * 1000.0);
+		Sample.PhysicsMs = static_cast<float>(PhysicsSeconds * 1000.0);
+		Sample.PlatformMs = static_cast<float>(PlatformSeconds * 1000.0);
+		Sample.ColorMs = static_cast<float>(ColorSeconds * 1000.0);
+		Sample.UObjectCount = GUObjectArray.GetObjectArrayNumMinusAvailable();
+		Sample.UsedMemoryMB = static_cast<float>(FPlatformMemory::GetStats().UsedPhysical / BYTES_PER_MB);
+	}
+
+	++FrameIndex;
+	if (Samples.Num() >= Settings.Frames)
+	{
+		FinishScenario();
+	}
+}
+
+// =======================
+// 生成
+// =======================
+
+// 処理の流れ:
+// 1. シナリオごとの既定クラスを決める（指定があればそちらを使う）
+// 2. 原点を中心に格子状に並べて生成
+// 3. 自前物理のボディは格子の下に床を置いてから落とす
+// 4. コンベアは下に受け面を置き、その上に自前物理のボディを落とす
+void UPerfScenarioSubsystem::SpawnActors()
+{
+	SpawnedActors.Reset();
+
+	TSubclassOf<AActor> SpawnClass = Settings.ActorClass;
+	if (!SpawnClass)
+	{
+		switch (Settings.Scenario)
+		{
+		case EPerfScenario::Conveyor: SpawnClass = AColorReactiveBeltConveyor::StaticClass(); break;
+		case EPerfScenario::Platform: SpawnClass = AMovingObject::StaticClass(); break;
+		case EPerfScenario::Color:    SpawnClass = AColorReactiveObject::StaticClass(); break;
+		default: break;
+		}
+	}
+
+	const int32 Columns = FMath::Max(1, FMath::CeilToInt(FMath::Sqrt(static_cast<float>(Settings.Count))));
+	const float HalfWidth = Columns * SPAWN_SPACING * 0.5f;
+
+	FActorSpawnParameters Params;
+	Params.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	// 最下段（Z=0）のボディが少し落ちてから着地する高さに床を置く
+	if (Settings.Scenario == EPerfScenario::Physics)
+	{
+		const FVector FloorCenter(0.0f, -SPAWN_SPACING * 0.5f, -SPAWN_SPACING * 0.5f - SURFACE_HALF_THICKNESS);
+		SpawnedActors.Add(SpawnStaticSurface(FloorCenter, FVector(SURFACE_HALF_DEPTH, HalfWidth, SURFACE_HALF_THICKNESS)));
+	}
+
+	for (int32 i = 0; i < Settings.Count; ++i)
+	{
+		// 横スクロールのため YZ 平面に並べる
+		const FVector Location(0.0f, (i % Columns) * SPAWN_SPACING - HalfWidth, (i / Columns) * SPAWN_SPACING);
+
+		if (Settings.Scenario == EPerfScenario::Physics && !Settings.ActorClass)
+		{
+			SpawnedActors.Add(SpawnPhysicsBody(Location));
+			continue;
+		}
+
+		AActor* Actor = GetWorld()->SpawnActor<AActor>(SpawnClass, Location, FRotator::ZeroRotator, Params);
+		if (!Actor)
+			continue;
+
+		SpawnedActors.Add(Actor);
+
+		if (Settings.Scenario == EPerfScenario::Conveyor)
+		{
+			// コンベアのボックスは重なり判定のみのため、その底面に受け面を置いてボディが力場の中に留まるようにする
+			FVector Origin, Extent;
+			Actor->GetActorBounds(false, Origin, Extent);
+			const float SurfaceTop = Extent.IsZero() ? Location.Z : Origin.Z - Extent.Z;
+			const float SurfaceHalfWidth = FMath::Max(Extent.Y, BODIES_PER_CONVEYOR * CONVEYOR_BODY_SPACING * 0.5f + BODY_HALF_EXTENT);
+			SpawnedActors.Add(SpawnStaticSurface(
+				FVector(Location.X, Location.Y, SurfaceTop - SURFACE_HALF_THICKNESS),
+				FVector(SURFACE_HALF_DEPTH, SurfaceHalfWidth, SURFACE_HALF_THICKNESS)));
+
+			for (int32 Body = 0; Body < BODIES_PER_CONVEYOR; ++Body)
+			{
+				const FVector Offset(0.0f, (Body - (BODIES_PER_CONVEYOR - 1) * 0.5f) * CONVEYOR_BODY_SPACING, BODY_SPAWN_HEIGHT);
+				SpawnedActors.Add(SpawnPhysicsBody(Location + Offset));
+			}
+		}
+	}
+
+	SpawnedActors.RemoveAll([](const TObjectPtr<AActor>& Actor) { return Actor == nullptr; });
+}
+
+// 処理の流れ:
+// 1. 空のアクターを生成し、ボックスをルートに設定
+// 2. 自前物理コンポーネントを追加して重力を有効化
+AActor* UPerfScenarioSubsystem::SpawnPhysicsBody(const FVector& Location)
+{
+	FActorSpawnParameters Params;
+	Params.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	AActor* Actor = GetWorld()->SpawnActor<AActor>(AActor::StaticClass(), Location, FRotator::ZeroRotator, Params);
+	if (!Actor)
+		return nullptr;
+
+	UBoxComponent* Box = NewObject<UBoxComponent>(Actor, TEXT("Box"));
+	Box->SetBoxExtent(FVector(BODY_HALF_EXTENT));
+	Box->SetCollisionProfileName(TEXT("BlockAllDynamic"));
+	Actor->SetRootComponent(Box);
+	Box->RegisterComponent();
+	Box->SetWorldLocation(Location);
+
+	UPhysicsCalculator* Physics = NewObject<UPhysicsCalculator>(Actor, TEXT("Physics"));
+	Physics->RegisterComponent();
+	Physics->SetGravityScale(true, 50.0f);
+
+	return Actor;
+}
+
+// 処理の流れ:
+// 1. 空のアクターを生成
+// 2. 全てを遮る静的なボックスをルートに設定（ボディの着地先になる）
+AActor* UPerfScenarioSubsystem::SpawnStaticSurface(const FVector& Center, const FVector& Extent)
+{
+	FActorSpawnParameters Params;
+	Params.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	AActor* Actor = GetWorld()->SpawnActor<AActor>(AActor::StaticClass(), Center, FRotator::ZeroRotator, Params);
+	if (!Actor)
+		return nullptr;
+
+	UBoxComponent* Box = NewObject<UBoxComponent>(Actor, TEXT("Surface"));
+	Box->SetMobility(EComponentMobility::Static);
+	Box->SetBoxExtent(Extent);
+	Box->SetCollisionProfileName(TEXT("BlockAll"));
+	Box->SetWorldLocation(Center);
+	Actor->SetRootComponent(Box);
+	Box->RegisterComponent();
+
+	return Actor;
+}
+
+// 処理の流れ:
+// 1. ColorManager を取得
+// 2. 色相を進めた色をワールド色として適用し、かかった時間を返す
+double UPerfScenarioSubsystem::ApplyScriptedColor()
+{
+	const UGameServicesSubsystem* Services = UGameServicesSubsystem::Get(this);
+	UColorManager* ColorManager = Services ? Services->GetColorManager() : nullptr;
+	if (!ColorManager)
+		return 0.0;
+
+	const float Hue = FMath::Fmod(ColorChangeCount * COLOR_HUE_STEP, 360.0f);
+	const FLinearColor Color = FLinearColor(Hue, 1.0f, 1.0f).HSVToLinearRGB();
+	++ColorChangeCount;
+
+	const double StartTime = FPlatformTime::Seconds();
+	ColorManager->ApplyColor(Color, EColorTargetType::WorldColor);
+	return FPlatformTime::Seconds() - StartTime;
+}
+
+// =======================
+// 結果の出力
+// =======================
+
+// 処理の流れ:
+// 1. フレームごとの計測値と集計を書き出す
+// 2. 生成したアクターを破棄（色ターゲットは各アクターの EndPlay で登録解除される）
+// 3. 色ターゲットの登録が残っていれば警告（次のシナリオの色の計測が膨らむため）
+// 4. 指定があればゲームを終了
+void UPerfScenarioSubsystem::FinishScenario()
+{
+	bRunning = false;
+
+	const FString Directory = FPaths::ProfilingDir() / TEXT("PerfScenarios");
+	IFileManager::Get().MakeDirectory(*Directory, true);
+
+	WriteFrameCsv(Directory);
+	WriteSummary(Directory);
+
+	for (AActor* Actor : SpawnedActors)
+	{
+		if (IsValid(Actor))
+		{
+			Actor->Destroy();
+		}
+	}
+	SpawnedActors.Reset();
+
+	const int32 ColorTargetsAfterDestroy = GetNumColorTargets();
+	if (ColorTargetsAfterDestroy != ColorTargetsBeforeSpawn)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Perf scenario %s left %d color targets registered (before spawn: %d)"),
+			*GetScenarioName(), ColorTargetsAfterDestroy, ColorTargetsBeforeSpawn);
+	}
+
+	if (bExitOnFinish)
+	{
+		FPlatformMisc::RequestExit(false);
+	}
+}
+
+void UPerfScenarioSubsystem::WriteFrameCsv(const FString& Directory) const
+{
+	FString Csv = TEXT("frame,frame_ms,physics_ms,platform_ms,color_ms,uobjects,used_mb\n");
+	for (int32 i = 0; i < Samples.Num(); ++i)
+	{
+		const FPerfFrameSample& Sample = Samples[i];
+		Csv += FString::Printf(TEXT("%d,%.3f,%.3f,%.3f,%.3f,%d,%.1f\n"),
+			i, Sample.FrameMs, Sample.PhysicsMs, Sample.PlatformMs, Sample.ColorMs, Sample.UObjectCount, Sample.UsedMemoryMB);
+	}
+
+	const FString Path = Directory / FString::Printf(TEXT("%s_%d.csv"), *GetScenarioName(), Settings.Count);
+	FFileHelper::SaveStringToFile(Csv, *Path);
+}
+
+// 処理の流れ:
+// 1. 平均・95パーセンタイル・UObject数とメモリの増減を求める
+// 2. Summary.csv に1行追記（無ければ見出しを付けて作成）
+// 3. 基準ファイルに同じシナリオ・数の行があれば差分をログと CSV に出力
+void UPerfScenarioSubsystem::WriteSummary(const FString& Directory) const
+{
+	if (Samples.Num() == 0)
+		return;
+
+	TArray<float> FrameTimes;
+	double FrameSum = 0.0, PhysicsSum = 0.0, PlatformSum = 0.0, ColorSum = 0.0;
+	for (const FPerfFrameSample& Sample : Samples)
+	{
+		FrameTimes.Add(Sample.FrameMs);
+		FrameSum += Sample.FrameMs;
+		PhysicsSum += Sample.PhysicsMs;
+		PlatformSum += Sample.PlatformMs;
+		ColorSum += Sample.ColorMs;
+	}
+	FrameTimes.Sort();
+
+	const double Num = Samples.Num();
+	FPerfSummary Current;
+	Current.Scenario = GetScenarioName();
+	Current.Count = Settings.Count;
+	Current.Values =
+	{
+		Num,
+		FrameSum / Num,
+		FrameTimes[FMath::Min(FMath::FloorToInt(Num * 0.95), Samples.Num() - 1)],
+		PhysicsSum / Num,
+		PlatformSum / Num,
+		ColorSum / Num,
+		static_cast<double>(Samples.Last().UObjectCount - Samples[0].UObjectCount),
+		Samples.Last().UsedMemoryMB - Samples[0].UsedMemoryMB,
+	};
+
+	FString Line = FString::Printf(TEXT("%s,%d"), *Current.Scenario, Current.Count);
+	for (const double Value : Current.Values)
+	{
+		Line += FString::Printf(TEXT(",%.3f"), Value);
+	}
+
+	const FString SummaryPath = Directory / TEXT("Summary.csv");
+	if (!IFileManager::Get().FileExists(*SummaryPath))
+	{
+		FFileHelper::SaveStringToFile(FString(SUMMARY_HEADER) + TEXT("\n"), *SummaryPath);
+	}
+	FFileHelper::SaveStringToFile(Line + TEXT("\n"), *SummaryPath,
+		FFileHelper::EEncodingOptions::AutoDetect, &IFileManager::Get(), FILEWRITE_Append);
+
+	UE_LOG(LogTemp, Log, TEXT("Perf scenario finished: %s"), *Line);
+
+	if (Settings.BaselinePath.IsEmpty())
+		return;
+
+	TArray<FString> BaselineLines;
+	if (!FFileHelper::LoadFileToStringArray(BaselineLines, *Settings.BaselinePath))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Failed to load perf baseline: %s"), *Settings.BaselinePath);
+		return;
+	}
+
+	// 同じシナリオ・数の最後の行を基準にする
+	FPerfSummary Baseline;
+	bool bFound = false;
+	for (const FString& BaselineLine : BaselineLines)
+	{
+		FPerfSummary Parsed;
+		if (ParseSummaryLine(BaselineLine, Parsed) && Parsed.Scenario == Current.Scenario && Parsed.Count == Current.Count)
+		{
+			Baseline = MoveTemp(Parsed);
+			bFound = true;
+		}
+	}
+	if (!bFound)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("No baseline row for %s count=%d"), *Current.Scenario, Current.Count);
+		return;
+	}
+
+	TArray<FString> ColumnNames;
+	FString(SUMMARY_HEADER).ParseIntoArray(ColumnNames, TEXT(","));
+
+	FString Compare = TEXT("metric,baseline,current,delta_pct\n");
+	const int32 NumValues = FMath::Min(Baseline.Values.Num(), Current.Values.Num());
+	for (int32 i = 0; i < NumValues; ++i)
+	{
+		const double Base = Baseline.Values[i];
+		const double Value = Current.Values[i];
+		const double DeltaPct = FMath::IsNearlyZero(Base) ? 0.0 : (Value - Base) / Base * 100.0;
+		const FString& Metric = ColumnNames.IsValidIndex(i + 2) ? ColumnNames[i + 2] : FString();
+
+		Compare += FString::Printf(TEXT("%s,%.3f,%.3f,%.1f\n"), *Metric, Base, Value, DeltaPct);
+		UE_LOG(LogTemp, Log, TEXT("  %s: %.3f -> %.3f (%+.1f%%)"), *Metric, Base, Value, DeltaPct);
+	}
+
+	const FString ComparePath = Directory / FString::Printf(TEXT("%s_%d_vs_baseline.csv"), *Current.Scenario, Current.Count);
+	FFileHelper::SaveStringToFile(Compare, *ComparePath);
+}
@@ -0,0 +1,156 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "PerfScenarioSubsystem.generated.h"
+
+/**
+ * 計測シナリオの種類
+ */
+enum class EPerfScenario : uint8
+{
+	Color,		// 色に反応するオブジェクト
+	Physics,	// 自前物理のボディ
+	Conveyor,	// ベルトコンベアとその上のボディ
+	Platform,	// 動く足場
+};
+
+/**
+ * 計測シナリオの設定
+ */
+struct FPerfScenarioSettings
+{
+	EPerfScenario Scenario = EPerfScenario::Color;
+
+	// 生成する数
+	int32 Count = 100;
+
+	// 計測するフレーム数（生成直後の安定待ちは含まない）
+	int32 Frames = 600;
+
+	// 比較する基準の集計ファイル（空なら比較しない）
+	FString BaselinePath;
+
+	// 生成するクラス（未指定ならシナリオごとの既定クラス）
+	TSubclassOf<AActor> ActorClass;
+};
+
+/**
+ * 1フレーム分の計測値
+ */
+struct FPerfFrameSample
+{
+	float FrameMs = 0.0f;
+	float PhysicsMs = 0.0f;
+	float PlatformMs = 0.0f;
+	float ColorMs = 0.0f;
+	int32 UObjectCount = 0;
+	float UsedMemoryMB = 0.0f;
+};
+
+/**
+ * 色・自前物理・ギミックの負荷をエディタ無しで計測するワールドサブシステム
+ * 指定数のアクターを生成し、一定間隔で UColorManager::ApplyColor を呼びながら
+ * フレームごとの時間・サブシステムごとの時間・UObject数とメモリ使用量を CSV に書き出す
+ *
+ * コンソール: Pachio.Perf.Run <Color|Physics|Conveyor|Platform> [数] [フレーム数] [基準ファイル]
+ * 起動引数:   -PerfScenario=<種類> -PerfCount=<数> -PerfFrames=<フレーム数> [-PerfClass=<クラスパス>] [-PerfBaseline=<ファイル>] [-PerfExit]
+ *   例) UnrealEditor-Cmd Pachio.uproject <マップ> -game -nullrhi -unattended -PerfScenario=Physics -PerfCount=1000 -PerfExit
+ *
+ * 結果は Saved/Profiling/PerfScenarios/ に、フレームごとの <種類>_<数>.csv と集計の Summary.csv を出力する
+ */
+UCLASS()
+class PACHIO_API UPerfScenarioSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	// 計測中だけTickする
+	virtual ETickableTickType GetTickableTickType() const override { return ETickableTickType::Conditional; }
+	virtual bool IsTickable() const override { return bRunning; }
+
+	/**
+	 * シナリオを開始する（実行中なら何もしない）
+	 * @param InSettings シナリオの設定
+	 * @return 開始できた場合true
+	 */
+	bool StartScenario(const FPerfScenarioSettings& InSettings);
+
+	bool IsRunning() const { return bRunning; }
+
+	/**
+	 * シナリオ名から種類を求める
+	 * @param Name シナリオ名（大文字小文字は区別しない）
+	 * @param OutScenario 求めた種類
+	 * @return 一致する種類があった場合true
+	 */
+	static bool ParseScenario(const FString& Name, EPerfScenario& OutScenario);
+
+private:
+	// シナリオのアクターを格子状に生成する
+	void SpawnActors();
+
+	/** 自前物理のボディを持つアクターを生成する @param Location 生成位置 */
+	AActor* SpawnPhysicsBody(const FVector& Location);
+
+	/**
+	 * ボディを受け止める静的な床を生成する
+	 * @param Center 中心位置
+	 * @param Extent 大きさ（半分）
+	 */
+	AActor* SpawnStaticSurface(const FVector& Center, const FVector& Extent);
+
+	// 一定間隔でワールド色を変える（かかった時間を返す）
+	double ApplyScriptedColor();
+
+	// 計測を終えて結果を書き出し、生成したアクターを破棄する
+	void FinishScenario();
+
+	/** フレームごとの計測値を書き出す @param Directory 出力先 */
+	void WriteFrameCsv(const FString& Directory) const;
+
+	/**
+	 * 集計を書き出し、基準があれば比較する
+	 * @param Directory 出力先
+	 */
+	void WriteSummary(const FString& Directory) const;
+
+	// シナリオ名（ファイル名・集計に使う）
+	FString GetScenarioName() const;
+
+	// ColorManager に登録されている色ターゲットの数（ColorManager が無ければ INDEX_NONE）
+	int32 GetNumColorTargets() const;
+
+private:
+	FPerfScenarioSettings Settings;
+
+	// 生成したアクター
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<AActor>> SpawnedActors;
+
+	TArray<FPerfFrameSample> Samples;
+
+	// 安定待ちを含めた経過フレーム数
+	int32 FrameIndex = 0;
+
+	// 前フレームの時刻
+	double LastFrameTime = 0.0;
+
+	// 色を変えた回数（色相を進めるのに使う）
+	int32 ColorChangeCount = 0;
+
+	// 生成前の色ターゲットの数（破棄後に登録が残っていないかの確認に使う）
+	int32 ColorTargetsBeforeSpawn = INDEX_NONE;
+
+	bool bRunning = false;
+
+	// 終了時にゲームを終了するか
+	bool bExitOnFinish = false;
+};
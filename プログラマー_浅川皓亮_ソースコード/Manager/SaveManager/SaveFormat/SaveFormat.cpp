@@ -0,0 +1,424 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Logic/Save/SaveFormat.h"
+
+#include <cstring>
+
+namespace SaveFormat
+{
+	namespace
+	{
+		// フィールドの見出し（タグとバイト数）の大きさ
+		static constexpr size_t FIELD_HEADER_SIZE = 6;
+
+		// ステージのファイルのタグ
+		static constexpr uint16_t TAG_STAGE = 1;
+
+		// 1ステージ分のフィールドのタグ（TAG_STAGE の値の中に並ぶ）
+		static constexpr uint16_t TAG_STAGE_KEY = 1;
+		static constexpr uint16_t TAG_STAGE_CLEARED = 2;
+		static constexpr uint16_t TAG_STAGE_CLEAR_RANK = 3;
+		static constexpr uint16_t TAG_STAGE_DIFFICULTY = 4;
+		static constexpr uint16_t TAG_STAGE_TITLE = 5;
+
+		// 音量のファイルのタグ
+		static constexpr uint16_t TAG_VOLUME_BGM = 1;
+		static constexpr uint16_t TAG_VOLUME_SE = 2;
+
+		// CRC32（IEEE、反転した多項式）
+		static constexpr uint32_t CRC32_POLYNOMIAL = 0xEDB88320u;
+
+		// 8バイトずつ処理するためのテーブル（Values[k][i] は値 i の後に 0 が k バイト続いた時のCRC）
+		struct FCrcTable
+		{
+			uint32_t Values[8][256];
+
+			FCrcTable()
+			{
+				for (uint32_t i = 0; i < 256; ++i)
+				{
+					uint32_t Crc = i;
+					for (int32_t Bit = 0; Bit < 8; ++Bit)
+					{
+						Crc = (Crc & 1u) ? (Crc >> 1) ^ CRC32_POLYNOMIAL : Crc >> 1;
+					}
+					Values[0][i] = Crc;
+				}
+				for (int32_t k = 1; k < 8; ++k)
+				{
+					for (uint32_t i = 0; i < 256; ++i)
+					{
+						Values[k][i] = (Values[k - 1][i] >> 8) ^ Values[0][Values[k - 1][i] & 0xFFu];
+					}
+				}
+			}
+		};
+
+		// =======================
+		// 書き出し
+		// =======================
+
+		void WriteU16(std::vector<uint8_t>& Out, uint16_t Value)
+		{
+			const uint8_t Bytes[2] = { static_cast<uint8_t>(Value), static_cast<uint8_t>(Value >> 8) };
+			Out.insert(Out.end(), Bytes, Bytes + 2);
+		}
+
+		void WriteU32(std::vector<uint8_t>& Out, uint32_t Value)
+		{
+			const uint8_t Bytes[4] = {
+				static_cast<uint8_t>(Value), static_cast<uint8_t>(Value >> 8),
+				static_cast<uint8_t>(Value >> 16), static_cast<uint8_t>(Value >> 24) };
+			Out.insert(Out.end(), Bytes, Bytes + 4);
+		}
+
+		void WriteU32At(std::vector<uint8_t>& Out, size_t Offset, uint32_t Value)
+		{
+			for (int32_t i = 0; i < 4; ++i)
+			{
+				Out[Offset + i] = static_cast<uint8_t>(Value >> (i * 8));
+			}
+		}
+
+		// フィールドの見出しを書き、値のバイト数を後で埋めるための位置を返す
+		size_t BeginField(std::vector<uint8_t>& Out, uint16_t Tag)
+		{
+			WriteU16(Out, Tag);
+			const size_t SizeOffset = Out.size();
+			WriteU32(Out, 0);
+			return SizeOffset;
+		}
+
+		void EndField(std::vector<uint8_t>& Out, size_t SizeOffset)
+		{
+			WriteU32At(Out, SizeOffset, static_cast<uint32_t>(Out.size() - SizeOffset - 4));
+		}
+
+		void WriteBytesField(std::vector<uint8_t>& Out, uint16_t Tag, const void* Data, size_t Size)
+		{
+			WriteU16(Out, Tag);
+			WriteU32(Out, static_cast<uint32_t>(Size));
+			const uint8_t* Bytes = static_cast<const uint8_t*>(Data);
+			Out.insert(Out.end(), Bytes, Bytes + Size);
+		}
+
+		void WriteStringField(std::vector<uint8_t>& Out, uint16_t Tag, const std::string& Value)
+		{
+			WriteBytesField(Out, Tag, Value.data(), Value.size());
+		}
+
+		void WriteI32Field(std::vector<uint8_t>& Out, uint16_t Tag, int32_t Value)
+		{
+			WriteU16(Out, Tag);
+			WriteU32(Out, 4);
+			WriteU32(Out, static_cast<uint32_t>(Value));
+		}
+
+		void WriteF32Field(std::vector<uint8_t>& Out, uint16_t Tag, float Value)
+		{
+			uint32_t Bits = 0;
+			std::memcpy(&Bits, &Value, sizeof(Bits));
+			WriteU16(Out, Tag);
+			WriteU32(Out, 4);
+			WriteU32(Out, Bits);
+		}
+
+		// ヘッダーの場所を空けておく
+		void BeginFile(std::vector<uint8_t>& Out, size_t PayloadCapacity)
+		{
+			Out.clear();
+			Out.reserve(HEADER_SIZE + PayloadCapacity);
+			Out.resize(HEADER_SIZE, 0);
+		}
+
+		// 本体が書き終わってからヘッダーを埋める
+		void EndFile(std::vector<uint8_t>& Out, EFileKind Kind)
+		{
+			WriteU32At(Out, 0, MAGIC);
+			WriteU32At(Out, 4, FORMAT_VERSION | (static_cast<uint32_t>(SCHEMA_VERSION) << 16));
+			WriteU32At(Out, 8, static_cast<uint32_t>(Kind));
+			WriteU32At(Out, 12, static_cast<uint32_t>(Out.size() - HEADER_SIZE));
+			WriteU32At(Out, 16, Crc32(Out.data() + HEADER_SIZE, Out.size() - HEADER_SIZE));
+		}
+
+		// =======================
+		// 読み込み
+		// =======================
+
+		uint16_t ReadU16(const uint8_t* Data)
+		{
+			return static_cast<uint16_t>(Data[0] | (Data[1] << 8));
+		}
+
+		uint32_t ReadU32(const uint8_t* Data)
+		{
+			return static_cast<uint32_t>(Data[0]) | (static_cast<uint32_t>(Data[1]) << 8)
+				| (static_cast<uint32_t>(Data[2]) << 16) | (static_cast<uint32_t>(Data[3]) << 24);
+		}
+
+		// バッファの中のフィールドを順に取り出す（コピーはしない）
+		class FFieldReader
+		{
+		public:
+			FFieldReader(const uint8_t* InData, size_t InSize) : Data(InData), Size(InSize) {}
+
+			/**
+			 * 次のフィールドを取り出す
+			 * @return 終端に達したか、フィールドがはみ出していれば false（はみ出しは IsCorrupt で分かる）
+			 */
+			bool Next(uint16_t& OutTag, const uint8_t*& OutValue, size_t& OutSize)
+			{
+				if (Offset == Size)
+					return false;
+
+				if (Size - Offset < FIELD_HEADER_SIZE)
+				{
+					bCorrupt = true;
+					return false;
+				}
+
+				OutTag = ReadU16(Data + Offset);
+				OutSize = ReadU32(Data + Offset + 2);
+				Offset += FIELD_HEADER_SIZE;
+				if (OutSize > Size - Offset)
+				{
+					bCorrupt = true;
+					return false;
+				}
+
+				OutValue = Data + Offset;
+				Offset += OutSize;
+				return true;
+			}
+
+			bool IsCorrupt() const { return bCorrupt; }
+
+		private:
+			const uint8_t* Data;
+			size_t Size;
+			size_t Offset = 0;
+			bool bCorrupt = false;
+		};
+
+		// 1. 識別子と形式のバージョン、種類を確認
+		// 2. 本体の大きさとCRC32を確認して、本体の範囲を返す
+		EReadResult ReadHeader(const uint8_t* Data, size_t Size, EFileKind Kind, const uint8_t*& OutPayload, size_t& OutPayloadSize)
+		{
+			if (!Data || Size < HEADER_SIZE || ReadU32(Data) != MAGIC)
+				return EReadResult::BadHeader;
+
+			if (ReadU16(Data + 4) > FORMAT_VERSION)
+				return EReadResult::UnsupportedVersion;
+
+			if (ReadU16(Data + 8) != static_cast<uint16_t>(Kind))
+				return EReadResult::WrongKind;
+
+			const size_t PayloadSize = ReadU32(Data + 12);
+			if (PayloadSize > Size - HEADER_SIZE)
+				return EReadResult::Corrupt;
+
+			OutPayload = Data + HEADER_SIZE;
+			OutPayloadSize = PayloadSize;
+			if (Crc32(OutPayload, OutPayloadSize) != ReadU32(Data + 16))
+				return EReadResult::ChecksumMismatch;
+
+			return EReadResult::Ok;
+		}
+
+		// 大きさが合わない値は読まずに既定値のままにする（型を変えた新しいフィールドと区別できないため）
+		void ReadI32(const uint8_t* Value, size_t Size, int32_t& OutValue)
+		{
+			if (Size == 4)
+			{
+				OutValue = static_cast<int32_t>(ReadU32(Value));
+			}
+		}
+
+		void ReadF32(const uint8_t* Value, size_t Size, float& OutValue)
+		{
+			if (Size == 4)
+			{
+				const uint32_t Bits = ReadU32(Value);
+				std::memcpy(&OutValue, &Bits, sizeof(OutValue));
+			}
+		}
+	}
+
+	const char* ToString(EReadResult Result)
+	{
+		switch (Result)
+		{
+		case EReadResult::Ok:                 return "ok";
+		case EReadResult::BadHeader:          return "bad header";
+		case EReadResult::UnsupportedVersion: return "unsupported version";
+		case EReadResult::WrongKind:          return "wrong kind";
+		case EReadResult::ChecksumMismatch:   return "checksum mismatch";
+		case EReadResult::Corrupt:            return "corrupt";
+		}
+		return "unknown";
+	}
+
+	// 処理の流れ:
+	// 1. 8バイトずつ、テーブルを8回引いてまとめて進める
+	// 2. 残りを1バイトずつ進める
+	uint32_t Crc32(const uint8_t* Data, size_t Size)
+	{
+		static const FCrcTable Table;
+		const uint32_t (&Values)[8][256] = Table.Values;
+
+		uint32_t Crc = 0xFFFFFFFFu;
+		for (; Size >= 8; Data += 8, Size -= 8)
+		{
+			const uint32_t Low = Crc ^ ReadU32(Data);
+			const uint32_t High = ReadU32(Data + 4);
+			Crc = Values[7][Low & 0xFFu] ^ Values[6][(Low >> 8) & 0xFFu] ^ Values[5][(Low >> 16) & 0xFFu] ^ Values[4][Low >> 24]
+				^ Values[3][High & 0xFFu] ^ Values[2][(High >> 8) & 0xFFu] ^ Values[1][(High >> 16) & 0xFFu] ^ Values[0][High >> 24];
+		}
+		for (; Size > 0; ++Data, --Size)
+		{
+			Crc = Values[0][(Crc ^ *Data) & 0xFFu] ^ (Crc >> 8);
+		}
+		return Crc ^ 0xFFFFFFFFu;
+	}
+
+	// 処理の流れ:
+	// 1. ヘッダーの場所を空ける
+	// 2. ステージごとに TAG_STAGE のフィールドを書き、その中に各値のフィールドを並べる
+	// 3. 本体の大きさとCRC32を入れてヘッダーを埋める
+	void WriteStageSave(const std::vector<FStageRecord>& Stages, std::vector<uint8_t>& OutBytes)
+	{
+		// 1ステージ分は見出し6つと固定長の値（1 + 4 + 4）と文字列2つ
+		size_t PayloadCapacity = 0;
+		for (const FStageRecord& Stage : Stages)
+		{
+			PayloadCapacity += FIELD_HEADER_SIZE * 6 + 9 + Stage.Key.size() + Stage.Title.size();
+		}
+
+		BeginFile(OutBytes, PayloadCapacity);
+		for (const FStageRecord& Stage : Stages)
+		{
+			const size_t SizeOffset = BeginField(OutBytes, TAG_STAGE);
+			WriteStringField(OutBytes, TAG_STAGE_KEY, Stage.Key);
+			const uint8_t Cleared = Stage.bCleared ? 1 : 0;
+			WriteBytesField(OutBytes, TAG_STAGE_CLEARED, &Cleared, 1);
+			WriteI32Field(OutBytes, TAG_STAGE_CLEAR_RANK, Stage.ClearRank);
+			WriteI32Field(OutBytes, TAG_STAGE_DIFFICULTY, Stage.Difficulty);
+			WriteStringField(OutBytes, TAG_STAGE_TITLE, Stage.Title);
+			EndField(OutBytes, SizeOffset);
+		}
+		EndFile(OutBytes, EFileKind::Stage);
+	}
+
+	// 処理の流れ:
+	// 1. ヘッダーを確認
+	// 2. TAG_STAGE のフィールドごとに中の値を読む（知らないタグは読み飛ばす）
+	// 3. フィールドがはみ出していれば失敗
+	EReadResult ReadStageSave(const uint8_t* Data, size_t Size, std::vector<FStageRecord>& OutStages)
+	{
+		OutStages.clear();
+
+		const uint8_t* Payload = nullptr;
+		size_t PayloadSize = 0;
+		const EReadResult HeaderResult = ReadHeader(Data, Size, EFileKind::Stage, Payload, PayloadSize);
+		if (HeaderResult != EReadResult::Ok)
+			return HeaderResult;
+
+		FFieldReader Reader(Payload, PayloadSize);
+		uint16_t Tag = 0;
+		const uint8_t* Value = nullptr;
+		size_t ValueSize = 0;
+		while (Reader.Next(Tag, Value, ValueSize))
+		{
+			if (Tag != TAG_STAGE)
+				continue;
+
+			FStageRecord& Stage = OutStages.emplace_back();
+			FFieldReader StageReader(Value, ValueSize);
+			uint16_t StageTag = 0;
+			const uint8_t* StageValue = nullptr;
+			size_t StageValueSize = 0;
+			while (StageReader.Next(StageTag, StageValue, StageValueSize))
+			{
+				switch (StageTag)
+				{
+				case TAG_STAGE_KEY:
+					Stage.Key.assign(reinterpret_cast<const char*>(StageValue), StageValueSize);
+					break;
+				case TAG_STAGE_CLEARED:
+					if (StageValueSize == 1) Stage.bCleared = StageValue[0] != 0;
+					break;
+				case TAG_STAGE_CLEAR_RANK:
+					ReadI32(StageValue, StageValueSize, Stage.ClearRank);
+					break;
+				case TAG_STAGE_DIFFICULTY:
+					ReadI32(StageValue, StageValueSize, Stage.Difficulty);
+					break;
+				case TAG_STAGE_TITLE:
+					Stage.Title.assign(reinterpret_cast<const char*>(StageValue), StageValueSize);
+					break;
+				default:
+					break;
+				}
+			}
+
+			if (StageReader.IsCorrupt())
+			{
+				OutStages.clear();
+				return EReadResult::Corrupt;
+			}
+		}
+
+		if (Reader.IsCorrupt())
+		{
+			OutStages.clear();
+			return EReadResult::Corrupt;
+		}
+		return EReadResult::Ok;
+	}
+
+	void WriteVolumeSave(const FVolumeRecord& Volume, std::vector<uint8_t>& OutBytes)
+	{
+		BeginFile(OutBytes, (FIELD_HEADER_SIZE + 4) * 2);
+		WriteF32Field(OutBytes, TAG_VOLUME_BGM, Volume.BGMVolume);
+		WriteF32Field(OutBytes, TAG_VOLUME_SE, Volume.SEVolume);
+		EndFile(OutBytes, EFileKind::Volume);
+	}
+
+	EReadResult ReadVolumeSave(const uint8_t* Data, size_t Size, FVolumeRecord& OutVolume)
+	{
+		OutVolume = FVolumeRecord();
+
+		const uint8_t* Payload = nullptr;
+		size_t PayloadSize = 0;
+		const EReadResult HeaderResult = ReadHeader(Data, Size, EFileKind::Volume, Payload, PayloadSize);
+		if (HeaderResult != EReadResult::Ok)
+			return HeaderResult;
+
+		FVolumeRecord Volume;
+		FFieldReader Reader(Payload, PayloadSize);
+		uint16_t Tag = 0;
+		const uint8_t* Value = nullptr;
+		size_t ValueSize = 0;
+		while (Reader.Next(Tag, Value, ValueSize))
+		{
+			switch (Tag)
+			{
+			case TAG_VOLUME_BGM:
+				ReadF32(Value, ValueSize, Volume.BGMVolume);
+				break;
+			case TAG_VOLUME_SE:
+				ReadF32(Value, ValueSize, Volume.SEVolume);
+				break;
+			default:
+				break;
+			}
+		}
+
+		if (Reader.IsCorrupt())
+			return EReadResult::Corrupt;
+
+		OutVolume = Volume;
+		return EReadResult::Ok;
+	}
+}
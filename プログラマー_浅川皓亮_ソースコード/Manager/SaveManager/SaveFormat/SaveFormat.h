@@ -0,0 +1,113 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+// エンジンに依存しないセーブデータのバイナリ形式
+// FSaveStore がセーブファイルの読み書きに使うほか、エディタ無しのベンチマークからも使えるように標準ライブラリだけで実装する
+//
+// ファイルの構成（数値は全てリトルエンディアン）:
+//   ヘッダー（HEADER_SIZE バイト）
+//     uint32 MAGIC / uint16 形式のバージョン / uint16 スキーマのバージョン
+//     uint16 ファイルの種類 / uint16 予約（0） / uint32 本体のバイト数 / uint32 本体のCRC32
+//   本体: フィールドの並び
+//     uint16 タグ / uint32 値のバイト数 / 値
+//
+// 知らないタグは読み飛ばすため、フィールドを足してもスキーマのバージョンを上げるだけで古い読み込み側でも読める
+// 形式のバージョンはヘッダーやフィールドの並べ方を変える時だけ上げる（新しい形式は読まない）
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace SaveFormat
+{
+	// ファイルの先頭の識別子（"PSAV"）
+	static constexpr uint32_t MAGIC = 0x56415350u;
+
+	// 形式のバージョン（読めるのはこれ以下）
+	static constexpr uint16_t FORMAT_VERSION = 1;
+
+	// スキーマのバージョン（フィールドを足したら上げる）
+	static constexpr uint16_t SCHEMA_VERSION = 1;
+
+	static constexpr size_t HEADER_SIZE = 20;
+
+	// ファイルの種類
+	enum class EFileKind : uint16_t
+	{
+		Stage = 1,
+		Volume = 2,
+	};
+
+	// 読み込みの結果
+	enum class EReadResult : uint8_t
+	{
+		Ok,
+		BadHeader,           // 短すぎる・識別子が違う
+		UnsupportedVersion,  // 新しい形式
+		WrongKind,           // 別の種類のファイル
+		ChecksumMismatch,    // 本体が壊れている
+		Corrupt,             // フィールドがファイルの外にはみ出している
+	};
+
+	/* 読み込みの結果をログ用の文字列にする */
+	const char* ToString(EReadResult Result);
+
+	// FStageSaveData の1ステージ分
+	struct FStageRecord
+	{
+		std::string Key;       // UTF-8
+		bool bCleared = false;
+		int32_t ClearRank = 0;
+		int32_t Difficulty = 0;
+		std::string Title;     // UTF-8
+	};
+
+	// FVolumeSaveData
+	struct FVolumeRecord
+	{
+		float BGMVolume = 1.0f;
+		float SEVolume = 1.0f;
+	};
+
+	/**
+	 * CRC32（IEEE）を求める
+	 * @param Data 対象のバイト列
+	 * @param Size バイト数
+	 * @return CRC32
+	 */
+	uint32_t Crc32(const uint8_t* Data, size_t Size);
+
+	/**
+	 * ステージのセーブデータを書き出す
+	 * @param Stages 書き出すステージ
+	 * @param OutBytes 書き出したファイルの中身（上書き）
+	 */
+	void WriteStageSave(const std::vector<FStageRecord>& Stages, std::vector<uint8_t>& OutBytes);
+
+	/**
+	 * ステージのセーブデータを読み込む（1つのバッファから直接読む。文字列は std::string にコピーする）
+	 * @param Data ファイルの中身
+	 * @param Size ファイルのバイト数
+	 * @param OutStages 読み込んだステージ（失敗した場合は空）
+	 * @return 読み込みの結果
+	 */
+	EReadResult ReadStageSave(const uint8_t* Data, size_t Size, std::vector<FStageRecord>& OutStages);
+
+	/**
+	 * 音量設定を書き出す
+	 * @param Volume 書き出す音量設定
+	 * @param OutBytes 書き出したファイルの中身（上書き）
+	 */
+	void WriteVolumeSave(const FVolumeRecord& Volume, std::vector<uint8_t>& OutBytes);
+
+	/**
+	 * 音量設定を読み込む（1つのバッファから直接読む）
+	 * @param Data ファイルの中身
+	 * @param Size ファイルのバイト数
+	 * @param OutVolume 読み込んだ音量設定（失敗した場合は既定値）
+	 * @return 読み込みの結果
+	 */
+	EReadResult ReadVolumeSave(const uint8_t* Data, size_t Size, FVolumeRecord& OutVolume);
+}
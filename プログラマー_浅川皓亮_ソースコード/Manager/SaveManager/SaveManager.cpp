@@ -2,132 +2,85 @@
 
 
 #include "Manager/SaveManager.h"
-#include "Misc/FileHelper.h"
-#include "Misc/Paths.h"
-#include "Serialization/JsonWriter.h"
-#include "Serialization/JsonSerializer.h"
+#include "Manager/SaveStore.h"
 #include "DataContainer/SaveData.h"
 
 
-// 1. 現在のセーブデータを読み込む
-// 2. 指定されたステージキーのデータを更新または追加
-// 3. JSONファイルに保存
+// 1. 指定されたステージキーのデータを更新または追加
+// 2. 書き込みはフレームの最後にまとめて行う
 void USaveManager::SaveStageData(const FString& StageKey, FSaveData NewData)
 {
-    FStageSaveData CurrentData = LoadFromJson();
-    CurrentData.Stages.FindOrAdd(StageKey) = NewData;
-    SaveToJson(CurrentData);
+    FSaveStore::Get().SetStageData(StageKey, NewData);
 }
 
-// 1. セーブファイルのパスを取得
-// 2. データをJSON形式にシリアライズ
-// 3. ファイルに書き込み
+// 1. ステージセーブデータを全て置き換える
+// 2. 書き込みはフレームの最後にまとめて行う
 void USaveManager::SaveToJson(const FStageSaveData& InData)
 {
-    FString SavePath = FPaths::ProjectSavedDir() + "StageSave.json";
-    FStageSaveData Data = InData;
-
-    if (!FPaths::FileExists(SavePath))
-    {
-        UE_LOG(LogTemp, Warning, TEXT("Save file not found. Creating default."));
-    }
-
-    FString OutputString;
-    TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&OutputString);
-    FJsonSerializer::Serialize(Data.ToJson().ToSharedRef(), Writer);
-    FFileHelper::SaveStringToFile(OutputString, *SavePath);
+    FSaveStore::Get().SetAllStageData(InData);
 }
 
-// 1. セーブファイルのパスを取得
-// 2. ファイルから文字列を読み込み
-// 3. JSON形式をデシリアライズしてデータ構造に変換
-// 4. 読み込まれたデータを返す
+// メモリ上のステージセーブデータを返す（初回のみファイルから読み込む）
 FStageSaveData USaveManager::LoadFromJson()
 {
-    FString SavePath = FPaths::ProjectSavedDir() + "StageSave.json";
-    FString Input;
-    FStageSaveData LoadedData;
-
-    if (FFileHelper::LoadFileToString(Input, *SavePath))
-    {
-        TSharedPtr<FJsonObject> Json;
-        TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Input);
-        if (FJsonSerializer::Deserialize(Reader, Json))
-        {
-            LoadedData = FStageSaveData::FromJson(Json);
-        }
-    }
-
-    return LoadedData;
+    return FSaveStore::Get().GetStageData();
 }
 
-// 1. セーブデータを読み込む
-// 2. 指定されたステージのランクを取得して返す
+// 指定されたステージのランクをメモリ上のデータから返す
 EStageRank USaveManager::GetStageRank(const FString& StageKey)
 {
-    FStageSaveData Data = LoadFromJson();
-    return Data.GetStageRank(StageKey);
+    return FSaveStore::Get().GetStageData().GetStageRank(StageKey);
 }
 
-// 1. 音量セーブファイルのパスを取得
-// 2. データをJSON形式にシリアライズ
-// 3. ファイルに書き込み
+// 1. 音量設定を置き換える
+// 2. 書き込みはフレームの最後にまとめて行う
 void USaveManager::SaveVolumeToJson(const FVolumeSaveData& InData)
 {
-    FString SavePath = FPaths::ProjectSavedDir() + "VolumeSave.json";
-    FString OutputString;
-    TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&OutputString);
-    FJsonSerializer::Serialize(InData.ToJson().ToSharedRef(), Writer);
-    FFileHelper::SaveStringToFile(OutputString, *SavePath);
+    FSaveStore::Get().SetVolumeData(InData);
 }
 
-// 1. 音量セーブファイルのパスを取得
-// 2. ファイルから文字列を読み込み
-// 3. JSON形式をデシリアライズ
-// 4. ファイルが存在しない場合はデフォルト値を保存
-// 5. 読み込まれたデータを返す
+// メモリ上の音量設定を返す（初回のみファイルから読み込み、無ければデフォルト値で作る）
 FVolumeSaveData USaveManager::LoadVolumeFromJson()
 {
-    FString SavePath = FPaths::ProjectSavedDir() + "VolumeSave.json";
-    FString Input;
-    FVolumeSaveData LoadedData;
-
-    if (FFileHelper::LoadFileToString(Input, *SavePath))
-    {
-        TSharedPtr<FJsonObject> Json;
-        TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Input);
-        if (FJsonSerializer::Deserialize(Reader, Json))
-        {
-            LoadedData = FVolumeSaveData::FromJson(Json);
-        }
-    }
-    else
-    {
-        UE_LOG(LogTemp, Warning, TEXT("Volume save file not found, creating new with default values."));
-        SaveVolumeToJson(LoadedData);
-    }
-
-    return LoadedData;
+    return FSaveStore::Get().GetVolumeData();
 }
 
-// 音量データを読み込んでBGM音量を返す
+// メモリ上のBGM音量を返す
 float USaveManager::GetBGMVolume()
 {
-    return LoadVolumeFromJson().BGMVolume;
+    return FSaveStore::Get().GetVolumeData().BGMVolume;
 }
 
-// 音量データを読み込んでSE音量を返す
+// メモリ上のSE音量を返す
 float USaveManager::GetSEVolume()
 {
-    return LoadVolumeFromJson().SEVolume;
+    return FSaveStore::Get().GetVolumeData().SEVolume;
 }
 
 // 1. 新しい音量データを作成
-// 2. JSON形式で保存
+// 2. 音量設定を置き換える（書き込みはフレームの最後にまとめて行う）
 void USaveManager::SetVolume(float NewBGM, float NewSE)
 {
     FVolumeSaveData VolumeData;
     VolumeData.BGMVolume = NewBGM;
     VolumeData.SEVolume = NewSE;
     SaveVolumeToJson(VolumeData);
+}
+
+// 変更を全て書き込み、終わるまで待つ
+void USaveManager::FlushSaves()
+{
+    FSaveStore::Get().Flush();
+}
+
+// JSONファイルに書き出す
+void USaveManager::ExportSavesToJson()
+{
+    FSaveStore::Get().ExportJson();
+}
+
+// JSONファイルから読み込んで置き換える
+bool USaveManager::ImportSavesFromJson()
+{
+    return FSaveStore::Get().ImportJson();
 }
\ No newline at end of file
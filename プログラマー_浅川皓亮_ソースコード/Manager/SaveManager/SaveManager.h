@@ -9,7 +9,9 @@
 
 /**
  * セーブデータの管理を行うマネージャークラス
- * ステージクリア情報と音量設定をJSON形式で保存・読み込みする
+ * ステージクリア情報と音量設定をバイナリ形式で保存・読み込みする（JSONはデバッグ用に書き出し・読み込みできる）
+ * データは FSaveStore がメモリに持ち、取得でファイルを読むのは初回のみ
+ * 保存は変更を記録するだけで、ファイルへの書き込みはフレームの最後にバックグラウンドで行う
  */
 UCLASS()
 class PACHIO_API USaveManager : public UObject
@@ -26,15 +28,15 @@ public:
     static void SaveStageData(const FString& StageKey, FSaveData NewData);
 
     /**
-     * ステージセーブデータをJSON形式で保存する
+     * ステージセーブデータを全て置き換えて保存する
      * @param Data 保存するステージセーブデータ
      */
     UFUNCTION(BlueprintCallable, Category = "Save")
     static void SaveToJson(const FStageSaveData& Data);
 
     /**
-     * ステージセーブデータをJSON形式で読み込む
-     * @return 読み込まれたステージセーブデータ
+     * ステージセーブデータを取得する（初回のみファイルから読み込む）
+     * @return ステージセーブデータ
      */
     UFUNCTION(BlueprintCallable, Category = "Save")
     static FStageSaveData LoadFromJson();
@@ -48,15 +50,15 @@ public:
     EStageRank GetStageRank(const FString& StageKey);
 
     /**
-     * 音量設定をJSON形式で保存する
+     * 音量設定を保存する
      * @param InData 保存する音量設定データ
      */
     UFUNCTION(BlueprintCallable, Category = "Save")
     static void SaveVolumeToJson(const FVolumeSaveData& InData);
 
     /**
-     * 音量設定をJSON形式で読み込む
-     * @return 読み込まれた音量設定データ
+     * 音量設定を取得する（初回のみファイルから読み込む）
+     * @return 音量設定データ
      */
     UFUNCTION(BlueprintCallable, Category = "Save")
     static FVolumeSaveData LoadVolumeFromJson();
@@ -82,4 +84,22 @@ public:
      */
     UFUNCTION(BlueprintCallable, Category = "Save")
     static void SetVolume(float NewBGM, float NewSE);
+
+    /**
+     * まだ書き込んでいない変更を全て書き込み、終わるまで待つ
+     * （終了時は自動で呼ばれる。ゲームを終了する前など、確実に書き込みたい時に使う）
+     */
+    UFUNCTION(BlueprintCallable, Category = "Save")
+    static void FlushSaves();
+
+    /* 現在のセーブデータをJSONファイル（StageSave.export.json / VolumeSave.export.json）に書き出す（デバッグ用） */
+    UFUNCTION(BlueprintCallable, Category = "Save")
+    static void ExportSavesToJson();
+
+    /**
+     * ExportSavesToJson で書き出したJSONファイルからセーブデータを読み込んで置き換える（デバッグ用、バイナリには次のフレームの最後に反映される）
+     * @return 1つでも読み込めたか
+     */
+    UFUNCTION(BlueprintCallable, Category = "Save")
+    static bool ImportSavesFromJson();
 };
\ No newline at end of file
@@ -0,0 +1,570 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Manager/SaveStore.h"
+#include "Logic/Save/SaveFormat.h"
+#include "Async/Async.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+#include "Serialization/JsonWriter.h"
+#include "Serialization/JsonSerializer.h"
+
+#if PLATFORM_WINDOWS
+#include "Windows/WindowsHWrapper.h"
+#elif PLATFORM_UNIX || PLATFORM_MAC
+#include <cstdio>
+#endif
+
+namespace
+{
+    // セーブファイル名（FPaths::ProjectSavedDir からの相対）
+    static const TCHAR* STAGE_SAVE_FILE_NAME = TEXT("StageSave.bin");
+    static const TCHAR* VOLUME_SAVE_FILE_NAME = TEXT("VolumeSave.bin");
+
+    // 以前の形式のJSONファイル名（読み込んでバイナリに移行する）
+    static const TCHAR* STAGE_JSON_FILE_NAME = TEXT("StageSave.json");
+    static const TCHAR* VOLUME_JSON_FILE_NAME = TEXT("VolumeSave.json");
+
+    // デバッグ用に書き出し・読み込みするJSONファイル名（以前の形式のファイルと混ざらないよう分ける）
+    static const TCHAR* STAGE_EXPORT_FILE_NAME = TEXT("StageSave.export.json");
+    static const TCHAR* VOLUME_EXPORT_FILE_NAME = TEXT("VolumeSave.export.json");
+
+    // 書き込み途中の一時ファイルに付ける拡張子
+    static const TCHAR* TEMP_FILE_SUFFIX = TEXT(".tmp");
+
+    // 移行が終わった以前の形式のファイルに付ける拡張子
+    static const TCHAR* MIGRATED_FILE_SUFFIX = TEXT(".migrated");
+
+    // 読めなかったセーブファイルを上書きする前に残すコピーの拡張子
+    static const TCHAR* BAD_FILE_SUFFIX = TEXT(".bad");
+
+    // 書き込みに失敗してから書き直すまでの間隔（秒）
+    // ディスクの空き不足などはすぐには直らないため、毎フレーム書き直して警告を出し続けないようにする
+    static constexpr double WRITE_RETRY_INTERVAL_SECONDS = 5.0;
+
+    // =======================
+    // JSON（以前の形式・デバッグ用）
+    // =======================
+
+    FString GetSavedPath(const TCHAR* FileName)
+    {
+        return FPaths::ProjectSavedDir() + FileName;
+    }
+
+    // JSONファイルを読む（無いか読めなければ nullptr）
+    TSharedPtr<FJsonObject> LoadJsonFile(const TCHAR* FileName)
+    {
+        FString Input;
+        if (!FFileHelper::LoadFileToString(Input, *GetSavedPath(FileName)))
+            return nullptr;
+
+        TSharedPtr<FJsonObject> Json;
+        TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Input);
+        if (!FJsonSerializer::Deserialize(Reader, Json))
+            return nullptr;
+        return Json;
+    }
+
+    void SaveJsonFile(const TCHAR* FileName, const TSharedPtr<FJsonObject>& Json)
+    {
+        FString OutputString;
+        TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&OutputString);
+        FJsonSerializer::Serialize(Json.ToSharedRef(), Writer);
+        FFileHelper::SaveStringToFile(OutputString, *GetSavedPath(FileName));
+    }
+
+    // =======================
+    // ファイル操作
+    // =======================
+
+    // 一時ファイルで元のファイルを置き換える
+    // IFileManager::Move は元のファイルを消してから名前を変えるため、その間に終了するとどちらも無くなる
+    // Windows と POSIX では置き換えを1回の操作で行い、元のファイルが無い瞬間を作らない
+    bool ReplaceFile(const FString& DestPath, const FString& SourcePath)
+    {
+#if PLATFORM_WINDOWS
+        const FString FullDest = FPaths::ConvertRelativePathToFull(DestPath);
+        const FString FullSource = FPaths::ConvertRelativePathToFull(SourcePath);
+        return ::MoveFileExW(*FullSource, *FullDest, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#elif PLATFORM_UNIX || PLATFORM_MAC
+        const FString FullDest = FPaths::ConvertRelativePathToFull(DestPath);
+        const FString FullSource = FPaths::ConvertRelativePathToFull(SourcePath);
+        return std::rename(TCHAR_TO_UTF8(*FullSource), TCHAR_TO_UTF8(*FullDest)) == 0;
+#else
+        // その他のプラットフォームは読み込み側で一時ファイルから復旧する
+        return IFileManager::Get().Move(*DestPath, *SourcePath, true, true);
+#endif
+    }
+
+    // セーブファイルを読み、Read で確認・変換する（どちらかが読めた場合 true）
+    // 処理の流れ:
+    // 1. セーブファイルを読んで確認する（読めなかった理由を OutFileResult に返す、ファイルが無ければ Ok）
+    // 2. 無いか読めなければ、置き換え前に残った一時ファイルを読んで確認する（CRCで書き終わっているものだけ使う）
+    // 3. 一時ファイルから読んだ場合は bOutFromTemp を立てる（セーブファイルを書き直すため）
+    template <typename ReadFunc>
+    bool LoadSaveFile(const FString& Path, const TCHAR* Label, ReadFunc&& Read, bool& bOutFromTemp, SaveFormat::EReadResult& OutFileResult)
+    {
+        bOutFromTemp = false;
+        OutFileResult = SaveFormat::EReadResult::Ok;
+
+        const FString Candidates[] = { Path, Path + TEMP_FILE_SUFFIX };
+        for (int32 i = 0; i < UE_ARRAY_COUNT(Candidates); ++i)
+        {
+            const FString& Candidate = Candidates[i];
+            TArray<uint8> Bytes;
+            if (!FFileHelper::LoadFileToArray(Bytes, *Candidate, FILEREAD_Silent))
+                continue;
+
+            const SaveFormat::EReadResult Result = Read(Bytes);
+            if (i == 0)
+            {
+                OutFileResult = Result;
+            }
+            if (Result == SaveFormat::EReadResult::Ok)
+            {
+                bOutFromTemp = i > 0;
+                if (bOutFromTemp)
+                {
+                    UE_LOG(LogTemp, Warning, TEXT("%s save recovered from %s"), Label, *Candidate);
+                }
+                return true;
+            }
+            UE_LOG(LogTemp, Warning, TEXT("%s save %s is unreadable (%s)."), Label, *Candidate, ANSI_TO_TCHAR(SaveFormat::ToString(Result)));
+        }
+        return false;
+    }
+
+    // =======================
+    // バイナリ形式との変換
+    // =======================
+
+    std::string ToUTF8(const FString& Value)
+    {
+        const FTCHARToUTF8 Converted(*Value);
+        return std::string(Converted.Get(), Converted.Length());
+    }
+
+    FString FromUTF8(const std::string& Value)
+    {
+        const FUTF8ToTCHAR Converted(Value.data(), static_cast<int32>(Value.size()));
+        return FString(Converted.Length(), Converted.Get());
+    }
+
+    TArray<uint8> EncodeStageSave(const FStageSaveData& Data)
+    {
+        std::vector<SaveFormat::FStageRecord> Records;
+        Records.reserve(Data.Stages.Num());
+        for (const TPair<FString, FSaveData>& Stage : Data.Stages)
+        {
+            SaveFormat::FStageRecord& Record = Records.emplace_back();
+            Record.Key = ToUTF8(Stage.Key);
+            Record.bCleared = Stage.Value.bCleared;
+            Record.ClearRank = static_cast<int32>(Stage.Value.ClearRank);
+            Record.Difficulty = Stage.Value.difficultyRank;
+            Record.Title = ToUTF8(Stage.Value.Title);
+        }
+
+        std::vector<uint8_t> Bytes;
+        SaveFormat::WriteStageSave(Records, Bytes);
+        return TArray<uint8>(Bytes.data(), static_cast<int32>(Bytes.size()));
+    }
+
+    FStageSaveData DecodeStageSave(const std::vector<SaveFormat::FStageRecord>& Records)
+    {
+        FStageSaveData Data;
+        for (const SaveFormat::FStageRecord& Record : Records)
+        {
+            FSaveData& Stage = Data.Stages.FindOrAdd(FromUTF8(Record.Key));
+            Stage.bCleared = Record.bCleared;
+            Stage.ClearRank = static_cast<EStageRank>(Record.ClearRank);
+            Stage.difficultyRank = Record.Difficulty;
+            Stage.Title = FromUTF8(Record.Title);
+        }
+        return Data;
+    }
+
+    TArray<uint8> EncodeVolumeSave(const FVolumeSaveData& Data)
+    {
+        SaveFormat::FVolumeRecord Record;
+        Record.BGMVolume = Data.BGMVolume;
+        Record.SEVolume = Data.SEVolume;
+
+        std::vector<uint8_t> Bytes;
+        SaveFormat::WriteVolumeSave(Record, Bytes);
+        return TArray<uint8>(Bytes.data(), static_cast<int32>(Bytes.size()));
+    }
+}
+
+// =======================
+// FAsyncSaveFile
+// =======================
+
+FAsyncSaveFile::FAsyncSaveFile(const FString& InFileName)
+    : Path(FPaths::ProjectSavedDir() + InFileName)
+{
+}
+
+FAsyncSaveFile::~FAsyncSaveFile()
+{
+    Flush();
+}
+
+// 1. 最新の依頼として残す（前の依頼がまだ書かれていなければ置き換える）
+// 2. バックグラウンドの書き込みが動いていなければ開始する
+void FAsyncSaveFile::Write(TFunction<TArray<uint8>()>&& Serialize)
+{
+    FScopeLock ScopeLock(&Lock);
+    PendingSerialize = MoveTemp(Serialize);
+    StartWriterLocked();
+}
+
+void FAsyncSaveFile::RetireAfterWrite(const FString& InPath)
+{
+    FScopeLock ScopeLock(&Lock);
+    PendingRetirePath = InPath;
+}
+
+void FAsyncSaveFile::PreserveBeforeWrite()
+{
+    FScopeLock ScopeLock(&Lock);
+    bPreservePending = true;
+}
+
+// 失敗した依頼は PendingSerialize に残っているため、書き込みが止まっていて時刻を過ぎていれば開始する
+void FAsyncSaveFile::RetryFailedWrite()
+{
+    FScopeLock ScopeLock(&Lock);
+    if (PendingSerialize && FPlatformTime::Seconds() >= NextRetryTime)
+    {
+        StartWriterLocked();
+    }
+}
+
+// 1. 失敗して残っている依頼があれば、再試行の時刻を待たずに書き直す
+// 2. 依頼はゲームスレッドからしか来ないため、最後に開始した書き込みの終了を待てば全て書き終わっている
+void FAsyncSaveFile::Flush()
+{
+    {
+        FScopeLock ScopeLock(&Lock);
+        if (PendingSerialize)
+        {
+            StartWriterLocked();
+        }
+    }
+
+    if (WriterTask.IsValid())
+    {
+        WriterTask.Wait();
+    }
+}
+
+void FAsyncSaveFile::StartWriterLocked()
+{
+    if (bWriterRunning)
+        return;
+
+    bWriterRunning = true;
+    WriterTask = Async(EAsyncExecution::ThreadPool, [this]() { RunWriter(); });
+}
+
+// 1. 依頼を1つ取り出す（無ければ終了）
+// 2. 読めなかったファイルを残す指定があれば、.bad を付けてコピーする（コピーできなければ書き込みの失敗として扱う）
+// 3. ファイルの中身を作って書き込む
+// 4. 失敗した場合、書き込み中に新しい依頼が来ていればそちらを書く
+//    来ていなければ依頼と移行元のファイルを戻し、再試行の時刻を決めて終了する
+// 5. 書き込めていれば、移行元のファイルを退避する
+// 6. 書き込み中に来た依頼があれば続けて書く
+void FAsyncSaveFile::RunWriter()
+{
+    for (;;)
+    {
+        TFunction<TArray<uint8>()> Serialize;
+        FString RetirePath;
+        bool bPreserve = false;
+        {
+            FScopeLock ScopeLock(&Lock);
+            if (!PendingSerialize)
+            {
+                bWriterRunning = false;
+                return;
+            }
+            Serialize = MoveTemp(PendingSerialize);
+            PendingSerialize = nullptr;
+            RetirePath = MoveTemp(PendingRetirePath);
+            PendingRetirePath.Reset();
+            bPreserve = bPreservePending;
+            bPreservePending = false;
+        }
+
+        bool bPreserved = true;
+        if (bPreserve)
+        {
+            const FString BadPath = Path + BAD_FILE_SUFFIX;
+            bPreserved = !IFileManager::Get().FileExists(*Path) || IFileManager::Get().Copy(*BadPath, *Path, true) == COPY_OK;
+            if (bPreserved)
+            {
+                UE_LOG(LogTemp, Warning, TEXT("Unreadable save file kept as %s"), *BadPath);
+            }
+            else
+            {
+                UE_LOG(LogTemp, Warning, TEXT("Failed to keep unreadable save file as %s"), *BadPath);
+            }
+        }
+
+        if (!bPreserved || !WriteAtomic(Serialize()))
+        {
+            FScopeLock ScopeLock(&Lock);
+            if (PendingRetirePath.IsEmpty())
+            {
+                PendingRetirePath = MoveTemp(RetirePath);
+            }
+            bPreservePending |= !bPreserved;
+            if (PendingSerialize)
+                continue;
+
+            PendingSerialize = MoveTemp(Serialize);
+            NextRetryTime = FPlatformTime::Seconds() + WRITE_RETRY_INTERVAL_SECONDS;
+            bWriterRunning = false;
+            UE_LOG(LogTemp, Warning, TEXT("Save file %s will be retried in %.0f seconds"), *Path, WRITE_RETRY_INTERVAL_SECONDS);
+            return;
+        }
+
+        if (!RetirePath.IsEmpty() && !IFileManager::Get().Move(*(RetirePath + MIGRATED_FILE_SUFFIX), *RetirePath, true, true))
+        {
+            UE_LOG(LogTemp, Warning, TEXT("Failed to retire migrated save file %s"), *RetirePath);
+        }
+    }
+}
+
+// 1. 一時ファイルに書き込む
+// 2. 元のファイルを一時ファイルで置き換える（失敗した場合は一時ファイルを消し、元のファイルを残す）
+// 置き換えの途中で終了しても、元のファイルか書き終わった一時ファイルのどちらかが残る
+bool FAsyncSaveFile::WriteAtomic(const TArray<uint8>& Bytes) const
+{
+    const FString TempPath = Path + TEMP_FILE_SUFFIX;
+    if (!FFileHelper::SaveArrayToFile(Bytes, *TempPath))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Failed to write save file %s"), *TempPath);
+        return false;
+    }
+
+    if (!ReplaceFile(Path, TempPath))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Failed to replace save file %s"), *Path);
+        IFileManager::Get().Delete(*TempPath);
+        return false;
+    }
+    return true;
+}
+
+// =======================
+// FSaveStore
+// =======================
+
+FSaveStore& FSaveStore::Get()
+{
+    static FSaveStore Store;
+    return Store;
+}
+
+// フレームの最後に変更を書き込み、終了前に残りを書き込むよう登録する
+FSaveStore::FSaveStore()
+    : StageFile(STAGE_SAVE_FILE_NAME)
+    , VolumeFile(VOLUME_SAVE_FILE_NAME)
+{
+    EndFrameHandle = FCoreDelegates::OnEndFrame.AddRaw(this, &FSaveStore::WriteDirty);
+    PreExitHandle = FCoreDelegates::OnEnginePreExit.AddRaw(this, &FSaveStore::OnPreExit);
+}
+
+// 1. 初回のみバイナリのセーブファイル（無ければ一時ファイル）を1つのバッファに読み込んで変換する
+//    （文字列は SaveFormat が std::string にコピーし、さらに FString に変換する）
+// 2. セーブファイルが読めなかった場合は、次の書き込みの前に .bad として残す
+// 3. 一時ファイルから読んだ場合はセーブファイルを作り直すため Dirty を立てる
+// 4. どちらも読めなければ以前のJSONファイルから読み、バイナリに移行するため Dirty を立てる
+//    （セーブファイルが新しい形式の場合は、移行済みのため以前のJSONファイルは読まない）
+const FStageSaveData& FSaveStore::GetStageData()
+{
+    if (!bStageLoaded)
+    {
+        bStageLoaded = true;
+
+        std::vector<SaveFormat::FStageRecord> Records;
+        bool bFromTemp = false;
+        SaveFormat::EReadResult FileResult;
+        const bool bLoaded = LoadSaveFile(StageFile.GetPath(), TEXT("Stage"), [&Records](const TArray<uint8>& Bytes)
+            {
+                Records.clear();
+                return SaveFormat::ReadStageSave(Bytes.GetData(), Bytes.Num(), Records);
+            }, bFromTemp, FileResult);
+        if (FileResult != SaveFormat::EReadResult::Ok)
+        {
+            StageFile.PreserveBeforeWrite();
+        }
+        if (bLoaded)
+        {
+            StageData = DecodeStageSave(Records);
+            bStageDirty = bFromTemp;
+            return StageData;
+        }
+
+        if (FileResult == SaveFormat::EReadResult::UnsupportedVersion)
+            return StageData;
+
+        if (TSharedPtr<FJsonObject> Json = LoadJsonFile(STAGE_JSON_FILE_NAME))
+        {
+            StageData = FStageSaveData::FromJson(Json);
+            StageFile.RetireAfterWrite(GetSavedPath(STAGE_JSON_FILE_NAME));
+            bStageDirty = true;
+        }
+    }
+    return StageData;
+}
+
+// 1. 保存済みのデータと同じなら何もしない（毎回のレベル読み込みで同じ内容を書かないように）
+// 2. 更新または追加して Dirty を立てる
+void FSaveStore::SetStageData(const FString& StageKey, const FSaveData& NewData)
+{
+    GetStageData();
+
+    if (const FSaveData* Existing = StageData.Stages.Find(StageKey))
+    {
+        if (FSaveData::StaticStruct()->CompareScriptStruct(Existing, &NewData, PPF_None))
+            return;
+    }
+
+    StageData.Stages.FindOrAdd(StageKey) = NewData;
+    bStageDirty = true;
+}
+
+// 読めなかったセーブファイルを残すため、置き換える前に1度読んでおく
+void FSaveStore::SetAllStageData(const FStageSaveData& NewData)
+{
+    GetStageData();
+    StageData = NewData;
+    bStageDirty = true;
+}
+
+// 1. 初回のみバイナリの音量セーブファイル（無ければ一時ファイル）を読み込む
+// 2. セーブファイルが読めなかった場合は、次の書き込みの前に .bad として残す
+// 3. 一時ファイルから読んだ場合はセーブファイルを作り直すため Dirty を立てる
+// 4. セーブファイルが新しい形式の場合は、デフォルト値のまま Dirty を立てない（値を変えるまで上書きしない）
+// 5. どちらも読めなければ以前のJSONファイルから読み、バイナリに移行するため Dirty を立てる
+// 6. JSONも無い場合はデフォルト値で Dirty を立てる（次のフレームの最後に作られる）
+const FVolumeSaveData& FSaveStore::GetVolumeData()
+{
+    if (!bVolumeLoaded)
+    {
+        bVolumeLoaded = true;
+
+        SaveFormat::FVolumeRecord Record;
+        bool bFromTemp = false;
+        SaveFormat::EReadResult FileResult;
+        const bool bLoaded = LoadSaveFile(VolumeFile.GetPath(), TEXT("Volume"), [&Record](const TArray<uint8>& Bytes)
+            {
+                return SaveFormat::ReadVolumeSave(Bytes.GetData(), Bytes.Num(), Record);
+            }, bFromTemp, FileResult);
+        if (FileResult != SaveFormat::EReadResult::Ok)
+        {
+            VolumeFile.PreserveBeforeWrite();
+        }
+        if (bLoaded)
+        {
+            VolumeData.BGMVolume = Record.BGMVolume;
+            VolumeData.SEVolume = Record.SEVolume;
+            bVolumeDirty = bFromTemp;
+            return VolumeData;
+        }
+
+        if (FileResult == SaveFormat::EReadResult::UnsupportedVersion)
+            return VolumeData;
+
+        if (TSharedPtr<FJsonObject> Json = LoadJsonFile(VOLUME_JSON_FILE_NAME))
+        {
+            VolumeData = FVolumeSaveData::FromJson(Json);
+            VolumeFile.RetireAfterWrite(GetSavedPath(VOLUME_JSON_FILE_NAME));
+        }
+        else
+        {
+            UE_LOG(LogTemp, Warning, TEXT("Volume save file not found, creating new with default values."));
+        }
+        bVolumeDirty = true;
+    }
+    return VolumeData;
+}
+
+void FSaveStore::SetVolumeData(const FVolumeSaveData& NewData)
+{
+    GetVolumeData();
+
+    if (FVolumeSaveData::StaticStruct()->CompareScriptStruct(&VolumeData, &NewData, PPF_None))
+        return;
+
+    VolumeData = NewData;
+    bVolumeDirty = true;
+}
+
+void FSaveStore::Flush()
+{
+    WriteDirty();
+    StageFile.Flush();
+    VolumeFile.Flush();
+}
+
+// 1. 以前に失敗した書き込みがあれば、時刻を過ぎていれば書き直す
+// 2. Dirty なデータをコピーして書き込みを依頼する（バイナリへの変換と書き込みはバックグラウンドで行う）
+void FSaveStore::WriteDirty()
+{
+    StageFile.RetryFailedWrite();
+    VolumeFile.RetryFailedWrite();
+
+    if (bStageDirty)
+    {
+        bStageDirty = false;
+        StageFile.Write([Data = StageData]() { return EncodeStageSave(Data); });
+    }
+
+    if (bVolumeDirty)
+    {
+        bVolumeDirty = false;
+        VolumeFile.Write([Data = VolumeData]() { return EncodeVolumeSave(Data); });
+    }
+}
+
+// 読み込み前なら先に読んでから書き出す
+void FSaveStore::ExportJson()
+{
+    FStageSaveData Stage = GetStageData();
+    SaveJsonFile(STAGE_EXPORT_FILE_NAME, Stage.ToJson());
+    SaveJsonFile(VOLUME_EXPORT_FILE_NAME, GetVolumeData().ToJson());
+}
+
+// 読み込めたデータだけ置き換えて Dirty を立てる（読めなかったセーブファイルを残すため、置き換える前に1度読んでおく）
+bool FSaveStore::ImportJson()
+{
+    bool bImported = false;
+    if (TSharedPtr<FJsonObject> Json = LoadJsonFile(STAGE_EXPORT_FILE_NAME))
+    {
+        SetAllStageData(FStageSaveData::FromJson(Json));
+        bImported = true;
+    }
+    if (TSharedPtr<FJsonObject> Json = LoadJsonFile(VOLUME_EXPORT_FILE_NAME))
+    {
+        GetVolumeData();
+        VolumeData = FVolumeSaveData::FromJson(Json);
+        bVolumeDirty = true;
+        bImported = true;
+    }
+    return bImported;
+}
+
+void FSaveStore::OnPreExit()
+{
+    Flush();
+
+    FCoreDelegates::OnEndFrame.Remove(EndFrameHandle);
+    FCoreDelegates::OnEnginePreExit.Remove(PreExitHandle);
+}
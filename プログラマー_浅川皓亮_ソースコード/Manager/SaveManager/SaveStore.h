@@ -0,0 +1,163 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Async/Future.h"
+#include "HAL/CriticalSection.h"
+#include "DataContainer/SaveData.h"
+
+/**
+ * 1つのセーブファイルをバックグラウンドで書き込む
+ * 書き込み中に次の書き込みが来た場合は最新の1つだけを残し、書き込みが終わってから続けて書く
+ * 一時ファイルに書いてから1回の操作で置き換えるため、途中で終了しても壊れたファイルが残らない
+ * （置き換えを1回で行えないプラットフォームでは、読み込み側が一時ファイルから復旧する）
+ * 書き込みに失敗した依頼は捨てずに残し、一定時間後か Flush で書き直す（その間に新しい依頼が来ればそちらを書く）
+ */
+class FAsyncSaveFile
+{
+public:
+    explicit FAsyncSaveFile(const FString& InFileName);
+    ~FAsyncSaveFile();
+
+    FAsyncSaveFile(const FAsyncSaveFile&) = delete;
+    FAsyncSaveFile& operator=(const FAsyncSaveFile&) = delete;
+
+    /* セーブファイルのパス */
+    const FString& GetPath() const { return Path; }
+
+    /**
+     * 書き込みを依頼する（ゲームスレッドで呼ぶ）
+     * @param Serialize ファイルの中身を作る処理（バックグラウンドで呼ばれるため、データはコピーして持たせる）
+     */
+    void Write(TFunction<TArray<uint8>()>&& Serialize);
+
+    /**
+     * 次の書き込みが成功した後に、移行元のファイルの名前に .migrated を付けて退避する（ゲームスレッドで呼ぶ）
+     * 移行が終わったファイルを次の起動で読み直さないようにする
+     * @param InPath 移行元のファイルのパス
+     */
+    void RetireAfterWrite(const FString& InPath);
+
+    /**
+     * 次の書き込みの前に、今のセーブファイルを .bad を付けてコピーしておく（ゲームスレッドで呼ぶ）
+     * 読めなかったファイルを既定値で上書きして、調べる手掛かりや新しい形式のデータを失わないようにする
+     */
+    void PreserveBeforeWrite();
+
+    /* 失敗した書き込みが残っていて、再試行の時刻を過ぎていれば書き直す（ゲームスレッドで毎フレーム呼ぶ） */
+    void RetryFailedWrite();
+
+    /* 依頼済みの書き込みが全て終わるまで待つ（失敗して残っている依頼もすぐに書き直す、ゲームスレッドで呼ぶ） */
+    void Flush();
+
+private:
+    /* バックグラウンドの書き込みが動いていなければ開始する（Lock を取った状態で呼ぶ） */
+    void StartWriterLocked();
+
+    /* バックグラウンドで、依頼が無くなるまで書き込みを続ける */
+    void RunWriter();
+
+    /* 一時ファイルに書いてから置き換える */
+    bool WriteAtomic(const TArray<uint8>& Bytes) const;
+
+    FString Path;
+
+    /* PendingSerialize・PendingRetirePath・bPreservePending・NextRetryTime と bWriterRunning を守る */
+    FCriticalSection Lock;
+
+    /* まだ書いていない最新の依頼 */
+    TFunction<TArray<uint8>()> PendingSerialize;
+
+    /* 次の書き込みの後に退避する移行元のファイル（無ければ空） */
+    FString PendingRetirePath;
+
+    /* 次の書き込みの前に今のファイルをコピーしておくか */
+    bool bPreservePending = false;
+
+    /* 失敗した依頼を書き直す時刻（FPlatformTime::Seconds） */
+    double NextRetryTime = 0.0;
+
+    /* バックグラウンドの書き込みが動いているか */
+    bool bWriterRunning = false;
+
+    /* 最後に開始したバックグラウンドの書き込み（ゲームスレッドだけが触る） */
+    TFuture<void> WriterTask;
+};
+
+/**
+ * ステージクリア情報と音量設定をメモリに持つセーブデータ
+ * 最初の取得時に1度だけファイルから読み、以降の取得はメモリから返す
+ * 変更は Dirty を立てるだけで、フレームの最後にまとめてバックグラウンドで書き込む
+ * （終了時は残っている変更を書き込んでから終わる）
+ *
+ * ファイルはバイナリ形式（SaveFormat）で保存する
+ * バイナリが無いか読めない場合は、置き換え前に残った一時ファイル、以前のJSONファイルの順に読み、次の書き込みでバイナリを作り直す
+ * 読めなかったバイナリは、作り直す前に .bad を付けて残す
+ * 新しい形式のバイナリは既定値で上書きしない（このバージョンで値を変えた場合だけ、残してから書き込む）
+ * 移行が終わったJSONファイルは .migrated を付けて退避する
+ * デバッグ用のJSONの書き出し・読み込みは、以前の形式とは別のファイル（*.export.json）で行う
+ */
+class FSaveStore
+{
+public:
+    /* プロセスに1つのセーブデータを取得する */
+    static FSaveStore& Get();
+
+    FSaveStore();
+
+    FSaveStore(const FSaveStore&) = delete;
+    FSaveStore& operator=(const FSaveStore&) = delete;
+
+    /* ステージのセーブデータ（初回のみファイルから読む） */
+    const FStageSaveData& GetStageData();
+
+    /**
+     * ステージのセーブデータを更新する（内容が変わらなければ書き込まない）
+     * @param StageKey ステージの識別キー
+     * @param NewData 保存するセーブデータ
+     */
+    void SetStageData(const FString& StageKey, const FSaveData& NewData);
+
+    /* ステージのセーブデータを全て置き換える */
+    void SetAllStageData(const FStageSaveData& NewData);
+
+    /* 音量設定（初回のみファイルから読み、無ければ既定値で作る） */
+    const FVolumeSaveData& GetVolumeData();
+
+    /* 音量設定を置き換える */
+    void SetVolumeData(const FVolumeSaveData& NewData);
+
+    /* 変更を全て書き込み、終わるまで待つ */
+    void Flush();
+
+    /* 現在のデータをJSONファイル（*.export.json）に書き出す（デバッグ用、その場で書き込む） */
+    void ExportJson();
+
+    /**
+     * JSONファイル（*.export.json）からデータを読み込んで置き換える（デバッグ用、バイナリには次の書き込みで反映される）
+     * @return 1つでも読み込めたか
+     */
+    bool ImportJson();
+
+private:
+    /* Dirty なデータの書き込みを依頼する（フレームの最後に呼ばれる） */
+    void WriteDirty();
+
+    /* 終了前に残っている変更を書き込み、エンジンのデリゲートから外す */
+    void OnPreExit();
+
+    FStageSaveData StageData;
+    FVolumeSaveData VolumeData;
+
+    bool bStageLoaded = false;
+    bool bVolumeLoaded = false;
+    bool bStageDirty = false;
+    bool bVolumeDirty = false;
+
+    FAsyncSaveFile StageFile;
+    FAsyncSaveFile VolumeFile;
+
+    FDelegateHandle EndFrameHandle;
+    FDelegateHandle PreExitHandle;
+};
@@ -3,7 +3,7 @@
 
 #include "Manager/WeatherEffectManager.h"
 #include "Manager/ColorManager.h"
-#include "Manager/LevelManager.h"
+#include "Manager/GameServicesSubsystem.h"
 #include "NiagaraComponent.h"
 #include "NiagaraFunctionLibrary.h"
 #include "Logic/ColorManager/ColorTargetRegistry.h"
@@ -22,10 +22,11 @@ void UWeatherComponent::BeginPlay()
 
     InitializeEffects();
 
-    ALevelManager* LevelManager = ALevelManager::GetInstance(GetWorld());
-    if (LevelManager && LevelManager->GetColorManager() && LevelManager->GetColorManager()->GetColorTargetRegistry())
+    const UGameServicesSubsystem* Services = UGameServicesSubsystem::Get(this);
+    UColorManager* ColorManager = Services ? Services->GetColorManager() : nullptr;
+    if (ColorManager && ColorManager->GetColorTargetRegistry())
     {
-        LevelManager->GetColorManager()->GetColorTargetRegistry()->OnColorApplied.AddDynamic(this, &UWeatherComponent::SetWeather);
+        ColorManager->GetColorTargetRegistry()->OnColorApplied.AddDynamic(this, &UWeatherComponent::SetWeather);
     }
 }
 
@@ -134,9 +135,12 @@ void UWeatherComponent::SetWeather(EColorTargetType Mode, FLinearColor NewColor)
     if (Mode != EColorTargetType::WorldColor)
         return;
 
-    FEffectMatchResult Match = ALevelManager::GetInstance(GetWorld())
-        ->GetColorManager()
-        ->GetClosestEffectByHue(NewColor);
+    const UGameServicesSubsystem* Services = UGameServicesSubsystem::Get(this);
+    UColorManager* ColorManager = Services ? Services->GetColorManager() : nullptr;
+    if (!ColorManager)
+        return;
+
+    FEffectMatchResult Match = ColorManager->GetClosestEffectByHue(NewColor);
 
     if (RainEffect)
         RainEffect->Deactivate();
@@ -0,0 +1,131 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Logic/Physics/KinematicsBoxWorld.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace Kinematics
+{
+	void FKinematicsBoxWorld::AddBox(const FKinVector& Center, const FKinVector& HalfExtent)
+	{
+		Boxes.push_back({ Center, HalfExtent });
+	}
+
+	// 処理の流れ:
+	// 1. 各ボックスをスイープするボックスの大きさだけ膨らませる
+	// 2. 開始位置から終了位置への線分と膨らませたボックスをスラブ法で判定
+	// 3. 最も手前で当たった距離と、その面の法線を返す
+	//    （開始時点で重なっていれば UE のスイープと同様に距離0とし、最も浅く抜け出せる向きを法線とする）
+	bool FKinematicsBoxWorld::SweepBox(const FKinSweep& Sweep, FKinHit& OutHit) const
+	{
+		const FKinVector Delta = Sweep.End - Sweep.Start;
+		const float Length = Delta.Size();
+		if (Length < 1.e-4f)
+			return false;
+
+		const float Start[3] = { Sweep.Start.X, Sweep.Start.Y, Sweep.Start.Z };
+		const float Dir[3] = { Delta.X, Delta.Y, Delta.Z };
+
+		float BestTime = std::numeric_limits<float>::max();
+		int BestAxis = -1;
+		float BestSign = 0.0f;
+		bool bFound = false;
+
+		for (const FKinBox& Box : Boxes)
+		{
+			const float Min[3] = {
+				Box.Center.X - Box.HalfExtent.X - Sweep.HalfExtent.X,
+				Box.Center.Y - Box.HalfExtent.Y - Sweep.HalfExtent.Y,
+				Box.Center.Z - Box.HalfExtent.Z - Sweep.HalfExtent.Z };
+			const float Max[3] = {
+				Box.Center.X + Box.HalfExtent.X + Sweep.HalfExtent.X,
+				Box.Center.Y + Box.HalfExtent.Y + Sweep.HalfExtent.Y,
+				Box.Center.Z + Box.HalfExtent.Z + Sweep.HalfExtent.Z };
+
+			float EnterTime = 0.0f;
+			float ExitTime = 1.0f;
+			int EnterAxis = -1;
+			float EnterSign = 0.0f;
+			bool bMiss = false;
+
+			for (int Axis = 0; Axis < 3; ++Axis)
+			{
+				if (std::fabs(Dir[Axis]) < 1.e-8f)
+				{
+					// 軸に平行な場合は範囲外なら当たらない
+					if (Start[Axis] < Min[Axis] || Start[Axis] > Max[Axis])
+					{
+						bMiss = true;
+						break;
+					}
+					continue;
+				}
+
+				const float InvDir = 1.0f / Dir[Axis];
+				float Near = (Min[Axis] - Start[Axis]) * InvDir;
+				float Far = (Max[Axis] - Start[Axis]) * InvDir;
+				float Sign = -1.0f;
+				if (Near > Far)
+				{
+					std::swap(Near, Far);
+					Sign = 1.0f;
+				}
+
+				if (Near > EnterTime)
+				{
+					EnterTime = Near;
+					EnterAxis = Axis;
+					EnterSign = Sign;
+				}
+				ExitTime = std::min(ExitTime, Far);
+
+				if (EnterTime > ExitTime)
+				{
+					bMiss = true;
+					break;
+				}
+			}
+
+			if (bMiss || EnterTime >= BestTime)
+				continue;
+
+			// 開始時点で重なっている場合は、押し出す距離が最も短い軸の外向きを法線とする
+			if (EnterAxis < 0)
+			{
+				float Depth = std::numeric_limits<float>::max();
+				for (int Axis = 0; Axis < 3; ++Axis)
+				{
+					if (Start[Axis] - Min[Axis] < Depth)
+					{
+						Depth = Start[Axis] - Min[Axis];
+						EnterAxis = Axis;
+						EnterSign = -1.0f;
+					}
+					if (Max[Axis] - Start[Axis] < Depth)
+					{
+						Depth = Max[Axis] - Start[Axis];
+						EnterAxis = Axis;
+						EnterSign = 1.0f;
+					}
+				}
+			}
+
+			BestTime = EnterTime;
+			BestAxis = EnterAxis;
+			BestSign = EnterSign;
+			bFound = true;
+		}
+
+		if (!bFound)
+			return false;
+
+		OutHit.Distance = BestTime * Length;
+		OutHit.Normal = FKinVector(
+			BestAxis == 0 ? BestSign : 0.0f,
+			BestAxis == 1 ? BestSign : 0.0f,
+			BestAxis == 2 ? BestSign : 0.0f);
+		return true;
+	}
+}
@@ -0,0 +1,43 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "Logic/Physics/KinematicsCore.h"
+
+#include <vector>
+
+namespace Kinematics
+{
+	// 軸平行の静的ボックス
+	struct FKinBox
+	{
+		FKinVector Center;
+		FKinVector HalfExtent;
+	};
+
+	/**
+	 * メモリ上の静的ボックスだけで構成された衝突判定
+	 * エディタ無しで自前物理の挙動確認・計測を行うために使う
+	 * スイープするボックスの回転は無視し、軸平行として扱う
+	 */
+	class FKinematicsBoxWorld : public IKinematicsCollisionQuery
+	{
+	public:
+		/**
+		 * 静的ボックスを追加
+		 * @param Center 中心位置
+		 * @param HalfExtent 半分の大きさ
+		 */
+		void AddBox(const FKinVector& Center, const FKinVector& HalfExtent);
+
+		// 全てのボックスを削除
+		void Clear() { Boxes.clear(); }
+
+		int32_t NumBoxes() const { return static_cast<int32_t>(Boxes.size()); }
+
+		virtual bool SweepBox(const FKinSweep& Sweep, FKinHit& OutHit) const override;
+
+	private:
+		std::vector<FKinBox> Boxes;
+	};
+}
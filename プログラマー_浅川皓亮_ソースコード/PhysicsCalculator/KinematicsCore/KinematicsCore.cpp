@@ -0,0 +1,556 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Logic/Physics/KinematicsCore.h"
+
+#include <algorithm>
+
+namespace Kinematics
+{
+	namespace
+	{
+		// 既存の力・落下速度は60fpsの1フレーム当たりの移動量として調整されている
+		static constexpr float REFERENCE_STEP_RATE = 60.0f;
+		// 力の減衰速度（1秒当たり）
+		static constexpr float FORCE_DECAY_RATE = 10.0f;
+
+		// 接地判定用の足元ボックス（X・Yはスケール倍）と判定距離
+		static constexpr float GROUND_BOX_EXTENT_X = 40.0f;
+		static constexpr float GROUND_BOX_EXTENT_Y = 20.0f;
+		static constexpr float GROUND_BOX_EXTENT_Z = 15.0f;
+		static constexpr float GROUND_CHECK_DISTANCE = 5.0f;
+
+		// 移動判定用ボックス（スケール倍）と、開始位置の後退量・停止位置の余白
+		static constexpr float MOVE_BOX_EXTENT = 20.0f;
+		static constexpr float MOVE_BACKSTEP_DISTANCE = 1.0f;
+		static constexpr float MOVE_ADJUST_MARGIN = 0.1f;
+
+		// 天井に当たったとみなす移動率
+		static constexpr float CEILING_BLOCK_RATIO = 0.1f;
+
+		// 1ステップで面に沿って滑らせる回数の上限（最初の移動を含む）
+		static constexpr int32_t MAX_SLIDE_ITERATIONS = 2;
+		// 歩ける面とみなす法線の上方向成分（約45度）
+		static constexpr float WALKABLE_NORMAL_Z = 0.7f;
+
+		// 重力による落下速度（基準レートでの1フレーム当たりの移動量）
+		float GetFallSpeed(const FKinematicsBodies& Bodies, int32_t Index, float Timer)
+		{
+			return std::min((Bodies.GravityScales[Index] * Timer) / Bodies.ForceModifiers[Index], Bodies.MaxFallingSpeeds[Index]);
+		}
+
+		// ローカル指定の力をワールド座標に変換
+		FKinVector ToWorldForce(const FKinematicsBodies& Bodies, int32_t Index, const FKinVector& Force)
+		{
+			return HasFlag(Bodies.Flags[Index], EBodyFlags::LocalOffset) ? Bodies.Rotations[Index].RotateVector(Force) : Force;
+		}
+	}
+
+	// =======================
+	// 数学型
+	// =======================
+
+	FKinVector FKinVector::GetSafeNormal() const
+	{
+		const float SquareSum = SizeSquared();
+		if (SquareSum < 1.e-8f)
+			return FKinVector();
+
+		return *this * (1.0f / std::sqrt(SquareSum));
+	}
+
+	FKinVector FKinVector::GetClampedToMaxSize(float MaxSize) const
+	{
+		if (MaxSize < 1.e-4f)
+			return FKinVector();
+
+		const float SquareSum = SizeSquared();
+		if (SquareSum <= MaxSize * MaxSize)
+			return *this;
+
+		return *this * (MaxSize / std::sqrt(SquareSum));
+	}
+
+	// v' = v + 2w(q×v) + 2q×(q×v)
+	FKinVector FKinQuat::RotateVector(const FKinVector& V) const
+	{
+		const FKinVector Q(X, Y, Z);
+		const FKinVector T(
+			2.0f * (Q.Y * V.Z - Q.Z * V.Y),
+			2.0f * (Q.Z * V.X - Q.X * V.Z),
+			2.0f * (Q.X * V.Y - Q.Y * V.X));
+
+		return V + T * W + FKinVector(
+			Q.Y * T.Z - Q.Z * T.Y,
+			Q.Z * T.X - Q.X * T.Z,
+			Q.X * T.Y - Q.Y * T.X);
+	}
+
+	// =======================
+	// SoA コンテナ
+	// =======================
+
+	int32_t FKinematicsBodies::Add(const FKinVector& Location)
+	{
+		ForceDirections.emplace_back();
+		ForceScales.push_back(0.0f);
+		Timers.push_back(0.0f);
+		GravityScales.push_back(9.8f);
+		ForceModifiers.push_back(1.0f);
+		MaxFallingSpeeds.push_back(200.0f);
+		Flags.push_back(EBodyFlags::ApplyGravity | EBodyFlags::LocalOffset);
+		Locations.push_back(Location);
+		Rotations.emplace_back();
+		Scales.emplace_back(1.0f, 1.0f, 1.0f);
+		HalfHeights.push_back(0.0f);
+		PreviousPositions.push_back(Location);
+		DesiredMoves.emplace_back();
+		FieldMoves.emplace_back();
+		RestSteps.push_back(0);
+		bAwakeIndicesDirty = true;
+		return Num() - 1;
+	}
+
+	void FKinematicsBodies::RemoveAtSwap(int32_t Index)
+	{
+		const auto RemoveSwap = [Index](auto& Array)
+		{
+			Array[Index] = Array.back();
+			Array.pop_back();
+		};
+
+		RemoveSwap(ForceDirections);
+		RemoveSwap(ForceScales);
+		RemoveSwap(Timers);
+		RemoveSwap(GravityScales);
+		RemoveSwap(ForceModifiers);
+		RemoveSwap(MaxFallingSpeeds);
+		RemoveSwap(Flags);
+		RemoveSwap(Locations);
+		RemoveSwap(Rotations);
+		RemoveSwap(Scales);
+		RemoveSwap(HalfHeights);
+		RemoveSwap(PreviousPositions);
+		RemoveSwap(DesiredMoves);
+		RemoveSwap(FieldMoves);
+		RemoveSwap(RestSteps);
+		bAwakeIndicesDirty = true;
+	}
+
+	void FKinematicsBodies::RefreshAwakeIndices()
+	{
+		if (!bAwakeIndicesDirty)
+			return;
+
+		AwakeIndices.clear();
+		for (int32_t i = 0; i < Num(); ++i)
+		{
+			if (!HasFlag(Flags[i], EBodyFlags::Sleeping))
+			{
+				AwakeIndices.push_back(i);
+			}
+		}
+		bAwakeIndicesDirty = false;
+	}
+
+	// =======================
+	// 外部からの操作
+	// =======================
+
+	void AddForce(FKinematicsBodies& Bodies, int32_t Index, const FKinVector& Direction, float Force, bool bSweep, bool bUseLocalOffset)
+	{
+		WakeBody(Bodies, Index);
+
+		Bodies.ForceDirections[Index] = Direction;
+		Bodies.ForceScales[Index] = Force;
+		Bodies.Timers[Index] = 0.0f;
+
+		EBodyFlags& Flags = Bodies.Flags[Index];
+		Flags &= ~(EBodyFlags::PhysicsEnabled | EBodyFlags::Sweep | EBodyFlags::LocalOffset);
+		if (bSweep) Flags |= EBodyFlags::Sweep;
+		if (bUseLocalOffset) Flags |= EBodyFlags::LocalOffset;
+
+		// 上向きの力(ジャンプ)の場合、一時的に接地判定を無視
+		if (Direction.Z > 0)
+		{
+			Flags |= EBodyFlags::IgnoreGroundCheck;
+		}
+	}
+
+	void ResetForce(FKinematicsBodies& Bodies, int32_t Index)
+	{
+		WakeBody(Bodies, Index);
+
+		Bodies.ForceDirections[Index] = FKinVector();
+		Bodies.ForceScales[Index] = 0.0f;
+		Bodies.Timers[Index] = 0.0f;
+		Bodies.Flags[Index] |= EBodyFlags::PhysicsEnabled;
+	}
+
+	void WakeBody(FKinematicsBodies& Bodies, int32_t Index)
+	{
+		Bodies.RestSteps[Index] = 0;
+
+		if (!HasFlag(Bodies.Flags[Index], EBodyFlags::Sleeping))
+			return;
+
+		Bodies.Flags[Index] &= ~EBodyFlags::Sleeping;
+		Bodies.bAwakeIndicesDirty = true;
+	}
+
+	void PutBodyToSleep(FKinematicsBodies& Bodies, int32_t Index)
+	{
+		if (HasFlag(Bodies.Flags[Index], EBodyFlags::Sleeping))
+			return;
+
+		Bodies.Flags[Index] |= EBodyFlags::Sleeping;
+		Bodies.Flags[Index] &= ~EBodyFlags::JustLanded;
+		Bodies.RestSteps[Index] = 0;
+		Bodies.bAwakeIndicesDirty = true;
+	}
+
+	// 処理の流れ:
+	// 1. 接地していて移動量が無ければ静止ステップ数を数える（それ以外はリセット）
+	// 2. 静止が閾値まで続いたらスリープ状態にして計算対象から外す
+	bool UpdateSleepState(FKinematicsBodies& Bodies, int32_t Index)
+	{
+		const EBodyFlags Flags = Bodies.Flags[Index];
+		const bool bResting =
+			HasFlag(Flags, EBodyFlags::OnGround) &&
+			!HasFlag(Flags, EBodyFlags::IgnoreGroundCheck) &&
+			Bodies.DesiredMoves[Index].IsNearlyZero() &&
+			Bodies.ForceScales[Index] <= 0.0f;
+
+		if (!bResting)
+		{
+			Bodies.RestSteps[Index] = 0;
+			return false;
+		}
+
+		if (++Bodies.RestSteps[Index] < Bodies.SleepStepThreshold)
+			return false;
+
+		Bodies.Flags[Index] |= EBodyFlags::Sleeping;
+		Bodies.Flags[Index] &= ~EBodyFlags::JustLanded;
+		Bodies.bAwakeIndicesDirty = true;
+		return true;
+	}
+
+	// スリープ中のボディも、このフレームで着地してから眠ったものがあるため全て対象にする
+	void BeginFrame(FKinematicsBodies& Bodies)
+	{
+		for (EBodyFlags& Flags : Bodies.Flags)
+		{
+			Flags &= ~EBodyFlags::LandedThisFrame;
+		}
+	}
+
+	void ApplyGroundResult(FKinematicsBodies& Bodies, int32_t Index, bool bOnGround)
+	{
+		if (bOnGround)
+		{
+			Bodies.Flags[Index] |= EBodyFlags::OnGround;
+		}
+		else
+		{
+			Bodies.Flags[Index] &= ~EBodyFlags::OnGround;
+		}
+	}
+
+	// =======================
+	// 力場
+	// =======================
+
+	// 位置を力場のローカル座標へ戻し、ボディの大きさ分広げた各軸の半径と比べる
+	bool IsInsideForceField(const FKinForceField& Field, const FKinVector& Location, float Radius)
+	{
+		const FKinQuat Inverse(-Field.Rotation.X, -Field.Rotation.Y, -Field.Rotation.Z, Field.Rotation.W);
+		const FKinVector Local = Inverse.RotateVector(Location - Field.Center);
+
+		return std::fabs(Local.X) <= Field.HalfExtent.X + Radius &&
+			std::fabs(Local.Y) <= Field.HalfExtent.Y + Radius &&
+			std::fabs(Local.Z) <= Field.HalfExtent.Z + Radius;
+	}
+
+	void AccumulateForceField(FKinematicsBodies& Bodies, int32_t Index, const FKinForceField& Field, float StepTime)
+	{
+		const FKinVector Move = Field.Direction * (Field.Power * StepTime * REFERENCE_STEP_RATE);
+		Bodies.FieldMoves[Index] += Field.bLocalDirection ? Bodies.Rotations[Index].RotateVector(Move) : Move;
+	}
+
+	void ResetFieldMoves(FKinematicsBodies& Bodies)
+	{
+		Bodies.RefreshAwakeIndices();
+		for (const int32_t i : Bodies.AwakeIndices)
+		{
+			Bodies.FieldMoves[i] = FKinVector();
+		}
+	}
+
+	void ApplyForceFields(FKinematicsBodies& Bodies, const std::vector<FKinForceField>& Fields, float StepTime)
+	{
+		ResetFieldMoves(Bodies);
+		for (const FKinForceField& Field : Fields)
+		{
+			if (Field.IsIdle())
+				continue;
+
+			for (const int32_t i : Bodies.AwakeIndices)
+			{
+				if (IsInsideForceField(Field, Bodies.Locations[i], Bodies.HalfHeights[i])
+					&& std::find(Field.BlockedBodies.begin(), Field.BlockedBodies.end(), i) == Field.BlockedBodies.end())
+				{
+					AccumulateForceField(Bodies, i, Field, StepTime);
+				}
+			}
+		}
+	}
+
+	// =======================
+	// 積分
+	// =======================
+
+	// 処理の流れ（ボディごと）:
+	// 1. 接地していなければ落下時間を進めて重力による移動量を求める
+	// 2. 着地判定とジャンプ中の上昇力キャンセル
+	// 3. 力を減衰させ、ステップ時間に応じた移動量を求める
+	// 4. 重力・力・力場の移動量を合算
+	void IntegrateBodies(FKinematicsBodies& Bodies, float StepTime)
+	{
+		const float StepScale = StepTime * REFERENCE_STEP_RATE;
+
+		Bodies.RefreshAwakeIndices();
+		for (const int32_t i : Bodies.AwakeIndices)
+		{
+			EBodyFlags Flags = Bodies.Flags[i];
+			const bool bOnGround = HasFlag(Flags, EBodyFlags::OnGround);
+
+			FKinVector GravityMove;
+			if (HasFlag(Flags, EBodyFlags::ApplyGravity))
+			{
+				if (bOnGround)
+				{
+					Flags &= ~(EBodyFlags::PhysicsEnabled | EBodyFlags::Falling);
+					Bodies.Timers[i] = 0.0f;
+				}
+				else
+				{
+					Bodies.Timers[i] += StepTime;
+					GravityMove = -Bodies.Rotations[i].GetUpVector() * (GetFallSpeed(Bodies, i, Bodies.Timers[i]) * StepScale);
+				}
+
+				const bool bWasOnGround = HasFlag(Flags, EBodyFlags::WasOnGround);
+				Flags &= ~(EBodyFlags::JustLanded | EBodyFlags::WasOnGround);
+				if (!bWasOnGround && bOnGround) Flags |= EBodyFlags::JustLanded | EBodyFlags::LandedThisFrame;
+				if (bOnGround) Flags |= EBodyFlags::WasOnGround;
+			}
+
+			// 接地したら上昇力をキャンセル（ただしジャンプ直後は無視）
+			const bool bIgnoreGround = HasFlag(Flags, EBodyFlags::IgnoreGroundCheck);
+			if (!bIgnoreGround && bOnGround && Bodies.ForceDirections[i].Z > 0)
+			{
+				Bodies.ForceDirections[i].Z = 0;
+				Bodies.ForceScales[i] = 0;
+				Bodies.Timers[i] = 0;
+				Flags |= EBodyFlags::PhysicsEnabled;
+			}
+
+			// 地面から離れたらフラグを解除
+			if (bIgnoreGround && !bOnGround)
+			{
+				Flags &= ~EBodyFlags::IgnoreGroundCheck;
+			}
+
+			FKinVector ForceMove;
+			if (!HasFlag(Flags, EBodyFlags::PhysicsEnabled))
+			{
+				Bodies.ForceScales[i] = std::max(Bodies.ForceScales[i] - StepTime * FORCE_DECAY_RATE, 0.0f);
+				ForceMove = ToWorldForce(Bodies, i, Bodies.ForceDirections[i] * (Bodies.ForceScales[i] * StepScale));
+			}
+
+			Bodies.DesiredMoves[i] = GravityMove + ForceMove + Bodies.FieldMoves[i];
+			Bodies.Flags[i] = Flags;
+		}
+	}
+
+	// 処理の流れ:
+	// 1. 現在の状態から次ステップの落下時間・力の減衰を進めた値を求める
+	// 2. その値で重力と力の移動量を合算（接地中は重力なし）
+	// 3. 力場は今回と同じだけ受けるとみなして加算
+	FKinVector PredictNextMove(const FKinematicsBodies& Bodies, int32_t Index, float StepTime)
+	{
+		const float StepScale = StepTime * REFERENCE_STEP_RATE;
+		const EBodyFlags Flags = Bodies.Flags[Index];
+
+		FKinVector Move;
+
+		if (HasFlag(Flags, EBodyFlags::ApplyGravity) && !HasFlag(Flags, EBodyFlags::OnGround))
+		{
+			const float FallSpeed = GetFallSpeed(Bodies, Index, Bodies.Timers[Index] + StepTime);
+			Move -= Bodies.Rotations[Index].GetUpVector() * (FallSpeed * StepScale);
+		}
+
+		if (!HasFlag(Flags, EBodyFlags::PhysicsEnabled))
+		{
+			const float NextScale = std::max(Bodies.ForceScales[Index] - StepTime * FORCE_DECAY_RATE, 0.0f);
+			Move += ToWorldForce(Bodies, Index, Bodies.ForceDirections[Index] * (NextScale * StepScale));
+		}
+
+		return Move + Bodies.FieldMoves[Index];
+	}
+
+	// 処理の流れ:
+	// 1. 残りの移動量を1回スイープし、当たる直前まで進める
+	// 2. 当たった面が歩ける角度なら接地として記録
+	// 3. 進めなかった分を面に沿う成分だけ残し、上限回数まで繰り返す
+	// 4. 天井に当たったら上昇力を、下降に転じたら力を打ち切る
+	FKinMoveResult MoveAndSlide(FKinematicsBodies& Bodies, int32_t Index, const IKinematicsCollisionQuery& Query, const FKinSweepResult* FirstSweep)
+	{
+		FKinMoveResult Result;
+
+		const FKinVector Desired = Bodies.DesiredMoves[Index];
+		if (Desired.IsNearlyZero())
+			return Result;
+
+		const FKinVector UpVector = Bodies.Rotations[Index].GetUpVector();
+		const FKinVector StartLocation = Bodies.Locations[Index];
+		FKinVector Remaining = Desired;
+
+		for (int32_t Iteration = 0; Iteration < MAX_SLIDE_ITERATIONS && !Remaining.IsNearlyZero(); ++Iteration)
+		{
+			FKinSweepResult Sweep;
+			if (Iteration == 0 && FirstSweep)
+			{
+				Sweep = *FirstSweep;
+			}
+			else
+			{
+				Sweep.bHit = Query.SweepBox(MakeMoveSweep(Bodies, Index, Remaining), Sweep.Hit);
+				++Result.QueryCount;
+			}
+
+			// 開始位置を後退させているため、接している面から離れる移動は重なった状態から始まる
+			// 法線が移動を妨げない向きの当たり（押し出し方向へ離れる移動）は無視する
+			if (Sweep.bHit && Sweep.Hit.Normal.Dot(Remaining) >= 0.0f)
+			{
+				Sweep.bHit = false;
+			}
+
+			// スイープは後退させた位置から始めているので、その分を差し引いて進める距離を求める
+			const float Length = Remaining.Size();
+			const float Allowed = Sweep.bHit
+				? std::max(Sweep.Hit.Distance - MOVE_BACKSTEP_DISTANCE - MOVE_ADJUST_MARGIN, 0.0f)
+				: Length;
+
+			if (Allowed >= Length)
+			{
+				Bodies.Locations[Index] += Remaining;
+				break;
+			}
+
+			const FKinVector Moved = Remaining.GetSafeNormal() * Allowed;
+			Bodies.Locations[Index] += Moved;
+
+			const FKinVector& Normal = Sweep.Hit.Normal;
+			if (Normal.Dot(UpVector) >= WALKABLE_NORMAL_Z)
+			{
+				Result.bGroundContact = true;
+				Result.GroundNormal = Normal;
+			}
+
+			// 面に沿う成分だけを残す
+			const FKinVector Blocked = Remaining - Moved;
+			Remaining = Blocked - Normal * Blocked.Dot(Normal);
+		}
+
+		EBodyFlags& Flags = Bodies.Flags[Index];
+		if (HasFlag(Flags, EBodyFlags::PhysicsEnabled))
+			return Result;
+
+		const FKinVector NewLocation = Bodies.Locations[Index];
+
+		// 天井に当たったら上昇力をキャンセル
+		if (Bodies.ForceDirections[Index].Z > 0 && Desired.Z > 0 && NewLocation.Z - StartLocation.Z < Desired.Z * CEILING_BLOCK_RATIO)
+		{
+			Bodies.ForceDirections[Index].Z = 0;
+			Bodies.ForceScales[Index] = 0;
+			Flags |= EBodyFlags::PhysicsEnabled;
+		}
+
+		// 下降に転じたら力を打ち切り落下状態へ
+		if (NewLocation.Z - Bodies.PreviousPositions[Index].Z < 0)
+		{
+			Bodies.ForceDirections[Index].Z = 0;
+			Bodies.ForceScales[Index] = 0;
+			Bodies.Timers[Index] = 0;
+			Flags |= EBodyFlags::PhysicsEnabled | EBodyFlags::Falling;
+		}
+		Bodies.PreviousPositions[Index] = NewLocation;
+
+		return Result;
+	}
+
+	// =======================
+	// 衝突判定
+	// =======================
+
+	FKinSweep MakeGroundSweep(const FKinematicsBodies& Bodies, int32_t Index)
+	{
+		const FKinQuat& Rotation = Bodies.Rotations[Index];
+		const FKinVector& Scale = Bodies.Scales[Index];
+		const FKinVector DownVector = -Rotation.GetUpVector();
+		const FKinVector FootLocation = Bodies.Locations[Index] + DownVector * Bodies.HalfHeights[Index];
+
+		FKinSweep Sweep;
+		Sweep.Start = FootLocation;
+		Sweep.End = FootLocation + DownVector * GROUND_CHECK_DISTANCE;
+		Sweep.Rotation = Rotation;
+		Sweep.HalfExtent = FKinVector(GROUND_BOX_EXTENT_X * Scale.X, GROUND_BOX_EXTENT_Y * Scale.Y, GROUND_BOX_EXTENT_Z);
+		Sweep.IgnoreBody = Index;
+		return Sweep;
+	}
+
+	FKinSweep MakeMoveSweep(const FKinematicsBodies& Bodies, int32_t Index, const FKinVector& Move)
+	{
+		const FKinVector& Scale = Bodies.Scales[Index];
+		const FKinVector Start = Bodies.Locations[Index] - Move.GetSafeNormal() * MOVE_BACKSTEP_DISTANCE;
+
+		FKinSweep Sweep;
+		Sweep.Start = Start;
+		Sweep.End = Bodies.Locations[Index] + Move;
+		Sweep.HalfExtent = Scale * MOVE_BOX_EXTENT;
+		Sweep.IgnoreBody = Index;
+		return Sweep;
+	}
+
+	// 処理の流れ:
+	// 1. 力場の移動量を加算し、スリープしていないボディの移動量をまとめて計算
+	// 2. ボディごとに移動と滑りを解決し、地面に当たれば接地とする
+	// 3. 移動中に地面へ当たらなかった重力ありのボディだけ足元を判定
+	// 4. 静止が続いたボディをスリープさせる
+	void StepBodies(FKinematicsBodies& Bodies, float StepTime, const IKinematicsCollisionQuery& Query, const std::vector<FKinForceField>* Fields)
+	{
+		if (Fields)
+		{
+			ApplyForceFields(Bodies, *Fields, StepTime);
+		}
+		IntegrateBodies(Bodies, StepTime);
+
+		FKinHit Hit;
+
+		for (const int32_t i : Bodies.AwakeIndices)
+		{
+			const FKinMoveResult Result = MoveAndSlide(Bodies, i, Query);
+			if (Result.bGroundContact)
+			{
+				ApplyGroundResult(Bodies, i, true);
+			}
+			else if (HasFlag(Bodies.Flags[i], EBodyFlags::ApplyGravity))
+			{
+				ApplyGroundResult(Bodies, i, Query.SweepBox(MakeGroundSweep(Bodies, i), Hit));
+			}
+
+			UpdateSleepState(Bodies, i);
+		}
+	}
+}
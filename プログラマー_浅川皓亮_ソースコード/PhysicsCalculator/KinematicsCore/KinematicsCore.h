@@ -0,0 +1,374 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+// エンジンに依存しない自前物理（重力・力の減衰・着地判定・移動補正）の計算部
+// UPhysicsBatchSubsystem から使うほか、エディタ無しのベンチマークからも使えるように
+// 標準ライブラリだけで実装する
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace Kinematics
+{
+	// =======================
+	// 数学型
+	// =======================
+
+	// 3次元ベクトル
+	struct FKinVector
+	{
+		float X = 0.0f;
+		float Y = 0.0f;
+		float Z = 0.0f;
+
+		FKinVector() = default;
+		FKinVector(float InX, float InY, float InZ) : X(InX), Y(InY), Z(InZ) {}
+
+		FKinVector operator+(const FKinVector& V) const { return FKinVector(X + V.X, Y + V.Y, Z + V.Z); }
+		FKinVector operator-(const FKinVector& V) const { return FKinVector(X - V.X, Y - V.Y, Z - V.Z); }
+		FKinVector operator-() const { return FKinVector(-X, -Y, -Z); }
+		FKinVector operator*(float S) const { return FKinVector(X * S, Y * S, Z * S); }
+		FKinVector& operator+=(const FKinVector& V) { X += V.X; Y += V.Y; Z += V.Z; return *this; }
+		FKinVector& operator-=(const FKinVector& V) { X -= V.X; Y -= V.Y; Z -= V.Z; return *this; }
+
+		float Dot(const FKinVector& V) const { return X * V.X + Y * V.Y + Z * V.Z; }
+		float SizeSquared() const { return Dot(*this); }
+		float Size() const { return std::sqrt(SizeSquared()); }
+		bool IsNearlyZero(float Tolerance = 1.e-4f) const { return std::fabs(X) <= Tolerance && std::fabs(Y) <= Tolerance && std::fabs(Z) <= Tolerance; }
+
+		/** 正規化したベクトルを返す（長さがほぼ0ならゼロベクトル） */
+		FKinVector GetSafeNormal() const;
+
+		/** 長さを上限で切り詰めたベクトルを返す @param MaxSize 上限の長さ */
+		FKinVector GetClampedToMaxSize(float MaxSize) const;
+	};
+
+	// 回転（クォータニオン）
+	struct FKinQuat
+	{
+		float X = 0.0f;
+		float Y = 0.0f;
+		float Z = 0.0f;
+		float W = 1.0f;
+
+		FKinQuat() = default;
+		FKinQuat(float InX, float InY, float InZ, float InW) : X(InX), Y(InY), Z(InZ), W(InW) {}
+
+		/** ベクトルを回転させる @param V 回転させるベクトル */
+		FKinVector RotateVector(const FKinVector& V) const;
+
+		// 回転後の上方向
+		FKinVector GetUpVector() const { return RotateVector(FKinVector(0.0f, 0.0f, 1.0f)); }
+	};
+
+	// =======================
+	// 衝突判定インターフェース
+	// =======================
+
+	// ボックスのスイープ要求
+	struct FKinSweep
+	{
+		FKinVector Start;
+		FKinVector End;
+		FKinQuat Rotation;
+		FKinVector HalfExtent;
+		// 判定から除外するボディ番号
+		int32_t IgnoreBody = -1;
+	};
+
+	// スイープの結果
+	struct FKinHit
+	{
+		// 開始位置から衝突位置までの距離
+		float Distance = 0.0f;
+		// 衝突面の法線
+		FKinVector Normal = FKinVector(0.0f, 0.0f, 1.0f);
+	};
+
+	// 事前に行ったスイープの結果
+	struct FKinSweepResult
+	{
+		bool bHit = false;
+		FKinHit Hit;
+	};
+
+	// 移動と滑りの結果
+	struct FKinMoveResult
+	{
+		// 移動中に歩ける面へ当たったか（接地判定の副産物）
+		bool bGroundContact = false;
+		// 当たった地面の法線
+		FKinVector GroundNormal = FKinVector(0.0f, 0.0f, 1.0f);
+		// 発行したスイープの数
+		int32_t QueryCount = 0;
+	};
+
+	/**
+	 * 衝突判定の抽象インターフェース
+	 * ゲームでは UWorld のスイープ、ベンチマークではメモリ上のボックスワールドが実装する
+	 */
+	class IKinematicsCollisionQuery
+	{
+	public:
+		virtual ~IKinematicsCollisionQuery() = default;
+
+		/**
+		 * ボックスをスイープして最初に当たった面を返す
+		 * @param Sweep スイープ要求
+		 * @param OutHit 衝突結果
+		 * @return 何かに当たったか
+		 */
+		virtual bool SweepBox(const FKinSweep& Sweep, FKinHit& OutHit) const = 0;
+	};
+
+	// =======================
+	// 力場
+	// =======================
+
+	/**
+	 * ベルトコンベア等の力場
+	 * 回転付きボックスの範囲内にいるボディへ、毎ステップ一定の移動量を加える
+	 * 複数の力場に入っている場合は合算される
+	 */
+	struct FKinForceField
+	{
+		// 範囲（中心・回転・半径）
+		FKinVector Center;
+		FKinQuat Rotation;
+		FKinVector HalfExtent;
+
+		// 押し出す方向と強さ（基準レートでの1フレーム当たりの移動量）
+		FKinVector Direction;
+		float Power = 0.0f;
+
+		// 方向をボディのローカル座標として扱うか
+		bool bLocalDirection = false;
+
+		// 遮蔽物があり力を加えないボディの番号
+		std::vector<int32_t> BlockedBodies;
+
+		// 押し出す力が無い（停止中）か
+		bool IsIdle() const { return Power == 0.0f || Direction.IsNearlyZero(); }
+	};
+
+	// =======================
+	// ボディの状態
+	// =======================
+
+	// ボディごとの状態フラグ
+	enum class EBodyFlags : uint16_t
+	{
+		None = 0,
+		ApplyGravity = 1 << 0,		// 重力を加える
+		PhysicsEnabled = 1 << 1,	// 力による移動を止めている（既存の bIsPhysicsEnabled と同じ意味）
+		Sweep = 1 << 2,				// 移動時に衝突を考慮する
+		LocalOffset = 1 << 3,		// 力の方向をローカル座標として扱う
+		OnGround = 1 << 4,			// 接地している
+		WasOnGround = 1 << 5,		// 前ステップで接地していた
+		JustLanded = 1 << 6,		// このステップで着地した
+		IgnoreGroundCheck = 1 << 7,	// ジャンプ直後で接地判定を無視している
+		Falling = 1 << 8,			// 落下中
+		Sleeping = 1 << 9,			// 静止しているため計算を止めている
+		LandedThisFrame = 1 << 10,	// このフレームのどこかのステップで着地した（BeginFrame まで残る）
+	};
+
+	inline EBodyFlags operator|(EBodyFlags A, EBodyFlags B) { return static_cast<EBodyFlags>(static_cast<uint16_t>(A) | static_cast<uint16_t>(B)); }
+	inline EBodyFlags operator&(EBodyFlags A, EBodyFlags B) { return static_cast<EBodyFlags>(static_cast<uint16_t>(A) & static_cast<uint16_t>(B)); }
+	inline EBodyFlags operator~(EBodyFlags A) { return static_cast<EBodyFlags>(~static_cast<uint16_t>(A)); }
+	inline EBodyFlags& operator|=(EBodyFlags& A, EBodyFlags B) { return A = A | B; }
+	inline EBodyFlags& operator&=(EBodyFlags& A, EBodyFlags B) { return A = A & B; }
+	inline bool HasFlag(EBodyFlags Flags, EBodyFlags Test) { return (Flags & Test) != EBodyFlags::None; }
+
+	/**
+	 * 全ボディの状態を構造体の配列（SoA）として保持するコンテナ
+	 * インデックスが同じ要素が1つのボディを表す
+	 */
+	struct FKinematicsBodies
+	{
+		// 力の方向と強さ
+		std::vector<FKinVector> ForceDirections;
+		std::vector<float> ForceScales;
+
+		// 落下時間と重力パラメータ
+		std::vector<float> Timers;
+		std::vector<float> GravityScales;
+		std::vector<float> ForceModifiers;
+		std::vector<float> MaxFallingSpeeds;
+
+		// 状態フラグ
+		std::vector<EBodyFlags> Flags;
+
+		// 姿勢（位置はこのコンテナが正とし、ホスト側が反映する）
+		std::vector<FKinVector> Locations;
+		std::vector<FKinQuat> Rotations;
+		std::vector<FKinVector> Scales;
+		std::vector<float> HalfHeights;
+
+		// 落下判定用の前回位置
+		std::vector<FKinVector> PreviousPositions;
+
+		// このステップで求めた移動量（重力＋力＋力場）
+		std::vector<FKinVector> DesiredMoves;
+
+		// このステップで力場から受けた移動量（ステップの最初にリセットして加算し直す）
+		std::vector<FKinVector> FieldMoves;
+
+		// 力が無く接地したままのステップ数
+		std::vector<uint16_t> RestSteps;
+
+		// 計算対象（スリープしていない）ボディの番号
+		// スリープ・起床・追加・削除があった時だけ作り直す
+		std::vector<int32_t> AwakeIndices;
+		bool bAwakeIndicesDirty = true;
+
+		// このステップ数だけ静止が続いたらスリープする
+		uint16_t SleepStepThreshold = 30;
+
+		/** 末尾にボディを1つ追加 @param Location 初期位置 @return 追加したインデックス */
+		int32_t Add(const FKinVector& Location);
+
+		/** 指定インデックスの要素を末尾と入れ替えて削除 */
+		void RemoveAtSwap(int32_t Index);
+
+		int32_t Num() const { return static_cast<int32_t>(Flags.size()); }
+
+		// 計算対象のボディ番号を必要なら作り直す
+		void RefreshAwakeIndices();
+
+		int32_t NumAwake() const { return static_cast<int32_t>(AwakeIndices.size()); }
+	};
+
+	// =======================
+	// 計算処理
+	// =======================
+
+	/**
+	 * フレームの最初に呼び、フレーム単位のフラグ（LandedThisFrame）をリセットする
+	 * 1フレームに複数ステップ進めても、途中の着地を利用側が1フレームに1回読めるようにする
+	 * @param Bodies ボディの状態
+	 */
+	void BeginFrame(FKinematicsBodies& Bodies);
+
+	/**
+	 * ボディに力を加える
+	 * @param Bodies ボディの状態
+	 * @param Index 対象のボディ番号
+	 * @param Direction 力の方向
+	 * @param Force 力の強さ
+	 * @param bSweep 衝突を考慮して移動するか
+	 * @param bUseLocalOffset 方向をローカル座標として扱うか
+	 */
+	void AddForce(FKinematicsBodies& Bodies, int32_t Index, const FKinVector& Direction, float Force, bool bSweep, bool bUseLocalOffset);
+
+	/** ボディの力をリセット @param Bodies ボディの状態 @param Index 対象のボディ番号 */
+	void ResetForce(FKinematicsBodies& Bodies, int32_t Index);
+
+	/**
+	 * スリープ中のボディを起こす
+	 * @param Bodies ボディの状態
+	 * @param Index 対象のボディ番号
+	 */
+	void WakeBody(FKinematicsBodies& Bodies, int32_t Index);
+
+	/**
+	 * ボディを静止状態に関わらずスリープさせる（画面外で計算を止める時など）
+	 * @param Bodies ボディの状態
+	 * @param Index 対象のボディ番号
+	 */
+	void PutBodyToSleep(FKinematicsBodies& Bodies, int32_t Index);
+
+	/**
+	 * 静止が続いたボディをスリープさせる（移動と接地判定の後に呼ぶ）
+	 * @param Bodies ボディの状態
+	 * @param Index 対象のボディ番号
+	 * @return このステップでスリープしたか
+	 */
+	bool UpdateSleepState(FKinematicsBodies& Bodies, int32_t Index);
+
+	/**
+	 * 接地判定の結果を反映する
+	 * @param Bodies ボディの状態
+	 * @param Index 対象のボディ番号
+	 * @param bOnGround 接地しているか
+	 */
+	void ApplyGroundResult(FKinematicsBodies& Bodies, int32_t Index, bool bOnGround);
+
+	/**
+	 * ボディが力場の範囲に触れているか（範囲をボディの大きさ分広げて中心位置で判定）
+	 * @param Field 力場
+	 * @param Location ボディの中心位置
+	 * @param Radius ボディの大きさ（半分の高さ）
+	 */
+	bool IsInsideForceField(const FKinForceField& Field, const FKinVector& Location, float Radius);
+
+	/**
+	 * 力場から受ける1ステップ分の移動量をボディに加算する（範囲の判定は呼び出し側で行う）
+	 * @param Bodies ボディの状態
+	 * @param Index 対象のボディ番号
+	 * @param Field 力場
+	 * @param StepTime ステップ時間（秒）
+	 */
+	void AccumulateForceField(FKinematicsBodies& Bodies, int32_t Index, const FKinForceField& Field, float StepTime);
+
+	/** スリープしていない全ボディの力場の移動量をリセット @param Bodies ボディの状態 */
+	void ResetFieldMoves(FKinematicsBodies& Bodies);
+
+	/**
+	 * スリープしていない全ボディの力場の移動量をリセットし、範囲内の力場の移動量を加算する
+	 * 力場の BlockedBodies に含まれるボディには加算しない
+	 * @param Bodies ボディの状態
+	 * @param Fields 力場の一覧
+	 * @param StepTime ステップ時間（秒）
+	 */
+	void ApplyForceFields(FKinematicsBodies& Bodies, const std::vector<FKinForceField>& Fields, float StepTime);
+
+	/**
+	 * 重力・力の減衰・力場からスリープしていない全ボディの移動量を求める（結果は DesiredMoves）
+	 * @param Bodies ボディの状態
+	 * @param StepTime ステップ時間（秒）
+	 */
+	void IntegrateBodies(FKinematicsBodies& Bodies, float StepTime);
+
+	/**
+	 * 次ステップで発生する移動量を予測する
+	 * @param Bodies ボディの状態
+	 * @param Index 対象のボディ番号
+	 * @param StepTime ステップ時間（秒）
+	 * @return 予測移動量（ワールド座標）
+	 */
+	FKinVector PredictNextMove(const FKinematicsBodies& Bodies, int32_t Index, float StepTime);
+
+	/**
+	 * 移動量（重力＋力）を1回のスイープで解決し、当たった面に沿って滑らせる
+	 * 天井・落下の判定もここで行い、歩ける面に当たった場合は接地として返す
+	 * @param Bodies ボディの状態
+	 * @param Index 対象のボディ番号
+	 * @param Query 衝突判定
+	 * @param FirstSweep 最初のスイープを事前に行っている場合はその結果（非同期判定の結果など）
+	 * @return 移動結果
+	 */
+	FKinMoveResult MoveAndSlide(FKinematicsBodies& Bodies, int32_t Index, const IKinematicsCollisionQuery& Query, const FKinSweepResult* FirstSweep = nullptr);
+
+	/** 足元の接地判定用スイープを作成 @param Bodies ボディの状態 @param Index 対象のボディ番号 */
+	FKinSweep MakeGroundSweep(const FKinematicsBodies& Bodies, int32_t Index);
+
+	/**
+	 * 移動経路のスイープを作成
+	 * @param Bodies ボディの状態
+	 * @param Index 対象のボディ番号
+	 * @param Move 移動量
+	 */
+	FKinSweep MakeMoveSweep(const FKinematicsBodies& Bodies, int32_t Index, const FKinVector& Move);
+
+	/**
+	 * 衝突判定を同期的に行いながら全ボディを1ステップ進める
+	 * 移動中に地面へ当たらなかったボディだけ足元を追加で判定する
+	 * @param Bodies ボディの状態
+	 * @param StepTime ステップ時間（秒）
+	 * @param Query 衝突判定
+	 * @param Fields 力場の一覧（無ければ nullptr）
+	 */
+	void StepBodies(FKinematicsBodies& Bodies, float StepTime, const IKinematicsCollisionQuery& Query, const std::vector<FKinForceField>* Fields = nullptr);
+}
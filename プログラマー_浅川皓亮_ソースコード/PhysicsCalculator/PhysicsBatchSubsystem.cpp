@@ -0,0 +1,712 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Manager/PhysicsBatchSubsystem.h"
+#include "Components/PhysicsCalculator.h"
+#include "Components/SceneComponent.h"
+#include "Components/BoxComponent.h"
+#include "Engine/World.h"
+#include "Misc/ScopeExit.h"
+
+DECLARE_STATS_GROUP(TEXT("PhysicsBatch"), STATGROUP_PhysicsBatch, STATCAT_Advanced);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Awake Bodies"), STAT_PhysicsBatchAwakeBodies, STATGROUP_PhysicsBatch);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Sleeping Bodies"), STAT_PhysicsBatchSleepingBodies, STATGROUP_PhysicsBatch);
+
+using namespace Kinematics;
+
+namespace
+{
+	// 設定ファイルの値が小さすぎる場合に使う固定ステップの下限（Hz）
+	static constexpr float MIN_FIXED_STEP_RATE = 10.0f;
+
+	// 予測したスイープが今回の移動に使えるとみなす許容値
+	static constexpr float PREDICTION_START_TOLERANCE = 1.0f;
+	static constexpr float PREDICTION_DIRECTION_TOLERANCE = 0.99f;
+
+	// 足場が消えた時に起こす範囲を上方向へ広げる量
+	static constexpr float WAKE_BOX_UP_EXTENT = 200.0f;
+
+	// =======================
+	// エンジン型との変換
+	// =======================
+
+	FKinVector ToKin(const FVector& V) { return FKinVector(static_cast<float>(V.X), static_cast<float>(V.Y), static_cast<float>(V.Z)); }
+	FKinQuat ToKin(const FQuat& Q) { return FKinQuat(static_cast<float>(Q.X), static_cast<float>(Q.Y), static_cast<float>(Q.Z), static_cast<float>(Q.W)); }
+	FVector ToEngine(const FKinVector& V) { return FVector(V.X, V.Y, V.Z); }
+	FQuat ToEngine(const FKinQuat& Q) { return FQuat(Q.X, Q.Y, Q.Z, Q.W); }
+
+	// スイープの共通パラメータを作成
+	FCollisionQueryParams MakeQueryParams(const AActor* Owner)
+	{
+		return FCollisionQueryParams(SCENE_QUERY_STAT(PhysicsBatchSweep), false, Owner);
+	}
+
+	/**
+	 * UWorld の同期スイープによる衝突判定
+	 * 非同期の予測が外れたボディの補正に使う
+	 */
+	class FWorldCollisionQuery : public IKinematicsCollisionQuery
+	{
+	public:
+		FWorldCollisionQuery(UWorld* InWorld, const TArray<TObjectPtr<UPhysicsCalculator>>& InCalculators)
+			: World(InWorld)
+			, Calculators(InCalculators)
+		{
+		}
+
+		virtual bool SweepBox(const FKinSweep& Sweep, FKinHit& OutHit) const override
+		{
+			const AActor* Owner = Calculators.IsValidIndex(Sweep.IgnoreBody) && Calculators[Sweep.IgnoreBody]
+				? Calculators[Sweep.IgnoreBody]->GetOwner()
+				: nullptr;
+
+			FHitResult Hit;
+			const bool bHit = World->SweepSingleByChannel(
+				Hit,
+				ToEngine(Sweep.Start),
+				ToEngine(Sweep.End),
+				ToEngine(Sweep.Rotation),
+				ECC_Visibility,
+				FCollisionShape::MakeBox(ToEngine(Sweep.HalfExtent)),
+				MakeQueryParams(Owner));
+
+			if (bHit)
+			{
+				OutHit.Distance = Hit.Distance;
+				OutHit.Normal = ToKin(Hit.ImpactNormal);
+			}
+			return bHit;
+		}
+
+	private:
+		UWorld* World;
+		const TArray<TObjectPtr<UPhysicsCalculator>>& Calculators;
+	};
+
+	/**
+	 * スイープ要求を非同期で発行
+	 * @param World 発行先のワールド
+	 * @param Sweep スイープ要求
+	 * @param Owner 判定から除外するアクター
+	 */
+	FTraceHandle SubmitAsyncSweep(UWorld* World, const FKinSweep& Sweep, const AActor* Owner)
+	{
+		return World->AsyncSweepByChannel(
+			EAsyncTraceType::Single,
+			ToEngine(Sweep.Start),
+			ToEngine(Sweep.End),
+			ToEngine(Sweep.Rotation),
+			ECC_Visibility,
+			FCollisionShape::MakeBox(ToEngine(Sweep.HalfExtent)),
+			MakeQueryParams(Owner));
+	}
+
+	// 非同期スイープの結果から最初のブロッキングヒットを取り出す
+	const FHitResult* FindBlockingHit(const FTraceDatum& Datum)
+	{
+		return Datum.OutHits.FindByPredicate([](const FHitResult& Hit) { return Hit.bBlockingHit; });
+	}
+
+	/**
+	 * 非同期スイープの結果を取り出す
+	 * 結果は発行した次のフレームまでしか残らないため、取り出せないまま古くなったハンドルも無効にする
+	 * （サブステップが0回のフレームを挟むと起こる。無効にしないと次のスイープを発行できなくなる）
+	 * @param World 発行先のワールド
+	 * @param Handle 発行中のスイープ（取り出せたか古くなった場合は無効にする）
+	 * @param OutDatum 取り出した結果
+	 * @return 結果を取り出せたか
+	 */
+	bool ConsumeTrace(UWorld* World, FTraceHandle& Handle, FTraceDatum& OutDatum)
+	{
+		if (!Handle.IsValid())
+			return false;
+
+		if (World->QueryTraceData(Handle, OutDatum))
+		{
+			Handle = FTraceHandle();
+			return true;
+		}
+
+		if (!World->IsTraceHandleValid(Handle, false))
+		{
+			Handle = FTraceHandle();
+		}
+		return false;
+	}
+}
+
+// =======================
+// SoA コンテナ
+// =======================
+
+void FPhysicsBodyQueryArrays::Add(const FVector& Location)
+{
+	GroundTraces.AddDefaulted();
+	MoveTraces.AddDefaulted();
+	PredictedStarts.Add(Location);
+	PredictedMoves.Add(FVector::ZeroVector);
+	PredictedResults.AddDefaulted();
+	MoveGroundContacts.Add(false);
+	PrevSimLocations.Add(Location);
+	SimLocations.Add(Location);
+	VisualBaseLocations.Add(FVector::ZeroVector);
+}
+
+void FPhysicsBodyQueryArrays::RemoveAtSwap(int32 Index)
+{
+	GroundTraces.RemoveAtSwap(Index);
+	MoveTraces.RemoveAtSwap(Index);
+	PredictedStarts.RemoveAtSwap(Index);
+	PredictedMoves.RemoveAtSwap(Index);
+	PredictedResults.RemoveAtSwap(Index);
+	MoveGroundContacts.RemoveAtSwap(Index);
+	PrevSimLocations.RemoveAtSwap(Index);
+	SimLocations.RemoveAtSwap(Index);
+	VisualBaseLocations.RemoveAtSwap(Index);
+}
+
+// =======================
+// 登録・解除
+// =======================
+
+void UPhysicsBatchSubsystem::Deinitialize()
+{
+	for (UPhysicsCalculator* Calculator : Calculators)
+	{
+		if (Calculator)
+		{
+			Calculator->BodyIndex = INDEX_NONE;
+		}
+	}
+
+	Calculators.Empty();
+	VisualComponents.Empty();
+	ForceFields.Empty();
+	Bodies = FKinematicsBodies();
+	Queries = FPhysicsBodyQueryArrays();
+
+	Super::Deinitialize();
+}
+
+// 処理の流れ:
+// 1. SoA に要素を追加し、コンポーネントの設定値をコピー
+// 2. 見た目用コンポーネントの基準位置を保持
+int32 UPhysicsBatchSubsystem::RegisterBody(UPhysicsCalculator* Calculator)
+{
+	if (!Calculator || !Calculator->GetOwner())
+		return INDEX_NONE;
+
+	const FVector Location = Calculator->GetOwner()->GetActorLocation();
+
+	const int32 Index = Bodies.Add(ToKin(Location));
+	Queries.Add(Location);
+	Calculators.Add(Calculator);
+	VisualComponents.Add(Calculator->VisualComponent);
+
+	Bodies.GravityScales[Index] = Calculator->GravityScale;
+	Bodies.ForceModifiers[Index] = Calculator->ForceModifier;
+	Bodies.MaxFallingSpeeds[Index] = Calculator->MaxFallingSpeed;
+
+	EBodyFlags& Flags = Bodies.Flags[Index];
+	Flags = EBodyFlags::LocalOffset;
+	if (Calculator->bShouldApplyGravity) Flags |= EBodyFlags::ApplyGravity;
+	if (Calculator->bIsPhysicsEnabled) Flags |= EBodyFlags::PhysicsEnabled;
+	if (Calculator->bIsSweep) Flags |= EBodyFlags::Sweep;
+
+	if (Calculator->VisualComponent)
+	{
+		Queries.VisualBaseLocations[Index] = Calculator->VisualComponent->GetRelativeLocation();
+	}
+
+	return Index;
+}
+
+// 処理の流れ:
+// 1. 末尾の要素を解除する位置へ移動して配列を詰める
+// 2. 移動したボディのコンポーネントに新しい番号を通知
+void UPhysicsBatchSubsystem::UnregisterBody(int32 BodyIndex)
+{
+	if (!Calculators.IsValidIndex(BodyIndex))
+		return;
+
+	Bodies.RemoveAtSwap(BodyIndex);
+	Queries.RemoveAtSwap(BodyIndex);
+	Calculators.RemoveAtSwap(BodyIndex);
+	VisualComponents.RemoveAtSwap(BodyIndex);
+
+	if (Calculators.IsValidIndex(BodyIndex) && Calculators[BodyIndex])
+	{
+		Calculators[BodyIndex]->BodyIndex = BodyIndex;
+	}
+}
+
+// =======================
+// 外部からの操作
+// =======================
+// 状態を変える操作は眠っているボディを起こしてから反映する
+
+void UPhysicsBatchSubsystem::AddForce(int32 BodyIndex, const FVector& Direction, float Force, bool bSweep, bool bUseLocalOffset)
+{
+	WakeBody(BodyIndex);
+	Kinematics::AddForce(Bodies, BodyIndex, ToKin(Direction), Force, bSweep, bUseLocalOffset);
+}
+
+void UPhysicsBatchSubsystem::ResetForce(int32 BodyIndex)
+{
+	WakeBody(BodyIndex);
+	Kinematics::ResetForce(Bodies, BodyIndex);
+}
+
+void UPhysicsBatchSubsystem::SetGravity(int32 BodyIndex, bool bApplyGravity, float Scale, float Modifier)
+{
+	WakeBody(BodyIndex);
+
+	Bodies.GravityScales[BodyIndex] = Scale;
+	Bodies.ForceModifiers[BodyIndex] = Modifier;
+
+	if (bApplyGravity)
+	{
+		Bodies.Flags[BodyIndex] |= EBodyFlags::ApplyGravity;
+	}
+	else
+	{
+		Bodies.Flags[BodyIndex] &= ~EBodyFlags::ApplyGravity;
+	}
+}
+
+// 処理の流れ:
+// 1. スリープを解除して計算対象に戻す
+// 2. 眠る前の非同期スイープは使わないよう、予測を捨てておく
+void UPhysicsBatchSubsystem::WakeBody(int32 BodyIndex)
+{
+	if (!Calculators.IsValidIndex(BodyIndex) || !IsSleeping(BodyIndex))
+		return;
+
+	Kinematics::WakeBody(Bodies, BodyIndex);
+	Queries.GroundTraces[BodyIndex] = FTraceHandle();
+	Queries.MoveTraces[BodyIndex] = FTraceHandle();
+	Queries.PredictedMoves[BodyIndex] = FVector::ZeroVector;
+}
+
+void UPhysicsBatchSubsystem::SleepBody(int32 BodyIndex)
+{
+	if (!Calculators.IsValidIndex(BodyIndex) || IsSleeping(BodyIndex))
+		return;
+
+	PutBodyToSleep(Bodies, BodyIndex);
+	OnBodySlept(BodyIndex);
+}
+
+// 処理の流れ:
+// 1. 発行中のスイープは起きた時に使わないよう破棄する
+// 2. 眠っている間は補間しないため、見た目用コンポーネントのずれを0に戻す
+void UPhysicsBatchSubsystem::OnBodySlept(int32 BodyIndex)
+{
+	Queries.GroundTraces[BodyIndex] = FTraceHandle();
+	Queries.MoveTraces[BodyIndex] = FTraceHandle();
+	Queries.PredictedMoves[BodyIndex] = FVector::ZeroVector;
+
+	const FVector Location = ToEngine(Bodies.Locations[BodyIndex]);
+	Queries.PrevSimLocations[BodyIndex] = Location;
+	Queries.SimLocations[BodyIndex] = Location;
+
+	USceneComponent* Visual = VisualComponents[BodyIndex];
+	if (Visual && Calculators[BodyIndex] && Calculators[BodyIndex]->bInterpolateRender)
+	{
+		Visual->SetRelativeLocation(Queries.VisualBaseLocations[BodyIndex]);
+	}
+}
+
+void UPhysicsBatchSubsystem::WakeBodiesInBox(const FBox& Bounds)
+{
+	if (!Bounds.IsValid)
+		return;
+
+	FBox WakeBounds = Bounds;
+	WakeBounds.Max.Z += WAKE_BOX_UP_EXTENT;
+
+	for (int32 i = 0; i < Bodies.Num(); ++i)
+	{
+		if (IsSleeping(i) && WakeBounds.IsInsideOrOn(ToEngine(Bodies.Locations[i])))
+		{
+			WakeBody(i);
+		}
+	}
+}
+
+// =======================
+// 力場
+// =======================
+
+int32 UPhysicsBatchSubsystem::RegisterForceField(UBoxComponent* Volume)
+{
+	if (!Volume)
+		return INDEX_NONE;
+
+	FPhysicsForceField& Field = ForceFields.AddDefaulted_GetRef();
+	Field.Id = NextForceFieldId++;
+	Field.Volume = Volume;
+	return Field.Id;
+}
+
+void UPhysicsBatchSubsystem::UnregisterForceField(int32 FieldId)
+{
+	ForceFields.RemoveAllSwap([FieldId](const FPhysicsForceField& Field) { return Field.Id == FieldId; });
+}
+
+FPhysicsForceField* UPhysicsBatchSubsystem::FindForceField(int32 FieldId)
+{
+	return ForceFields.FindByPredicate([FieldId](const FPhysicsForceField& Field) { return Field.Id == FieldId; });
+}
+
+// 処理の流れ:
+// 1. 方向・強さ・座標系が変わっていなければ何もしない
+// 2. 値を更新し、範囲内で眠っているボディを起こす（動き出したベルトの上など）
+void UPhysicsBatchSubsystem::SetForceFieldMotion(int32 FieldId, const FVector& Direction, float Power, bool bLocalDirection)
+{
+	FPhysicsForceField* Field = FindForceField(FieldId);
+	if (!Field)
+		return;
+
+	if (Field->Direction.Equals(Direction) && FMath::IsNearlyEqual(Field->Power, Power) && Field->bLocalDirection == bLocalDirection)
+		return;
+
+	Field->Direction = Direction;
+	Field->Power = Power;
+	Field->bLocalDirection = bLocalDirection;
+
+	if (const UBoxComponent* Volume = Field->Volume.Get())
+	{
+		WakeBodiesInBox(Volume->Bounds.GetBox());
+	}
+}
+
+// 処理の流れ:
+// 1. 遮られなくなったボディは眠ったまま取り残されないよう起こす
+// 2. 遮られているボディの一覧を置き換える
+void UPhysicsBatchSubsystem::SetForceFieldBlockedBodies(int32 FieldId, const TArray<UPhysicsCalculator*>& Blocked)
+{
+	FPhysicsForceField* Field = FindForceField(FieldId);
+	if (!Field)
+		return;
+
+	for (const TWeakObjectPtr<UPhysicsCalculator>& Previous : Field->BlockedBodies)
+	{
+		UPhysicsCalculator* Calculator = Previous.Get();
+		if (Calculator && !Blocked.Contains(Calculator) && Calculator->BodyIndex != INDEX_NONE)
+		{
+			WakeBody(Calculator->BodyIndex);
+		}
+	}
+
+	Field->BlockedBodies.Reset(Blocked.Num());
+	for (UPhysicsCalculator* Calculator : Blocked)
+	{
+		Field->BlockedBodies.Add(Calculator);
+	}
+}
+
+// 処理の流れ:
+// 1. コリジョンが有効な力場ごとに、範囲を現在のボックスから求めて計算用の一覧に詰める
+// 2. 遮られているボディの番号を一覧に添える
+// 3. 移動量のリセットと加算は Kinematics に任せる（重なった力場は合算）
+void UPhysicsBatchSubsystem::ApplyForceFields(float StepTime)
+{
+	int32 NumFields = 0;
+	KinForceFields.resize(ForceFields.Num());
+	for (const FPhysicsForceField& Field : ForceFields)
+	{
+		const UBoxComponent* Volume = Field.Volume.Get();
+		if (!Volume || !Volume->IsCollisionEnabled())
+			continue;
+
+		const FTransform& VolumeTransform = Volume->GetComponentTransform();
+
+		FKinForceField& KinField = KinForceFields[NumFields++];
+		KinField.Center = ToKin(VolumeTransform.GetLocation());
+		KinField.Rotation = ToKin(VolumeTransform.GetRotation());
+		KinField.HalfExtent = ToKin(Volume->GetScaledBoxExtent());
+		KinField.Direction = ToKin(Field.Direction);
+		KinField.Power = Field.Power;
+		KinField.bLocalDirection = Field.bLocalDirection;
+
+		KinField.BlockedBodies.clear();
+		for (const TWeakObjectPtr<UPhysicsCalculator>& Blocked : Field.BlockedBodies)
+		{
+			const UPhysicsCalculator* Calculator = Blocked.Get();
+			if (Calculator && Calculator->BodyIndex != INDEX_NONE)
+			{
+				KinField.BlockedBodies.push_back(Calculator->BodyIndex);
+			}
+		}
+	}
+	KinForceFields.resize(NumFields);
+
+	Kinematics::ApplyForceFields(Bodies, KinForceFields, StepTime);
+}
+
+// =======================
+// 更新処理
+// =======================
+
+TStatId UPhysicsBatchSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UPhysicsBatchSubsystem, STATGROUP_Tickables);
+}
+
+// 処理の流れ:
+// 1. 前フレームの着地の記録を消す（利用側は前フレームの結果を Tick の前に読み終えている）
+// 2. 全ボディが眠っていれば何もしない
+// 3. 固定タイムステップを使わない設定なら、経過時間で1回だけ更新して終わる
+// 4. 経過時間を蓄積し、固定ステップ分ずつ上限回数まで全ボディを更新
+// 5. ステップが無かったフレームも、前フレームのスイープ結果は破棄される前に取り込んでおく
+// 6. 上限を超えた余剰時間は切り捨てる（処理落ち時の暴走防止）
+// 7. 残り時間の割合で見た目の位置を補間
+void UPhysicsBatchSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	const double TickStartTime = FPlatformTime::Seconds();
+	ON_SCOPE_EXIT { TickSeconds += FPlatformTime::Seconds() - TickStartTime; };
+
+	BeginFrame(Bodies);
+
+	Bodies.RefreshAwakeIndices();
+	SET_DWORD_STAT(STAT_PhysicsBatchAwakeBodies, Bodies.NumAwake());
+	SET_DWORD_STAT(STAT_PhysicsBatchSleepingBodies, Bodies.Num() - Bodies.NumAwake());
+
+	if (Bodies.NumAwake() == 0)
+	{
+		TimeAccumulator = 0.0f;
+		return;
+	}
+
+	if (!bUseFixedTimestep)
+	{
+		TimeAccumulator = 0.0f;
+		if (DeltaTime > 0.0f)
+		{
+			StepBodies(DeltaTime);
+		}
+		else
+		{
+			ConsumeQueryResults();
+		}
+		UpdateRenderInterpolation(1.0f);
+		return;
+	}
+
+	const float StepTime = 1.0f / FMath::Max(FixedStepRate, MIN_FIXED_STEP_RATE);
+	const int32 StepLimit = FMath::Max(MaxSubSteps, 1);
+	TimeAccumulator += DeltaTime;
+
+	int32 SubSteps = 0;
+	while (TimeAccumulator >= StepTime && SubSteps < StepLimit)
+	{
+		StepBodies(StepTime);
+		TimeAccumulator -= StepTime;
+		++SubSteps;
+	}
+
+	if (SubSteps == 0)
+	{
+		ConsumeQueryResults();
+	}
+
+	TimeAccumulator = FMath::Min(TimeAccumulator, StepTime);
+
+	UpdateRenderInterpolation(TimeAccumulator / StepTime);
+}
+
+// 処理の流れ:
+// 1. 計算対象（スリープしていない）ボディの番号を更新
+// 2. オーナーの姿勢を収集
+// 3. 前ステップの非同期スイープ結果を取り込む
+// 4. 力場の移動量を加算し、全ボディの移動量を1つのループで計算
+// 5. 移動と滑りを解決して反映し、静止が続いたボディを眠らせる
+// 6. 次ステップ用のスイープをまとめて発行
+// スリープ中のボディはどの処理でも参照しない
+void UPhysicsBatchSubsystem::StepBodies(float StepTime)
+{
+	Bodies.RefreshAwakeIndices();
+	GatherTransforms();
+	ConsumeQueryResults();
+	ApplyForceFields(StepTime);
+	IntegrateBodies(Bodies, StepTime);
+	ResolveAndApplyMoves();
+	SubmitQueries(StepTime);
+}
+
+void UPhysicsBatchSubsystem::GatherTransforms()
+{
+	for (const int32 i : Bodies.AwakeIndices)
+	{
+		const AActor* Owner = Calculators[i] ? Calculators[i]->GetOwner() : nullptr;
+		if (!Owner)
+			continue;
+
+		const FTransform& Transform = Owner->GetActorTransform();
+		Bodies.Locations[i] = ToKin(Transform.GetLocation());
+		Bodies.Rotations[i] = ToKin(Transform.GetRotation());
+		Bodies.Scales[i] = ToKin(Transform.GetScale3D());
+		Bodies.HalfHeights[i] = Owner->GetSimpleCollisionHalfHeight();
+	}
+}
+
+// 処理の流れ:
+// 1. 接地スイープの結果が届いていれば接地フラグを更新（未着なら前回の値を維持）
+// 2. 移動スイープの結果が届いていれば、次の移動で最初のスイープとして使うために保持
+// 3. 結果が破棄されて古くなったハンドルは捨て、このステップで発行し直す（移動の予測も使わない）
+void UPhysicsBatchSubsystem::ConsumeQueryResults()
+{
+	UWorld* World = GetWorld();
+	if (!World)
+		return;
+
+	FTraceDatum Datum;
+	for (const int32 i : Bodies.AwakeIndices)
+	{
+		if (ConsumeTrace(World, Queries.GroundTraces[i], Datum))
+		{
+			ApplyGroundResult(Bodies, i, FindBlockingHit(Datum) != nullptr);
+		}
+
+		const bool bHadMoveTrace = Queries.MoveTraces[i].IsValid();
+		if (ConsumeTrace(World, Queries.MoveTraces[i], Datum))
+		{
+			FKinSweepResult& Result = Queries.PredictedResults[i];
+			const FHitResult* Blocking = FindBlockingHit(Datum);
+			Result.bHit = Blocking != nullptr;
+			if (Blocking)
+			{
+				Result.Hit.Distance = Blocking->Distance;
+				Result.Hit.Normal = ToKin(Blocking->ImpactNormal);
+			}
+		}
+		else if (bHadMoveTrace && !Queries.MoveTraces[i].IsValid())
+		{
+			Queries.PredictedMoves[i] = FVector::ZeroVector;
+		}
+	}
+}
+
+// 処理の流れ:
+// 1. 前ステップで予測した経路の結果が届いていて今回の移動を含んでいれば、最初のスイープとして使う
+// 2. 予測が外れた（力の向きが変わった・外部から動かされた）ボディは同期スイープで解決
+// 3. 移動と滑りを解決し、地面に当たれば接地としてオーナーに反映（スイープ指定ならエンジン側でも掃引して動かす）
+// 4. 静止が続いたボディを眠らせ、発行中のスイープを破棄
+void UPhysicsBatchSubsystem::ResolveAndApplyMoves()
+{
+	const FWorldCollisionQuery SyncQuery(GetWorld(), Calculators);
+	TGuardValue<bool> ApplyingGuard(bApplyingMoves, true);
+
+	for (const int32 i : Bodies.AwakeIndices)
+	{
+		Queries.MoveGroundContacts[i] = false;
+
+		UPhysicsCalculator* Calculator = Calculators[i];
+		AActor* Owner = Calculator ? Calculator->GetOwner() : nullptr;
+		if (!Owner || Calculator->IsActive())
+			continue;
+
+		const FKinVector& Desired = Bodies.DesiredMoves[i];
+		if (Desired.IsNearlyZero())
+			continue;
+
+		const FVector DesiredMove = ToEngine(Desired);
+		const FVector& Predicted = Queries.PredictedMoves[i];
+		const bool bPredictionValid =
+			!Queries.MoveTraces[i].IsValid() &&
+			!Predicted.IsNearlyZero() &&
+			Queries.PredictedStarts[i].Equals(ToEngine(Bodies.Locations[i]), PREDICTION_START_TOLERANCE) &&
+			Predicted.SizeSquared() >= DesiredMove.SizeSquared() &&
+			(DesiredMove.GetSafeNormal() | Predicted.GetSafeNormal()) >= PREDICTION_DIRECTION_TOLERANCE;
+
+		const FKinMoveResult Result = MoveAndSlide(Bodies, i, SyncQuery, bPredictionValid ? &Queries.PredictedResults[i] : nullptr);
+		if (Result.bGroundContact)
+		{
+			ApplyGroundResult(Bodies, i, true);
+			Queries.MoveGroundContacts[i] = true;
+		}
+
+		// 力をスイープ指定で加えたボディと重力だけで動くボディ（以前の AddActorOffset と同じ条件）は
+		// エンジンのコリジョンでも掃引して動かし、止まった位置を正とする
+		const bool bSweep = HasBodyFlag(i, EBodyFlags::Sweep) || HasBodyFlag(i, EBodyFlags::PhysicsEnabled);
+		FHitResult SweepHit;
+		Owner->SetActorLocation(ToEngine(Bodies.Locations[i]), bSweep, bSweep ? &SweepHit : nullptr);
+		if (SweepHit.bBlockingHit)
+		{
+			Bodies.Locations[i] = ToKin(Owner->GetActorLocation());
+		}
+	}
+
+	// 描画補間用に今回のシミュレーション位置を記録
+	for (const int32 i : Bodies.AwakeIndices)
+	{
+		Queries.PrevSimLocations[i] = Queries.SimLocations[i];
+		Queries.SimLocations[i] = ToEngine(Bodies.Locations[i]);
+
+		if (UpdateSleepState(Bodies, i))
+		{
+			OnBodySlept(i);
+		}
+	}
+}
+
+// 処理の流れ:
+// 1. 移動中に地面へ当たらなかった重力ありのボディだけ、足元のスイープを発行
+// 2. 次ステップの移動量を予測し、その経路の移動スイープを発行
+void UPhysicsBatchSubsystem::SubmitQueries(float StepTime)
+{
+	UWorld* World = GetWorld();
+	if (!World)
+		return;
+
+	// このステップで眠ったボディには発行しない
+	Bodies.RefreshAwakeIndices();
+	for (const int32 i : Bodies.AwakeIndices)
+	{
+		const AActor* Owner = Calculators[i] ? Calculators[i]->GetOwner() : nullptr;
+		if (!Owner)
+			continue;
+
+		const bool bNeedGroundProbe = !Queries.MoveGroundContacts[i] && HasBodyFlag(i, EBodyFlags::ApplyGravity);
+		if (bNeedGroundProbe && !Queries.GroundTraces[i].IsValid())
+		{
+			Queries.GroundTraces[i] = SubmitAsyncSweep(World, MakeGroundSweep(Bodies, i), Owner);
+		}
+
+		if (!Queries.MoveTraces[i].IsValid())
+		{
+			const FKinVector Predicted = PredictNextMove(Bodies, i, StepTime);
+			Queries.PredictedStarts[i] = ToEngine(Bodies.Locations[i]);
+			Queries.PredictedMoves[i] = ToEngine(Predicted);
+			Queries.PredictedResults[i] = FKinSweepResult();
+
+			if (!Predicted.IsNearlyZero())
+			{
+				Queries.MoveTraces[i] = SubmitAsyncSweep(World, MakeMoveSweep(Bodies, i, Predicted), Owner);
+			}
+		}
+	}
+}
+
+// 処理の流れ:
+// 1. 直前ステップの開始位置と終了位置を補間した表示位置を求める
+// 2. アクター本体は動かさず、見た目用コンポーネントだけを差分だけずらす
+void UPhysicsBatchSubsystem::UpdateRenderInterpolation(float Alpha)
+{
+	for (const int32 i : Bodies.AwakeIndices)
+	{
+		USceneComponent* Visual = VisualComponents[i];
+		if (!Visual || !Calculators[i] || !Calculators[i]->bInterpolateRender)
+			continue;
+
+		const FVector WorldOffset = FMath::Lerp(Queries.PrevSimLocations[i], Queries.SimLocations[i], Alpha) - Queries.SimLocations[i];
+
+		const USceneComponent* Parent = Visual->GetAttachParent();
+		const FVector LocalOffset = Parent ? Parent->GetComponentTransform().InverseTransformVector(WorldOffset) : WorldOffset;
+
+		Visual->SetRelativeLocation(Queries.VisualBaseLocations[i] + LocalOffset);
+	}
+}
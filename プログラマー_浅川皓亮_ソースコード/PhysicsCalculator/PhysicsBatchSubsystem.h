@@ -0,0 +1,253 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "WorldCollision.h"
+#include "Logic/Physics/KinematicsCore.h"
+#include "PhysicsBatchSubsystem.generated.h"
+
+class UPhysicsCalculator;
+class USceneComponent;
+class UBoxComponent;
+
+/**
+ * エンジン側だけで必要になるボディごとの情報（SoA）
+ * 物理の状態そのものは Kinematics::FKinematicsBodies が持ち、インデックスは共通
+ */
+struct FPhysicsBodyQueryArrays
+{
+	// 発行中の非同期スイープ
+	TArray<FTraceHandle> GroundTraces;
+	TArray<FTraceHandle> MoveTraces;
+
+	// 非同期スイープを発行した時の開始位置と予測移動量、その結果
+	TArray<FVector> PredictedStarts;
+	TArray<FVector> PredictedMoves;
+	TArray<Kinematics::FKinSweepResult> PredictedResults;
+
+	// このステップの移動中に地面へ当たったか（当たっていれば足元の判定を省く）
+	TArray<bool> MoveGroundContacts;
+
+	// 描画補間用のシミュレーション位置
+	TArray<FVector> PrevSimLocations;
+	TArray<FVector> SimLocations;
+	TArray<FVector> VisualBaseLocations;
+
+	/** 末尾にボディを1つ追加 @param Location 初期位置 */
+	void Add(const FVector& Location);
+
+	/** 指定インデックスの要素を末尾と入れ替えて削除 */
+	void RemoveAtSwap(int32 Index);
+};
+
+/**
+ * 登録された力場（ベルトコンベア等）
+ * 範囲はボックスコンポーネントから毎ステップ取得するため、動く足場に付いていても追従する
+ */
+struct FPhysicsForceField
+{
+	int32 Id = INDEX_NONE;
+
+	// 範囲を表すボックス（コリジョンが無効の間は力を加えない）
+	TWeakObjectPtr<UBoxComponent> Volume;
+
+	// 押し出す方向と強さ
+	FVector Direction = FVector::ZeroVector;
+	float Power = 0.0f;
+	bool bLocalDirection = false;
+
+	// 遮蔽物があり力を加えないボディ
+	TArray<TWeakObjectPtr<UPhysicsCalculator>> BlockedBodies;
+};
+
+/**
+ * 全ての UPhysicsCalculator をまとめて更新するワールドサブシステム
+ * 計算はエンジン非依存の Kinematics に任せ、ここでは姿勢の収集・反映と
+ * 非同期スイープの発行（結果は次のステップで使用）を担当する
+ *
+ * タイムステップは DefaultGame.ini の [/Script/Pachio.PhysicsBatchSubsystem] で変更できる
+ *   例) FixedStepRate=120 / MaxSubSteps=8 / bUseFixedTimestep=False
+ */
+UCLASS(config = Game)
+class PACHIO_API UPhysicsBatchSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	/**
+	 * ボディを登録する
+	 * @param Calculator 登録する物理コンポーネント
+	 * @return 割り当てたボディ番号
+	 */
+	int32 RegisterBody(UPhysicsCalculator* Calculator);
+
+	/**
+	 * ボディの登録を解除する（末尾のボディが空いた番号に移動する）
+	 * @param BodyIndex 解除するボディ番号
+	 */
+	void UnregisterBody(int32 BodyIndex);
+
+	/**
+	 * ボディに力を加える
+	 * @param BodyIndex 対象のボディ番号
+	 * @param Direction 力の方向
+	 * @param Force 力の強さ
+	 * @param bSweep 衝突を考慮して移動するか
+	 * @param bUseLocalOffset 方向をローカル座標として扱うか
+	 */
+	void AddForce(int32 BodyIndex, const FVector& Direction, float Force, bool bSweep, bool bUseLocalOffset);
+
+	/** ボディの力をリセット @param BodyIndex 対象のボディ番号 */
+	void ResetForce(int32 BodyIndex);
+
+	/**
+	 * ボディの重力設定を変更
+	 * @param BodyIndex 対象のボディ番号
+	 * @param bApplyGravity 重力を加えるか
+	 * @param Scale 重力の強さ
+	 * @param Modifier 落下速度の補正値
+	 */
+	void SetGravity(int32 BodyIndex, bool bApplyGravity, float Scale, float Modifier);
+
+	/** 接地しているか @param BodyIndex 対象のボディ番号 */
+	bool IsOnGround(int32 BodyIndex) const { return HasBodyFlag(BodyIndex, Kinematics::EBodyFlags::OnGround); }
+
+	/** 直前のフレームのどこかのステップで着地したか（サブステップが複数でも取りこぼさない） @param BodyIndex 対象のボディ番号 */
+	bool HasJustLanded(int32 BodyIndex) const { return HasBodyFlag(BodyIndex, Kinematics::EBodyFlags::LandedThisFrame); }
+
+	/** 力による移動が止まっているか @param BodyIndex 対象のボディ番号 */
+	bool IsPhysicsEnabled(int32 BodyIndex) const { return HasBodyFlag(BodyIndex, Kinematics::EBodyFlags::PhysicsEnabled); }
+
+	/** 静止してスリープしているか @param BodyIndex 対象のボディ番号 */
+	bool IsSleeping(int32 BodyIndex) const { return HasBodyFlag(BodyIndex, Kinematics::EBodyFlags::Sleeping); }
+
+	/** スリープ中のボディを起こす @param BodyIndex 対象のボディ番号 */
+	void WakeBody(int32 BodyIndex);
+
+	/** 静止していなくてもボディを眠らせる（画面外の部屋など） @param BodyIndex 対象のボディ番号 */
+	void SleepBody(int32 BodyIndex);
+
+	/**
+	 * 範囲内でスリープしているボディをまとめて起こす
+	 * 足場が消えた時などに使う（上に乗っているボディを含めるため範囲は上方向へ広げる）
+	 * @param Bounds 対象の範囲（ワールド座標）
+	 */
+	void WakeBodiesInBox(const FBox& Bounds);
+
+	/**
+	 * 力場を登録する
+	 * @param Volume 範囲を表すボックス
+	 * @return 割り当てた力場の番号
+	 */
+	int32 RegisterForceField(UBoxComponent* Volume);
+
+	/** 力場の登録を解除する @param FieldId 力場の番号 */
+	void UnregisterForceField(int32 FieldId);
+
+	/**
+	 * 力場の方向と強さを変更する（変わった場合は範囲内のボディを起こす）
+	 * @param FieldId 力場の番号
+	 * @param Direction 押し出す方向
+	 * @param Power 押し出す強さ
+	 * @param bLocalDirection 方向をボディのローカル座標として扱うか
+	 */
+	void SetForceFieldMotion(int32 FieldId, const FVector& Direction, float Power, bool bLocalDirection);
+
+	/**
+	 * 遮蔽物があり力を加えないボディを設定する（外れたボディは起こす）
+	 * @param FieldId 力場の番号
+	 * @param Blocked 遮られているボディ
+	 */
+	void SetForceFieldBlockedBodies(int32 FieldId, const TArray<UPhysicsCalculator*>& Blocked);
+
+	// 自身が移動を反映している最中か（外部からの移動と区別するため）
+	bool IsApplyingMoves() const { return bApplyingMoves; }
+
+	// 登録中のボディ数
+	int32 GetNumBodies() const { return Bodies.Num(); }
+
+	// 計算対象（スリープしていない）のボディ数
+	int32 GetNumAwakeBodies() const { return Bodies.NumAwake(); }
+
+	// 前回の取得以降に Tick で使った時間（秒）を返してリセットする（計測用）
+	double ConsumeTickSeconds() { const double Seconds = TickSeconds; TickSeconds = 0.0; return Seconds; }
+
+private:
+	bool HasBodyFlag(int32 BodyIndex, Kinematics::EBodyFlags Flag) const { return Kinematics::HasFlag(Bodies.Flags[BodyIndex], Flag); }
+
+	/** 1ステップ分、全ボディを更新する @param StepTime ステップ時間（秒） */
+	void StepBodies(float StepTime);
+
+	// オーナーの位置・回転・スケールを配列に収集
+	void GatherTransforms();
+
+	/** 力場の範囲を求め、範囲内のボディに移動量を加算 @param StepTime ステップ時間（秒） */
+	void ApplyForceFields(float StepTime);
+
+	// 番号から力場を探す（無ければ nullptr）
+	FPhysicsForceField* FindForceField(int32 FieldId);
+
+	// 前ステップで発行した非同期スイープの結果を取り込む
+	void ConsumeQueryResults();
+
+	// 移動量を衝突結果で補正してオーナーに反映
+	void ResolveAndApplyMoves();
+
+	/** 次ステップ用の非同期スイープをまとめて発行 @param StepTime ステップ時間（秒） */
+	void SubmitQueries(float StepTime);
+
+	/** 見た目用コンポーネントをステップ間で補間 @param Alpha 補間係数（0～1） */
+	void UpdateRenderInterpolation(float Alpha);
+
+	/** 眠ったボディの発行中のスイープと予測を捨て、見た目用コンポーネントを基準位置に戻す @param BodyIndex 対象のボディ番号 */
+	void OnBodySlept(int32 BodyIndex);
+
+private:
+	// ボディの状態（SoA）
+	Kinematics::FKinematicsBodies Bodies;
+
+	// スイープ・描画補間用の情報（SoA）
+	FPhysicsBodyQueryArrays Queries;
+
+	// 状態と同じ並びのコンポーネント
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<UPhysicsCalculator>> Calculators;
+
+	// 描画補間で動かす見た目用のコンポーネント（無い場合は nullptr）
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<USceneComponent>> VisualComponents;
+
+	// 登録中の力場
+	TArray<FPhysicsForceField> ForceFields;
+	int32 NextForceFieldId = 0;
+
+	// 計算に渡す力場の一覧（毎ステップ詰め直し、確保した領域は使い回す）
+	std::vector<Kinematics::FKinForceField> KinForceFields;
+
+	// 固定タイムステップで全ボディを積分するかどうか（false ならフレームの経過時間で1回だけ更新する）
+	UPROPERTY(Config, EditAnywhere, Category = "Physics|Timestep")
+	bool bUseFixedTimestep = true;
+
+	// 固定ステップの更新レート（Hz）
+	UPROPERTY(Config, EditAnywhere, Category = "Physics|Timestep", meta = (ClampMin = "10.0", EditCondition = "bUseFixedTimestep"))
+	float FixedStepRate = 60.0f;
+
+	// 1フレームで処理するサブステップの上限（処理落ち時の暴走防止）
+	UPROPERTY(Config, EditAnywhere, Category = "Physics|Timestep", meta = (ClampMin = "1", EditCondition = "bUseFixedTimestep"))
+	int32 MaxSubSteps = 4;
+
+	// 未消化の経過時間
+	float TimeAccumulator = 0.0f;
+
+	// オーナーへ移動を反映している間だけ true
+	bool bApplyingMoves = false;
+
+	// Tick で使った時間の累計（計測用）
+	double TickSeconds = 0.0;
+};
@@ -1,154 +1,181 @@
 #include "Components/PhysicsCalculator.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Manager/PhysicsBatchSubsystem.h"
 #include "Math/UnrealMathUtility.h"
 #include "DrawDebugHelpers.h"
+#include "FunctionLibrary.h"
 
 // コンストラクタでデフォルト値を設定
 UPhysicsCalculator::UPhysicsCalculator()
-	: ForceScale(0)
-	, ForceDirection(FVector::ZeroVector)
-	, PreviousPosition(FVector::ZeroVector)
-	, Timer(0)
-	, bShouldApplyGravity(true)
+	: bShouldApplyGravity(true)
 	, bIsSweep(false)
 	, bIsPhysicsEnabled(false)
 {
-	PrimaryComponentTick.bCanEverTick = true;
+	// 更新は UPhysicsBatchSubsystem がまとめて行う
+	PrimaryComponentTick.bCanEverTick = false;
 }
 
+// 処理の流れ:
+// 1. 描画補間に使う見た目用のメッシュを取得
+// 2. サブシステムにボディとして登録し、登録前に加えられた力を渡す
+// 3. 外部から動かされた時に起きるよう、ルートの移動通知を購読
 void UPhysicsCalculator::BeginPlay()
 {
 	Super::BeginPlay();
-}
-
-// 毎フレーム更新処理
-void UPhysicsCalculator::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
-{
-	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
 
 	AActor* Owner = GetOwner();
+	UWorld* World = GetWorld();
+	if (!Owner || !World) return;
+
+	VisualComponent = UFunctionLibrary::FindComponentByName<USkeletalMeshComponent>(Owner, TEXT("Mesh"));
 
-	if (IsActive())
+	BatchSubsystem = World->GetSubsystem<UPhysicsBatchSubsystem>();
+	if (BatchSubsystem)
 	{
-		return;
+		BodyIndex = BatchSubsystem->RegisterBody(this);
 	}
-	if (bShouldApplyGravity)
+	FlushPendingForces();
+
+	if (USceneComponent* Root = Owner->GetRootComponent())
 	{
-		AddGravity();
-		UpdateGroundState();
+		Root->TransformUpdated.AddUObject(this, &UPhysicsCalculator::OnOwnerTransformUpdated);
 	}
+}
 
-	// ★ 修正: 接地したら上昇力をキャンセル（ただしジャンプ直後は無視）
-	if (!bIgnoreGroundCheck && OnGround() && ForceDirection.Z > 0)
+void UPhysicsCalculator::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (AActor* Owner = GetOwner())
 	{
-		ForceDirection.Z = 0;
-		ForceScale = 0;
-		bIsPhysicsEnabled = true;
-		Timer = 0;
+		if (USceneComponent* Root = Owner->GetRootComponent())
+		{
+			Root->TransformUpdated.RemoveAll(this);
+		}
 	}
 
-	// ★ 追加: 地面から離れたらフラグを解除
-	if (bIgnoreGroundCheck && !OnGround())
+	if (IsRegistered())
 	{
-		bIgnoreGroundCheck = false;
+		BatchSubsystem->UnregisterBody(BodyIndex);
 	}
+	BatchSubsystem = nullptr;
+	BodyIndex = INDEX_NONE;
+	PendingForces.Reset();
 
-	FVector MoveVector;
-	if (!bIsPhysicsEnabled)
-	{
-		ForceScale = FMath::Max(ForceScale - DeltaTime * 10.0f, 0.0f);
-		MoveVector = ForceDirection * ForceScale;
+	Super::EndPlay(EndPlayReason);
+}
 
-		FVector Adjusted = GetBlockedAdjustedVector(MoveVector);
+// 処理の流れ:
+// 1. 登録済みならサブシステムに渡す
+// 2. BeginPlay の前（スポーン直後など）なら、登録するまで取っておく
+// 3. それ以外（サブシステムが無い・EndPlay 後）は渡せないため警告する
+void UPhysicsCalculator::AddForce(FVector Direction, float Force, const bool bSweep, const bool useLocalOffset)
+{
+	bIsSweep = bSweep;
 
-		if (ForceDirection.Z > 0 && Adjusted.Z < MoveVector.Z * 0.1f)
-		{
-			ForceDirection.Z = 0;
-			ForceScale = 0;
-			bIsPhysicsEnabled = true;
-		}
+	if (IsRegistered())
+	{
+		BatchSubsystem->AddForce(BodyIndex, Direction, Force, bSweep, useLocalOffset);
+	}
+	else if (!HasBegunPlay())
+	{
+		PendingForces.Add({ Direction, Force, bSweep, useLocalOffset });
+	}
+	else
+	{
+		WarnForceDropped(TEXT("AddForce"));
+	}
+}
 
-		if (bUseLocalOffset)
-		{
-			GetOwner()->AddActorLocalOffset(Adjusted, bIsSweep);
-		}
-		else
-		{
-			GetOwner()->AddActorWorldOffset(Adjusted, bIsSweep);
-		}
+// 登録前なら取っておいた力も捨てる
+void UPhysicsCalculator::ResetForce()
+{
+	if (IsRegistered())
+	{
+		BatchSubsystem->ResetForce(BodyIndex);
+	}
+	else if (!HasBegunPlay())
+	{
+		PendingForces.Reset();
+	}
+	else
+	{
+		WarnForceDropped(TEXT("ResetForce"));
+	}
+}
 
-		FVector currentPosition = GetOwner()->GetActorLocation();
-		float distanceZ = currentPosition.Z - PreviousPosition.Z;
+// 処理の流れ:
+// 1. 登録できていなければ、取っておいた力は渡せないため警告して捨てる
+// 2. 加えられた順にサブシステムに渡す
+void UPhysicsCalculator::FlushPendingForces()
+{
+	if (PendingForces.Num() == 0)
+		return;
 
-		if (distanceZ < 0)
-		{
-			ForceDirection.Z = 0;
-			ForceScale = 0;
-			Timer = 0;
-			bIsPhysicsEnabled = true;
-			bFalling = true;
-		}
+	if (!IsRegistered())
+	{
+		WarnForceDropped(TEXT("AddForce"));
+		PendingForces.Reset();
+		return;
+	}
 
-		PreviousPosition = currentPosition;
+	for (const FPendingForce& Pending : PendingForces)
+	{
+		BatchSubsystem->AddForce(BodyIndex, Pending.Direction, Pending.Force, Pending.bSweep, Pending.bUseLocalOffset);
 	}
+	PendingForces.Reset();
 }
 
-void UPhysicsCalculator::UpdateGroundState()
+void UPhysicsCalculator::WarnForceDropped(const TCHAR* FunctionName)
 {
-	bool bIsCurrentlyOnGround = OnGround();
-	bHasJustLanded = (!bWasOnGround && bIsCurrentlyOnGround);
-
-	if (bHasJustLanded)
-		UE_LOG(LogTemp, Log, TEXT("着地"));
+	if (bWarnedForceDropped)
+		return;
 
-	bWasOnGround = bIsCurrentlyOnGround;
+	bWarnedForceDropped = true;
+	UE_LOG(LogTemp, Warning, TEXT("%s on %s was ignored because the body is not registered with UPhysicsBatchSubsystem"),
+		FunctionName, *GetPathNameSafe(GetOwner()));
 }
 
-void UPhysicsCalculator::AddForce(FVector Direction, float Force, const bool bSweep, const bool useLocalOffset)
+void UPhysicsCalculator::WakeUp()
 {
-	ForceDirection = Direction;
-	ForceScale = Force;
-	Timer = 0;
-	bIsSweep = bSweep;
-	bIsPhysicsEnabled = false;
-	bUseLocalOffset = useLocalOffset;
+	if (IsRegistered())
+	{
+		BatchSubsystem->WakeBody(BodyIndex);
+	}
+}
 
-	// ★ 追加: 上向きの力(ジャンプ)の場合、一時的に接地判定を無視
-	if (Direction.Z > 0)
+void UPhysicsCalculator::Sleep()
+{
+	if (IsRegistered())
 	{
-		bIgnoreGroundCheck = true;
+		BatchSubsystem->SleepBody(BodyIndex);
 	}
 }
-void UPhysicsCalculator::ResetForce()
+
+bool UPhysicsCalculator::IsSleeping() const
 {
-	ForceDirection = FVector::ZeroVector;
-	ForceScale = 0;
-	Timer = 0;
-	bIsPhysicsEnabled = true;
+	return IsRegistered() && BatchSubsystem->IsSleeping(BodyIndex);
 }
 
-void UPhysicsCalculator::AddGravity()
+// サブシステム自身による移動は除き、眠っている時だけ起こす
+void UPhysicsCalculator::OnOwnerTransformUpdated(USceneComponent* UpdatedComponent, EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport)
 {
-	if (OnGround())
-	{
-		bIsPhysicsEnabled = false;
-		bFalling = false;
-		Timer = 0;
+	if (!IsRegistered() || BatchSubsystem->IsApplyingMoves())
 		return;
-	}
-
-	Timer += GetWorld()->DeltaTimeSeconds;
 
-	// 落下速度を計算
-	float FallSpeed = (GravityScale * Timer) / ForceModifier;
+	BatchSubsystem->WakeBody(BodyIndex);
+}
 
-	// 上限を適用
-	FallSpeed = FMath::Min(FallSpeed, MaxFallingSpeed);
+// 接地判定はサブシステムが非同期スイープで更新した結果を返す
+bool UPhysicsCalculator::OnGround() const
+{
+	if (IsRegistered())
+	{
+		return BatchSubsystem->IsOnGround(BodyIndex);
+	}
 
-	GetOwner()->AddActorLocalOffset(FVector(0, 0, -FallSpeed), true);
+	return SweepGround();
 }
 
-
-bool UPhysicsCalculator::OnGround() const
+bool UPhysicsCalculator::SweepGround() const
 {
 	AActor* Owner = GetOwner();
 	if (!Owner) return false;
@@ -204,88 +231,19 @@ void UPhysicsCalculator::SetGravityScale(bool applyGravity, float scale,float Mo
 	GravityScale = scale;
 	bShouldApplyGravity = applyGravity;
 	ForceModifier = Modifier;
-}
 
-FVector UPhysicsCalculator::GetBlockedAdjustedVector(const FVector& MoveVector)
-{
-	AActor* Owner = GetOwner();
-	if (!Owner || MoveVector.IsNearlyZero()) return MoveVector;
-
-	FVector ActorLocation = Owner->GetActorLocation();
-	FVector ActorScale = Owner->GetActorScale();
-
-	// スケールを元にした固定サイズ（基準20cm）で BoxExtent を計算
-	FVector BoxExtent(
-		20.0f * ActorScale.X,  // 横幅
-		20.0f * ActorScale.Y,  // 奥行き（前後）
-		20.0f * ActorScale.Z   // 高さ
-	);
-
-	FVector Direction = MoveVector.GetSafeNormal();
-	const float BackstepDistance = 1.0f;
-	FVector Start = ActorLocation - Direction * BackstepDistance;
-	FVector End = Start + MoveVector;
-
-	FHitResult Hit;
-	FCollisionQueryParams Params;
-	Params.AddIgnoredActor(Owner);
-
-	bool bHit = GetWorld()->SweepSingleByChannel(
-		Hit,
-		Start,
-		End,
-		FQuat::Identity,
-		ECC_Visibility,
-		FCollisionShape::MakeBox(BoxExtent),
-		Params
-	);
-
-	if (bHit)
+	if (IsRegistered())
 	{
-		const float AdjustMargin = 0.1f;
-		float Distance = FMath::Max(Hit.Distance - AdjustMargin, 0.0f);
-		return Direction * Distance;
+		BatchSubsystem->SetGravity(BodyIndex, applyGravity, scale, Modifier);
 	}
-
-	return MoveVector;
 }
-FVector UPhysicsCalculator::GetGroundNormal() const
-{
-	AActor* Owner = GetOwner();
-	if (!Owner) return FVector::UpVector;
-
-	FVector ActorLocation = Owner->GetActorLocation();
-	FVector ActorScale = Owner->GetActorScale();
-	FVector BoxExtent(20.0f * ActorScale.X, 20.0f * ActorScale.Y, 2.0f);
-
-	float HalfHeight = Owner->GetSimpleCollisionHalfHeight();
-	FVector FootLocation = ActorLocation - FVector(0, 0, HalfHeight);
-	FVector StartTrace = FootLocation;
-	FVector EndTrace = FootLocation - FVector(0, 0, 5.0f);
-
-	FCollisionQueryParams Params;
-	Params.AddIgnoredActor(Owner);
-	FHitResult Hit;
-
-	bool bHit = GetWorld()->SweepSingleByChannel(
-		Hit,
-		StartTrace,
-		EndTrace,
-		FQuat::Identity,
-		ECC_Visibility,
-		FCollisionShape::MakeBox(BoxExtent),
-		Params
-	);
 
-	if (bHit)
-	{
-		return Hit.Normal;
-	}
-
-	// 接地してなければ上向きを返す
-	return FVector::UpVector;
-}
 const bool UPhysicsCalculator::HasLanded()
 {
-	return bHasJustLanded;
+	return IsRegistered() && BatchSubsystem->HasJustLanded(BodyIndex);
+}
+
+bool UPhysicsCalculator::IsPhysicsEnabled() const
+{
+	return IsRegistered() ? BatchSubsystem->IsPhysicsEnabled(BodyIndex) : bIsPhysicsEnabled;
 }
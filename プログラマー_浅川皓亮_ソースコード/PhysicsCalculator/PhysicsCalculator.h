@@ -6,6 +6,8 @@
 #include "Components/ActorComponent.h"
 #include "PhysicsCalculator.generated.h"
 
+class UPhysicsBatchSubsystem;
+
 
 UCLASS( ClassGroup=(Custom), meta=(BlueprintSpawnableComponent) )
 class PACHIO_API UPhysicsCalculator : public UActorComponent
@@ -19,11 +21,10 @@ public:
 protected:
 	// ゲーム開始時に呼ばれる
 	virtual void BeginPlay() override;
+	// 終了時にサブシステムから登録を解除する
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 public:
-	// 毎フレーム呼ばれる
-	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
-
 	UFUNCTION(BlueprintCallable)
 	void ResetForce();
 	// オブジェクトに力を加える
@@ -36,40 +37,42 @@ public:
 
 	void SetGravityScale(const bool applyGravity = true, float scale = 9.8f , float Modifier = 1.0F);
 
-	FVector GetBlockedAdjustedVector(const FVector& MoveVector);
 	UFUNCTION(BlueprintCallable)
 	const bool HasLanded();
 	// 物理計算が有効かどうかを返す
-	bool IsPhysicsEnabled() const { return bIsPhysicsEnabled; }
+	bool IsPhysicsEnabled() const;
+
+	// 静止して眠っているボディを起こす
+	UFUNCTION(BlueprintCallable)
+	void WakeUp();
+	// 静止していなくても計算を止める（画面外の部屋など）
+	UFUNCTION(BlueprintCallable)
+	void Sleep();
+	// 静止して計算を止めているかどうかを返す
+	UFUNCTION(BlueprintCallable)
+	bool IsSleeping() const;
 private:
-	void UpdateGroundState();
-	// オブジェクトに重力を加える
-	void AddGravity();
-	//設置面にあわせて傾ける
-	FVector GetGroundNormal() const;
+	// サブシステムに登録済みかどうか
+	bool IsRegistered() const { return BatchSubsystem != nullptr && BodyIndex != INDEX_NONE; }
+	// 足元を同期スイープして接地しているか調べる（サブシステム未登録時に使用）
+	bool SweepGround() const;
+	// 登録前に加えられた力をサブシステムに渡す
+	void FlushPendingForces();
+	// 登録されていないため力を渡せなかったことを1度だけ警告する
+	void WarnForceDropped(const TCHAR* FunctionName);
+	// 外部（足場・ギミック等）からオーナーが動かされたら起きる
+	void OnOwnerTransformUpdated(USceneComponent* UpdatedComponent, EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport);
 
 private:
+	// 状態の更新はサブシステムがまとめて行う
+	friend class UPhysicsBatchSubsystem;
+
 	// 重力のスケールを設定（重力の強さ）
 	float GravityScale = 9.8f;
 
-	// 力の強さ（スケール）
-	float ForceScale;
-
 	UPROPERTY(EditAnywhere, Category = "Physics")
 	float MaxFallingSpeed = 200.0f;
 
-	// 力を加える方向
-	FVector ForceDirection;
-
-	// 前回のオブジェクトの位置（移動を比較するため）
-	FVector PreviousPosition;	
-	
-	//
-	FVector Velocity = FVector::ZeroVector;
-
-	// 物理シミュレーションのタイマー（力の適用や時間ベースのロジックに使用）
-	float Timer;
-
 	float ForceModifier = 1;
 
 	// 重力を加えるかどうかのフラグ
@@ -84,13 +87,29 @@ private:
 	UPROPERTY(EditAnywhere)
 	bool bIsPhysicsEnabled;		
 
-	bool bUseLocalOffset = true;
-
-	bool bWasOnGround = false;
-
-	bool bFalling = false;
-
-	bool bHasJustLanded = false;
-
-	bool bIgnoreGroundCheck = false; // 接地判定を一時的に無視するフラグ
+	// 描画用にステップ間の位置を補間するかどうか
+	UPROPERTY(EditAnywhere, Category = "Physics|Timestep")
+	bool bInterpolateRender = true;
+
+	// 補間で動かす見た目用のコンポーネント
+	UPROPERTY()
+	USceneComponent* VisualComponent = nullptr;
+
+	// 状態を保持しているサブシステムと、その中でのボディ番号
+	UPROPERTY(Transient)
+	UPhysicsBatchSubsystem* BatchSubsystem = nullptr;
+	int32 BodyIndex = INDEX_NONE;
+
+	// BeginPlay で登録する前に加えられた力（登録した時に順に渡す）
+	struct FPendingForce
+	{
+		FVector Direction;
+		float Force;
+		bool bSweep;
+		bool bUseLocalOffset;
+	};
+	TArray<FPendingForce> PendingForces;
+
+	// 力を渡せなかった警告を出したか
+	bool bWarnedForceDropped = false;
 };
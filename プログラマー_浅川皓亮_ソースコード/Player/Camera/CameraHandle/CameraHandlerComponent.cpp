@@ -1,6 +1,8 @@
 #include "Components/CameraHandlerComponent.h"
 #include "Camera/CameraComponent.h"
 #include "GameFramework/SpringArmComponent.h"
+#include "Manager/GridActivationSubsystem.h"
+#include "Manager/GridStreamingSubsystem.h"
 
 UCameraHandlerComponent::UCameraHandlerComponent()
 {
@@ -16,10 +18,41 @@ void UCameraHandlerComponent::Init(TObjectPtr<USceneComponent> RootComponent)
     if (Camera == nullptr || RootComponent == nullptr)
         return;
   //  SetComponentTickEnabled(false);
+
+    // 部屋の切り替えに合わせてギミックの有効範囲を切り替える
+    if (UGridActivationSubsystem* Activation = GetWorld() ? GetWorld()->GetSubsystem<UGridActivationSubsystem>() : nullptr)
+    {
+        OnGridChanged.AddUObject(Activation, &UGridActivationSubsystem::SetActiveGrid);
+    }
+
+    // 部屋の切り替えに合わせてサブレベルを読み込み・破棄する
+    if (UGridStreamingSubsystem* Streaming = GetWorld() ? GetWorld()->GetSubsystem<UGridStreamingSubsystem>() : nullptr)
+    {
+        OnGridChanged.AddUObject(Streaming, &UGridStreamingSubsystem::SetCurrentGrid);
+    }
+
     SetCameraLocation(CameraViewType);
     SetCameraRotation(CameraViewType);
 }
 
+FIntPoint UCameraHandlerComponent::ComputeGrid(const FVector& Location, const FVector2D& InGridSize)
+{
+    // Y: 横方向 / Z: 縦方向
+    return FIntPoint(
+        FMath::FloorToInt(Location.Y / InGridSize.X),
+        FMath::FloorToInt(Location.Z / InGridSize.Y)
+    );
+}
+
+void UCameraHandlerComponent::SetCurrentGrid(FIntPoint NewGrid, bool bForceNotify)
+{
+    if (NewGrid == CurrentGrid && !bForceNotify)
+        return;
+
+    CurrentGrid = NewGrid;
+    OnGridChanged.Broadcast(CurrentGrid, GridSize, CameraViewType == ECameraViewType::GridView);
+}
+
 
 
 void UCameraHandlerComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
@@ -39,6 +72,9 @@ void UCameraHandlerComponent::UpdateCameraPosition(float DeltaTime)
     {
     case ECameraViewType::CharacterView:
     {
+        // カメラは部屋に固定しないが、ストリーミング用に部屋の切り替えは通知する
+        SetCurrentGrid(ComputeGrid(PlayerLocation, GridSize));
+
         // プレイヤーの前方ベクトルを取得
         FVector PlayerForward = GetOwner()->GetActorForwardVector();
 
@@ -59,17 +95,8 @@ void UCameraHandlerComponent::UpdateCameraPosition(float DeltaTime)
         break;
     }
     case ECameraViewType::GridView:
-        FIntPoint NewGrid;
         // グリッド計算（YZ平面）
-        NewGrid = FIntPoint(
-            FMath::FloorToInt(PlayerLocation.Y / GridSize.X),
-            FMath::FloorToInt(PlayerLocation.Z / GridSize.Y)
-        );
-
-        if (NewGrid != CurrentGrid)
-        {
-            CurrentGrid = NewGrid;
-        }
+        SetCurrentGrid(ComputeGrid(PlayerLocation, GridSize));
 
         // グリッド中央 + プレイヤー位置の偏差 * 追尾割合
         {
@@ -194,10 +221,7 @@ void UCameraHandlerComponent::SetCameraRotation(ECameraViewType type)
 void UCameraHandlerComponent::SetCameraLocation(ECameraViewType type)
 {
     FVector PlayerLocation = GetOwner()->GetActorLocation();
-    CurrentGrid = FIntPoint(
-        FMath::FloorToInt(PlayerLocation.Y / GridSize.X),
-        FMath::FloorToInt(PlayerLocation.Z / GridSize.Y)
-    );
+    SetCurrentGrid(ComputeGrid(PlayerLocation, GridSize), true);
     //switch (type)
     //{
     //case ECameraViewType::SideView:
@@ -237,11 +261,8 @@ void UCameraHandlerComponent::ApplyCameraSettings(FVector2D newSize, float newBu
     GridSize = newSize;
     Zbaffa = newBuffa;
     FVector PlayerLocation = GetOwner()->GetActorLocation();
-    // Y: 横方向 / Z: 縦方向
-    CurrentGrid = FIntPoint(
-        FMath::FloorToInt(PlayerLocation.Y / GridSize.X),
-        FMath::FloorToInt(PlayerLocation.Z / GridSize.Y)
-    );
+    // グリッドサイズが変わった場合も部屋の割り当てをやり直すため必ず通知する
+    SetCurrentGrid(ComputeGrid(PlayerLocation, GridSize), true);
 
     TargetCameraLocation = FVector(
         -Zbaffa,  // ← X方向に配置（プレイヤーの右側）
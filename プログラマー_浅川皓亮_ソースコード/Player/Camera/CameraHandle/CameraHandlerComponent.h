@@ -9,6 +9,9 @@
 class USpringArmComponent;
 class UCameraComponent;
 
+// 部屋（グリッド）が切り替わった時の通知（グリッド座標・グリッドサイズ・グリッド表示中か）
+DECLARE_MULTICAST_DELEGATE_ThreeParams(FOnCameraGridChanged, FIntPoint, FVector2D, bool);
+
 UENUM(BlueprintType)
 enum class ECameraViewType : uint8
 {
@@ -30,14 +33,26 @@ public:
 	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
 	void ApplyCameraSettings(FVector2D, float);
 	void ApplyCameraSettings(FVector2D, float, ECameraViewType);
-	void ChangeViewMode(ECameraViewType newMode) { CameraViewType = newMode; }
+	void ChangeViewMode(ECameraViewType newMode) { CameraViewType = newMode; SetCurrentGrid(CurrentGrid, true); }
 	bool IsParameterMatch(FVector2D, float);
 
 	UCameraComponent* GetCamera() { return Camera; }
+
+	// 現在のグリッド座標とグリッドサイズ
+	FIntPoint GetCurrentGrid() const { return CurrentGrid; }
+	FVector2D GetGridSize() const { return GridSize; }
+
+	// 位置が含まれるグリッド座標（YZ平面）を求める
+	static FIntPoint ComputeGrid(const FVector& Location, const FVector2D& InGridSize);
+
+	// 部屋が切り替わった時の通知
+	FOnCameraGridChanged OnGridChanged;
 private:	
 	void UpdateCameraPosition(float DeltaTime);
 	void SetCameraRotation(ECameraViewType);
 	void SetCameraLocation(ECameraViewType);
+	// グリッド座標を更新し、変わっていれば（または強制時）通知する
+	void SetCurrentGrid(FIntPoint NewGrid, bool bForceNotify = false);
 private:
 	UPROPERTY(EditAnywhere, Category = "Grid")
 	ECameraViewType CameraViewType = ECameraViewType::CharacterView;
@@ -5,6 +5,7 @@
 #include "Player/PlayerCharacter.h"
 #include "Components/BoxComponent.h"
 #include "Components/CameraHandlerComponent.h"
+#include "Manager/GridStreamingSubsystem.h"
 
 AConfigTriggerZone::AConfigTriggerZone()
 {
@@ -27,7 +28,9 @@ void AConfigTriggerZone::BeginPlay()
 // 1. アクターの有効性を確認
 // 2. プレイヤーキャラクターにキャスト
 // 3. CameraHandlerComponentを取得
-// 4. 現在のパラメータと異なる場合のみカメラ設定を適用
+// 4. 部屋ごとのサブレベルをストリーミングに設定（カメラ設定の通知で読み込ませるため先に設定）
+// 5. 現在のパラメータと異なる場合のみカメラ設定を適用
+// 6. 同じ場合はグリッドの通知が無いため、今の部屋で読み込み直す
 void AConfigTriggerZone::OnOverlapBegin(UPrimitiveComponent* OverlappedComp, AActor* OtherActor, UPrimitiveComponent* OtherComp,
 	int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
 {
@@ -42,8 +45,19 @@ void AConfigTriggerZone::OnOverlapBegin(UPrimitiveComponent* OverlappedComp, AAc
 	if (CameraHandle == nullptr)
 		return;
 
+	// 空の場合も設定し、前のゾーンの部屋を残さない
+	UGridStreamingSubsystem* Streaming = GetWorld()->GetSubsystem<UGridStreamingSubsystem>();
+	if (Streaming)
+	{
+		Streaming->SetStreamingCells(StreamingCells);
+	}
+
 	if (!CameraHandle->IsParameterMatch(GridSize, ZBaffer))
 	{
 		CameraHandle->ApplyCameraSettings(GridSize, ZBaffer, CameraViewType);
 	}
+	else if (Streaming)
+	{
+		Streaming->RefreshStreaming();
+	}
 }
\ No newline at end of file
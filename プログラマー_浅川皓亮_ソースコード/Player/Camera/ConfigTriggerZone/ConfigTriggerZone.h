@@ -5,6 +5,7 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
 #include "Components/CameraHandlerComponent.h"
+#include "Manager/GridStreamingSubsystem.h"
 #include "ConfigTriggerZone.generated.h"
 
 
@@ -12,6 +13,7 @@ class UBoxComponent;
 /**
  * カメラ設定トリガーゾーン
  * プレイヤーが侵入するとカメラの設定(グリッドサイズ、Zバッファ、視点タイプ)を変更する
+ * 部屋ごとのサブレベルが設定されていれば、同じグリッドでのストリーミングに切り替える
  */
 UCLASS()
 class PACHIO_API AConfigTriggerZone : public AActor
@@ -55,4 +57,8 @@ private:
 	// カメラのZバッファ値(エディタで設定)
 	UPROPERTY(EditAnywhere, Category = "Camera Settings")
 	float ZBaffer = 9000.0f;
+
+	// このゾーンの部屋ごとのサブレベル(GridSizeで区切った座標、空ならストリーミングしない)
+	UPROPERTY(EditAnywhere, Category = "Streaming")
+	TArray<FGridStreamingCell> StreamingCells;
 };
\ No newline at end of file
@@ -0,0 +1,227 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Logic/Input/InputTrace.h"
+
+#include <cmath>
+#include <cstring>
+
+namespace InputTrace
+{
+	namespace
+	{
+		static constexpr uint8_t MAGIC[4] = { 'P', 'I', 'T', 'R' };
+		static constexpr uint32_t VERSION = 1;
+		static constexpr uint32_t FNV_PRIME = 16777619u;
+
+		// 1フレームあたりのイベント数の上限（壊れたファイルで巨大な確保をしないため）
+		static constexpr uint64_t MAX_EVENTS_PER_FRAME = 1024;
+
+		uint32_t ZigZag(int32_t Value)
+		{
+			return (static_cast<uint32_t>(Value) << 1) ^ static_cast<uint32_t>(Value >> 31);
+		}
+
+		int32_t UnZigZag(uint32_t Value)
+		{
+			return static_cast<int32_t>(Value >> 1) ^ -static_cast<int32_t>(Value & 1);
+		}
+
+		void WriteVarUInt(std::vector<uint8_t>& Out, uint64_t Value)
+		{
+			while (Value >= 0x80)
+			{
+				Out.push_back(static_cast<uint8_t>(Value | 0x80));
+				Value >>= 7;
+			}
+			Out.push_back(static_cast<uint8_t>(Value));
+		}
+
+		void WriteVarInt(std::vector<uint8_t>& Out, int32_t Value)
+		{
+			WriteVarUInt(Out, ZigZag(Value));
+		}
+
+		void WriteUInt32(std::vector<uint8_t>& Out, uint32_t Value)
+		{
+			for (int32_t i = 0; i < 4; ++i)
+			{
+				Out.push_back(static_cast<uint8_t>(Value >> (i * 8)));
+			}
+		}
+
+		// 読み込み位置と範囲を持つ簡易リーダー（範囲外を読もうとしたら失敗扱い）
+		struct FReader
+		{
+			const uint8_t* Data;
+			size_t Size;
+			size_t Offset = 0;
+			bool bError = false;
+
+			uint64_t ReadVarUInt()
+			{
+				uint64_t Value = 0;
+				for (int32_t Shift = 0; Shift < 64; Shift += 7)
+				{
+					if (Offset >= Size)
+						break;
+
+					const uint8_t Byte = Data[Offset++];
+					Value |= static_cast<uint64_t>(Byte & 0x7F) << Shift;
+					if ((Byte & 0x80) == 0)
+						return Value;
+				}
+				bError = true;
+				return 0;
+			}
+
+			int32_t ReadVarInt()
+			{
+				return UnZigZag(static_cast<uint32_t>(ReadVarUInt()));
+			}
+
+			uint32_t ReadUInt32()
+			{
+				if (Offset + 4 > Size)
+				{
+					bError = true;
+					return 0;
+				}
+
+				uint32_t Value = 0;
+				for (int32_t i = 0; i < 4; ++i)
+				{
+					Value |= static_cast<uint32_t>(Data[Offset++]) << (i * 8);
+				}
+				return Value;
+			}
+		};
+
+		// 差分の基準にするチャンネルごとの前回値
+		struct FLastValues
+		{
+			int32_t X[static_cast<int32_t>(EChannel::Count)] = {};
+			int32_t Y[static_cast<int32_t>(EChannel::Count)] = {};
+			int32_t MouseX = 0;
+			int32_t MouseY = 0;
+		};
+	}
+
+	int32_t Quantize(float Value)
+	{
+		return static_cast<int32_t>(std::lround(Value * QUANTIZE_SCALE));
+	}
+
+	float Dequantize(int32_t Value)
+	{
+		return static_cast<float>(Value) / QUANTIZE_SCALE;
+	}
+
+	// 処理の流れ:
+	// 1. ヘッダ（識別子・バージョン・固定ステップ・フレーム数）を書き出す
+	// 2. フレームごとにイベント数と各イベントを書き出す（軸はチャンネルごとの前回値との差分）
+	// 3. マウス移動量は前フレームとの差分、状態ハッシュはそのまま4バイトで書き出す
+	void Encode(const FTrace& Trace, std::vector<uint8_t>& OutBytes)
+	{
+		OutBytes.insert(OutBytes.end(), MAGIC, MAGIC + sizeof(MAGIC));
+		WriteVarUInt(OutBytes, VERSION);
+
+		uint32_t FixedDeltaBits = 0;
+		std::memcpy(&FixedDeltaBits, &Trace.FixedDeltaTime, sizeof(FixedDeltaBits));
+		WriteUInt32(OutBytes, FixedDeltaBits);
+		WriteVarUInt(OutBytes, Trace.Frames.size());
+
+		FLastValues Last;
+		for (const FFrame& Frame : Trace.Frames)
+		{
+			WriteVarUInt(OutBytes, Frame.Events.size());
+			for (const FEvent& Event : Frame.Events)
+			{
+				const int32_t Channel = static_cast<int32_t>(Event.Channel);
+				OutBytes.push_back(static_cast<uint8_t>(Channel));
+				WriteVarInt(OutBytes, Event.X - Last.X[Channel]);
+				WriteVarInt(OutBytes, Event.Y - Last.Y[Channel]);
+				Last.X[Channel] = Event.X;
+				Last.Y[Channel] = Event.Y;
+			}
+
+			WriteVarInt(OutBytes, Frame.MouseX - Last.MouseX);
+			WriteVarInt(OutBytes, Frame.MouseY - Last.MouseY);
+			Last.MouseX = Frame.MouseX;
+			Last.MouseY = Frame.MouseY;
+
+			WriteUInt32(OutBytes, Frame.StateHash);
+		}
+	}
+
+	// 処理の流れ:
+	// 1. 識別子とバージョンを確認
+	// 2. 固定ステップとフレーム数を読み込む
+	// 3. Encode と同じ順で差分を足し戻しながらフレームを復元
+	bool Decode(const uint8_t* Bytes, size_t Size, FTrace& OutTrace)
+	{
+		OutTrace = FTrace();
+		if (Bytes == nullptr || Size < sizeof(MAGIC) || std::memcmp(Bytes, MAGIC, sizeof(MAGIC)) != 0)
+			return false;
+
+		FReader Reader{ Bytes, Size, sizeof(MAGIC) };
+		if (Reader.ReadVarUInt() != VERSION)
+			return false;
+
+		const uint32_t FixedDeltaBits = Reader.ReadUInt32();
+		std::memcpy(&OutTrace.FixedDeltaTime, &FixedDeltaBits, sizeof(FixedDeltaBits));
+
+		// 1フレームは最低6バイト（イベント数・マウス2軸・ハッシュ）
+		const uint64_t FrameCount = Reader.ReadVarUInt();
+		if (Reader.bError || FrameCount > Size / 6)
+			return false;
+
+		OutTrace.Frames.resize(static_cast<size_t>(FrameCount));
+
+		FLastValues Last;
+		for (FFrame& Frame : OutTrace.Frames)
+		{
+			const uint64_t EventCount = Reader.ReadVarUInt();
+			if (Reader.bError || EventCount > MAX_EVENTS_PER_FRAME)
+				return false;
+
+			Frame.Events.resize(static_cast<size_t>(EventCount));
+			for (FEvent& Event : Frame.Events)
+			{
+				if (Reader.Offset >= Reader.Size)
+					return false;
+
+				const int32_t Channel = Reader.Data[Reader.Offset++];
+				if (Channel >= static_cast<int32_t>(EChannel::Count))
+					return false;
+
+				Event.Channel = static_cast<EChannel>(Channel);
+				Event.X = Last.X[Channel] + Reader.ReadVarInt();
+				Event.Y = Last.Y[Channel] + Reader.ReadVarInt();
+				Last.X[Channel] = Event.X;
+				Last.Y[Channel] = Event.Y;
+			}
+
+			Frame.MouseX = Last.MouseX + Reader.ReadVarInt();
+			Frame.MouseY = Last.MouseY + Reader.ReadVarInt();
+			Last.MouseX = Frame.MouseX;
+			Last.MouseY = Frame.MouseY;
+
+			Frame.StateHash = Reader.ReadUInt32();
+			if (Reader.bError)
+				return false;
+		}
+
+		return Reader.Offset == Reader.Size;
+	}
+
+	uint32_t HashCombine(uint32_t Hash, int32_t Value)
+	{
+		const uint32_t Bits = static_cast<uint32_t>(Value);
+		for (int32_t i = 0; i < 4; ++i)
+		{
+			Hash ^= (Bits >> (i * 8)) & 0xFF;
+			Hash *= FNV_PRIME;
+		}
+		return Hash;
+	}
+}
@@ -0,0 +1,92 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * 入力の記録・再生に使うバイナリ形式（エンジン非依存）
+ *
+ * 1フレーム分の入力イベントとマウス移動量、フレーム終了時の状態ハッシュを持つ
+ * 値は固定小数点に量子化し、前回値との差分を ZigZag + 可変長整数で書き出す
+ */
+namespace InputTrace
+{
+	// 入力の種類（記録後に並びを変えないこと）
+	enum class EChannel : uint8_t
+	{
+		Move = 0,
+		Jump,
+		Action,
+		MouseScroll,
+		StickMove,
+		Count
+	};
+
+	// 浮動小数を固定小数点に変換する倍率
+	static constexpr float QUANTIZE_SCALE = 1000.0f;
+
+	// 1つの入力イベント（軸は量子化済み）
+	struct FEvent
+	{
+		EChannel Channel = EChannel::Move;
+		int32_t X = 0;
+		int32_t Y = 0;
+	};
+
+	// 1フレーム分の入力
+	struct FFrame
+	{
+		std::vector<FEvent> Events;
+
+		// Tick中に読み取ったマウス移動量（量子化済み）
+		int32_t MouseX = 0;
+		int32_t MouseY = 0;
+
+		// フレーム終了時の状態ハッシュ（再生時のずれ検出用）
+		uint32_t StateHash = 0;
+	};
+
+	// 記録全体
+	struct FTrace
+	{
+		// 記録時の固定ステップ（秒）
+		float FixedDeltaTime = 1.0f / 60.0f;
+
+		std::vector<FFrame> Frames;
+	};
+
+	/** 浮動小数を量子化 @param Value 元の値 */
+	int32_t Quantize(float Value);
+
+	/** 量子化した値を浮動小数に戻す @param Value 量子化した値 */
+	float Dequantize(int32_t Value);
+
+	/**
+	 * 記録をバイト列に変換する
+	 * @param Trace 記録
+	 * @param OutBytes 書き出し先（末尾に追加）
+	 */
+	void Encode(const FTrace& Trace, std::vector<uint8_t>& OutBytes);
+
+	/**
+	 * バイト列から記録を復元する
+	 * @param Bytes 読み込むバイト列
+	 * @param Size バイト数
+	 * @param OutTrace 復元先
+	 * @return 形式が正しく最後まで読めた場合true
+	 */
+	bool Decode(const uint8_t* Bytes, size_t Size, FTrace& OutTrace);
+
+	/**
+	 * 状態ハッシュに値を混ぜる（FNV-1a）
+	 * @param Hash これまでのハッシュ（最初は HASH_SEED）
+	 * @param Value 混ぜる値
+	 * @return 更新後のハッシュ
+	 */
+	uint32_t HashCombine(uint32_t Hash, int32_t Value);
+
+	static constexpr uint32_t HASH_SEED = 2166136261u;
+}
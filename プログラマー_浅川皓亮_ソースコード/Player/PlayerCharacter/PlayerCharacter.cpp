@@ -22,8 +22,9 @@
 #include "Kismet/KismetMathLibrary.h"
 #include "Kismet/GameplayStatics.h" 
 #include "Logic/Movement/PlayerMoveLogic.h"
-#include "Manager/LevelManager.h"
+#include "Manager/GameServicesSubsystem.h"
 #include "Manager/ColorManager.h"
+#include "Manager/InputReplaySubsystem.h"
 #include "UI/UIManager.h"
 #include "Player/SlimeFluidActor.h"
 #include "NiagaraComponent.h"
@@ -44,6 +45,10 @@ namespace
 	static constexpr float MOUSE_DELTA_THRESHOLD = 4.0f;
 	static constexpr float GLOW_INTENSITY_ON = 1.0f;
 	static constexpr float GLOW_INTENSITY_OFF = 0.0f;
+	// 発光の強さを書き込む Custom Primitive Data の番号（マテリアル側と合わせる）
+	static constexpr int32 GLOW_CUSTOM_DATA_INDEX = 0;
+	// この距離以上移動したら最も近い発光対象を選び直す
+	static constexpr float GLOW_RECHECK_DISTANCE = 10.0f;
 }
 
 // コンストラクタ
@@ -88,12 +93,22 @@ void APlayerCharacter::BeginPlay()
 	InitInput();
 	// 視覚関連設定（アウトラインなど）
 	InitVisualSettings();
+	// 持てる物の発光対象の追跡を開始
+	InitGlowTracking();
+	// 色変更のたびに検索しないよう先に解決しておく
+	CachedSlimeFluid.Get(this);
 	// ColorManager に登録
-	ALevelManager::GetInstance(GetWorld())->GetColorManager()->RegisterTarget(this);
+	const UGameServicesSubsystem* Services = UGameServicesSubsystem::Get(this);
+	if (UColorManager* ColorManager = Services ? Services->GetColorManager() : nullptr)
+	{
+		ColorManager->RegisterTarget(this);
+	}
 
 	colorController->OnColorChanged.AddDynamic(this,&APlayerCharacter::ApplayColorToEffect);
 
 	bUseControllerRotationYaw = false;
+
+	InputReplay = GetWorld()->GetSubsystem<UInputReplaySubsystem>();
 }
 
 void APlayerCharacter::Tick(float DeltaTime)
@@ -102,10 +117,22 @@ void APlayerCharacter::Tick(float DeltaTime)
 
 	if (StateManagerComponent == nullptr)
 		return;
+
+	// 入力再生中はこのフレームの入力をここで流す
+	if (InputReplay)
+	{
+		InputReplay->BeginPlayerFrame(this);
+	}
+
 	Circle();
 
 	StateManagerComponent->Update(DeltaTime);
 	UpdateGlowTarget();
+
+	if (InputReplay)
+	{
+		InputReplay->EndPlayerFrame(this);
+	}
 	//if (GetActorLocation().X != FixedXLocation)
 	//	SetActorLocation(FVector(FixedXLocation, GetActorLocation().Y, GetActorLocation().Z));
 }
@@ -182,6 +209,10 @@ void APlayerCharacter::Circle()
 		return;
 
 	PC->GetInputMouseDelta(DeltaX, DeltaY);
+	if (InputReplay)
+	{
+		InputReplay->FilterMouseDelta(DeltaX, DeltaY);
+	}
 	FVector2D CurrentDir(DeltaX, DeltaY);
 
 	if (CurrentDir.SizeSquared() > MOUSE_DELTA_THRESHOLD)
@@ -216,9 +247,10 @@ void APlayerCharacter::Circle()
 
 
 // 移動入力処理（MoveCompを通して移動方向を取得し移動）
-void APlayerCharacter::Movement(const FInputActionValue& Value)
+void APlayerCharacter::Movement(const FInputActionValue& InValue)
 {
-	if (StateManagerComponent == nullptr)
+	FInputActionValue Value = InValue;
+	if (StateManagerComponent == nullptr || !FilterRecordedInput(InputTrace::EChannel::Move, Value))
 		return;
 
 	UPlayerStateComponent* CurrentState = StateManagerComponent->GetCurrentState();
@@ -232,9 +264,10 @@ void APlayerCharacter::Movement(const FInputActionValue& Value)
 // 移動方向はMovement関数で取得済みのFVector directionをジャンプでも使いたいので
 // Movement関数のdirectionをJump関数に渡すか、Jump関数内で再取得する必要あり
 
-void APlayerCharacter::Jump(const FInputActionValue& Value)
+void APlayerCharacter::Jump(const FInputActionValue& InValue)
 {
-	if (StateManagerComponent == nullptr)
+	FInputActionValue Value = InValue;
+	if (StateManagerComponent == nullptr || !FilterRecordedInput(InputTrace::EChannel::Jump, Value))
 		return;
 
 	UPlayerStateComponent* CurrentState = StateManagerComponent->GetCurrentState();
@@ -246,9 +279,10 @@ void APlayerCharacter::Jump(const FInputActionValue& Value)
 
 // ダッシュ・スキル開始処理
 // APlayerCharacter.cpp 内の Action メソッド
-void APlayerCharacter::Action(const FInputActionValue& Value)
+void APlayerCharacter::Action(const FInputActionValue& InValue)
 {
-	if (StateManagerComponent == nullptr)
+	FInputActionValue Value = InValue;
+	if (StateManagerComponent == nullptr || !FilterRecordedInput(InputTrace::EChannel::Action, Value))
 		return;
 
 	UPlayerStateComponent* CurrentState = StateManagerComponent->GetCurrentState();
@@ -274,8 +308,12 @@ void APlayerCharacter::SetGravityScale(bool applyGravity, float scale)
 	physics->SetGravityScale(applyGravity, scale);
 }
 
-void APlayerCharacter::OnMouseScroll(const FInputActionValue& Value)
+void APlayerCharacter::OnMouseScroll(const FInputActionValue& InValue)
 {
+	FInputActionValue Value = InValue;
+	if (!FilterRecordedInput(InputTrace::EChannel::MouseScroll, Value))
+		return;
+
 	float ScrollValue = Value.Get<float>();
 
 	if (ScrollValue > SCROLL_COLOR_CHANGE_RATE)
@@ -294,7 +332,7 @@ void APlayerCharacter::ChangeColor(float value)
 		return;
 
 	colorController->AdjustColor(value);
-	USlimeFluidComponent* SlimeFluidComponent = GetComponentByClass<USlimeFluidComponent>();
+	USlimeFluidComponent* SlimeFluidComponent = CachedSlimeFluid.Get(this);
 	if (SlimeFluidComponent)
 	{
 		SlimeFluidComponent->ChangeMaterialColor(colorController->GetCurrentColor());
@@ -320,6 +358,29 @@ void APlayerCharacter::ChangeCameraViewModeToGrid()
 	StateManagerComponent->GetCurrentState()->ChangePaintMode(EColorAbsorbMode::Paint);
 }
 
+// 入力の記録・再生（サブシステムが無い場合はそのまま処理する）
+bool APlayerCharacter::FilterRecordedInput(InputTrace::EChannel Channel, FInputActionValue& Value) const
+{
+	return InputReplay == nullptr || InputReplay->FilterInput(Channel, Value);
+}
+
+// 入力再生のずれ検出用ハッシュ（位置は量子化し、浮動小数の誤差程度では変わらないようにする）
+uint32 APlayerCharacter::ComputeReplayStateHash() const
+{
+	const FVector Location = GetActorLocation();
+
+	uint32 Hash = InputTrace::HASH_SEED;
+	Hash = InputTrace::HashCombine(Hash, FMath::RoundToInt(Location.X * 10.0f));
+	Hash = InputTrace::HashCombine(Hash, FMath::RoundToInt(Location.Y * 10.0f));
+	Hash = InputTrace::HashCombine(Hash, FMath::RoundToInt(Location.Z * 10.0f));
+	Hash = InputTrace::HashCombine(Hash, FMath::RoundToInt(GetActorRotation().Yaw));
+	if (StateManagerComponent != nullptr)
+	{
+		Hash = InputTrace::HashCombine(Hash, static_cast<int32>(StateManagerComponent->GetCurrentStateType()));
+	}
+	return Hash;
+}
+
 // 状態の変更（ステートタグを指定して遷移）
 UPlayerStateComponent* APlayerCharacter::ChangeState(EPlayerStateType Tag)
 {
@@ -437,15 +498,23 @@ void APlayerCharacter::OnStickRotate(const FVector2D& StickInput)
 	}
 }
 
-void APlayerCharacter::OnStickMove(const FInputActionValue& Value)
+void APlayerCharacter::OnStickMove(const FInputActionValue& InValue)
 {
+	FInputActionValue Value = InValue;
+	if (!FilterRecordedInput(InputTrace::EChannel::StickMove, Value))
+		return;
+
 	FVector2D StickInput = Value.Get<FVector2D>();
 	OnStickRotate(StickInput);
 }
 
 void APlayerCharacter::OpenMenu(const FInputActionValue& Value)
 {
-	ALevelManager::GetInstance(GetWorld())->GetUIManager()->ShowWidget(EWidgetCategory::Menu, "Menu");
+	const UGameServicesSubsystem* Services = UGameServicesSubsystem::Get(this);
+	if (UUIManager* UIManager = Services ? Services->GetUIManager() : nullptr)
+	{
+		UIManager->ShowWidget(EWidgetCategory::Menu, "Menu");
+	}
 }
 
 UCameraComponent* APlayerCharacter::GetCamera()const
@@ -477,59 +546,117 @@ void APlayerCharacter::ApplayColorToEffect(FLinearColor NewColor)
 
 }
 
+// 処理の流れ:
+// 1. 候補が変わっておらず、前回からの移動が閾値未満で、光らせている対象のタグも外れていなければ何もしない
+// 2. 破棄された候補を取り除き、"Holdable" タグ付きの候補から最も近いものを選ぶ
+// 3. 対象が変わった場合のみ発光を切り替える
 void APlayerCharacter::UpdateGlowTarget()
 {
-	UBoxComponent* InteractionBox = UFunctionLibrary::FindComponentByName<UBoxComponent>(this, TEXT("InteractionBox"));
-	if (InteractionBox == nullptr)
-	{
-		CurrentGlowTarget = nullptr;
+	const FVector MyLocation = GetActorLocation();
+	const bool bTargetStillHoldable = CurrentGlowTarget == nullptr || (IsValid(CurrentGlowTarget) && CurrentGlowTarget->ActorHasTag("Holdable"));
+	if (!bGlowCandidatesDirty && bTargetStillHoldable
+		&& FVector::DistSquared(MyLocation, LastGlowCheckLocation) < FMath::Square(GLOW_RECHECK_DISTANCE))
 		return;
-	}
-	// オーバーラップ中のActorを取得
-	TArray<AActor*> OverlappingActors;
-	InteractionBox->GetOverlappingActors(OverlappingActors);
+
+	bGlowCandidatesDirty = false;
+	LastGlowCheckLocation = MyLocation;
 
 	AActor* NewGlowTarget = nullptr;
 	float MinDistSq = FLT_MAX;
-	FVector MyLocation = GetActorLocation();
 
-	for (AActor* Actor : OverlappingActors)
+	for (int32 i = GlowCandidates.Num() - 1; i >= 0; --i)
 	{
+		AActor* Actor = GlowCandidates[i].Get();
 		if (!IsValid(Actor))
+		{
+			GlowCandidates.RemoveAtSwap(i);
 			continue;
+		}
 
-		// Tagで判定
-		if (Actor->ActorHasTag("Holdable"))
+		// 持っている間などにタグが外れていれば対象にしない
+		if (!Actor->ActorHasTag("Holdable"))
+			continue;
+
+		float DistSq = FVector::DistSquared(MyLocation, Actor->GetActorLocation());
+		if (DistSq < MinDistSq)
 		{
-			float DistSq = FVector::DistSquared(MyLocation, Actor->GetActorLocation());
-			if (DistSq < MinDistSq)
-			{
-				MinDistSq = DistSq;
-				NewGlowTarget = Actor;
-			}
+			MinDistSq = DistSq;
+			NewGlowTarget = Actor;
 		}
 	}
 
 	if (NewGlowTarget != CurrentGlowTarget)
 	{
-		// 前のGlowを解除
-		if (CurrentGlowTarget)
-		{
-			if (USkeletalMeshComponent* mesh = CurrentGlowTarget->FindComponentByClass<USkeletalMeshComponent>())
-			{
-				mesh->SetScalarParameterValueOnMaterials(TEXT("GlowIntensity"), GLOW_INTENSITY_OFF);
-			}
-		}
+		// 前のGlowを解除して新しいGlowを適用
+		SetGlowIntensity(CurrentGlowTarget, GLOW_INTENSITY_OFF);
+		SetGlowIntensity(NewGlowTarget, GLOW_INTENSITY_ON);
+
+		CurrentGlowTarget = NewGlowTarget;
+	}
+}
+
+// 処理の流れ:
+// 1. InteractionBox を名前で一度だけ取得
+// 2. オーバーラップ開始・終了イベントを登録
+// 3. 既に重なっているActorを候補に追加（タグは UpdateGlowTarget で確認する）
+void APlayerCharacter::InitGlowTracking()
+{
+	InteractionBox = UFunctionLibrary::FindComponentByName<UBoxComponent>(this, TEXT("InteractionBox"));
+	if (InteractionBox == nullptr)
+		return;
+
+	InteractionBox->OnComponentBeginOverlap.AddUniqueDynamic(this, &APlayerCharacter::OnInteractionBoxBeginOverlap);
+	InteractionBox->OnComponentEndOverlap.AddUniqueDynamic(this, &APlayerCharacter::OnInteractionBoxEndOverlap);
 
-		// 新しいGlowを適用
-		if (NewGlowTarget)
+	TArray<AActor*> OverlappingActors;
+	InteractionBox->GetOverlappingActors(OverlappingActors);
+	for (AActor* Actor : OverlappingActors)
+	{
+		if (IsValid(Actor) && Actor != this)
 		{
-			if (USkeletalMeshComponent* mesh = NewGlowTarget->FindComponentByClass<USkeletalMeshComponent>())
-			{
-				mesh->SetScalarParameterValueOnMaterials(TEXT("GlowIntensity"), GLOW_INTENSITY_ON);
-			}
+			GlowCandidates.AddUnique(Actor);
 		}
+	}
 
-		CurrentGlowTarget = NewGlowTarget;
+	bGlowCandidatesDirty = true;
+}
+
+// Actorが入ったら候補に追加（後から "Holdable" タグが付くこともあるため、タグはここでは見ない）
+void APlayerCharacter::OnInteractionBoxBeginOverlap(UPrimitiveComponent* OverlappedComp, AActor* OtherActor, UPrimitiveComponent* OtherComp,
+	int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
+{
+	if (!IsValid(OtherActor) || OtherActor == this)
+		return;
+
+	// 複数のコンポーネントが重なった場合も候補は1つ
+	if (GlowCandidates.Contains(OtherActor))
+		return;
+
+	GlowCandidates.Add(OtherActor);
+	bGlowCandidatesDirty = true;
+}
+
+// Actorが出たら候補から外す（別のコンポーネントがまだ重なっている場合は残す）
+void APlayerCharacter::OnInteractionBoxEndOverlap(UPrimitiveComponent* OverlappedComp, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex)
+{
+	if (OtherActor == nullptr || (InteractionBox && InteractionBox->IsOverlappingActor(OtherActor)))
+		return;
+
+	if (GlowCandidates.Remove(OtherActor) > 0)
+	{
+		bGlowCandidatesDirty = true;
+	}
+}
+
+// マテリアルのパラメータではなく Custom Primitive Data で発光させる
+// （マテリアルインスタンスを作らずに済み、同じメッシュ同士の描画がまとめられたままになる）
+void APlayerCharacter::SetGlowIntensity(AActor* Target, float Intensity) const
+{
+	if (!IsValid(Target))
+		return;
+
+	if (USkeletalMeshComponent* mesh = Target->FindComponentByClass<USkeletalMeshComponent>())
+	{
+		mesh->SetCustomPrimitiveDataFloat(GLOW_CUSTOM_DATA_INDEX, Intensity);
 	}
 }
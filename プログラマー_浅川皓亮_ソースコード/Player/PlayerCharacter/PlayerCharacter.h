@@ -6,6 +6,7 @@
 #include "Interface/StateControllable.h"
 #include "Interface/ColorFilterInterface.h"
 #include "Interface/ActionControl/CharacterActionInterfaces.h"
+#include "Components/ComponentCache.h"
 #include "PlayerCharacter.generated.h"
 
 // ===========================
@@ -31,6 +32,10 @@ class UPhysicsCalculator;
 class UMoveComponent;
 
 class UNiagaraSystem;
+class UInputReplaySubsystem;
+class USlimeFluidComponent;
+
+namespace InputTrace { enum class EChannel : uint8_t; }
 
 struct FInputActionValue;
 /**
@@ -157,6 +162,7 @@ public:
 
     /**
      * @brief 現在光らせている対象を更新
+     * 候補が変わった時か、一定距離以上移動した時だけ最も近い候補を選び直す
      */
     void UpdateGlowTarget();
 
@@ -184,6 +190,12 @@ public:
     UFUNCTION(BlueprintCallable)
     void ApplayColorToEffect(FLinearColor NewColor);
 
+    /**
+     * @brief 入力再生のずれ検出に使う状態ハッシュ
+     * @return 位置・向き・ステートから求めたハッシュ
+     */
+    uint32 ComputeReplayStateHash() const;
+
 private:
     // ============================
     // ==== ステート管理関連 ======
@@ -223,6 +235,51 @@ private:
     /** @brief サークル処理（未詳細） */
     void Circle();
 
+    /**
+     * @brief 入力を記録・再生に通す
+     * @param Channel 入力の種類
+     * @param Value 入力値（記録中は量子化後の値に置き換わる）
+     * @return 入力を処理してよい場合true（再生中の実入力はfalse）
+     */
+    bool FilterRecordedInput(InputTrace::EChannel Channel, FInputActionValue& Value) const;
+
+    // ============================
+    // ==== 発光対象の管理 ========
+    // ============================
+
+    /** @brief InteractionBox を取得してオーバーラップイベントを登録し、現在の候補を集める */
+    void InitGlowTracking();
+
+    /**
+     * @brief InteractionBox に入ったActorを発光候補に追加
+     * @param OverlappedComp オーバーラップしたコンポーネント
+     * @param OtherActor オーバーラップした相手のアクター
+     * @param OtherComp 相手のコンポーネント
+     * @param OtherBodyIndex 相手のボディインデックス
+     * @param bFromSweep スイープによるオーバーラップか
+     * @param SweepResult スイープ結果
+     */
+    UFUNCTION()
+    void OnInteractionBoxBeginOverlap(UPrimitiveComponent* OverlappedComp, AActor* OtherActor, UPrimitiveComponent* OtherComp,
+        int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult);
+
+    /**
+     * @brief InteractionBox から出たActorを発光候補から外す
+     * @param OverlappedComp オーバーラップしていたコンポーネント
+     * @param OtherActor オーバーラップしていた相手のアクター
+     * @param OtherComp 相手のコンポーネント
+     * @param OtherBodyIndex 相手のボディインデックス
+     */
+    UFUNCTION()
+    void OnInteractionBoxEndOverlap(UPrimitiveComponent* OverlappedComp, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex);
+
+    /**
+     * @brief 対象の発光の強さを Custom Primitive Data で設定
+     * @param Target 対象Actor
+     * @param Intensity 発光の強さ
+     */
+    void SetGlowIntensity(AActor* Target, float Intensity) const;
+
 private:
     // ============================
     // ==== プレイヤー変数 ========
@@ -284,4 +341,24 @@ private:
     /** 現在光らせている対象Actor */
     UPROPERTY()
     AActor* CurrentGlowTarget;
+
+    /** 持てる物を検出する範囲（BPで追加されるため BeginPlay で取得） */
+    UPROPERTY()
+    UBoxComponent* InteractionBox = nullptr;
+
+    /** InteractionBox 内にあるActor（タグは後から付け外しされるため、"Holdable" かどうかは選ぶ時に確認する） */
+    TArray<TWeakObjectPtr<AActor>> GlowCandidates;
+
+    /** 最後に発光対象を選んだ時の位置 */
+    FVector LastGlowCheckLocation = FVector::ZeroVector;
+
+    /** 候補が変わり、発光対象を選び直す必要があるか */
+    bool bGlowCandidatesDirty = false;
+
+    /** 色変更時にマテリアル色を反映するスライムの流体コンポーネント */
+    TCachedComponent<USlimeFluidComponent> CachedSlimeFluid;
+
+    /** 入力の記録・再生 */
+    UPROPERTY()
+    UInputReplaySubsystem* InputReplay = nullptr;
 };
@@ -29,6 +29,11 @@ bool UPlayerStateComponent::OnExit(APawn*)
 	return false;
 }
 
+void UPlayerStateComponent::ResetState()
+{
+	MoveDelta = FVector::ZeroVector;
+}
+
 bool UPlayerStateComponent::OnSkill(const FInputActionValue&)
 {
 	return false;
@@ -52,6 +52,15 @@ public:
 	 */
 	virtual bool OnExit(APawn* Owner);
 
+	/**
+	 * 前回の遷移で残った状態を初期化する
+	 *
+	 * ステートは生成済みのものを再利用するため、OnEnter の直前に毎回呼ばれる。
+	 * 派生クラスで持つ一時的な状態（経過時間、対象から求めた値など）はここで戻す。
+	 * 遷移の予約後に SetUp 等で渡された値は OnEnter で使うため戻さず、OnExit で手放す。
+	 */
+	virtual void ResetState();
+
 	/**
 	 * スキル入力時の処理
 	 *
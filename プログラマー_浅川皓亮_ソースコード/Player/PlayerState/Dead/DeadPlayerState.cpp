@@ -4,7 +4,7 @@
 #include "Player/State/DeadPlayerState.h"
 #include "Player/PlayerCharacter.h"
 #include "Interface/StateControllable.h"
-#include "Manager/LevelManager.h"
+#include "Manager/GameServicesSubsystem.h"
 #include "Sound/SoundManager.h"
 #include "Kismet/GameplayStatics.h"
 
@@ -14,7 +14,7 @@
 // 3. プレイヤー入力を無効化
 // 4. カメラを暗転させる
 // 5. リスポーン状態と経過時間を初期化
-// 6. LevelManagerを取得
+// 6. SoundManagerを取得
 // 7. 死亡SEを再生
 bool UDeadPlayerState::OnEnter(APawn* Owner, UWorld* World)
 {
@@ -39,17 +39,26 @@ bool UDeadPlayerState::OnEnter(APawn* Owner, UWorld* World)
         ElapsedTime = 0.f;
     }
 
-    ALevelManager* LevelManager = ALevelManager::GetInstance(GetWorld());
-    if (LevelManager == nullptr)
+    const UGameServicesSubsystem* Services = UGameServicesSubsystem::Get(this);
+    USoundManager* Sound = Services ? Services->GetSoundManager() : nullptr;
+    if (Sound == nullptr)
         return false;
 
-    LevelManager->GetSoundManager()->PlaySound(TEXT("SE"), TEXT("Dead"));
+    Sound->PlaySound(TEXT("SE"), TEXT("Dead"));
 
     return true;
 }
 
 
 
+void UDeadPlayerState::ResetState()
+{
+    Super::ResetState();
+
+    ElapsedTime = 0.f;
+    bIsRespawn = false;
+}
+
 // 処理の流れ:
 // 1. Playerの有効性を確認
 // 2. 経過時間を加算
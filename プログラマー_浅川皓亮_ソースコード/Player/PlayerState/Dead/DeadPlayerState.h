@@ -40,6 +40,9 @@ public:
 	 */
 	virtual bool OnExit(APawn* Owner) override;
 
+	/** 経過時間とリスポーン状態を初期化する */
+	virtual void ResetState() override;
+
 private:
 	/** 死亡後の経過時間 */
 	float ElapsedTime = 0.f;
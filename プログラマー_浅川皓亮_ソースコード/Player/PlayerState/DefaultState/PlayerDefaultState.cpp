@@ -14,10 +14,10 @@
 #include "GameFramework/CharacterMovementComponent.h"
 #include "InputActionValue.h"
 #include "Interface/StateControllable.h"
-#include "Interface/Soundable.h"
 #include "Kismet/KismetMathLibrary.h"
 #include "Logic/Movement/PlayerMoveLogic.h"
-#include "Manager/LevelManager.h"
+#include "Manager/GameServicesSubsystem.h"
+#include "Sound/SoundManager.h"
 #include "UI/UIManager.h"
 #include "Objects/Color/LadderActor.h"
 
@@ -31,9 +31,10 @@ UPlayerDefaultState::UPlayerDefaultState()
 // 3. MoveComponentと移動ロジックを初期化
 // 4. 物理・当たり判定コンポーネントを取得
 // 5. プレイヤー用マテリアルを適用
-// 6. 着地モンタージュ終了イベントを登録
+// 6. 着地モンタージュ終了イベントを登録（再利用時に二重登録しない）
 // 7. 入力モードをゲーム専用に設定
 // 8. 移動関連パラメータを初期化
+// 9. 着地・ジャンプSEのハンドルを取得
 bool UPlayerDefaultState::OnEnter(APawn* Owner, UWorld* World)
 {
 	if (Owner == nullptr || World == nullptr)
@@ -74,11 +75,11 @@ bool UPlayerDefaultState::OnEnter(APawn* Owner, UWorld* World)
 	if (!Player)
 		return false;
 
-	if (USkeletalMeshComponent* MeshComp = Player->FindComponentByClass<USkeletalMeshComponent>())
+	if (USkeletalMeshComponent* MeshComp = CachedMesh.Get(Player))
 	{
 		if (UAnimInstance* AnimInstance = MeshComp->GetAnimInstance())
 		{
-			AnimInstance->OnMontageEnded.AddDynamic(
+			AnimInstance->OnMontageEnded.AddUniqueDynamic(
 				this, &UPlayerDefaultState::OnLandingMontageEnded);
 		}
 	}
@@ -94,6 +95,13 @@ bool UPlayerDefaultState::OnEnter(APawn* Owner, UWorld* World)
 	mMoveSpeed = 100.f;
 	CurrentDirection = mOwner->GetActorForwardVector();
 
+	const UGameServicesSubsystem* Services = UGameServicesSubsystem::Get(this);
+	if (const USoundManager* Sound = Services ? Services->GetSoundManager() : nullptr)
+	{
+		LandSound = Sound->FindSound("SE", "Land");
+		JumpSound = Sound->FindSound("SE", "Jump");
+	}
+
 	return true;
 }
 
@@ -112,11 +120,10 @@ bool UPlayerDefaultState::OnUpdate(float DeltaTime)
 
 	if (Physics->HasLanded() && !bIsPlayingLandingAnimation)
 	{
-		ISoundable* Sound =
-			ALevelManager::GetInstance(GetWorld())->GetSoundManager().GetInterface();
-		if (Sound)
+		const UGameServicesSubsystem* Services = UGameServicesSubsystem::Get(this);
+		if (USoundManager* Sound = Services ? Services->GetSoundManager() : nullptr)
 		{
-			Sound->PlaySound("SE", "Land");
+			Sound->PlaySoundByHandle(LandSound);
 		}
 
 		PlayLandingAnimation();
@@ -141,8 +148,7 @@ bool UPlayerDefaultState::OnExit(APawn* Owner)
 		APlayerCharacter* Player = Cast<APlayerCharacter>(mOwner);
 		if (Player)
 		{
-			if (USkeletalMeshComponent* MeshComp =
-				Player->FindComponentByClass<USkeletalMeshComponent>())
+			if (USkeletalMeshComponent* MeshComp = CachedMesh.Get(Player))
 			{
 				if (UAnimInstance* AnimInstance = MeshComp->GetAnimInstance())
 				{
@@ -162,6 +168,14 @@ bool UPlayerDefaultState::OnExit(APawn* Owner)
 	return true;
 }
 
+void UPlayerDefaultState::ResetState()
+{
+	Super::ResetState();
+
+	bIsPlayingLandingAnimation = false;
+	bLandingAnimationJustEnded = false;
+}
+
 // 処理の流れ:
 // 1. 入力が有効か確認
 // 2. 着地アニメーション中は無効
@@ -256,11 +270,10 @@ bool UPlayerDefaultState::Jump(float jumpForce)
 
 	Physics->AddForce(GetOwner()->GetActorUpVector(), jumpForce);
 
-	ISoundable* Sound =
-		ALevelManager::GetInstance(GetWorld())->GetSoundManager().GetInterface();
-	if (Sound)
+	const UGameServicesSubsystem* Services = UGameServicesSubsystem::Get(this);
+	if (USoundManager* Sound = Services ? Services->GetSoundManager() : nullptr)
 	{
-		Sound->PlaySound("SE", "Jump");
+		Sound->PlaySoundByHandle(JumpSound);
 	}
 
 	return true;
@@ -349,8 +362,7 @@ void UPlayerDefaultState::PlayLandingAnimation()
 	if (!Player)
 		return;
 
-	USkeletalMeshComponent* MeshComp =
-		Player->FindComponentByClass<USkeletalMeshComponent>();
+	USkeletalMeshComponent* MeshComp = CachedMesh.Get(Player);
 	if (!MeshComp)
 		return;
 
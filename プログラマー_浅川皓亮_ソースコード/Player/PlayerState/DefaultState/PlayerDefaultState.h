@@ -4,9 +4,12 @@
 
 #include "CoreMinimal.h"
 #include "Components/Player/PlayerStateComponent.h"
+#include "Components/ComponentCache.h"
+#include "Sound/SoundHandle.h"
 #include "PlayerDefaultState.generated.h"
 class UMoveComponent;
 class UBoxComponent;
+class USkeletalMeshComponent;
 
 
 /**
@@ -44,6 +47,9 @@ public:
 	 */
 	virtual bool OnExit(APawn* Owner) override;
 
+	/** 着地アニメーションのフラグを初期化する */
+	virtual void ResetState() override;
+
 	/**
 	 * スキル入力時の処理
 	 * @param Value 入力値
@@ -148,5 +154,12 @@ private:
 	/** 着地アニメーションが終了した瞬間のフラグ */
 	bool bLandingAnimationJustEnded = false;
 
+	/** モンタージュ再生用のプレイヤーのメッシュ */
+	TCachedComponent<USkeletalMeshComponent> CachedMesh;
+
+	/** 着地・ジャンプSE（OnEnterで取得） */
+	FSoundHandle LandSound;
+	FSoundHandle JumpSound;
+
 
 };
@@ -2,7 +2,7 @@
 
 
 #include "Player/State/PlayerHoldState.h"
-#include "Manager/LevelManager.h"
+#include "Manager/GameServicesSubsystem.h"
 #include "Sound/SoundManager.h"
 #include "InputActionValue.h"
 #include "Interface/StateControllable.h"
@@ -17,8 +17,10 @@ UPlayerHoldState::UPlayerHoldState()
 
 // 処理の流れ:
 // 1. Ownerを内部に保持
-// 2. MoveComponentが未生成なら生成
-// 3. 移動ロジックを初期化
+// 2. SetUp で渡された掴み対象から、掴み開始時の距離と色コンポーネントを取得
+// 3. MoveComponentが未生成なら生成
+// 4. 移動ロジックを初期化
+// 5. 置くSEのハンドルを取得
 bool UPlayerHoldState::OnEnter(APawn* Owner, UWorld* World)
 {
 	if (Owner == nullptr)
@@ -26,6 +28,15 @@ bool UPlayerHoldState::OnEnter(APawn* Owner, UWorld* World)
 
 	mOwner = Owner;
 
+	if (HoldTarget)
+	{
+		InitialHoldDistance =
+			FVector::Dist(mOwner->GetActorLocation(), HoldTarget->GetActorLocation());
+
+		TargetComp =
+			HoldTarget->GetComponentByClass<UColorReactiveComponent>();
+	}
+
 	if (!MoveComp)
 	{
 		MoveComp = NewObject<UMoveComponent>(mOwner);
@@ -33,6 +44,12 @@ bool UPlayerHoldState::OnEnter(APawn* Owner, UWorld* World)
 		MoveComp->Init(PlayerLogic);
 	}
 
+	const UGameServicesSubsystem* Services = UGameServicesSubsystem::Get(this);
+	if (const USoundManager* Sound = Services ? Services->GetSoundManager() : nullptr)
+	{
+		PutSound = Sound->FindSound("SE", "Put");
+	}
+
 	return true;
 }
 
@@ -81,13 +98,23 @@ bool UPlayerHoldState::OnExit(APawn* Owner)
 	HoldTarget = nullptr;
 	TargetComp = nullptr;
 
-	ALevelManager::GetInstance(GetWorld())
-		->GetSoundManager()
-		->PlaySound("SE", "Put");
+	const UGameServicesSubsystem* Services = UGameServicesSubsystem::Get(this);
+	if (USoundManager* Sound = Services ? Services->GetSoundManager() : nullptr)
+	{
+		Sound->PlaySoundByHandle(PutSound);
+	}
 
 	return true;
 }
 
+void UPlayerHoldState::ResetState()
+{
+	Super::ResetState();
+
+	TargetComp = nullptr;
+	InitialHoldDistance = 0.f;
+}
+
 // 処理の流れ:
 // 1. 入力が押されたかを確認
 // 2. 押されたら掴み解除
@@ -143,22 +170,10 @@ void UPlayerHoldState::Movement(const FInputActionValue& Value)
 }
 
 // 処理の流れ:
-// 1. 掴み対象を保持
-// 2. 掴み開始時の距離を保存
-// 3. 色反応コンポーネントを取得
-// 4. 掴んだ向きを固定値として保存
+// 1. 掴み対象を保持（距離と色反応コンポーネントは OnEnter で取得）
+// 2. 掴んだ向きを固定値として保存
 void UPlayerHoldState::SetUp(AActor* Target, bool bGrabDirection)
 {
 	HoldTarget = Target;
-
-	if (HoldTarget && mOwner)
-	{
-		InitialHoldDistance =
-			FVector::Dist(mOwner->GetActorLocation(), HoldTarget->GetActorLocation());
-
-		TargetComp =
-			HoldTarget->GetComponentByClass<UColorReactiveComponent>();
-	}
-
 	GrabDirection = bGrabDirection ? 1 : -1;
 }
@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "Components/Player/PlayerStateComponent.h"
+#include "Sound/SoundHandle.h"
 #include "PlayerHoldState.generated.h"
 
 class UMoveComponent;
@@ -51,6 +52,9 @@ private:
 	 */
 	virtual bool OnExit(APawn* Owner) override;
 
+	/** 前回の掴み開始時の距離と色コンポーネントを初期化する（掴み対象は SetUp の値を残す） */
+	virtual void ResetState() override;
+
 	/**
 	 * スキル入力時の処理（掴み解除）
 	 * @param Value 入力値
@@ -83,4 +87,7 @@ private:
 
 	/** 掴んだ向き（1 or -1） */
 	int32 GrabDirection = 1;
+
+	/** 置くSE（OnEnterで取得） */
+	FSoundHandle PutSound;
 };
\ No newline at end of file
@@ -34,10 +34,8 @@ FVector GetLadderCenterXZ(const AActor* Ladder)
 
 // 処理の流れ:
 // 1. 引数の梯子の有効性を確認
-// 2. 昇降対象の梯子をメンバに保持
-// 3. 梯子に対する固定位置を取得
-// 4. 梯子のColorConfiguratorを取得
-// 5. プレイヤー位置を梯子位置へ補正
+// 2. 昇降対象の梯子をメンバに保持（ColorConfiguratorは OnEnter で取得）
+// 3. プレイヤー位置を梯子に対する固定位置へ補正
 void ULadderClimberState::SetTargetLadder(ALadderActor* LadderActor)
 {
 	if (LadderActor == nullptr)
@@ -45,24 +43,17 @@ void ULadderClimberState::SetTargetLadder(ALadderActor* LadderActor)
 
 	Ladder = LadderActor;
 
-	FixedPosition = Ladder->GetFixedPositionForActor(GetOwner());
-
-	UColorConfigurator* Comp = Ladder->GetComponentByClass<UColorConfigurator>();
-	if (Comp != nullptr)
-	{
-		TargetComp = Comp;
-	}
-
-	GetOwner()->SetActorLocation(FixedPosition);
+	GetOwner()->SetActorLocation(Ladder->GetFixedPositionForActor(GetOwner()));
 }
 
 // 処理の流れ:
 // 1. OwnerとWorldを保持
-// 2. MoveComponentと梯子移動ロジックを初期化
-// 3. 物理挙動を停止
-// 4. キャラクターの速度をリセット
-// 5. 重力を無効化しフライングモードに変更
-// 6. コリジョンを無効化
+// 2. 梯子の固定位置と色コンポーネントを取得
+// 3. MoveComponentと梯子移動ロジックを初期化
+// 4. 物理挙動を停止
+// 5. キャラクターの速度をリセット
+// 6. 重力を無効化しフライングモードに変更
+// 7. コリジョンを無効化
 bool ULadderClimberState::OnEnter(APawn* Owner, UWorld* World)
 {
 	if (!Owner)
@@ -74,6 +65,12 @@ bool ULadderClimberState::OnEnter(APawn* Owner, UWorld* World)
 	if (!pWorld)
 		pWorld = World;
 
+	if (Ladder)
+	{
+		FixedPosition = Ladder->GetFixedPositionForActor(GetOwner());
+		TargetComp = Ladder->GetComponentByClass<UColorConfigurator>();
+	}
+
 	if (!MoveComp)
 	{
 		MoveComp = NewObject<UMoveComponent>(mOwner);
@@ -175,7 +172,7 @@ bool ULadderClimberState::OnUpdate(float DeltaTime)
 
 		if (!bFoundNewLadder)
 		{
-			if (UStateManager* StateManager = mOwner->FindComponentByClass<UStateManager>())
+			if (UStateManager* StateManager = CachedStateManager.Get(mOwner))
 			{
 				if (PlayerZ > LadderTopZ)
 				{
@@ -209,11 +206,15 @@ bool ULadderClimberState::OnUpdate(float DeltaTime)
 }
 
 // 処理の流れ:
-// 1. Ownerの有効性を確認
-// 2. キャラクターの重力と移動モードを元に戻す
-// 3. コリジョンを有効化
+// 1. 梯子の参照を手放す
+// 2. Ownerの有効性を確認
+// 3. キャラクターの重力と移動モードを元に戻す
+// 4. コリジョンを有効化
 bool ULadderClimberState::OnExit(APawn* Owner)
 {
+	Ladder = nullptr;
+	TargetComp = nullptr;
+
 	if (!Owner)
 		return false;
 
@@ -240,6 +241,14 @@ bool ULadderClimberState::OnExit(APawn* Owner)
 	return true;
 }
 
+void ULadderClimberState::ResetState()
+{
+	Super::ResetState();
+
+	TargetComp = nullptr;
+	FixedPosition = FVector::ZeroVector;
+}
+
 // 処理の流れ:
 // 1. OwnerをStateControllableとして取得
 // 2. 通常ステートへ遷移
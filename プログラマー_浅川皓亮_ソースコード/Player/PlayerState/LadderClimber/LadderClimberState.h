@@ -4,11 +4,13 @@
 
 #include "CoreMinimal.h"
 #include "Components/Player/PlayerStateComponent.h"
+#include "Components/ComponentCache.h"
 #include "LadderClimberState.generated.h"
 
 class ALadderActor;
 class UMoveComponent;
 class UColorConfigurator;
+class UStateManager;
 
 /**
  * 梯子昇降中のプレイヤーステート
@@ -55,6 +57,9 @@ private:
 	 */
 	virtual bool OnExit(APawn* Owner) override;
 
+	/** 前回の固定位置と色コンポーネントを初期化する（梯子は SetTargetLadder の値を残す） */
+	virtual void ResetState() override;
+
 	/**
 	 * スキル入力時の処理
 	 * @param Input 入力値
@@ -77,4 +82,7 @@ private:
 
 	/** 梯子に対して固定される位置 */
 	FVector FixedPosition;
+
+	/** 梯子を登り切った時のステート変更に使うステートマネージャー */
+	TCachedComponent<UStateManager> CachedStateManager;
 };
@@ -2,6 +2,29 @@
 #include "Player/State/PlayerDefaultState.h"
 #include "Components/Player/PlayerStateComponent.h"
 
+// 遷移ごとにステートを生成していないかの確認用（生成数はステートの種類数から増えない）
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Player State Objects Created"), STAT_PlayerStateObjectsCreated, STATGROUP_Game);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Player State Transitions"), STAT_PlayerStateTransitions, STATGROUP_Game);
+
+namespace
+{
+	static constexpr int32 STATE_COUNT = static_cast<int32>(EPlayerStateType::Dead) + 1;
+
+	// 遷移表 [遷移元][遷移先]（並びは EPlayerStateType と同じ）
+	static constexpr bool TRANSITION_TABLE[STATE_COUNT][STATE_COUNT] =
+	{
+		//                Default Hold   Climb  Dead
+		/* Default */   { false,  true,  true,  true  },
+		/* Hold    */   { true,   false, false, true  },
+		/* Climb   */   { true,   false, false, true  },
+		/* Dead    */   { true,   false, false, false },
+	};
+	static_assert(UE_ARRAY_COUNT(TRANSITION_TABLE) == STATE_COUNT, "遷移表をEPlayerStateTypeに合わせること");
+
+	// 1回の適用で処理する遷移の上限（OnEnter/OnExit内の要求が循環した場合の保険）
+	static constexpr int32 MAX_TRANSITIONS_PER_UPDATE = 8;
+}
+
 // 処理の流れ:
 // 1. コンポーネントが毎フレームTick可能になるよう設定
 UStateManager::UStateManager()
@@ -12,7 +35,8 @@ UStateManager::UStateManager()
 // 処理の流れ:
 // 1. OwnerとWorldの有効性を確認
 // 2. 内部メンバにOwnerとWorldを保持
-// 3. 初期ステートとしてDefaultステートに遷移
+// 3. 全ステートを生成（生成済みなら再利用）
+// 4. 初期ステートとしてDefaultステートに遷移
 void UStateManager::Init(APawn* Owner, UWorld* World)
 {
 	if (!Owner || !World)
@@ -21,68 +45,114 @@ void UStateManager::Init(APawn* Owner, UWorld* World)
 	mOwner = Owner;
 	pWorld = World;
 
+	for (const TPair<EPlayerStateType, TSubclassOf<UPlayerStateComponent>>& Pair : StateClassMap)
+	{
+		if (Pair.Value == nullptr || States.Contains(Pair.Key))
+			continue;
+
+		if (UPlayerStateComponent* State = NewObject<UPlayerStateComponent>(mOwner, Pair.Value))
+		{
+			States.Add(Pair.Key, State);
+			INC_DWORD_STAT(STAT_PlayerStateObjectsCreated);
+		}
+	}
+
+	// 初期ステートは要求と同時に適用し、Init直後から現在のステートを参照できるようにする
 	ChangeState(EPlayerStateType::Default);
+	ApplyPendingStates();
 }
 
 // 処理の流れ:
-// 1. 現在のステートが存在するか確認
-// 2. 存在する場合、ステートのOnUpdateを呼び出す
+// 1. 予約されている遷移を適用（遷移はここでのみ行う）
+// 2. 現在のステートのOnUpdateを呼び出す（中で要求した遷移は次のUpdateで適用）
 void UStateManager::Update(float DeltaTime)
 {
+	ApplyPendingStates();
+
 	if (CurrentState != nullptr)
 	{
 		CurrentState->OnUpdate(DeltaTime);
 	}
 }
 
+bool UStateManager::CanTransition(EPlayerStateType From, EPlayerStateType To)
+{
+	const int32 FromIndex = static_cast<int32>(From);
+	const int32 ToIndex = static_cast<int32>(To);
+	if (FromIndex >= STATE_COUNT || ToIndex >= STATE_COUNT)
+		return false;
+
+	return TRANSITION_TABLE[FromIndex][ToIndex];
+}
+
 // 処理の流れ:
-// 1. ステートマップ・Owner・Worldの有効性を確認
-// 2. 遷移先ステートクラスを取得
-// 3. 現在のステートが存在する場合、OnExitを呼び出し破棄
-// 4. 新しいステートを生成
-// 5. 新しいステートのOnEnterを実行
-// 6. 生成したステートを返却
+// 1. Owner・Worldと遷移先ステートの有効性を確認
+// 2. 予約済みの遷移を含めた遷移元を求め、同じステートなら何もしない
+// 3. 遷移表で許可されていない遷移は拒否
+// 4. 遷移を予約（リセットは実際に切り替える時に行う）
+// 5. 遷移先ステートを返却（呼び出し側は OnEnter の前に SetUp 等を行える）
 UPlayerStateComponent* UStateManager::ChangeState(EPlayerStateType NextStateTag)
 {
-	if (StateClassMap.IsEmpty() ||
-		!StateClassMap.Contains(NextStateTag) ||
-		!mOwner ||
-		!pWorld)
-	{
+	if (!mOwner || !pWorld)
 		return nullptr;
-	}
 
-	TSubclassOf<UPlayerStateComponent> StateClass =
-		StateClassMap[NextStateTag];
+	UPlayerStateComponent* NextState = States.FindRef(NextStateTag);
+	if (!NextState)
+		return nullptr;
 
-	if (CurrentState)
+	const bool bHasState = CurrentState != nullptr || PendingStates.Num() > 0;
+	const EPlayerStateType FromStateType = PendingStates.Num() > 0 ? PendingStates.Last() : CurrentStateType;
+
+	if (bHasState)
 	{
-		CurrentState->OnExit(mOwner);
-		CurrentState->ConditionalBeginDestroy();
-		CurrentState = nullptr;
-	}
+		if (FromStateType == NextStateTag)
+			return NextState;
 
-	CurrentState = NewObject<UPlayerStateComponent>(mOwner, StateClass);
-	if (!CurrentState)
-		return nullptr;
+		if (!CanTransition(FromStateType, NextStateTag))
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Rejected player state transition %d -> %d."),
+				static_cast<int32>(FromStateType), static_cast<int32>(NextStateTag));
+			return nullptr;
+		}
+	}
 
-	CurrentState->OnEnter(mOwner, pWorld);
-	return CurrentState;
+	PendingStates.Add(NextStateTag);
+	return NextState;
 }
 
 // 処理の流れ:
-// 1. 指定されたステート種別に対応するクラスを取得
-// 2. 現在のステートと取得したクラスの有効性を確認
-// 3. 現在のステートが指定クラスかを判定して返却
-bool UStateManager::IsStateMatch(EPlayerStateType StateTag)
+// 1. 予約順に遷移を取り出す
+// 2. 現在のステートのOnExitを呼び出す（破棄はしない）
+// 3. 遷移先ステートを前回の状態からリセットし、切り替えてOnEnterを実行
+void UStateManager::ApplyPendingStates()
 {
-	TSubclassOf<UPlayerStateComponent> StateClass =
-		StateClassMap.FindRef(StateTag);
-
-	if (StateClass == nullptr || CurrentState == nullptr)
+	int32 AppliedCount = 0;
+	while (PendingStates.Num() > 0 && AppliedCount < MAX_TRANSITIONS_PER_UPDATE)
 	{
-		return false;
+		const EPlayerStateType NextStateTag = PendingStates[0];
+		PendingStates.RemoveAt(0);
+
+		UPlayerStateComponent* NextState = States.FindRef(NextStateTag);
+		if (!NextState)
+			continue;
+
+		if (CurrentState)
+		{
+			CurrentState->OnExit(mOwner);
+		}
+
+		CurrentState = NextState;
+		CurrentStateType = NextStateTag;
+		INC_DWORD_STAT(STAT_PlayerStateTransitions);
+
+		CurrentState->ResetState();
+		CurrentState->OnEnter(mOwner, pWorld);
+		++AppliedCount;
 	}
+}
 
-	return CurrentState->IsA(StateClass);
+// 現在のステート種別との整数比較のみで判定する
+bool UStateManager::IsStateMatch(EPlayerStateType StateTag)
+{
+	return CurrentState != nullptr && CurrentStateType == StateTag;
 }
@@ -39,6 +39,7 @@ public:
 
 	/**
 	 * ステートマネージャの初期化処理
+	 * 全ステートをここで一度だけ生成し、以降の遷移では生成・破棄を行わない
 	 * @param Owner ステートを管理するPawn
 	 * @param World 現在のワールド
 	 */
@@ -51,12 +52,22 @@ public:
 	void Update(float DeltaTime);
 
 	/**
-	 * ステートを切り替える
+	 * ステートの切り替えを予約する
+	 * 遷移表で許可された遷移のみ受け付け、実際の切り替えは次の Update の先頭で行う
+	 * 戻り値に対して SetUp 等を行ってよい（渡した値は切り替え時のリセットでは消えない）
 	 * @param NextStateTag 遷移先ステートの種別
-	 * @return 新しく生成されたステート
+	 * @return 遷移先のステート（拒否された場合は nullptr）
 	 */
 	UPlayerStateComponent* ChangeState(EPlayerStateType NextStateTag);
 
+	/**
+	 * 遷移表で許可されている遷移かを判定
+	 * @param From 遷移元ステートの種別
+	 * @param To 遷移先ステートの種別
+	 * @return 許可されている場合true
+	 */
+	static bool CanTransition(EPlayerStateType From, EPlayerStateType To);
+
 	/**
 	 * 現在のステートが指定したステートかを判定
 	 * @param StateTag 判定対象のステート種別
@@ -75,11 +86,28 @@ public:
 		return CurrentState;
 	}
 
+	/**
+	 * 現在アクティブなステートの種別を取得
+	 * @return 現在のステート種別
+	 */
+	inline EPlayerStateType GetCurrentStateType() const
+	{
+		return CurrentStateType;
+	}
+
+private:
+	/** 予約されている遷移を順に適用する */
+	void ApplyPendingStates();
+
 private:
 	/** ステート種別とステートクラスの対応マップ */
 	UPROPERTY(EditAnywhere)
 	TMap<EPlayerStateType, TSubclassOf<UPlayerStateComponent>> StateClassMap;
 
+	/** 生成済みのステート（Initで一度だけ生成し、遷移ではポインタを切り替える） */
+	UPROPERTY(Transient)
+	TMap<EPlayerStateType, TObjectPtr<UPlayerStateComponent>> States;
+
 	/** ステートの所有者となるPawn */
 	UPROPERTY()
 	APawn* mOwner = nullptr;
@@ -88,6 +116,12 @@ private:
 	UPROPERTY()
 	UPlayerStateComponent* CurrentState = nullptr;
 
+	/** 現在アクティブなステートの種別 */
+	EPlayerStateType CurrentStateType = EPlayerStateType::Default;
+
+	/** 適用待ちの遷移（要求順） */
+	TArray<EPlayerStateType, TInlineAllocator<4>> PendingStates;
+
 	/** ワールド参照 */
 	UPROPERTY()
 	UWorld* pWorld = nullptr;
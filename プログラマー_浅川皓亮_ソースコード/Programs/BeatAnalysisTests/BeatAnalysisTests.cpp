@@ -0,0 +1,163 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+// オフラインのビート解析（Logic/Sound/BeatAnalysis）のテンポ推定を合成したクリック音で確認し、
+// ビートマップを使ったビート時計（Logic/Sound/BeatClock）のループを確認するプログラム
+// ゲームモジュールには含めず、ベンチマークと同様に単体のプログラムとしてビルドする
+//
+//   g++ -O2 -std=c++17 -I<インクルードルート> BeatAnalysisTests.cpp BeatAnalysis.cpp BeatClock.cpp
+//   ./a.out
+//
+// 失敗した確認を全て表示し、1つでも失敗すれば終了コード 1 を返す
+
+#include "Logic/Sound/BeatAnalysis.h"
+#include "Logic/Sound/BeatClock.h"
+
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+using namespace Beat;
+
+namespace
+{
+	static constexpr double PI = 3.14159265358979323846;
+
+	static constexpr int32_t SAMPLE_RATE = 44100;
+
+	// 合成する音声の長さ（秒）
+	static constexpr double CLIP_SECONDS = 30.0;
+
+	// クリック音の周波数と、減衰して消えるまでの長さ（秒）
+	static constexpr double CLICK_FREQUENCY = 80.0;
+	static constexpr double CLICK_SECONDS = 0.05;
+
+	// テンポの許容誤差（割合）
+	static constexpr float BPM_TOLERANCE = 0.02f;
+
+	int32_t NumChecks = 0;
+	int32_t NumFailures = 0;
+
+	// NDEBUG でも無効にならないよう assert の代わりに使う
+	#define BEAT_CHECK(Condition) Check((Condition), #Condition, __FILE__, __LINE__)
+
+	void Check(bool bPassed, const char* Expression, const char* File, int Line)
+	{
+		++NumChecks;
+		if (!bPassed)
+		{
+			++NumFailures;
+			std::fprintf(stderr, "%s:%d: check failed: %s\n", File, Line, Expression);
+		}
+	}
+
+	// 1つのクリックを書き込む
+	void AddClick(FMonoAudio& Audio, double Time, double Gain)
+	{
+		const size_t Start = static_cast<size_t>(Time * SAMPLE_RATE);
+		const size_t ClickLength = static_cast<size_t>(CLICK_SECONDS * SAMPLE_RATE);
+		for (size_t i = 0; i < ClickLength && Start + i < Audio.Samples.size(); ++i)
+		{
+			const double Seconds = static_cast<double>(i) / SAMPLE_RATE;
+			const double Decay = std::exp(-Seconds / (CLICK_SECONDS * 0.25));
+			Audio.Samples[Start + i] += static_cast<float>(Gain * Decay * std::sin(2.0 * PI * CLICK_FREQUENCY * Seconds));
+		}
+	}
+
+	// 一定のテンポで鳴る、減衰する低音のクリック（OffbeatGain が0でなければ裏拍にも鳴らす）
+	FMonoAudio MakeClickTrack(float BPM, double OffbeatGain = 0.0)
+	{
+		FMonoAudio Audio;
+		Audio.SampleRate = SAMPLE_RATE;
+		Audio.Samples.assign(static_cast<size_t>(CLIP_SECONDS * SAMPLE_RATE), 0.0f);
+
+		const double Period = 60.0 / BPM;
+		for (double Time = 0.25; Time < CLIP_SECONDS; Time += Period)
+		{
+			AddClick(Audio, Time, 0.8);
+			if (OffbeatGain > 0.0)
+			{
+				AddClick(Audio, Time + Period * 0.5, 0.8 * OffbeatGain);
+			}
+		}
+		return Audio;
+	}
+
+	// 倍・半分のテンポと取り違えず、許容誤差内で推定できる
+	void TestTempo(float BPM, double OffbeatGain = 0.0)
+	{
+		const FBeatAnalysisResult Result = AnalyzeBeats(MakeClickTrack(BPM, OffbeatGain));
+		const bool bMatched = std::fabs(Result.BPM - BPM) <= BPM * BPM_TOLERANCE;
+		if (!bMatched)
+		{
+			std::fprintf(stderr, "  expected %.1f BPM, estimated %.2f BPM\n", BPM, Result.BPM);
+		}
+		BEAT_CHECK(bMatched);
+
+		// 拍の数もテンポに合っている（最初と最後の1拍は取りこぼしてもよい）
+		const double ExpectedBeats = (CLIP_SECONDS - 0.25) * BPM / 60.0;
+		BEAT_CHECK(std::fabs(static_cast<double>(Result.BeatTimes.size()) - ExpectedBeats) <= 2.0);
+	}
+
+	// 最後の拍から曲の終わりまでが1拍より長い曲をループしても、無音の間に拍が増えず、拍の位置が戻らない
+	void TestBeatClockLoopTail()
+	{
+		static constexpr double BEAT_INTERVAL = 0.5;
+		static constexpr int32_t NUM_BEATS = 20;
+		static constexpr double LOOP_DURATION = 12.0;
+		static constexpr double START_TIME = 100.0;
+		static constexpr double SAMPLE_STEP = 0.01;
+
+		std::vector<float> Times;
+		for (int32_t i = 0; i < NUM_BEATS; ++i)
+		{
+			Times.push_back(static_cast<float>(i * BEAT_INTERVAL));
+		}
+
+		FBeatClock Clock;
+		Clock.SetBeatTable(Times.data(), NUM_BEATS, LOOP_DURATION);
+		Clock.Start(START_TIME, 120.0f);
+
+		bool bMonotonic = true;
+		bool bTailSilent = true;
+		double PrevPosition = Clock.GetBeatPosition(START_TIME);
+		for (double Elapsed = SAMPLE_STEP; Elapsed < LOOP_DURATION * 3.0; Elapsed += SAMPLE_STEP)
+		{
+			const double Position = Clock.GetBeatPosition(START_TIME + Elapsed);
+			bMonotonic &= Position >= PrevPosition;
+			PrevPosition = Position;
+
+			// 最後の拍から次の周回の最初の拍までは、最後の拍のまま
+			const double Local = Elapsed - LOOP_DURATION * static_cast<int32_t>(Elapsed / LOOP_DURATION);
+			const int64_t Loop = static_cast<int64_t>(Elapsed / LOOP_DURATION);
+			if (Local > Times.back() + SAMPLE_STEP && Local < LOOP_DURATION - SAMPLE_STEP)
+			{
+				bTailSilent &= Clock.GetBeatIndex(START_TIME + Elapsed) == Loop * NUM_BEATS + NUM_BEATS - 1;
+			}
+		}
+		BEAT_CHECK(bMonotonic);
+		BEAT_CHECK(bTailSilent);
+
+		// 次の周回の最初の拍で、拍の番号がちょうど1つ進む
+		BEAT_CHECK(Clock.GetBeatIndex(START_TIME + LOOP_DURATION - SAMPLE_STEP) == NUM_BEATS - 1);
+		BEAT_CHECK(Clock.GetBeatIndex(START_TIME + LOOP_DURATION + SAMPLE_STEP) == NUM_BEATS);
+		BEAT_CHECK(std::fabs(Clock.GetNextBeatTime(START_TIME + 10.0) - (START_TIME + LOOP_DURATION)) < 1e-6);
+	}
+}
+
+int main()
+{
+	// 優先テンポ（120）付近と、そこから離れて倍・半分と取り違えやすいテンポ
+	static const float Tempos[] = { 75.0f, 90.0f, 120.0f, 128.0f, 150.0f, 170.0f };
+	for (const float BPM : Tempos)
+	{
+		TestTempo(BPM);
+	}
+
+	// 弱い裏拍があっても倍のテンポにしない
+	TestTempo(100.0f, 0.3);
+
+	TestBeatClockLoopTail();
+
+	std::printf("checks=%d failures=%d\n", NumChecks, NumFailures);
+	return NumFailures == 0 ? 0 : 1;
+}
@@ -0,0 +1,569 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+// 色判定の計算部（Logic/ColorManager/ColorKernels）などをエディタ無しで計測するマイクロベンチマーク
+// ゲームモジュールには含めず、単体のプログラムとしてビルドする
+//
+//   g++ -O2 -std=c++17 -I<インクルードルート> ColorKernelBenchmark.cpp ColorKernels.cpp SaveFormat.cpp
+//   ./a.out [出力JSON=標準出力] [名前の絞り込み]
+//
+// 各処理を small / medium / large の3サイズで計測し、Google Benchmark に近い形式の JSON を出力する
+// checksum は最後の1回分の結果から計算するため、処理時間と合わせて挙動が変わっていないかも比較できる
+// SaveLoadJson / SaveLoadBinary は起動時のセーブ読み込みを JSON とバイナリ（Logic/Save/SaveFormat）で比べる
+// 注意: このプログラムはエンジン無しでビルドするため、実際の JSON（FJsonSerializer）の基準値は無い
+// SaveLoadJson は FJsonObject 相当の木を作る手書きの簡易パーサーで、FJsonSerializer の速さを表すものではない
+// JSON からの移行でどれだけ速くなったかは、このプログラムの数値からは言えない（エンジン上で FSaveStore の読み込みを計測して確かめる）
+// （同じデータを読むため checksum は一致する。SaveSerialize* の checksum はファイルのバイト数）
+
+#include "Logic/ColorManager/ColorKernels.h"
+#include "Logic/Save/SaveFormat.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace ColorKernels;
+using SaveFormat::FStageRecord;
+
+namespace
+{
+	// 入力サイズ（要素数）
+	static constexpr int32_t SIZE_SMALL = 64;
+	static constexpr int32_t SIZE_MEDIUM = 4096;
+	static constexpr int32_t SIZE_LARGE = 262144;
+
+	// 1つの計測に最低限かける時間（秒）と、反復回数の上限
+	static constexpr double MIN_TIME_SECONDS = 0.2;
+	static constexpr int64_t MAX_ITERATIONS = 1LL << 30;
+
+	// IsColorMatch の許容誤差（UColorReactiveComponent の既定値）
+	static constexpr float MATCH_TOLERANCE = 0.08f;
+
+	// 計測結果
+	struct FBenchmarkResult
+	{
+		std::string Name;
+		int32_t Size = 0;
+		int64_t Iterations = 0;
+		double NsPerIteration = 0.0;
+		double ItemsPerSecond = 0.0;
+		double Checksum = 0.0;
+	};
+
+	// 最適化で計算が消えないように結果を書き込む先
+	volatile double Sink = 0.0;
+
+	// 再現性のある入力色を作る（線形合同法）
+	std::vector<FRgb> MakeColors(int32_t Count, uint32_t Seed)
+	{
+		std::vector<FRgb> Colors;
+		Colors.reserve(Count);
+
+		uint32_t State = Seed;
+		auto Next = [&State]()
+			{
+				State = State * 1664525u + 1013904223u;
+				return static_cast<float>(State >> 8) / static_cast<float>(1u << 24);
+			};
+
+		for (int32_t i = 0; i < Count; ++i)
+		{
+			const float R = Next();
+			const float G = Next();
+			const float B = Next();
+			Colors.emplace_back(R, G, B);
+		}
+		return Colors;
+	}
+
+	// UEffectColorMatcher と同じ基準色
+	std::vector<FEffectReference> MakeEffectReferences()
+	{
+		return {
+			MakeEffectReference(FRgb(0.65f, 1.00f, 0.78f)),
+			MakeEffectReference(FRgb(0.65f, 0.78f, 1.00f)),
+			MakeEffectReference(FRgb(1.00f, 0.75f, 0.65f)),
+			MakeEffectReference(FRgb(1.00f, 1.00f, 0.65f)),
+			MakeEffectReference(FRgb(0.0f, 0.0f, 0.0f)),
+		};
+	}
+
+	// =======================
+	// 通知先のモック
+	// =======================
+
+	// IColorReactiveInterface::ColorAction 相当
+	class FMockColorTarget
+	{
+	public:
+		virtual ~FMockColorTarget() = default;
+		virtual void ColorAction(const FRgb& Color, const FEffectMatch& Effect) = 0;
+		virtual double GetState() const = 0;
+	};
+
+	// 色の一致で点灯を切り替えるギミック
+	class FMockSwitchTarget : public FMockColorTarget
+	{
+	public:
+		explicit FMockSwitchTarget(const FRgb& InColor) : Color(InColor) {}
+
+		virtual void ColorAction(const FRgb& InColor, const FEffectMatch& /*Effect*/) override
+		{
+			bActive = IsColorMatch(InColor, Color, MATCH_TOLERANCE) || IsColorMatch(ComplementaryColor(InColor), Color, MATCH_TOLERANCE);
+		}
+
+		virtual double GetState() const override { return bActive ? 1.0 : 0.0; }
+
+	private:
+		FRgb Color;
+		bool bActive = false;
+	};
+
+	// エフェクトの強さで速度を変えるギミック
+	class FMockConveyorTarget : public FMockColorTarget
+	{
+	public:
+		virtual void ColorAction(const FRgb& /*InColor*/, const FEffectMatch& Effect) override
+		{
+			Speed = Effect.StrengthRatio * (Effect.Index + 1);
+		}
+
+		virtual double GetState() const override { return Speed; }
+
+	private:
+		float Speed = 0.0f;
+	};
+
+	// UColorTargetRegistry::NotifyTargets と同じ走査（無効なターゲットは飛ばす）
+	void NotifyTargets(const std::vector<FMockColorTarget*>& Instances, const FRgb& Color, const FEffectMatch& Effect)
+	{
+		for (FMockColorTarget* Target : Instances)
+		{
+			if (Target)
+			{
+				Target->ColorAction(Color, Effect);
+			}
+		}
+	}
+
+	// =======================
+	// セーブデータのモック
+	// =======================
+
+	// FStageSaveData::ToJson と同じ構造の JSON を書き出す
+	void SerializeStageSave(const std::vector<FStageRecord>& Stages, std::string& Out)
+	{
+		Out.clear();
+		Out += "{\"Stages\":{";
+		for (size_t i = 0; i < Stages.size(); ++i)
+		{
+			if (i > 0)
+			{
+				Out += ',';
+			}
+			Out += '"';
+			Out += Stages[i].Key;
+			Out += "\":{\"bCleared\":";
+			Out += Stages[i].bCleared ? "true" : "false";
+			Out += ",\"ClearRank\":";
+			Out += std::to_string(Stages[i].ClearRank);
+			Out += ",\"difficultyRank\":";
+			Out += std::to_string(Stages[i].Difficulty);
+			Out += ",\"Title\":\"";
+			Out += Stages[i].Title;
+			Out += "\"}";
+		}
+		Out += "}}";
+	}
+
+	// FJsonValue / FJsonObject 相当（値ごとに共有ポインタで確保し、オブジェクトはハッシュマップで持つ）
+	struct FJsonValueMock
+	{
+		enum class EType : uint8_t { Null, Bool, Number, String, Object };
+
+		EType Type = EType::Null;
+		bool Bool = false;
+		double Number = 0.0;
+		std::string String;
+		std::unordered_map<std::string, std::shared_ptr<FJsonValueMock>> Object;
+	};
+
+	// TJsonReader + FJsonSerializer::Deserialize 相当（このベンチマークで書き出す JSON だけを読める）
+	class FJsonParserMock
+	{
+	public:
+		explicit FJsonParserMock(const std::string& InText) : Text(InText) {}
+
+		std::shared_ptr<FJsonValueMock> Parse()
+		{
+			SkipSpace();
+			return ParseValue();
+		}
+
+	private:
+		void SkipSpace()
+		{
+			while (Pos < Text.size() && (Text[Pos] == ' ' || Text[Pos] == '\n' || Text[Pos] == '\r' || Text[Pos] == '\t'))
+			{
+				++Pos;
+			}
+		}
+
+		bool ParseString(std::string& Out)
+		{
+			if (Pos >= Text.size() || Text[Pos] != '"')
+				return false;
+
+			++Pos;
+			Out.clear();
+			while (Pos < Text.size() && Text[Pos] != '"')
+			{
+				if (Text[Pos] == '\\' && Pos + 1 < Text.size())
+				{
+					++Pos;
+				}
+				Out += Text[Pos++];
+			}
+			++Pos;
+			return true;
+		}
+
+		std::shared_ptr<FJsonValueMock> ParseValue()
+		{
+			auto Value = std::make_shared<FJsonValueMock>();
+			if (Pos >= Text.size())
+				return nullptr;
+
+			const char Head = Text[Pos];
+			if (Head == '{')
+			{
+				Value->Type = FJsonValueMock::EType::Object;
+				++Pos;
+				SkipSpace();
+				while (Pos < Text.size() && Text[Pos] != '}')
+				{
+					std::string Key;
+					if (!ParseString(Key))
+						return nullptr;
+					SkipSpace();
+					++Pos;  // ':'
+					SkipSpace();
+					std::shared_ptr<FJsonValueMock> Child = ParseValue();
+					if (!Child)
+						return nullptr;
+					Value->Object.emplace(std::move(Key), std::move(Child));
+					SkipSpace();
+					if (Pos < Text.size() && Text[Pos] == ',')
+					{
+						++Pos;
+						SkipSpace();
+					}
+				}
+				++Pos;
+			}
+			else if (Head == '"')
+			{
+				Value->Type = FJsonValueMock::EType::String;
+				ParseString(Value->String);
+			}
+			else if (Text.compare(Pos, 4, "true") == 0 || Text.compare(Pos, 5, "false") == 0)
+			{
+				Value->Type = FJsonValueMock::EType::Bool;
+				Value->Bool = Head == 't';
+				Pos += Value->Bool ? 4 : 5;
+			}
+			else if (Text.compare(Pos, 4, "null") == 0)
+			{
+				Pos += 4;
+			}
+			else
+			{
+				char* End = nullptr;
+				Value->Type = FJsonValueMock::EType::Number;
+				Value->Number = std::strtod(Text.c_str() + Pos, &End);
+				Pos = static_cast<size_t>(End - Text.c_str());
+			}
+			return Value;
+		}
+
+		const std::string& Text;
+		size_t Pos = 0;
+	};
+
+	// FStageSaveData::FromJson 相当（フィールドを名前で探して取り出す）
+	void DeserializeStageSave(const std::string& Json, std::vector<FStageRecord>& OutStages)
+	{
+		OutStages.clear();
+		const std::shared_ptr<FJsonValueMock> Root = FJsonParserMock(Json).Parse();
+		if (!Root)
+			return;
+
+		const auto StagesIt = Root->Object.find("Stages");
+		if (StagesIt == Root->Object.end())
+			return;
+
+		for (const auto& Pair : StagesIt->second->Object)
+		{
+			const auto& Fields = Pair.second->Object;
+			FStageRecord& Stage = OutStages.emplace_back();
+			Stage.Key = Pair.first;
+			if (auto It = Fields.find("bCleared"); It != Fields.end()) Stage.bCleared = It->second->Bool;
+			if (auto It = Fields.find("ClearRank"); It != Fields.end()) Stage.ClearRank = static_cast<int32_t>(It->second->Number);
+			if (auto It = Fields.find("difficultyRank"); It != Fields.end()) Stage.Difficulty = static_cast<int32_t>(It->second->Number);
+			if (auto It = Fields.find("Title"); It != Fields.end()) Stage.Title = It->second->String;
+		}
+	}
+
+	// 読み込んだステージから checksum を作る（JSON とバイナリで一致するか比べる）
+	double StageChecksum(const std::vector<FStageRecord>& Stages)
+	{
+		double Sum = 0.0;
+		for (const FStageRecord& Stage : Stages)
+		{
+			Sum += Stage.ClearRank + Stage.Difficulty * 8 + (Stage.bCleared ? 64 : 0) + static_cast<double>(Stage.Key.size() + Stage.Title.size());
+		}
+		return Sum;
+	}
+
+	// =======================
+	// 計測
+	// =======================
+
+	// 処理の流れ:
+	// 1. 前回の時間から必要な反復回数を見積もり（最大10倍）、最低時間を超えるまで計測を繰り返す
+	// 2. 1反復当たりの時間と1秒当たりの処理要素数を計算
+	// 3. 最後の1反復の戻り値を checksum として記録
+	template<typename FunctionType>
+	FBenchmarkResult RunBenchmark(const std::string& Name, int32_t Size, FunctionType&& Body)
+	{
+		FBenchmarkResult Result;
+		Result.Name = Name;
+		Result.Size = Size;
+
+		// 1回目はキャッシュを温めるために捨てる
+		Result.Checksum = Body();
+
+		int64_t Iterations = 1;
+		while (true)
+		{
+			const auto Begin = std::chrono::steady_clock::now();
+			double Checksum = 0.0;
+			for (int64_t i = 0; i < Iterations; ++i)
+			{
+				Checksum = Body();
+			}
+			const auto End = std::chrono::steady_clock::now();
+			Sink = Sink + Checksum;
+
+			const double Seconds = std::chrono::duration<double>(End - Begin).count();
+			if (Seconds >= MIN_TIME_SECONDS || Iterations >= MAX_ITERATIONS)
+			{
+				Result.Iterations = Iterations;
+				Result.NsPerIteration = Seconds * 1.0e9 / static_cast<double>(Iterations);
+				Result.ItemsPerSecond = static_cast<double>(Size) * static_cast<double>(Iterations) / Seconds;
+				Result.Checksum = Checksum;
+				break;
+			}
+
+			// 少し多めに見積もって次の反復回数を決める
+			const double Multiplier = Seconds > 0.0 ? MIN_TIME_SECONDS * 1.4 / Seconds : 10.0;
+			const int64_t NextIterations = static_cast<int64_t>(static_cast<double>(Iterations) * (Multiplier < 10.0 ? Multiplier : 10.0));
+			Iterations = NextIterations > Iterations ? (NextIterations < MAX_ITERATIONS ? NextIterations : MAX_ITERATIONS) : Iterations + 1;
+		}
+		return Result;
+	}
+
+	// 結果を JSON で書き出す
+	void WriteJson(std::FILE* File, const std::vector<FBenchmarkResult>& Results)
+	{
+		std::fprintf(File, "{\n  \"context\": {\n    \"min_time_s\": %.3f\n  },\n  \"benchmarks\": [\n", MIN_TIME_SECONDS);
+		for (size_t i = 0; i < Results.size(); ++i)
+		{
+			const FBenchmarkResult& Result = Results[i];
+			std::fprintf(File,
+				"    {\"name\": \"%s\", \"size\": %d, \"iterations\": %lld, \"real_time\": %.3f, \"time_unit\": \"ns\", \"items_per_second\": %.1f, \"checksum\": %.6f}%s\n",
+				Result.Name.c_str(),
+				Result.Size,
+				static_cast<long long>(Result.Iterations),
+				Result.NsPerIteration,
+				Result.ItemsPerSecond,
+				Result.Checksum,
+				i + 1 < Results.size() ? "," : "");
+		}
+		std::fprintf(File, "  ]\n}\n");
+	}
+}
+
+int main(int argc, char** argv)
+{
+	const char* OutputPath = argc > 1 ? argv[1] : nullptr;
+	const std::string Filter = argc > 2 ? argv[2] : "";
+
+	const std::vector<FEffectReference> References = MakeEffectReferences();
+
+	struct FSizeCase
+	{
+		const char* Label;
+		int32_t Size;
+	};
+	const FSizeCase SizeCases[] = {
+		{ "small", SIZE_SMALL },
+		{ "medium", SIZE_MEDIUM },
+		{ "large", SIZE_LARGE },
+	};
+
+	std::vector<FBenchmarkResult> Results;
+	auto Run = [&](const char* Name, const FSizeCase& Case, auto&& Body)
+		{
+			const std::string FullName = std::string("BM_") + Name + "/" + Case.Label;
+			if (!Filter.empty() && FullName.find(Filter) == std::string::npos)
+			{
+				return;
+			}
+			Results.push_back(RunBenchmark(FullName, Case.Size, Body));
+			std::fprintf(stderr, "%-36s %12.1f ns\n", FullName.c_str(), Results.back().NsPerIteration);
+		};
+
+	for (const FSizeCase& Case : SizeCases)
+	{
+		const std::vector<FRgb> Colors = MakeColors(Case.Size, 12345u);
+		const std::vector<FRgb> Others = MakeColors(Case.Size, 67890u);
+
+		Run("ClosestEffectByHue", Case, [&]()
+			{
+				double Sum = 0.0;
+				for (const FRgb& Color : Colors)
+				{
+					const FEffectMatch Match = ClosestEffectByHue(Color, References.data(), static_cast<int32_t>(References.size()));
+					Sum += Match.Index + Match.StrengthRatio;
+				}
+				return Sum;
+			});
+
+		Run("HueAngleDistance", Case, [&]()
+			{
+				double Sum = 0.0;
+				for (size_t i = 0; i < Colors.size(); ++i)
+				{
+					Sum += HueAngleDistance(Colors[i], Others[i]);
+				}
+				return Sum;
+			});
+
+		Run("ComplementaryColor", Case, [&]()
+			{
+				double Sum = 0.0;
+				for (const FRgb& Color : Colors)
+				{
+					const FRgb Complementary = ComplementaryColor(Color);
+					Sum += Complementary.R + Complementary.G + Complementary.B;
+				}
+				return Sum;
+			});
+
+		Run("IsColorMatch", Case, [&]()
+			{
+				double Sum = 0.0;
+				for (size_t i = 0; i < Colors.size(); ++i)
+				{
+					Sum += IsColorMatch(Colors[i], Others[i], 0.5f) ? 1.0 : 0.0;
+				}
+				return Sum;
+			});
+
+		// 通知先（8つに1つは破棄済みのターゲットとして nullptr を混ぜる）
+		std::vector<std::unique_ptr<FMockColorTarget>> Storage;
+		std::vector<FMockColorTarget*> Instances;
+		for (int32_t i = 0; i < Case.Size; ++i)
+		{
+			if (i % 8 == 7)
+			{
+				Instances.push_back(nullptr);
+				continue;
+			}
+			if (i % 2 == 0)
+			{
+				Storage.push_back(std::make_unique<FMockSwitchTarget>(Others[i]));
+			}
+			else
+			{
+				Storage.push_back(std::make_unique<FMockConveyorTarget>());
+			}
+			Instances.push_back(Storage.back().get());
+		}
+
+		Run("RegistryNotify", Case, [&]()
+			{
+				const FRgb& WorldColor = Colors[0];
+				const FEffectMatch Effect = ClosestEffectByHue(WorldColor, References.data(), static_cast<int32_t>(References.size()));
+				NotifyTargets(Instances, WorldColor, Effect);
+
+				double Sum = 0.0;
+				for (const std::unique_ptr<FMockColorTarget>& Target : Storage)
+				{
+					Sum += Target->GetState();
+				}
+				return Sum;
+			});
+
+		std::vector<FStageRecord> Stages;
+		Stages.reserve(Case.Size);
+		for (int32_t i = 0; i < Case.Size; ++i)
+		{
+			FStageRecord& Stage = Stages.emplace_back();
+			Stage.Key = "Stage_" + std::to_string(i);
+			Stage.bCleared = i % 3 != 0;
+			Stage.ClearRank = i % 5;
+			Stage.Difficulty = i % 4;
+			Stage.Title = "Stage " + std::to_string(i);
+		}
+		std::string SaveJson;
+		std::vector<uint8_t> SaveBinary;
+
+		Run("SaveSerialize", Case, [&]()
+			{
+				SerializeStageSave(Stages, SaveJson);
+				return static_cast<double>(SaveJson.size());
+			});
+
+		Run("SaveSerializeBinary", Case, [&]()
+			{
+				SaveFormat::WriteStageSave(Stages, SaveBinary);
+				return static_cast<double>(SaveBinary.size());
+			});
+
+		// 起動時の読み込み（ファイルの中身は1つのバッファに読み込み済みとする）
+		SerializeStageSave(Stages, SaveJson);
+		SaveFormat::WriteStageSave(Stages, SaveBinary);
+		std::vector<FStageRecord> Loaded;
+
+		Run("SaveLoadJson", Case, [&]()
+			{
+				DeserializeStageSave(SaveJson, Loaded);
+				return StageChecksum(Loaded);
+			});
+
+		Run("SaveLoadBinary", Case, [&]()
+			{
+				SaveFormat::ReadStageSave(SaveBinary.data(), SaveBinary.size(), Loaded);
+				return StageChecksum(Loaded);
+			});
+	}
+
+	std::FILE* File = OutputPath ? std::fopen(OutputPath, "w") : stdout;
+	if (!File)
+	{
+		std::fprintf(stderr, "cannot open %s\n", OutputPath);
+		return 1;
+	}
+	WriteJson(File, Results);
+	if (File != stdout)
+	{
+		std::fclose(File);
+	}
+	return 0;
+}
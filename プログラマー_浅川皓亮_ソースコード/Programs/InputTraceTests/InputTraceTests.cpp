@@ -0,0 +1,201 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+// 入力の記録形式（Logic/Input/InputTrace）の書き出しと読み込みが往復で一致し、
+// 途中で切れたり壊れたりしたバイト列を正しく失敗扱いにするかを確認するプログラム
+// ゲームモジュールには含めず、ベンチマークと同様に単体のプログラムとしてビルドする
+//
+//   g++ -O2 -std=c++17 -I<インクルードルート> InputTraceTests.cpp InputTrace.cpp
+//   ./a.out
+//
+// 失敗した確認を全て表示し、1つでも失敗すれば終了コード 1 を返す
+
+#include "Logic/Input/InputTrace.h"
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+using namespace InputTrace;
+
+namespace
+{
+	static constexpr int32_t NUM_FRAMES = 300;
+
+	int32_t NumChecks = 0;
+	int32_t NumFailures = 0;
+
+	// NDEBUG でも無効にならないよう assert の代わりに使う
+	#define TRACE_CHECK(Condition) Check((Condition), #Condition, __FILE__, __LINE__)
+
+	void Check(bool bPassed, const char* Expression, const char* File, int Line)
+	{
+		++NumChecks;
+		if (!bPassed)
+		{
+			++NumFailures;
+			std::fprintf(stderr, "%s:%d: check failed: %s\n", File, Line, Expression);
+		}
+	}
+
+	// 全チャンネルと、差分が大きく・負になる値を含む記録
+	FTrace MakeTrace()
+	{
+		FTrace Trace;
+		Trace.FixedDeltaTime = 1.0f / 120.0f;
+
+		uint32_t Hash = HASH_SEED;
+		for (int32_t i = 0; i < NUM_FRAMES; ++i)
+		{
+			FFrame Frame;
+			for (int32_t Channel = 0; Channel < static_cast<int32_t>(EChannel::Count); ++Channel)
+			{
+				if ((i + Channel) % 3 == 0)
+					continue;
+
+				FEvent Event;
+				Event.Channel = static_cast<EChannel>(Channel);
+				Event.X = Quantize(static_cast<float>((i * 7 + Channel) % 200 - 100) * 0.01f);
+				Event.Y = Quantize(static_cast<float>((i * 13 + Channel) % 200 - 100) * 0.01f);
+				Frame.Events.push_back(Event);
+			}
+
+			Frame.MouseX = (i % 50 == 0) ? Quantize(100000.0f) : Quantize(static_cast<float>(i % 17) - 8.5f);
+			Frame.MouseY = (i % 50 == 0) ? Quantize(-100000.0f) : Quantize(static_cast<float>(i % 11) * -0.25f);
+
+			Hash = HashCombine(Hash, i);
+			Frame.StateHash = Hash;
+			Trace.Frames.push_back(Frame);
+		}
+		return Trace;
+	}
+
+	bool IsSameTrace(const FTrace& A, const FTrace& B)
+	{
+		if (std::memcmp(&A.FixedDeltaTime, &B.FixedDeltaTime, sizeof(float)) != 0 || A.Frames.size() != B.Frames.size())
+			return false;
+
+		for (size_t i = 0; i < A.Frames.size(); ++i)
+		{
+			const FFrame& FrameA = A.Frames[i];
+			const FFrame& FrameB = B.Frames[i];
+			if (FrameA.MouseX != FrameB.MouseX || FrameA.MouseY != FrameB.MouseY
+				|| FrameA.StateHash != FrameB.StateHash || FrameA.Events.size() != FrameB.Events.size())
+				return false;
+
+			for (size_t j = 0; j < FrameA.Events.size(); ++j)
+			{
+				const FEvent& EventA = FrameA.Events[j];
+				const FEvent& EventB = FrameB.Events[j];
+				if (EventA.Channel != EventB.Channel || EventA.X != EventB.X || EventA.Y != EventB.Y)
+					return false;
+			}
+		}
+		return true;
+	}
+
+	// 書き出した記録を読み込むと元と一致する（空の記録も含む）
+	void TestRoundTrip()
+	{
+		const FTrace Trace = MakeTrace();
+		std::vector<uint8_t> Bytes;
+		Encode(Trace, Bytes);
+
+		FTrace Decoded;
+		TRACE_CHECK(Decode(Bytes.data(), Bytes.size(), Decoded));
+		TRACE_CHECK(IsSameTrace(Trace, Decoded));
+
+		const FTrace Empty;
+		std::vector<uint8_t> EmptyBytes;
+		Encode(Empty, EmptyBytes);
+		TRACE_CHECK(Decode(EmptyBytes.data(), EmptyBytes.size(), Decoded));
+		TRACE_CHECK(IsSameTrace(Empty, Decoded));
+	}
+
+	// 量子化して戻した値は、量子化の刻みの半分以内に収まり、もう一度量子化しても変わらない
+	void TestQuantize()
+	{
+		bool bWithinStep = true;
+		bool bStable = true;
+		for (int32_t i = -2000; i <= 2000; ++i)
+		{
+			const float Value = static_cast<float>(i) * 0.00137f;
+			const float Restored = Dequantize(Quantize(Value));
+			bWithinStep &= (Restored - Value) <= 0.5f / QUANTIZE_SCALE + 1e-6f && (Value - Restored) <= 0.5f / QUANTIZE_SCALE + 1e-6f;
+			bStable &= Quantize(Restored) == Quantize(Value);
+		}
+		TRACE_CHECK(bWithinStep);
+		TRACE_CHECK(bStable);
+	}
+
+	// 途中で切れたバイト列は、どこで切れても読み込みに失敗する
+	void TestTruncation()
+	{
+		std::vector<uint8_t> Bytes;
+		Encode(MakeTrace(), Bytes);
+
+		bool bAllRejected = true;
+		for (size_t Size = 0; Size < Bytes.size(); ++Size)
+		{
+			FTrace Decoded;
+			if (Decode(Bytes.data(), Size, Decoded))
+			{
+				std::fprintf(stderr, "  truncated trace of %zu / %zu bytes was accepted\n", Size, Bytes.size());
+				bAllRejected = false;
+			}
+		}
+		TRACE_CHECK(bAllRejected);
+
+		// 末尾に余分なバイトがあっても失敗する
+		Bytes.push_back(0);
+		FTrace Decoded;
+		TRACE_CHECK(!Decode(Bytes.data(), Bytes.size(), Decoded));
+	}
+
+	// 識別子・バージョン・チャンネルが不正なバイト列と、巨大な数を書いたバイト列を失敗扱いにする
+	void TestCorruption()
+	{
+		std::vector<uint8_t> Bytes;
+		Encode(MakeTrace(), Bytes);
+
+		FTrace Decoded;
+		TRACE_CHECK(!Decode(nullptr, 0, Decoded));
+
+		std::vector<uint8_t> BadMagic = Bytes;
+		BadMagic[0] = 'X';
+		TRACE_CHECK(!Decode(BadMagic.data(), BadMagic.size(), Decoded));
+
+		std::vector<uint8_t> BadVersion = Bytes;
+		BadVersion[4] = 2;
+		TRACE_CHECK(!Decode(BadVersion.data(), BadVersion.size(), Decoded));
+
+		// ヘッダ（識別子4・バージョン1・固定ステップ4）の直後にフレーム数を書き、1フレーム目に不正なチャンネルを置く
+		static constexpr size_t HEADER_SIZE = 9;
+		std::vector<uint8_t> BadChannel(Bytes.begin(), Bytes.begin() + HEADER_SIZE);
+		BadChannel.push_back(1);
+		BadChannel.push_back(1);
+		BadChannel.push_back(static_cast<uint8_t>(EChannel::Count));
+		BadChannel.insert(BadChannel.end(), { 0, 0, 0, 0, 0, 0, 0, 0 });
+		TRACE_CHECK(!Decode(BadChannel.data(), BadChannel.size(), Decoded));
+
+		// バイト数に見合わないフレーム数
+		std::vector<uint8_t> HugeFrames(Bytes.begin(), Bytes.begin() + HEADER_SIZE);
+		HugeFrames.insert(HugeFrames.end(), { 0xFF, 0xFF, 0xFF, 0xFF, 0x0F });
+		TRACE_CHECK(!Decode(HugeFrames.data(), HugeFrames.size(), Decoded));
+
+		// 上限を超えるイベント数
+		std::vector<uint8_t> HugeEvents(Bytes.begin(), Bytes.begin() + HEADER_SIZE);
+		HugeEvents.insert(HugeEvents.end(), { 1, 0xFF, 0xFF, 0x03, 0, 0, 0, 0, 0, 0 });
+		TRACE_CHECK(!Decode(HugeEvents.data(), HugeEvents.size(), Decoded));
+	}
+}
+
+int main()
+{
+	TestRoundTrip();
+	TestQuantize();
+	TestTruncation();
+	TestCorruption();
+
+	std::printf("checks=%d failures=%d\n", NumChecks, NumFailures);
+	return NumFailures == 0 ? 0 : 1;
+}
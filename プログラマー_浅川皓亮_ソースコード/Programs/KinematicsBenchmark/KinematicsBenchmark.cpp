@@ -0,0 +1,179 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+// 自前物理の計算部（Logic/Physics/KinematicsCore）をエディタ無しで計測するベンチマーク
+// ゲームモジュールには含めず、単体のプログラムとしてビルドする
+//
+//   g++ -O2 -std=c++17 -I<インクルードルート> KinematicsBenchmark.cpp KinematicsCore.cpp KinematicsBoxWorld.cpp
+//   ./a.out [ボディ数=10000] [ステップ数=600]
+//
+// 最後に出力するチェックサムは全ボディの最終位置の合計で、挙動が変わっていないかの比較に使う
+
+#include "Logic/Physics/KinematicsCore.h"
+#include "Logic/Physics/KinematicsBoxWorld.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+using namespace Kinematics;
+
+namespace
+{
+	static constexpr float STEP_TIME = 1.0f / 60.0f;
+	static constexpr float BODY_HALF_HEIGHT = 20.0f;
+	static constexpr float BODY_SPACING = 120.0f;
+	static constexpr float SPAWN_HEIGHT = 400.0f;
+
+	// 衝突判定の呼び出し回数を数える
+	class FCountingQuery : public IKinematicsCollisionQuery
+	{
+	public:
+		explicit FCountingQuery(const IKinematicsCollisionQuery& InQuery) : Query(InQuery) {}
+
+		virtual bool SweepBox(const FKinSweep& Sweep, FKinHit& OutHit) const override
+		{
+			++Count;
+			return Query.SweepBox(Sweep, OutHit);
+		}
+
+		mutable int64_t Count = 0;
+
+	private:
+		const IKinematicsCollisionQuery& Query;
+	};
+
+	// 床・段差・壁で構成したステージを作る
+	void BuildStage(FKinematicsBoxWorld& World, int32_t GridSize)
+	{
+		const float StageHalf = GridSize * BODY_SPACING * 0.5f + 500.0f;
+
+		// 床
+		World.AddBox(FKinVector(0.0f, 0.0f, -50.0f), FKinVector(StageHalf, StageHalf, 50.0f));
+
+		// 段差（16マスおきに足場を置く）
+		for (int32_t y = 0; y < GridSize; y += 16)
+		{
+			for (int32_t x = 0; x < GridSize; x += 16)
+			{
+				const FKinVector Center(
+					(x - GridSize * 0.5f) * BODY_SPACING,
+					(y - GridSize * 0.5f) * BODY_SPACING,
+					150.0f);
+				World.AddBox(Center, FKinVector(200.0f, 200.0f, 20.0f));
+			}
+		}
+
+		// 外周の壁
+		World.AddBox(FKinVector(StageHalf, 0.0f, 500.0f), FKinVector(50.0f, StageHalf, 500.0f));
+		World.AddBox(FKinVector(-StageHalf, 0.0f, 500.0f), FKinVector(50.0f, StageHalf, 500.0f));
+		World.AddBox(FKinVector(0.0f, StageHalf, 500.0f), FKinVector(StageHalf, 50.0f, 500.0f));
+		World.AddBox(FKinVector(0.0f, -StageHalf, 500.0f), FKinVector(StageHalf, 50.0f, 500.0f));
+	}
+
+	// ベルトコンベア相当の力場を帯状に置く（8行おき、向きを交互に反転）
+	void BuildConveyors(std::vector<FKinForceField>& Fields, int32_t GridSize)
+	{
+		const float StageHalf = GridSize * BODY_SPACING * 0.5f;
+
+		for (int32_t y = 4; y < GridSize; y += 8)
+		{
+			FKinForceField Field;
+			Field.Center = FKinVector(0.0f, (y - GridSize * 0.5f) * BODY_SPACING, 10.0f);
+			Field.HalfExtent = FKinVector(StageHalf, BODY_SPACING * 0.5f, 10.0f);
+			Field.Direction = FKinVector((y / 8) % 2 == 0 ? 1.0f : -1.0f, 0.0f, 0.0f);
+			Field.Power = 2.0f;
+			Fields.push_back(Field);
+		}
+	}
+
+	// ボディを格子状に配置する
+	void SpawnBodies(FKinematicsBodies& Bodies, int32_t Count, int32_t GridSize)
+	{
+		for (int32_t i = 0; i < Count; ++i)
+		{
+			const int32_t x = i % GridSize;
+			const int32_t y = i / GridSize;
+			const FKinVector Location(
+				(x - GridSize * 0.5f) * BODY_SPACING,
+				(y - GridSize * 0.5f) * BODY_SPACING,
+				SPAWN_HEIGHT + (i % 5) * 40.0f);
+
+			const int32_t Index = Bodies.Add(Location);
+			Bodies.HalfHeights[Index] = BODY_HALF_HEIGHT;
+			Bodies.GravityScales[Index] = 50.0f;
+		}
+	}
+
+	// 押し出しやジャンプ相当の力を一部のボディに加える
+	void ApplyScriptedForces(FKinematicsBodies& Bodies, int32_t Step)
+	{
+		for (int32_t i = 0; i < Bodies.Num(); ++i)
+		{
+			if (i % 4 == 0 && Step % 60 == 0)
+			{
+				AddForce(Bodies, i, FKinVector(1.0f, 0.0f, 0.0f), 5.0f, true, false);
+			}
+			else if (i % 7 == 0 && Step % 90 == 30 && HasFlag(Bodies.Flags[i], EBodyFlags::OnGround))
+			{
+				AddForce(Bodies, i, FKinVector(0.0f, 0.0f, 1.0f), 12.0f, true, true);
+			}
+		}
+	}
+}
+
+int main(int argc, char** argv)
+{
+	const int32_t BodyCount = argc > 1 ? std::atoi(argv[1]) : 10000;
+	const int32_t StepCount = argc > 2 ? std::atoi(argv[2]) : 600;
+	if (BodyCount <= 0 || StepCount <= 0)
+	{
+		std::fprintf(stderr, "usage: %s [bodies] [steps]\n", argv[0]);
+		return 1;
+	}
+
+	int32_t GridSize = 1;
+	while (GridSize * GridSize < BodyCount)
+	{
+		++GridSize;
+	}
+
+	FKinematicsBoxWorld World;
+	BuildStage(World, GridSize);
+
+	std::vector<FKinForceField> Conveyors;
+	BuildConveyors(Conveyors, GridSize);
+
+	FKinematicsBodies Bodies;
+	SpawnBodies(Bodies, BodyCount, GridSize);
+
+	const FCountingQuery Query(World);
+
+	const auto Begin = std::chrono::steady_clock::now();
+	for (int32_t Step = 0; Step < StepCount; ++Step)
+	{
+		ApplyScriptedForces(Bodies, Step);
+		StepBodies(Bodies, STEP_TIME, Query, &Conveyors);
+	}
+	const auto End = std::chrono::steady_clock::now();
+
+	const double TotalMs = std::chrono::duration<double, std::milli>(End - Begin).count();
+	const double NsPerBodyStep = TotalMs * 1.0e6 / (static_cast<double>(BodyCount) * StepCount);
+
+	int32_t Grounded = 0;
+	double Checksum = 0.0;
+	for (int32_t i = 0; i < Bodies.Num(); ++i)
+	{
+		if (HasFlag(Bodies.Flags[i], EBodyFlags::OnGround))
+		{
+			++Grounded;
+		}
+		Checksum += Bodies.Locations[i].X + Bodies.Locations[i].Y + Bodies.Locations[i].Z;
+	}
+
+	std::printf("bodies=%d steps=%d boxes=%d conveyors=%d\n", BodyCount, StepCount, World.NumBoxes(), static_cast<int32_t>(Conveyors.size()));
+	std::printf("total_ms=%.3f ns_per_body_step=%.1f\n", TotalMs, NsPerBodyStep);
+	std::printf("queries_per_body_step=%.2f\n", static_cast<double>(Query.Count) / (static_cast<double>(BodyCount) * StepCount));
+	std::printf("grounded=%d awake=%d checksum=%.3f\n", Grounded, Bodies.NumAwake(), Checksum);
+	return 0;
+}
@@ -0,0 +1,386 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+// 自前物理の計算部（Logic/Physics/KinematicsCore）の挙動をボックスワールド上で確認するプログラム
+// ゲームモジュールには含めず、ベンチマークと同様に単体のプログラムとしてビルドする
+//
+//   g++ -O2 -std=c++17 -I<インクルードルート> KinematicsTests.cpp KinematicsCore.cpp KinematicsBoxWorld.cpp
+//   ./a.out
+//
+// 失敗した確認を全て表示し、1つでも失敗すれば終了コード 1 を返す
+
+#include "Logic/Physics/KinematicsCore.h"
+#include "Logic/Physics/KinematicsBoxWorld.h"
+
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+using namespace Kinematics;
+
+namespace
+{
+	static constexpr float STEP_TIME = 1.0f / 60.0f;
+	static constexpr float BODY_HALF_HEIGHT = 20.0f;
+
+	// MOVE_BOX_EXTENT（スケール1）と同じ。面からこれ以上近づかない
+	static constexpr float MOVE_BOX_HALF = 20.0f;
+
+	// 足元の判定が届く高さ（半分の高さ + GROUND_BOX_EXTENT_Z + GROUND_CHECK_DISTANCE）
+	static constexpr float GROUND_PROBE_REACH = BODY_HALF_HEIGHT + 15.0f + 5.0f;
+
+	// 床の上面の高さ
+	static constexpr float FLOOR_TOP = 0.0f;
+
+	int32_t NumChecks = 0;
+	int32_t NumFailures = 0;
+
+	// NDEBUG でも無効にならないよう assert の代わりに使う
+	#define KIN_CHECK(Condition) Check((Condition), #Condition, __FILE__, __LINE__)
+
+	void Check(bool bPassed, const char* Expression, const char* File, int Line)
+	{
+		++NumChecks;
+		if (!bPassed)
+		{
+			++NumFailures;
+			std::fprintf(stderr, "%s:%d: check failed: %s\n", File, Line, Expression);
+		}
+	}
+
+	bool IsNear(float A, float B, float Tolerance)
+	{
+		return std::fabs(A - B) <= Tolerance;
+	}
+
+	// 上面が FLOOR_TOP の広い床
+	void AddFloor(FKinematicsBoxWorld& World)
+	{
+		World.AddBox(FKinVector(0.0f, 0.0f, FLOOR_TOP - 50.0f), FKinVector(5000.0f, 5000.0f, 50.0f));
+	}
+
+	int32_t AddBody(FKinematicsBodies& Bodies, const FKinVector& Location, bool bApplyGravity)
+	{
+		const int32_t Index = Bodies.Add(Location);
+		Bodies.HalfHeights[Index] = BODY_HALF_HEIGHT;
+		Bodies.GravityScales[Index] = 50.0f;
+		if (!bApplyGravity)
+		{
+			Bodies.Flags[Index] &= ~EBodyFlags::ApplyGravity;
+		}
+		return Index;
+	}
+
+	// =======================
+	// 着地
+	// =======================
+
+	// 落下したボディが床で止まり、着地・接地を経てスリープする
+	void TestLanding()
+	{
+		FKinematicsBoxWorld World;
+		AddFloor(World);
+
+		FKinematicsBodies Bodies;
+		const int32_t Body = AddBody(Bodies, FKinVector(0.0f, 0.0f, 300.0f), true);
+
+		bool bLanded = false;
+		float LowestZ = Bodies.Locations[Body].Z;
+		for (int32_t Step = 0; Step < 300; ++Step)
+		{
+			StepBodies(Bodies, STEP_TIME, World);
+			bLanded |= HasFlag(Bodies.Flags[Body], EBodyFlags::JustLanded);
+			LowestZ = std::fmin(LowestZ, Bodies.Locations[Body].Z);
+		}
+
+		KIN_CHECK(bLanded);
+		KIN_CHECK(HasFlag(Bodies.Flags[Body], EBodyFlags::OnGround));
+		KIN_CHECK(!HasFlag(Bodies.Flags[Body], EBodyFlags::Falling));
+		KIN_CHECK(HasFlag(Bodies.Flags[Body], EBodyFlags::Sleeping));
+
+		// 床を抜けず、足元の判定が床に届いた高さで止まる
+		KIN_CHECK(LowestZ >= FLOOR_TOP + MOVE_BOX_HALF);
+		KIN_CHECK(Bodies.Locations[Body].Z <= FLOOR_TOP + GROUND_PROBE_REACH);
+	}
+
+	// 1フレームに複数ステップ進めた時、最初のステップで着地しても、フレームの終わりに着地が残っている
+	void TestLandingLatchedAcrossSubSteps()
+	{
+		static constexpr int32_t SUB_STEPS = 4;
+
+		FKinematicsBoxWorld World;
+		AddFloor(World);
+
+		FKinematicsBodies Bodies;
+		const int32_t Body = AddBody(Bodies, FKinVector(0.0f, 0.0f, FLOOR_TOP + MOVE_BOX_HALF + 30.0f), true);
+		Bodies.MaxFallingSpeeds[Body] = 200.0f;
+		Bodies.Timers[Body] = 10.0f;
+
+		BeginFrame(Bodies);
+		StepBodies(Bodies, STEP_TIME, World);
+		KIN_CHECK(HasFlag(Bodies.Flags[Body], EBodyFlags::OnGround));
+
+		for (int32_t Step = 1; Step < SUB_STEPS; ++Step)
+		{
+			StepBodies(Bodies, STEP_TIME, World);
+		}
+
+		// ステップ単位の JustLanded は消えているが、フレーム単位の記録は残る
+		KIN_CHECK(!HasFlag(Bodies.Flags[Body], EBodyFlags::JustLanded));
+		KIN_CHECK(HasFlag(Bodies.Flags[Body], EBodyFlags::LandedThisFrame));
+
+		// 次のフレームでは消え、接地したままなら立たない
+		BeginFrame(Bodies);
+		StepBodies(Bodies, STEP_TIME, World);
+		KIN_CHECK(!HasFlag(Bodies.Flags[Body], EBodyFlags::LandedThisFrame));
+
+		// 着地したフレームのうちに眠っても残る
+		FKinematicsBodies Sleepers;
+		Sleepers.SleepStepThreshold = 1;
+		const int32_t Sleeper = AddBody(Sleepers, FKinVector(0.0f, 0.0f, FLOOR_TOP + MOVE_BOX_HALF + 30.0f), true);
+		Sleepers.MaxFallingSpeeds[Sleeper] = 200.0f;
+		Sleepers.Timers[Sleeper] = 10.0f;
+
+		BeginFrame(Sleepers);
+		for (int32_t Step = 0; Step < SUB_STEPS; ++Step)
+		{
+			StepBodies(Sleepers, STEP_TIME, World);
+		}
+		KIN_CHECK(HasFlag(Sleepers.Flags[Sleeper], EBodyFlags::Sleeping));
+		KIN_CHECK(HasFlag(Sleepers.Flags[Sleeper], EBodyFlags::LandedThisFrame));
+	}
+
+	// 床に接するまで落ちたボディも、床から離れる向きには動ける（開始位置の後退で床と重なっていても止めない）
+	void TestJumpFromContact()
+	{
+		FKinematicsBoxWorld World;
+		AddFloor(World);
+
+		FKinematicsBodies Bodies;
+		const int32_t Body = AddBody(Bodies, FKinVector(0.0f, 0.0f, FLOOR_TOP + MOVE_BOX_HALF + 30.0f), true);
+		Bodies.MaxFallingSpeeds[Body] = 200.0f;
+		Bodies.Timers[Body] = 10.0f;
+
+		StepBodies(Bodies, STEP_TIME, World);
+		KIN_CHECK(HasFlag(Bodies.Flags[Body], EBodyFlags::OnGround));
+		KIN_CHECK(Bodies.Locations[Body].Z - (FLOOR_TOP + MOVE_BOX_HALF) < 1.0f);
+
+		const float RestZ = Bodies.Locations[Body].Z;
+		AddForce(Bodies, Body, FKinVector(0.0f, 0.0f, 1.0f), 12.0f, true, false);
+		StepBodies(Bodies, STEP_TIME, World);
+		KIN_CHECK(Bodies.Locations[Body].Z > RestZ + 10.0f);
+	}
+
+	// =======================
+	// 天井
+	// =======================
+
+	// 床の上で上向きの力を受けたボディが天井で止まり、上昇力が打ち切られる
+	void TestCeilingHit()
+	{
+		static constexpr float CEILING_BOTTOM = 80.0f;
+
+		FKinematicsBoxWorld World;
+		AddFloor(World);
+		World.AddBox(FKinVector(0.0f, 0.0f, CEILING_BOTTOM + 50.0f), FKinVector(5000.0f, 5000.0f, 50.0f));
+
+		FKinematicsBodies Bodies;
+		const int32_t Body = AddBody(Bodies, FKinVector(0.0f, 0.0f, FLOOR_TOP + MOVE_BOX_HALF + 10.0f), true);
+		for (int32_t Step = 0; Step < 10; ++Step)
+		{
+			StepBodies(Bodies, STEP_TIME, World);
+		}
+		KIN_CHECK(HasFlag(Bodies.Flags[Body], EBodyFlags::OnGround));
+
+		AddForce(Bodies, Body, FKinVector(0.0f, 0.0f, 1.0f), 12.0f, true, false);
+
+		bool bForceCancelled = false;
+		float HighestZ = Bodies.Locations[Body].Z;
+		for (int32_t Step = 0; Step < 20 && !bForceCancelled; ++Step)
+		{
+			StepBodies(Bodies, STEP_TIME, World);
+			HighestZ = std::fmax(HighestZ, Bodies.Locations[Body].Z);
+			bForceCancelled = Bodies.ForceScales[Body] == 0.0f && HasFlag(Bodies.Flags[Body], EBodyFlags::PhysicsEnabled);
+		}
+
+		// 力が減衰しきる（1.2秒）よりずっと前に、天井に当たったことで打ち切られる
+		KIN_CHECK(bForceCancelled);
+		KIN_CHECK(Bodies.ForceDirections[Body].Z == 0.0f);
+		KIN_CHECK(HighestZ <= CEILING_BOTTOM - MOVE_BOX_HALF);
+		KIN_CHECK(HighestZ > FLOOR_TOP + MOVE_BOX_HALF + 10.0f);
+	}
+
+	// =======================
+	// 壁に沿った滑り
+	// =======================
+
+	// 斜めに壁へ当たった移動は、壁の手前で止まり残りを壁に沿って進む
+	void TestWallSlide()
+	{
+		static constexpr float WALL_FACE_X = 100.0f;
+
+		FKinematicsBoxWorld World;
+		World.AddBox(FKinVector(WALL_FACE_X + 50.0f, 0.0f, 0.0f), FKinVector(50.0f, 5000.0f, 5000.0f));
+
+		FKinematicsBodies Bodies;
+		const int32_t Body = AddBody(Bodies, FKinVector(WALL_FACE_X - MOVE_BOX_HALF - 10.0f, 0.0f, 0.0f), false);
+		Bodies.Flags[Body] |= EBodyFlags::PhysicsEnabled;
+		Bodies.DesiredMoves[Body] = FKinVector(50.0f, 50.0f, 0.0f);
+
+		const FKinMoveResult Result = MoveAndSlide(Bodies, Body, World);
+		const FKinVector& Location = Bodies.Locations[Body];
+
+		KIN_CHECK(Location.X <= WALL_FACE_X - MOVE_BOX_HALF);
+		KIN_CHECK(Location.X >= WALL_FACE_X - MOVE_BOX_HALF - 1.5f);
+
+		// 壁まで斜めに進んだ分（約10）だけでなく、押し込んだ分も Y 方向へ滑る
+		KIN_CHECK(Location.Y > 30.0f);
+		KIN_CHECK(Location.Y <= 50.0f);
+		KIN_CHECK(IsNear(Location.Z, 0.0f, 1.e-3f));
+
+		// 垂直な壁は地面ではない
+		KIN_CHECK(!Result.bGroundContact);
+		KIN_CHECK(Result.QueryCount == 2);
+	}
+
+	// =======================
+	// 力の減衰
+	// =======================
+
+	// 力は1秒当たり FORCE_DECAY_RATE（10）で減り、0になったら移動しない
+	void TestForceDecay()
+	{
+		FKinematicsBoxWorld World;
+
+		FKinematicsBodies Bodies;
+		const int32_t Body = AddBody(Bodies, FKinVector(0.0f, 0.0f, 0.0f), false);
+		AddForce(Bodies, Body, FKinVector(1.0f, 0.0f, 0.0f), 5.0f, true, false);
+
+		StepBodies(Bodies, STEP_TIME, World);
+		KIN_CHECK(IsNear(Bodies.ForceScales[Body], 5.0f - 10.0f * STEP_TIME, 1.e-4f));
+
+		// 減衰後の値で移動する（基準レートの1フレーム分）
+		KIN_CHECK(IsNear(Bodies.Locations[Body].X, 5.0f - 10.0f * STEP_TIME, 1.e-3f));
+
+		// 0.5秒で 5 が減衰しきる
+		for (int32_t Step = 1; Step < 31; ++Step)
+		{
+			StepBodies(Bodies, STEP_TIME, World);
+		}
+		KIN_CHECK(Bodies.ForceScales[Body] == 0.0f);
+
+		const float StoppedX = Bodies.Locations[Body].X;
+		StepBodies(Bodies, STEP_TIME, World);
+		KIN_CHECK(Bodies.Locations[Body].X == StoppedX);
+
+		// 減衰中の移動量の合計（等差数列の和）
+		float ExpectedX = 0.0f;
+		for (int32_t Step = 1; Step <= 30; ++Step)
+		{
+			ExpectedX += std::fmax(5.0f - 10.0f * STEP_TIME * Step, 0.0f);
+		}
+		KIN_CHECK(IsNear(StoppedX, ExpectedX, 1.e-2f));
+
+		// ステップを半分にしても減衰の速さは変わらない
+		FKinematicsBodies HalfStepBodies;
+		const int32_t HalfStepBody = AddBody(HalfStepBodies, FKinVector(0.0f, 0.0f, 0.0f), false);
+		AddForce(HalfStepBodies, HalfStepBody, FKinVector(1.0f, 0.0f, 0.0f), 5.0f, true, false);
+		for (int32_t Step = 0; Step < 2; ++Step)
+		{
+			StepBodies(HalfStepBodies, STEP_TIME * 0.5f, World);
+		}
+		KIN_CHECK(IsNear(HalfStepBodies.ForceScales[HalfStepBody], 5.0f - 10.0f * STEP_TIME, 1.e-4f));
+	}
+
+	// =======================
+	// 力場
+	// =======================
+
+	// 範囲内のボディにだけ移動量が加わり、遮られているボディには加わらない
+	// 毎回リセットしてから加算するので、遮りを外したステップから移動量が加わる
+	void TestForceFieldBlockedBodies()
+	{
+		FKinematicsBodies Bodies;
+		const int32_t Inside = AddBody(Bodies, FKinVector(0.0f, 0.0f, 0.0f), false);
+		const int32_t Blocked = AddBody(Bodies, FKinVector(50.0f, 0.0f, 0.0f), false);
+		const int32_t Outside = AddBody(Bodies, FKinVector(500.0f, 0.0f, 0.0f), false);
+
+		std::vector<FKinForceField> Fields(1);
+		Fields[0].HalfExtent = FKinVector(100.0f, 100.0f, 100.0f);
+		Fields[0].Direction = FKinVector(1.0f, 0.0f, 0.0f);
+		Fields[0].Power = 2.0f;
+		Fields[0].BlockedBodies.push_back(Blocked);
+
+		// 基準レートの1フレーム分の移動量
+		const float ExpectedMove = 2.0f * STEP_TIME * 60.0f;
+
+		ApplyForceFields(Bodies, Fields, STEP_TIME);
+		KIN_CHECK(IsNear(Bodies.FieldMoves[Inside].X, ExpectedMove, 1.e-4f));
+		KIN_CHECK(Bodies.FieldMoves[Blocked].X == 0.0f);
+		KIN_CHECK(Bodies.FieldMoves[Outside].X == 0.0f);
+
+		Fields[0].BlockedBodies.clear();
+		ApplyForceFields(Bodies, Fields, STEP_TIME);
+		KIN_CHECK(IsNear(Bodies.FieldMoves[Inside].X, ExpectedMove, 1.e-4f));
+		KIN_CHECK(IsNear(Bodies.FieldMoves[Blocked].X, ExpectedMove, 1.e-4f));
+	}
+
+	// =======================
+	// 開始時点の重なり
+	// =======================
+
+	// 開始時点で重なっているスイープは距離0で当たり、法線は最も浅く抜け出せる向きになる
+	// ボディは重なりを深める向きには動かず、抜け出す向きには動ける
+	void TestStartPenetration()
+	{
+		FKinematicsBoxWorld World;
+		World.AddBox(FKinVector(0.0f, 0.0f, 0.0f), FKinVector(50.0f, 50.0f, 50.0f));
+
+		FKinSweep Sweep;
+		Sweep.Start = FKinVector(10.0f, 0.0f, 0.0f);
+		Sweep.End = FKinVector(110.0f, 0.0f, 0.0f);
+		Sweep.HalfExtent = FKinVector(MOVE_BOX_HALF, MOVE_BOX_HALF, MOVE_BOX_HALF);
+
+		FKinHit Hit;
+		KIN_CHECK(World.SweepBox(Sweep, Hit));
+		KIN_CHECK(Hit.Distance == 0.0f);
+		KIN_CHECK(IsNear(Hit.Normal.X, 1.0f, 1.e-5f));
+		KIN_CHECK(IsNear(Hit.Normal.Y, 0.0f, 1.e-5f));
+		KIN_CHECK(IsNear(Hit.Normal.Z, 0.0f, 1.e-5f));
+
+		// 離れていれば重なりとは扱わず、面までの距離と面の法線を返す
+		Sweep.Start = FKinVector(-200.0f, 0.0f, 0.0f);
+		Sweep.End = FKinVector(0.0f, 0.0f, 0.0f);
+		KIN_CHECK(World.SweepBox(Sweep, Hit));
+		KIN_CHECK(IsNear(Hit.Distance, 200.0f - 50.0f - MOVE_BOX_HALF, 1.e-3f));
+		KIN_CHECK(IsNear(Hit.Normal.X, -1.0f, 1.e-5f));
+
+		FKinematicsBodies Bodies;
+		const int32_t Body = AddBody(Bodies, FKinVector(10.0f, 0.0f, 0.0f), false);
+		Bodies.Flags[Body] |= EBodyFlags::PhysicsEnabled;
+		Bodies.DesiredMoves[Body] = FKinVector(-30.0f, 0.0f, 0.0f);
+
+		MoveAndSlide(Bodies, Body, World);
+		KIN_CHECK(Bodies.Locations[Body].X == 10.0f);
+		KIN_CHECK(Bodies.Locations[Body].Y == 0.0f);
+		KIN_CHECK(Bodies.Locations[Body].Z == 0.0f);
+
+		Bodies.DesiredMoves[Body] = FKinVector(30.0f, 0.0f, 0.0f);
+		MoveAndSlide(Bodies, Body, World);
+		KIN_CHECK(IsNear(Bodies.Locations[Body].X, 40.0f, 1.e-4f));
+	}
+}
+
+int main()
+{
+	TestLanding();
+	TestLandingLatchedAcrossSubSteps();
+	TestJumpFromContact();
+	TestCeilingHit();
+	TestWallSlide();
+	TestForceDecay();
+	TestForceFieldBlockedBodies();
+	TestStartPenetration();
+
+	std::printf("checks=%d failures=%d\n", NumChecks, NumFailures);
+	return NumFailures == 0 ? 0 : 1;
+}
@@ -0,0 +1,189 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+// リアルタイムのオンセット検出（Logic/Sound/OnsetDetector）をWAVファイルでエディタ無しに確認するツール
+// ゲームモジュールには含めず、単体のプログラムとしてビルドする
+//
+//   g++ -O2 -std=c++17 -I<インクルードルート> OnsetDetectorBenchmark.cpp OnsetDetector.cpp BeatAnalysis.cpp
+//   ./a.out <WAVファイル> [基準の時刻ファイル] [ブロックの長さ=1024]
+//
+// オーディオスレッドと同じように、ブロックの長さずつ音声を渡して検出する
+// 基準の時刻（1行に1つ、秒）と照らし合わせて、検出率・時刻のずれ・検出の遅れを出力する
+// 基準の時刻ファイルを省略した場合は、オフラインの解析（AnalyzeBeats）で求めた拍を基準にする
+// 検出の遅れはブロックの最後まで受け取ってから通知する前提で、ブロックの長さ分の待ちも含める
+
+#include "Logic/Sound/OnsetDetector.h"
+#include "Logic/Sound/BeatAnalysis.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+using namespace Beat;
+
+namespace
+{
+	static constexpr int32_t DEFAULT_BLOCK_SIZE = 1024;
+
+	// 1ブロックで検出するオンセットの上限（オーディオスレッドと同じ固定長）
+	static constexpr int32_t MAX_ONSETS_PER_BLOCK = 16;
+
+	// 基準の時刻と同じオンセットとみなす範囲（秒）
+	static constexpr double MATCH_TOLERANCE = 0.05;
+
+	bool LoadWav(const char* Path, FMonoAudio& OutAudio)
+	{
+		std::ifstream File(Path, std::ios::binary);
+		if (!File)
+			return false;
+
+		const std::vector<uint8_t> Data((std::istreambuf_iterator<char>(File)), std::istreambuf_iterator<char>());
+		return DecodeWav(Data.data(), Data.size(), OutAudio);
+	}
+
+	std::vector<double> LoadTimes(const char* Path)
+	{
+		std::vector<double> Times;
+		std::ifstream File(Path);
+		double Time = 0.0;
+		while (File >> Time)
+		{
+			Times.push_back(Time);
+		}
+		std::sort(Times.begin(), Times.end());
+		return Times;
+	}
+
+	double Percentile(std::vector<double> Values, double Ratio)
+	{
+		if (Values.empty())
+			return 0.0;
+
+		std::sort(Values.begin(), Values.end());
+		const size_t Index = std::min(Values.size() - 1, static_cast<size_t>(Ratio * static_cast<double>(Values.size())));
+		return Values[Index];
+	}
+}
+
+// 処理の流れ:
+// 1. WAVを読み込み、基準の時刻を用意する
+// 2. ブロックの長さずつ検出器に渡し、1ブロックあたりの処理時間を計る
+// 3. 検出したオンセットを基準の時刻と対応付けて、検出率・ずれ・遅れを出力する
+int main(int Argc, char** Argv)
+{
+	if (Argc < 2)
+	{
+		std::fprintf(stderr, "usage: %s <wav> [reference times] [block size=%d]\n", Argv[0], DEFAULT_BLOCK_SIZE);
+		return 1;
+	}
+
+	FMonoAudio Audio;
+	if (!LoadWav(Argv[1], Audio))
+	{
+		std::fprintf(stderr, "cannot read %s\n", Argv[1]);
+		return 1;
+	}
+
+	std::vector<double> References;
+	if (Argc >= 3)
+	{
+		References = LoadTimes(Argv[2]);
+	}
+	else
+	{
+		for (float Time : AnalyzeBeats(Audio).BeatTimes)
+		{
+			References.push_back(Time);
+		}
+	}
+
+	const int32_t BlockSize = Argc >= 4 ? std::max(1, std::atoi(Argv[3])) : DEFAULT_BLOCK_SIZE;
+
+	FOnsetDetector Detector;
+	if (!Detector.Init(Audio.SampleRate))
+	{
+		std::fprintf(stderr, "unsupported sample rate %d\n", Audio.SampleRate);
+		return 1;
+	}
+
+	std::vector<FOnset> Onsets;
+	FOnset BlockOnsets[MAX_ONSETS_PER_BLOCK];
+	double WorstBlockSeconds = 0.0;
+	double TotalSeconds = 0.0;
+	const int32_t NumSamples = static_cast<int32_t>(Audio.Samples.size());
+
+	for (int32_t Start = 0; Start < NumSamples; Start += BlockSize)
+	{
+		const int32_t Length = std::min(BlockSize, NumSamples - Start);
+
+		const auto Begin = std::chrono::steady_clock::now();
+		const int32_t Found = Detector.Process(Audio.Samples.data() + Start, Length, 1, BlockOnsets, MAX_ONSETS_PER_BLOCK);
+		const double Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - Begin).count();
+
+		WorstBlockSeconds = std::max(WorstBlockSeconds, Seconds);
+		TotalSeconds += Seconds;
+
+		for (int32_t i = 0; i < Found; ++i)
+		{
+			// ブロックの最後まで受け取ってから通知される
+			BlockOnsets[i].DetectedSample = Start + Length;
+			Onsets.push_back(BlockOnsets[i]);
+		}
+	}
+
+	// 基準の時刻ごとに、範囲内で最も近いオンセットを対応付ける
+	const double SampleRate = static_cast<double>(Audio.SampleRate);
+	std::vector<bool> Used(Onsets.size(), false);
+	std::vector<double> Errors;
+	std::vector<double> AbsErrors;
+	std::vector<double> Latencies;
+	for (double Reference : References)
+	{
+		int32_t Best = -1;
+		double BestDistance = MATCH_TOLERANCE;
+		for (size_t i = 0; i < Onsets.size(); ++i)
+		{
+			const double Distance = std::abs(Onsets[i].OnsetSample / SampleRate - Reference);
+			if (!Used[i] && Distance <= BestDistance)
+			{
+				Best = static_cast<int32_t>(i);
+				BestDistance = Distance;
+			}
+		}
+		if (Best < 0)
+			continue;
+
+		Used[Best] = true;
+		Errors.push_back(Onsets[Best].OnsetSample / SampleRate - Reference);
+		AbsErrors.push_back(std::abs(Errors.back()));
+		Latencies.push_back(Onsets[Best].DetectedSample / SampleRate - Reference);
+	}
+
+	double MeanError = 0.0;
+	for (double Error : Errors)
+	{
+		MeanError += Error;
+	}
+	MeanError = Errors.empty() ? 0.0 : MeanError / static_cast<double>(Errors.size());
+
+	const double Duration = NumSamples / SampleRate;
+	const double NumBlocks = std::ceil(static_cast<double>(NumSamples) / BlockSize);
+
+	std::printf("file            %s (%d Hz, %.2f s)\n", Argv[1], Audio.SampleRate, Duration);
+	std::printf("block           %d samples (%.2f ms)\n", BlockSize, BlockSize * 1000.0 / SampleRate);
+	std::printf("onsets          %zu detected, %zu reference (%s)\n", Onsets.size(), References.size(), Argc >= 3 ? Argv[2] : "offline beats");
+	std::printf("matched         %zu (recall %.1f%%, precision %.1f%%)\n", Errors.size(),
+		References.empty() ? 0.0 : 100.0 * Errors.size() / References.size(),
+		Onsets.empty() ? 0.0 : 100.0 * Errors.size() / Onsets.size());
+	std::printf("timing error    mean %+.2f ms, p95 |%.2f| ms\n", MeanError * 1000.0, Percentile(AbsErrors, 0.95) * 1000.0);
+	std::printf("latency         algorithm %.2f ms, median %.2f ms, p95 %.2f ms, max %.2f ms\n",
+		Detector.GetAlgorithmLatency() * 1000.0 / SampleRate,
+		Percentile(Latencies, 0.5) * 1000.0, Percentile(Latencies, 0.95) * 1000.0, Percentile(Latencies, 1.0) * 1000.0);
+	std::printf("process         mean %.2f us/block, worst %.2f us/block, %.1fx realtime\n",
+		TotalSeconds * 1e6 / NumBlocks, WorstBlockSeconds * 1e6, TotalSeconds > 0.0 ? Duration / TotalSeconds : 0.0);
+	return 0;
+}
@@ -0,0 +1,382 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+// セーブデータのバイナリ形式（Logic/Save/SaveFormat）の読み書きと、壊れたファイルの拒否を確認するプログラム
+// ゲームモジュールには含めず、ベンチマークと同様に単体のプログラムとしてビルドする
+//
+//   g++ -O2 -std=c++17 -I<インクルードルート> SaveFormatTests.cpp SaveFormat.cpp
+//   ./a.out
+//
+// 失敗した確認を全て表示し、1つでも失敗すれば終了コード 1 を返す
+
+#include "Logic/Save/SaveFormat.h"
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace SaveFormat;
+
+namespace
+{
+	// SaveFormat.cpp と同じタグ（テストでファイルを組み立てるのに使う）
+	static constexpr uint16_t TAG_STAGE = 1;
+	static constexpr uint16_t TAG_STAGE_KEY = 1;
+	static constexpr uint16_t TAG_STAGE_CLEARED = 2;
+	static constexpr uint16_t TAG_STAGE_CLEAR_RANK = 3;
+	static constexpr uint16_t TAG_STAGE_DIFFICULTY = 4;
+	static constexpr uint16_t TAG_VOLUME_BGM = 1;
+	static constexpr uint16_t TAG_VOLUME_SE = 2;
+
+	// どの読み込み側も知らないタグ
+	static constexpr uint16_t TAG_UNKNOWN = 0x7FFF;
+
+	// ヘッダーの中の位置
+	static constexpr size_t VERSION_OFFSET = 4;
+	static constexpr size_t CRC_OFFSET = 16;
+
+	int32_t NumChecks = 0;
+	int32_t NumFailures = 0;
+
+	// NDEBUG でも無効にならないよう assert の代わりに使う
+	#define SAVE_CHECK(Condition) Check((Condition), #Condition, __FILE__, __LINE__)
+
+	void Check(bool bPassed, const char* Expression, const char* File, int Line)
+	{
+		++NumChecks;
+		if (!bPassed)
+		{
+			++NumFailures;
+			std::fprintf(stderr, "%s:%d: check failed: %s\n", File, Line, Expression);
+		}
+	}
+
+	// =======================
+	// ファイルの組み立て
+	// =======================
+
+	void AppendU16(std::vector<uint8_t>& Out, uint16_t Value)
+	{
+		Out.push_back(static_cast<uint8_t>(Value));
+		Out.push_back(static_cast<uint8_t>(Value >> 8));
+	}
+
+	void AppendU32(std::vector<uint8_t>& Out, uint32_t Value)
+	{
+		for (int32_t i = 0; i < 4; ++i)
+		{
+			Out.push_back(static_cast<uint8_t>(Value >> (i * 8)));
+		}
+	}
+
+	void AppendField(std::vector<uint8_t>& Out, uint16_t Tag, const std::vector<uint8_t>& Value)
+	{
+		AppendU16(Out, Tag);
+		AppendU32(Out, static_cast<uint32_t>(Value.size()));
+		Out.insert(Out.end(), Value.begin(), Value.end());
+	}
+
+	std::vector<uint8_t> U32Value(uint32_t Value)
+	{
+		std::vector<uint8_t> Bytes;
+		AppendU32(Bytes, Value);
+		return Bytes;
+	}
+
+	std::vector<uint8_t> F32Value(float Value)
+	{
+		uint32_t Bits = 0;
+		std::memcpy(&Bits, &Value, sizeof(Bits));
+		return U32Value(Bits);
+	}
+
+	std::vector<uint8_t> StringValue(const std::string& Value)
+	{
+		return std::vector<uint8_t>(Value.begin(), Value.end());
+	}
+
+	// 本体にヘッダーを付けてファイルにする
+	std::vector<uint8_t> MakeFile(EFileKind Kind, const std::vector<uint8_t>& Payload, uint16_t FormatVersion = FORMAT_VERSION)
+	{
+		std::vector<uint8_t> Bytes;
+		AppendU32(Bytes, MAGIC);
+		AppendU16(Bytes, FormatVersion);
+		AppendU16(Bytes, SCHEMA_VERSION);
+		AppendU16(Bytes, static_cast<uint16_t>(Kind));
+		AppendU16(Bytes, 0);
+		AppendU32(Bytes, static_cast<uint32_t>(Payload.size()));
+		AppendU32(Bytes, Crc32(Payload.data(), Payload.size()));
+		Bytes.insert(Bytes.end(), Payload.begin(), Payload.end());
+		return Bytes;
+	}
+
+	// 1バイトずつ求める CRC32（Crc32 の8バイトずつ進める処理と比べる）
+	uint32_t ReferenceCrc32(const uint8_t* Data, size_t Size)
+	{
+		uint32_t Crc = 0xFFFFFFFFu;
+		for (size_t i = 0; i < Size; ++i)
+		{
+			Crc ^= Data[i];
+			for (int32_t Bit = 0; Bit < 8; ++Bit)
+			{
+				Crc = (Crc & 1u) ? (Crc >> 1) ^ 0xEDB88320u : Crc >> 1;
+			}
+		}
+		return Crc ^ 0xFFFFFFFFu;
+	}
+
+	std::vector<FStageRecord> MakeStages()
+	{
+		std::vector<FStageRecord> Stages(3);
+		Stages[0].Key = "Stage_1";
+		Stages[0].bCleared = true;
+		Stages[0].ClearRank = 2;
+		Stages[0].Difficulty = 1;
+		Stages[0].Title = "\xE3\x81\xAF\xE3\x81\x98\xE3\x81\xBE\xE3\x82\x8A"; // UTF-8 の「はじまり」
+		Stages[1].Key = "Stage_2";
+		Stages[1].ClearRank = -1;
+		Stages[1].Difficulty = 3;
+		Stages[2].Key = "";
+		Stages[2].Title = std::string("with\0null", 9);
+		return Stages;
+	}
+
+	bool IsSameStage(const FStageRecord& A, const FStageRecord& B)
+	{
+		return A.Key == B.Key && A.bCleared == B.bCleared && A.ClearRank == B.ClearRank
+			&& A.Difficulty == B.Difficulty && A.Title == B.Title;
+	}
+
+	// =======================
+	// テスト
+	// =======================
+
+	// "123456789" の CRC32 は 0xCBF43926（IEEE の確認値）で、8バイトずつの処理と1バイトずつの処理が一致する
+	void TestCrc32()
+	{
+		const char* CheckInput = "123456789";
+		SAVE_CHECK(Crc32(reinterpret_cast<const uint8_t*>(CheckInput), std::strlen(CheckInput)) == 0xCBF43926u);
+		SAVE_CHECK(Crc32(nullptr, 0) == 0u);
+
+		std::vector<uint8_t> Bytes(67);
+		for (size_t i = 0; i < Bytes.size(); ++i)
+		{
+			Bytes[i] = static_cast<uint8_t>(i * 37 + 11);
+		}
+
+		bool bMatched = true;
+		for (size_t Size = 0; Size <= Bytes.size(); ++Size)
+		{
+			bMatched &= Crc32(Bytes.data(), Size) == ReferenceCrc32(Bytes.data(), Size);
+		}
+		SAVE_CHECK(bMatched);
+	}
+
+	// 書き出したものを読み込むと同じ内容に戻る
+	void TestRoundTrip()
+	{
+		const std::vector<FStageRecord> Stages = MakeStages();
+		std::vector<uint8_t> Bytes;
+		WriteStageSave(Stages, Bytes);
+
+		std::vector<FStageRecord> Loaded;
+		SAVE_CHECK(ReadStageSave(Bytes.data(), Bytes.size(), Loaded) == EReadResult::Ok);
+		SAVE_CHECK(Loaded.size() == Stages.size());
+		bool bSame = Loaded.size() == Stages.size();
+		for (size_t i = 0; bSame && i < Stages.size(); ++i)
+		{
+			bSame = IsSameStage(Loaded[i], Stages[i]);
+		}
+		SAVE_CHECK(bSame);
+
+		// ステージが無くても読める
+		WriteStageSave({}, Bytes);
+		SAVE_CHECK(Bytes.size() == HEADER_SIZE);
+		SAVE_CHECK(ReadStageSave(Bytes.data(), Bytes.size(), Loaded) == EReadResult::Ok);
+		SAVE_CHECK(Loaded.empty());
+
+		FVolumeRecord Volume;
+		Volume.BGMVolume = 0.25f;
+		Volume.SEVolume = 0.0f;
+		WriteVolumeSave(Volume, Bytes);
+
+		FVolumeRecord LoadedVolume;
+		SAVE_CHECK(ReadVolumeSave(Bytes.data(), Bytes.size(), LoadedVolume) == EReadResult::Ok);
+		SAVE_CHECK(LoadedVolume.BGMVolume == 0.25f);
+		SAVE_CHECK(LoadedVolume.SEVolume == 0.0f);
+
+		// 種類の違うファイルは読まない
+		SAVE_CHECK(ReadStageSave(Bytes.data(), Bytes.size(), Loaded) == EReadResult::WrongKind);
+	}
+
+	// 知らないタグはファイルの直下でもステージの中でも読み飛ばす（新しいスキーマのファイルを古い読み込み側で読める）
+	void TestUnknownTagSkipped()
+	{
+		std::vector<uint8_t> Stage;
+		AppendField(Stage, TAG_UNKNOWN, StringValue("future field"));
+		AppendField(Stage, TAG_STAGE_KEY, StringValue("Stage_1"));
+		AppendField(Stage, TAG_STAGE_CLEARED, { 1 });
+		AppendField(Stage, TAG_UNKNOWN, {});
+		AppendField(Stage, TAG_STAGE_DIFFICULTY, U32Value(4));
+
+		std::vector<uint8_t> Payload;
+		AppendField(Payload, TAG_UNKNOWN, U32Value(123));
+		AppendField(Payload, TAG_STAGE, Stage);
+		AppendField(Payload, TAG_UNKNOWN, StringValue("trailing"));
+		const std::vector<uint8_t> Bytes = MakeFile(EFileKind::Stage, Payload);
+
+		std::vector<FStageRecord> Loaded;
+		SAVE_CHECK(ReadStageSave(Bytes.data(), Bytes.size(), Loaded) == EReadResult::Ok);
+		SAVE_CHECK(Loaded.size() == 1);
+		if (Loaded.size() == 1)
+		{
+			SAVE_CHECK(Loaded[0].Key == "Stage_1");
+			SAVE_CHECK(Loaded[0].bCleared);
+			SAVE_CHECK(Loaded[0].Difficulty == 4);
+		}
+
+		std::vector<uint8_t> VolumePayload;
+		AppendField(VolumePayload, TAG_UNKNOWN, F32Value(9.0f));
+		AppendField(VolumePayload, TAG_VOLUME_SE, F32Value(0.5f));
+		const std::vector<uint8_t> VolumeBytes = MakeFile(EFileKind::Volume, VolumePayload);
+
+		FVolumeRecord Volume;
+		SAVE_CHECK(ReadVolumeSave(VolumeBytes.data(), VolumeBytes.size(), Volume) == EReadResult::Ok);
+		SAVE_CHECK(Volume.BGMVolume == FVolumeRecord().BGMVolume);
+		SAVE_CHECK(Volume.SEVolume == 0.5f);
+	}
+
+	// 大きさが合わない値は読まずに既定値のままにする（型を変えた新しいフィールドと区別できないため）
+	void TestWrongSizeFieldKeepsDefault()
+	{
+		std::vector<uint8_t> Stage;
+		AppendField(Stage, TAG_STAGE_KEY, StringValue("Stage_1"));
+		AppendField(Stage, TAG_STAGE_CLEARED, { 1, 0 });
+		AppendField(Stage, TAG_STAGE_CLEAR_RANK, { 5, 0 });
+		AppendField(Stage, TAG_STAGE_DIFFICULTY, { 1, 0, 0, 0, 0, 0, 0, 0 });
+
+		std::vector<uint8_t> Payload;
+		AppendField(Payload, TAG_STAGE, Stage);
+		const std::vector<uint8_t> Bytes = MakeFile(EFileKind::Stage, Payload);
+
+		const FStageRecord Default;
+		std::vector<FStageRecord> Loaded;
+		SAVE_CHECK(ReadStageSave(Bytes.data(), Bytes.size(), Loaded) == EReadResult::Ok);
+		SAVE_CHECK(Loaded.size() == 1);
+		if (Loaded.size() == 1)
+		{
+			SAVE_CHECK(Loaded[0].Key == "Stage_1");
+			SAVE_CHECK(Loaded[0].bCleared == Default.bCleared);
+			SAVE_CHECK(Loaded[0].ClearRank == Default.ClearRank);
+			SAVE_CHECK(Loaded[0].Difficulty == Default.Difficulty);
+		}
+
+		std::vector<uint8_t> VolumePayload;
+		AppendField(VolumePayload, TAG_VOLUME_BGM, { 0, 0 });
+		AppendField(VolumePayload, TAG_VOLUME_SE, F32Value(0.75f));
+		const std::vector<uint8_t> VolumeBytes = MakeFile(EFileKind::Volume, VolumePayload);
+
+		FVolumeRecord Volume;
+		SAVE_CHECK(ReadVolumeSave(VolumeBytes.data(), VolumeBytes.size(), Volume) == EReadResult::Ok);
+		SAVE_CHECK(Volume.BGMVolume == FVolumeRecord().BGMVolume);
+		SAVE_CHECK(Volume.SEVolume == 0.75f);
+	}
+
+	// 途中で切れたファイルはどこで切れても読まない
+	void TestTruncationRejected()
+	{
+		std::vector<uint8_t> Bytes;
+		WriteStageSave(MakeStages(), Bytes);
+
+		bool bAllRejected = true;
+		std::vector<FStageRecord> Loaded;
+		for (size_t Size = 0; Size < Bytes.size(); ++Size)
+		{
+			bAllRejected &= ReadStageSave(Bytes.data(), Size, Loaded) != EReadResult::Ok && Loaded.empty();
+		}
+		SAVE_CHECK(bAllRejected);
+
+		FVolumeRecord Volume;
+		WriteVolumeSave(Volume, Bytes);
+		bAllRejected = true;
+		for (size_t Size = 0; Size < Bytes.size(); ++Size)
+		{
+			bAllRejected &= ReadVolumeSave(Bytes.data(), Size, Volume) != EReadResult::Ok;
+		}
+		SAVE_CHECK(bAllRejected);
+
+		// 本体のCRCは合っていても、フィールドが本体の外にはみ出していれば読まない
+		std::vector<uint8_t> Payload;
+		AppendU16(Payload, TAG_STAGE);
+		AppendU32(Payload, 100);
+		AppendU16(Payload, TAG_STAGE_KEY);
+		const std::vector<uint8_t> Overrun = MakeFile(EFileKind::Stage, Payload);
+		SAVE_CHECK(ReadStageSave(Overrun.data(), Overrun.size(), Loaded) == EReadResult::Corrupt);
+		SAVE_CHECK(Loaded.empty());
+	}
+
+	// 本体とCRCのどのビットが反転しても読まない
+	void TestBitFlipRejected()
+	{
+		std::vector<uint8_t> Bytes;
+		WriteStageSave(MakeStages(), Bytes);
+
+		bool bAllRejected = true;
+		std::vector<FStageRecord> Loaded;
+		for (size_t Offset = CRC_OFFSET; Offset < Bytes.size(); ++Offset)
+		{
+			for (int32_t Bit = 0; Bit < 8; ++Bit)
+			{
+				std::vector<uint8_t> Flipped = Bytes;
+				Flipped[Offset] ^= static_cast<uint8_t>(1u << Bit);
+				bAllRejected &= ReadStageSave(Flipped.data(), Flipped.size(), Loaded) == EReadResult::ChecksumMismatch;
+			}
+		}
+		SAVE_CHECK(bAllRejected);
+
+		// 識別子が違えばヘッダーから読まない
+		std::vector<uint8_t> BadMagic = Bytes;
+		BadMagic[0] ^= 1u;
+		SAVE_CHECK(ReadStageSave(BadMagic.data(), BadMagic.size(), Loaded) == EReadResult::BadHeader);
+	}
+
+	// 新しい形式のバージョンは、本体が読めても読まない（古いスキーマの追加とは違い、並べ方が変わっているため）
+	void TestNewerFormatRejected()
+	{
+		std::vector<uint8_t> Payload;
+		AppendField(Payload, TAG_VOLUME_BGM, F32Value(0.5f));
+		const std::vector<uint8_t> Newer = MakeFile(EFileKind::Volume, Payload, FORMAT_VERSION + 1);
+
+		FVolumeRecord Volume;
+		Volume.BGMVolume = 0.1f;
+		SAVE_CHECK(ReadVolumeSave(Newer.data(), Newer.size(), Volume) == EReadResult::UnsupportedVersion);
+		SAVE_CHECK(Volume.BGMVolume == FVolumeRecord().BGMVolume);
+
+		// 書き出したファイルのバージョンを上げても同じ
+		std::vector<uint8_t> Bytes;
+		WriteStageSave(MakeStages(), Bytes);
+		Bytes[VERSION_OFFSET] = static_cast<uint8_t>(FORMAT_VERSION + 1);
+		std::vector<FStageRecord> Loaded;
+		SAVE_CHECK(ReadStageSave(Bytes.data(), Bytes.size(), Loaded) == EReadResult::UnsupportedVersion);
+		SAVE_CHECK(Loaded.empty());
+
+		// 同じバージョンなら読める
+		const std::vector<uint8_t> Current = MakeFile(EFileKind::Volume, Payload);
+		SAVE_CHECK(ReadVolumeSave(Current.data(), Current.size(), Volume) == EReadResult::Ok);
+		SAVE_CHECK(Volume.BGMVolume == 0.5f);
+	}
+}
+
+int main()
+{
+	TestCrc32();
+	TestRoundTrip();
+	TestUnknownTagSkipped();
+	TestWrongSizeFieldKeepsDefault();
+	TestTruncationRejected();
+	TestBitFlipRejected();
+	TestNewerFormatRejected();
+
+	std::printf("checks=%d failures=%d\n", NumChecks, NumFailures);
+	return NumFailures == 0 ? 0 : 1;
+}
@@ -0,0 +1,546 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Logic/Sound/BeatAnalysis.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace Beat
+{
+	namespace
+	{
+		static constexpr double PI = 3.14159265358979323846;
+
+		// WAVの形式
+		static constexpr uint16_t WAVE_FORMAT_PCM = 1;
+		static constexpr uint16_t WAVE_FORMAT_IEEE_FLOAT = 3;
+		static constexpr uint16_t WAVE_FORMAT_EXTENSIBLE = 0xFFFE;
+
+		// 振幅を対数で圧縮する時の強さ（大きいほど小さな音の変化も拾う）
+		static constexpr float LOG_COMPRESSION = 100.0f;
+
+		// スペクトルフラックスを求める最低周波数
+		// 帯域ごとにまとめることで、広い帯域に広がるハイハット等が低音の拍より強くならないようにする
+		static constexpr float MIN_BAND_FREQUENCY = 30.0f;
+
+		// オンセットから引く移動平均の片側の幅（窓の数）
+		static constexpr int32_t ONSET_MEAN_RADIUS = 16;
+
+		// テンポ推定で優先テンポからの離れ具合に掛ける幅（オクターブ）
+		static constexpr float TEMPO_PRIOR_OCTAVES = 1.0f;
+
+		// テンポ推定の前にオンセットをならす片側の幅（窓の数）
+		// 拍の間隔が窓の整数倍でないと自己相関の山が隣の遅れに割れ、倍の遅れの方が高くなるのを防ぐ
+		static constexpr int32_t TEMPO_SMOOTH_RADIUS = 2;
+
+		// テンポ推定で倍の遅れ（半分のテンポ）の自己相関に掛ける重み
+		static constexpr double TEMPO_HARMONIC_WEIGHT = 0.5;
+
+		// 半分の遅れの自己相関がこの割合以上あれば、倍のテンポを選ぶ
+		// 裏拍が表拍とほぼ同じ強さで鳴っているなら、それも拍とみなす（対数圧縮で弱い裏拍も強めに出るため高めにする）
+		static constexpr double TEMPO_DOUBLE_RATIO = 0.9;
+
+		uint16_t ReadU16(const uint8_t* Data)
+		{
+			return static_cast<uint16_t>(Data[0] | (Data[1] << 8));
+		}
+
+		uint32_t ReadU32(const uint8_t* Data)
+		{
+			return static_cast<uint32_t>(Data[0]) | (static_cast<uint32_t>(Data[1]) << 8) | (static_cast<uint32_t>(Data[2]) << 16) | (static_cast<uint32_t>(Data[3]) << 24);
+		}
+
+		// 1サンプルを -1～1 の値として読む
+		float ReadSample(const uint8_t* Data, uint16_t Format, uint16_t BitsPerSample)
+		{
+			if (Format == WAVE_FORMAT_IEEE_FLOAT)
+			{
+				float Value;
+				std::memcpy(&Value, Data, sizeof(float));
+				return Value;
+			}
+
+			switch (BitsPerSample)
+			{
+			case 8:
+				return (static_cast<float>(Data[0]) - 128.0f) / 128.0f;
+			case 16:
+				return static_cast<float>(static_cast<int16_t>(ReadU16(Data))) / 32768.0f;
+			case 24:
+			{
+				int32_t Value = Data[0] | (Data[1] << 8) | (Data[2] << 16);
+				if (Value & 0x800000) Value |= ~0xFFFFFF;
+				return static_cast<float>(Value) / 8388608.0f;
+			}
+			case 32:
+				return static_cast<float>(static_cast<int32_t>(ReadU32(Data))) / 2147483648.0f;
+			default:
+				return 0.0f;
+			}
+		}
+
+		bool IsPowerOfTwo(size_t Value)
+		{
+			return Value != 0 && (Value & (Value - 1)) == 0;
+		}
+	}
+
+	// 処理の流れ:
+	// 1. RIFF/WAVE ヘッダを確認
+	// 2. チャンクを順に読み、fmt と data を探す
+	// 3. 形式が対応していれば、全チャンネルを平均してモノラルにする
+	bool DecodeWav(const uint8_t* Data, size_t Size, FMonoAudio& OutAudio)
+	{
+		if (!Data || Size < 12 || std::memcmp(Data, "RIFF", 4) != 0 || std::memcmp(Data + 8, "WAVE", 4) != 0)
+			return false;
+
+		uint16_t Format = 0;
+		uint16_t NumChannels = 0;
+		uint32_t SampleRate = 0;
+		uint16_t BitsPerSample = 0;
+		const uint8_t* SampleData = nullptr;
+		size_t SampleBytes = 0;
+
+		size_t Offset = 12;
+		while (Offset + 8 <= Size)
+		{
+			const uint8_t* Chunk = Data + Offset;
+			const size_t ChunkSize = ReadU32(Chunk + 4);
+			const size_t Available = std::min(ChunkSize, Size - Offset - 8);
+
+			if (std::memcmp(Chunk, "fmt ", 4) == 0 && Available >= 16)
+			{
+				Format = ReadU16(Chunk + 8);
+				NumChannels = ReadU16(Chunk + 10);
+				SampleRate = ReadU32(Chunk + 12);
+				BitsPerSample = ReadU16(Chunk + 22);
+
+				// 拡張形式は SubFormat の先頭2バイトが実際の形式
+				if (Format == WAVE_FORMAT_EXTENSIBLE && Available >= 26)
+				{
+					Format = ReadU16(Chunk + 8 + 24);
+				}
+			}
+			else if (std::memcmp(Chunk, "data", 4) == 0)
+			{
+				SampleData = Chunk + 8;
+				SampleBytes = Available;
+			}
+
+			// チャンクは2バイト境界に揃えられている
+			Offset += 8 + ChunkSize + (ChunkSize & 1);
+		}
+
+		const bool bSupportedFormat =
+			(Format == WAVE_FORMAT_PCM && (BitsPerSample == 8 || BitsPerSample == 16 || BitsPerSample == 24 || BitsPerSample == 32)) ||
+			(Format == WAVE_FORMAT_IEEE_FLOAT && BitsPerSample == 32);
+		if (!bSupportedFormat || !SampleData || NumChannels == 0 || SampleRate == 0)
+			return false;
+
+		const size_t BytesPerSample = BitsPerSample / 8;
+		const size_t BytesPerFrame = BytesPerSample * NumChannels;
+		const size_t NumFrames = SampleBytes / BytesPerFrame;
+
+		OutAudio.SampleRate = static_cast<int32_t>(SampleRate);
+		OutAudio.Samples.resize(NumFrames);
+
+		for (size_t i = 0; i < NumFrames; ++i)
+		{
+			const uint8_t* Frame = SampleData + i * BytesPerFrame;
+			float Sum = 0.0f;
+			for (uint16_t Channel = 0; Channel < NumChannels; ++Channel)
+			{
+				Sum += ReadSample(Frame + Channel * BytesPerSample, Format, BitsPerSample);
+			}
+			OutAudio.Samples[i] = Sum / static_cast<float>(NumChannels);
+		}
+		return true;
+	}
+
+	// 処理の流れ:
+	// 1. ビット反転の順に並べ替える
+	// 2. 長さ2から順にバタフライ演算を行う
+	void FFTInPlace(std::complex<float>* Values, size_t Num)
+	{
+		if (!Values || !IsPowerOfTwo(Num))
+			return;
+
+		for (size_t i = 1, j = 0; i < Num; ++i)
+		{
+			size_t Bit = Num >> 1;
+			for (; j & Bit; Bit >>= 1)
+			{
+				j ^= Bit;
+			}
+			j ^= Bit;
+
+			if (i < j)
+			{
+				std::swap(Values[i], Values[j]);
+			}
+		}
+
+		for (size_t Length = 2; Length <= Num; Length <<= 1)
+		{
+			const double Angle = -2.0 * PI / static_cast<double>(Length);
+			const std::complex<float> Step(static_cast<float>(std::cos(Angle)), static_cast<float>(std::sin(Angle)));
+
+			for (size_t Start = 0; Start < Num; Start += Length)
+			{
+				std::complex<float> Twiddle(1.0f, 0.0f);
+				for (size_t k = 0; k < Length / 2; ++k)
+				{
+					const std::complex<float> Even = Values[Start + k];
+					const std::complex<float> Odd = Values[Start + k + Length / 2] * Twiddle;
+					Values[Start + k] = Even + Odd;
+					Values[Start + k + Length / 2] = Even - Odd;
+					Twiddle *= Step;
+				}
+			}
+		}
+	}
+
+	void MakeHannWindow(float* OutWindow, size_t Num)
+	{
+		for (size_t i = 0; i < Num; ++i)
+		{
+			OutWindow[i] = static_cast<float>(0.5 - 0.5 * std::cos(2.0 * PI * static_cast<double>(i) / static_cast<double>(Num)));
+		}
+	}
+
+	// 処理の流れ:
+	// 1. 最低周波数からナイキスト周波数までを対数の間隔で分け、ビン番号に変換する
+	// 2. 低い帯域はビンが足りず同じ位置になるため、最低1ビンずつ割り当てる
+	void ComputeOnsetBandEdges(int32_t SampleRate, size_t FrameSize, size_t* OutEdges)
+	{
+		const size_t NumBins = FrameSize / 2;
+		const float BinFrequency = static_cast<float>(SampleRate) / static_cast<float>(FrameSize);
+		const float Nyquist = static_cast<float>(SampleRate) * 0.5f;
+		for (int32_t Band = 0; Band <= NUM_ONSET_BANDS; ++Band)
+		{
+			const float Frequency = MIN_BAND_FREQUENCY * std::pow(Nyquist / MIN_BAND_FREQUENCY, static_cast<float>(Band) / NUM_ONSET_BANDS);
+			const size_t Bin = static_cast<size_t>(std::round(Frequency / BinFrequency));
+			OutEdges[Band] = std::min(NumBins, std::max<size_t>(1, Bin));
+		}
+		for (int32_t Band = 1; Band <= NUM_ONSET_BANDS; ++Band)
+		{
+			OutEdges[Band] = std::min(NumBins, std::max(OutEdges[Band], OutEdges[Band - 1] + 1));
+		}
+	}
+
+	// 処理の流れ:
+	// 1. 帯域ごとに振幅を平均して対数で圧縮する
+	// 2. 前の窓から増えた分だけを足し合わせる
+	float ComputeBandFlux(const std::complex<float>* Spectrum, size_t FrameSize, const size_t* BandEdges, float* InOutMagnitudes)
+	{
+		const float Scale = LOG_COMPRESSION / static_cast<float>(FrameSize);
+
+		float Sum = 0.0f;
+		for (int32_t Band = 0; Band < NUM_ONSET_BANDS; ++Band)
+		{
+			const size_t Begin = BandEdges[Band];
+			const size_t End = BandEdges[Band + 1];
+			if (Begin >= End)
+				continue;
+
+			float BandSum = 0.0f;
+			for (size_t Bin = Begin; Bin < End; ++Bin)
+			{
+				BandSum += std::abs(Spectrum[Bin]);
+			}
+
+			const float Magnitude = std::log1p(Scale * BandSum / static_cast<float>(End - Begin));
+			Sum += std::max(0.0f, Magnitude - InOutMagnitudes[Band]);
+			InOutMagnitudes[Band] = Magnitude;
+		}
+		return Sum;
+	}
+
+	// 処理の流れ:
+	// 1. ハン窓を掛けた窓ごとにFFTし、帯域ごとのスペクトルフラックスを求める
+	// 2. 移動平均を引いて負の値を0にし、標準偏差で正規化する
+	std::vector<float> ComputeOnsetEnvelope(const FMonoAudio& Audio, const FBeatAnalysisSettings& Settings)
+	{
+		const size_t FrameSize = static_cast<size_t>(Settings.FrameSize);
+		const size_t HopSize = static_cast<size_t>(std::max(Settings.HopSize, 1));
+		if (!IsPowerOfTwo(FrameSize) || Audio.Samples.size() < FrameSize)
+			return {};
+
+		const size_t NumFrames = (Audio.Samples.size() - FrameSize) / HopSize + 1;
+
+		std::vector<float> Window(FrameSize);
+		MakeHannWindow(Window.data(), FrameSize);
+
+		size_t BandEdges[NUM_ONSET_BANDS + 1];
+		ComputeOnsetBandEdges(Audio.SampleRate, FrameSize, BandEdges);
+
+		std::vector<std::complex<float>> Spectrum(FrameSize);
+		float PrevMagnitudes[NUM_ONSET_BANDS] = {};
+		std::vector<float> Flux(NumFrames, 0.0f);
+
+		for (size_t Frame = 0; Frame < NumFrames; ++Frame)
+		{
+			const float* Samples = Audio.Samples.data() + Frame * HopSize;
+			for (size_t i = 0; i < FrameSize; ++i)
+			{
+				Spectrum[i] = std::complex<float>(Samples[i] * Window[i], 0.0f);
+			}
+			FFTInPlace(Spectrum.data(), FrameSize);
+
+			const float Sum = ComputeBandFlux(Spectrum.data(), FrameSize, BandEdges, PrevMagnitudes);
+
+			// 最初の窓は比べる相手が無いため0
+			Flux[Frame] = Frame == 0 ? 0.0f : Sum;
+		}
+
+		std::vector<float> Onsets(NumFrames, 0.0f);
+		double SumSquares = 0.0;
+		for (size_t Frame = 0; Frame < NumFrames; ++Frame)
+		{
+			const size_t Begin = Frame >= static_cast<size_t>(ONSET_MEAN_RADIUS) ? Frame - ONSET_MEAN_RADIUS : 0;
+			const size_t End = std::min(NumFrames, Frame + ONSET_MEAN_RADIUS + 1);
+
+			double Mean = 0.0;
+			for (size_t i = Begin; i < End; ++i)
+			{
+				Mean += Flux[i];
+			}
+			Mean /= static_cast<double>(End - Begin);
+
+			Onsets[Frame] = std::max(0.0f, Flux[Frame] - static_cast<float>(Mean));
+			SumSquares += static_cast<double>(Onsets[Frame]) * Onsets[Frame];
+		}
+
+		const double Deviation = std::sqrt(SumSquares / static_cast<double>(NumFrames));
+		if (Deviation > 0.0)
+		{
+			for (float& Onset : Onsets)
+			{
+				Onset = static_cast<float>(Onset / Deviation);
+			}
+		}
+		return Onsets;
+	}
+
+	namespace
+	{
+		// 遅れを中心に前後1窓の中で最大の自己相関（拍の間隔が窓の整数倍でなくても山を拾う）
+		double PeakCorrelation(const std::vector<double>& Correlations, size_t Lag)
+		{
+			double Peak = 0.0;
+			for (size_t i = Lag > 0 ? Lag - 1 : 0; i <= Lag + 1 && i < Correlations.size(); ++i)
+			{
+				Peak = std::max(Peak, Correlations[i]);
+			}
+			return Peak;
+		}
+	}
+
+	// 処理の流れ:
+	// 1. オンセットを三角窓でならす（山が隣の遅れに割れないように）
+	// 2. テンポの範囲とその倍の遅れまで自己相関を求める
+	// 3. 遅れごとに倍の遅れの自己相関も足し、優先テンポから離れるほど小さくなる重みを掛けた点数で最大を選ぶ
+	// 4. 半分の遅れが選んだ遅れと同じくらい強ければ、倍のテンポに切り替える（半分のテンポへの取り違えを防ぐ）
+	// 5. 選んだ遅れを前後の値から放物線で補間し、BPMに変換する
+	float EstimateTempo(const std::vector<float>& Onsets, float FrameRate, const FBeatAnalysisSettings& Settings)
+	{
+		if (Onsets.empty() || FrameRate <= 0.0f || Settings.MinBPM <= 0.0f || Settings.MaxBPM <= Settings.MinBPM)
+			return 0.0f;
+
+		const size_t MinLag = std::max<size_t>(1, static_cast<size_t>(std::floor(60.0f * FrameRate / Settings.MaxBPM)));
+		const size_t MaxLag = static_cast<size_t>(std::ceil(60.0f * FrameRate / Settings.MinBPM));
+		if (MaxLag + 1 >= Onsets.size())
+			return 0.0f;
+
+		const size_t NumFrames = Onsets.size();
+		std::vector<float> Smoothed(NumFrames, 0.0f);
+		for (size_t Frame = 0; Frame < NumFrames; ++Frame)
+		{
+			double Sum = 0.0;
+			double WeightSum = 0.0;
+			for (int32_t Offset = -TEMPO_SMOOTH_RADIUS; Offset <= TEMPO_SMOOTH_RADIUS; ++Offset)
+			{
+				const int64_t Index = static_cast<int64_t>(Frame) + Offset;
+				if (Index < 0 || Index >= static_cast<int64_t>(NumFrames))
+					continue;
+
+				const double Weight = TEMPO_SMOOTH_RADIUS + 1 - std::abs(Offset);
+				Sum += Weight * Onsets[static_cast<size_t>(Index)];
+				WeightSum += Weight;
+			}
+			Smoothed[Frame] = static_cast<float>(Sum / WeightSum);
+		}
+
+		// 倍の遅れが音声より長い場合は、求められる所までにする
+		const size_t MaxHarmonicLag = std::min(MaxLag * 2 + 2, NumFrames - 1);
+		std::vector<double> Correlations(MaxHarmonicLag + 1, 0.0);
+		for (size_t Lag = 1; Lag <= MaxHarmonicLag; ++Lag)
+		{
+			double Correlation = 0.0;
+			for (size_t i = 0; i + Lag < NumFrames; ++i)
+			{
+				Correlation += static_cast<double>(Smoothed[i]) * Smoothed[i + Lag];
+			}
+			Correlations[Lag] = Correlation / static_cast<double>(NumFrames - Lag);
+		}
+
+		std::vector<double> Scores(MaxLag + 2, 0.0);
+		for (size_t Lag = MinLag - 1; Lag <= MaxLag + 1; ++Lag)
+		{
+			if (Lag == 0)
+				continue;
+
+			const double Harmonic = Lag * 2 <= MaxHarmonicLag ? PeakCorrelation(Correlations, Lag * 2) : 0.0;
+			const double LagBPM = 60.0 * FrameRate / static_cast<double>(Lag);
+			const double Octaves = std::log2(LagBPM / Settings.PreferredBPM) / TEMPO_PRIOR_OCTAVES;
+			Scores[Lag] = (Correlations[Lag] + TEMPO_HARMONIC_WEIGHT * Harmonic) * std::exp(-0.5 * Octaves * Octaves);
+		}
+
+		size_t BestLag = MinLag;
+		for (size_t Lag = MinLag; Lag <= MaxLag; ++Lag)
+		{
+			if (Scores[Lag] > Scores[BestLag])
+			{
+				BestLag = Lag;
+			}
+		}
+
+		// 半分の遅れ（倍のテンポ）と比べる。半分の遅れの前後で最も強い遅れを使う
+		const size_t HalfLag = (BestLag + 1) / 2;
+		if (HalfLag >= MinLag + 1 && HalfLag + 1 <= MaxLag &&
+			PeakCorrelation(Correlations, HalfLag) >= TEMPO_DOUBLE_RATIO * PeakCorrelation(Correlations, BestLag))
+		{
+			BestLag = HalfLag;
+			for (size_t Lag = HalfLag - 1; Lag <= HalfLag + 1; ++Lag)
+			{
+				if (Scores[Lag] > Scores[BestLag])
+				{
+					BestLag = Lag;
+				}
+			}
+		}
+
+		double RefinedLag = static_cast<double>(BestLag);
+		const double Left = Scores[BestLag - 1];
+		const double Center = Scores[BestLag];
+		const double Right = Scores[BestLag + 1];
+		const double Denominator = Left - 2.0 * Center + Right;
+		if (Denominator < 0.0)
+		{
+			RefinedLag += 0.5 * (Left - Right) / Denominator;
+		}
+
+		return static_cast<float>(60.0 * FrameRate / RefinedLag);
+	}
+
+	// 処理の流れ（Ellis の動的計画法による拍の追跡）:
+	// 1. 各窓について、0.5～2拍前の窓から最も良い前の拍を選び、累積の点数を求める
+	//    （点数 = オンセットの強さ + 前の拍の点数 - テンポから外れた分の罰）
+	// 2. 最後の1拍分の中で点数が最大の窓から、前の拍を順にたどる
+	// 3. 窓の番号を秒に変換する
+	std::vector<float> TrackBeats(const std::vector<float>& Onsets, float FrameRate, float BPM, const FBeatAnalysisSettings& Settings)
+	{
+		if (Onsets.empty() || FrameRate <= 0.0f || BPM <= 0.0f)
+			return {};
+
+		const double Period = 60.0 * FrameRate / BPM;
+		const int32_t NumFrames = static_cast<int32_t>(Onsets.size());
+		const int32_t MinGap = std::max(1, static_cast<int32_t>(std::round(Period / 2.0)));
+		const int32_t MaxGap = std::max(MinGap, static_cast<int32_t>(std::round(Period * 2.0)));
+
+		std::vector<double> Scores(NumFrames, 0.0);
+		std::vector<int32_t> Previous(NumFrames, -1);
+
+		for (int32_t Frame = 0; Frame < NumFrames; ++Frame)
+		{
+			double BestScore = 0.0;
+			int32_t BestPrevious = -1;
+
+			for (int32_t Gap = MinGap; Gap <= MaxGap && Gap <= Frame; ++Gap)
+			{
+				const double Deviation = std::log(static_cast<double>(Gap) / Period);
+				const double Score = Scores[Frame - Gap] - Settings.TightnessPenalty * Deviation * Deviation;
+				if (BestPrevious == -1 || Score > BestScore)
+				{
+					BestScore = Score;
+					BestPrevious = Frame - Gap;
+				}
+			}
+
+			// 前の拍を選ぶと点数が下がる場合は、ここを最初の拍とする
+			if (BestPrevious != -1 && BestScore > 0.0)
+			{
+				Scores[Frame] = Onsets[Frame] + BestScore;
+				Previous[Frame] = BestPrevious;
+			}
+			else
+			{
+				Scores[Frame] = Onsets[Frame];
+			}
+		}
+
+		const int32_t SearchBegin = std::max(0, NumFrames - static_cast<int32_t>(std::ceil(Period)));
+		int32_t Frame = SearchBegin;
+		for (int32_t i = SearchBegin; i < NumFrames; ++i)
+		{
+			if (Scores[i] > Scores[Frame])
+			{
+				Frame = i;
+			}
+		}
+
+		std::vector<float> BeatTimes;
+		for (; Frame != -1; Frame = Previous[Frame])
+		{
+			BeatTimes.push_back(static_cast<float>(Frame / FrameRate));
+		}
+		std::reverse(BeatTimes.begin(), BeatTimes.end());
+		return BeatTimes;
+	}
+
+	FBeatAnalysisResult AnalyzeBeats(const FMonoAudio& Audio, const FBeatAnalysisSettings& Settings)
+	{
+		FBeatAnalysisResult Result;
+		if (Audio.SampleRate <= 0 || Settings.HopSize <= 0)
+			return Result;
+
+		const float FrameRate = static_cast<float>(Audio.SampleRate) / static_cast<float>(Settings.HopSize);
+		const std::vector<float> Onsets = ComputeOnsetEnvelope(Audio, Settings);
+
+		Result.BPM = EstimateTempo(Onsets, FrameRate, Settings);
+		Result.BeatTimes = TrackBeats(Onsets, FrameRate, Result.BPM, Settings);
+
+		// 自己相関の遅れは窓単位で粗いため、追跡した拍の間隔を直線で当てはめてBPMを求め直す
+		const size_t NumBeats = Result.BeatTimes.size();
+		if (NumBeats >= 2)
+		{
+			double MeanIndex = 0.0;
+			double MeanTime = 0.0;
+			for (size_t i = 0; i < NumBeats; ++i)
+			{
+				MeanIndex += static_cast<double>(i);
+				MeanTime += Result.BeatTimes[i];
+			}
+			MeanIndex /= static_cast<double>(NumBeats);
+			MeanTime /= static_cast<double>(NumBeats);
+
+			double Covariance = 0.0;
+			double Variance = 0.0;
+			for (size_t i = 0; i < NumBeats; ++i)
+			{
+				const double Index = static_cast<double>(i) - MeanIndex;
+				Covariance += Index * (Result.BeatTimes[i] - MeanTime);
+				Variance += Index * Index;
+			}
+
+			const double Interval = Covariance / Variance;
+			if (Interval > 0.0)
+			{
+				Result.BPM = static_cast<float>(60.0 / Interval);
+			}
+		}
+		return Result;
+	}
+}
@@ -0,0 +1,140 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+// エンジンに依存しないビート解析（オンセット検出・テンポ推定・拍の追跡）
+// UBeatMapCommandlet がBGMの音声からビートマップを作るのに使うほか、
+// エディタ無しのツールからも使えるように標準ライブラリだけで実装する
+
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Beat
+{
+	// =======================
+	// 音声データ
+	// =======================
+
+	// モノラルに変換した音声
+	struct FMonoAudio
+	{
+		std::vector<float> Samples;
+		int32_t SampleRate = 0;
+	};
+
+	/**
+	 * WAVファイルの中身をモノラルに変換する（PCM 8/16/24/32bit と 32bit float に対応）
+	 * @param Data ファイルの中身
+	 * @param Size ファイルのサイズ（バイト）
+	 * @param OutAudio 変換した音声
+	 * @return 対応していない形式や壊れたファイルの場合は false
+	 */
+	bool DecodeWav(const uint8_t* Data, size_t Size, FMonoAudio& OutAudio);
+
+	// =======================
+	// 周波数解析
+	// =======================
+
+	/**
+	 * 複素数列をその場でFFTする（要素数は2の累乗）
+	 * @param Values 変換する値（結果で上書き）
+	 * @param Num 要素数
+	 */
+	void FFTInPlace(std::complex<float>* Values, size_t Num);
+
+	/**
+	 * ハン窓を作る
+	 * @param OutWindow 窓の値を書き込む先（Num 個）
+	 * @param Num 窓の長さ
+	 */
+	void MakeHannWindow(float* OutWindow, size_t Num);
+
+	// スペクトルフラックスを求める帯域の数（対数の間隔で分ける）
+	static constexpr int32_t NUM_ONSET_BANDS = 24;
+
+	/**
+	 * スペクトルフラックスを求める帯域の境界を求める
+	 * @param SampleRate サンプリング周波数
+	 * @param FrameSize FFTの窓の長さ
+	 * @param OutEdges 各帯域の最初のビン（NUM_ONSET_BANDS + 1 個、最後の要素は終端）
+	 */
+	void ComputeOnsetBandEdges(int32_t SampleRate, size_t FrameSize, size_t* OutEdges);
+
+	/**
+	 * 1つの窓のスペクトルから、帯域ごとの対数振幅が前の窓より増えた分の合計を求める
+	 * @param Spectrum FFTした窓
+	 * @param FrameSize 窓の長さ
+	 * @param BandEdges ComputeOnsetBandEdges で求めた境界
+	 * @param InOutMagnitudes 前の窓の帯域ごとの対数振幅（NUM_ONSET_BANDS 個、この窓の値で上書きする）
+	 * @return スペクトルフラックス
+	 */
+	float ComputeBandFlux(const std::complex<float>* Spectrum, size_t FrameSize, const size_t* BandEdges, float* InOutMagnitudes);
+
+	// =======================
+	// ビート解析
+	// =======================
+
+	// 解析の設定
+	struct FBeatAnalysisSettings
+	{
+		// FFTの窓の長さと、窓をずらす幅（サンプル数）
+		int32_t FrameSize = 1024;
+		int32_t HopSize = 512;
+
+		// 推定するテンポの範囲
+		float MinBPM = 60.0f;
+		float MaxBPM = 200.0f;
+
+		// テンポ推定で優先するテンポ（この前後を好む）
+		float PreferredBPM = 120.0f;
+
+		// 拍の追跡で、テンポから外れることへの罰の強さ
+		float TightnessPenalty = 100.0f;
+	};
+
+	// 解析結果
+	struct FBeatAnalysisResult
+	{
+		float BPM = 0.0f;
+
+		// 拍の時刻（秒、昇順）
+		std::vector<float> BeatTimes;
+	};
+
+	/**
+	 * スペクトルフラックスによるオンセットの強さを求める（平均を引いて正規化済み）
+	 * @param Audio 解析する音声
+	 * @param Settings 解析の設定
+	 * @return 窓ごとのオンセットの強さ
+	 */
+	std::vector<float> ComputeOnsetEnvelope(const FMonoAudio& Audio, const FBeatAnalysisSettings& Settings);
+
+	/**
+	 * オンセットの自己相関からテンポを推定する
+	 * @param Onsets オンセットの強さ
+	 * @param FrameRate 1秒あたりの窓の数
+	 * @param Settings 解析の設定
+	 * @return BPM（推定できない場合は0）
+	 */
+	float EstimateTempo(const std::vector<float>& Onsets, float FrameRate, const FBeatAnalysisSettings& Settings);
+
+	/**
+	 * 動的計画法でオンセットに沿った拍の並びを求める
+	 * @param Onsets オンセットの強さ
+	 * @param FrameRate 1秒あたりの窓の数
+	 * @param BPM 推定したテンポ
+	 * @param Settings 解析の設定
+	 * @return 拍の時刻（秒、昇順）
+	 */
+	std::vector<float> TrackBeats(const std::vector<float>& Onsets, float FrameRate, float BPM, const FBeatAnalysisSettings& Settings);
+
+	/**
+	 * 音声からテンポと拍の時刻を求める
+	 * @param Audio 解析する音声
+	 * @param Settings 解析の設定
+	 * @return 解析結果（拍が見つからない場合は BeatTimes が空）
+	 */
+	FBeatAnalysisResult AnalyzeBeats(const FMonoAudio& Audio, const FBeatAnalysisSettings& Settings = FBeatAnalysisSettings());
+}
@@ -0,0 +1,251 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Logic/Sound/BeatClock.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Beat
+{
+	namespace
+	{
+		// BPM の下限（0 除算と極端な値を避ける）
+		static constexpr float MIN_BPM = 1.0f;
+
+		// マーカー間隔から測った1拍が予測とどれだけ離れていれば採用しないか（比率）
+		static constexpr double INTERVAL_TOLERANCE = 0.25;
+
+		// 測った1拍を予測へ反映する割合
+		static constexpr double INTERVAL_SMOOTHING = 0.2;
+
+		double ToBeatInterval(float BPM)
+		{
+			return 60.0 / std::max(BPM, MIN_BPM);
+		}
+	}
+
+	void FBeatClock::Start(double Now, float BPM)
+	{
+		AnchorTime = Now;
+		AnchorBeat = 0;
+		SongStartTime = Now;
+		BeatInterval = HasBeatTable()
+			? (BeatTable.back() - BeatTable.front()) / static_cast<double>(BeatTable.size() - 1)
+			: ToBeatInterval(BPM);
+		bHasConfirmedBeat = false;
+		bRunning = true;
+		++StartCount;
+	}
+
+	void FBeatClock::SetBeatTable(const float* Times, int32_t Num, double InLoopDuration)
+	{
+		BeatTable.clear();
+		if (Times && Num > 0)
+		{
+			BeatTable.assign(Times, Times + Num);
+		}
+
+		// 最後の拍より短い長さでは周回が重なるため、ループしないものとして扱う
+		LoopDuration = !BeatTable.empty() && InLoopDuration > BeatTable.back() ? InLoopDuration : 0.0;
+	}
+
+	// 処理の流れ:
+	// 1. 現在の拍数を求める
+	// 2. 現在時刻とその拍数を基準にして、以降は新しい間隔で進める
+	void FBeatClock::SetBPM(float BPM, double Now)
+	{
+		// 表がある場合のテンポは表の通り
+		if (HasBeatTable())
+			return;
+
+		if (!bRunning)
+		{
+			BeatInterval = ToBeatInterval(BPM);
+			return;
+		}
+
+		const double Position = GetBeatPosition(Now);
+		const double NewInterval = ToBeatInterval(BPM);
+
+		// 小数部の拍も残したまま基準を移す
+		const double Whole = std::floor(Position);
+		AnchorBeat = static_cast<int64_t>(Whole);
+		AnchorTime = Now - (Position - Whole) * NewInterval;
+		BeatInterval = NewInterval;
+
+		// 間隔が変わったので、前回のマーカーとの比較はやり直す
+		bHasConfirmedBeat = false;
+	}
+
+	// 処理の流れ:
+	// 1. 予測した拍数のうち最も近い拍に、鳴った時刻を合わせる
+	//    （表がある場合は曲の先頭の時刻をずらして合わせる）
+	// 2. 前回の補正から数拍の間隔が予測と近ければ、1拍の長さを少しずつ合わせる
+	// 3. 基準をこのビートに移す
+	void FBeatClock::ConfirmBeat(double BeatTime)
+	{
+		if (!bRunning)
+			return;
+
+		if (HasBeatTable())
+		{
+			const int64_t NearestBeat = static_cast<int64_t>(std::llround(GetBeatPosition(BeatTime)));
+			SongStartTime = BeatTime - GetSongBeatTime(NearestBeat);
+			return;
+		}
+
+		const int64_t NearestBeat = static_cast<int64_t>(std::llround(GetBeatPosition(BeatTime)));
+
+		if (bHasConfirmedBeat && NearestBeat > LastConfirmedBeat)
+		{
+			const double Measured = (BeatTime - LastConfirmedTime) / static_cast<double>(NearestBeat - LastConfirmedBeat);
+			if (std::fabs(Measured - BeatInterval) <= BeatInterval * INTERVAL_TOLERANCE)
+			{
+				BeatInterval += (Measured - BeatInterval) * INTERVAL_SMOOTHING;
+			}
+		}
+
+		AnchorTime = BeatTime;
+		AnchorBeat = NearestBeat;
+
+		LastConfirmedTime = BeatTime;
+		LastConfirmedBeat = NearestBeat;
+		bHasConfirmedBeat = true;
+	}
+
+	// 処理の流れ:
+	// 1. ループしていれば、予測した経過秒に最も近い周回を求める
+	// 2. その周回での再生位置と予測のずれが許容範囲を超えていれば、曲の先頭の時刻を合わせ直す
+	bool FBeatClock::SyncSongTime(double SongTime, double Now, double Tolerance)
+	{
+		if (!bRunning || !HasBeatTable())
+			return false;
+
+		const double Elapsed = Now - SongStartTime;
+		double Target = SongTime;
+		if (IsLooping())
+		{
+			const double Loop = std::max(0.0, std::round((Elapsed - SongTime) / LoopDuration));
+			Target += Loop * LoopDuration;
+		}
+
+		if (std::fabs(Elapsed - Target) <= Tolerance)
+			return false;
+
+		SongStartTime = Now - Target;
+		return true;
+	}
+
+	double FBeatClock::GetBeatPosition(double Now) const
+	{
+		if (!bRunning)
+			return 0.0;
+
+		if (HasBeatTable())
+			return GetSongPosition(Now - SongStartTime);
+
+		return static_cast<double>(AnchorBeat) + (Now - AnchorTime) / BeatInterval;
+	}
+
+	float FBeatClock::GetBeatPhase(double Now) const
+	{
+		const double Position = GetBeatPosition(Now);
+		return static_cast<float>(Position - std::floor(Position));
+	}
+
+	int64_t FBeatClock::GetBeatIndex(double Now) const
+	{
+		return static_cast<int64_t>(std::floor(GetBeatPosition(Now)));
+	}
+
+	double FBeatClock::GetNextBeatTime(double Now) const
+	{
+		if (!bRunning)
+			return Now;
+
+		const double NextBeat = std::floor(GetBeatPosition(Now)) + 1.0;
+		if (HasBeatTable())
+			return SongStartTime + GetSongBeatTime(static_cast<int64_t>(NextBeat));
+
+		return AnchorTime + (NextBeat - static_cast<double>(AnchorBeat)) * BeatInterval;
+	}
+
+	// 処理の流れ:
+	// 1. 表の前後は最初・最後の間隔で延ばす
+	// 2. 表の中は二分探索で前後の拍を探し、間を線形に補間する
+	double FBeatClock::GetTablePosition(double SongTime) const
+	{
+		const size_t Num = BeatTable.size();
+		if (SongTime < BeatTable.front())
+		{
+			return (SongTime - BeatTable.front()) / (BeatTable[1] - BeatTable[0]);
+		}
+		if (SongTime >= BeatTable.back())
+		{
+			return static_cast<double>(Num - 1) + (SongTime - BeatTable.back()) / (BeatTable[Num - 1] - BeatTable[Num - 2]);
+		}
+
+		const size_t Next = static_cast<size_t>(std::upper_bound(BeatTable.begin(), BeatTable.end(), static_cast<float>(SongTime)) - BeatTable.begin());
+		const size_t Prev = Next - 1;
+		return static_cast<double>(Prev) + (SongTime - BeatTable[Prev]) / (BeatTable[Next] - BeatTable[Prev]);
+	}
+
+	double FBeatClock::GetTableTime(int64_t Beat) const
+	{
+		const int64_t Num = static_cast<int64_t>(BeatTable.size());
+		if (Beat < 0)
+		{
+			return BeatTable.front() + static_cast<double>(Beat) * (BeatTable[1] - BeatTable[0]);
+		}
+		if (Beat >= Num)
+		{
+			return BeatTable.back() + static_cast<double>(Beat - (Num - 1)) * (BeatTable[Num - 1] - BeatTable[Num - 2]);
+		}
+		return BeatTable[static_cast<size_t>(Beat)];
+	}
+
+	// 処理の流れ:
+	// 1. ループしなければ表の上での拍数
+	// 2. ループしていれば周回の中の位置を求め、最後の拍から次の周回の最初の拍までは
+	//    最後の拍の続きとして [表の拍数 - 1, 表の拍数) に収める（曲の終わりの無音に拍を作らない）
+	// 3. 周回の数 × 表の拍数を足す（最初の周回の最初の拍より前は、表の最初の間隔で延ばす）
+	double FBeatClock::GetSongPosition(double Elapsed) const
+	{
+		if (!IsLooping() || Elapsed < 0.0)
+			return GetTablePosition(Elapsed);
+
+		const double Num = static_cast<double>(BeatTable.size());
+		const double First = BeatTable.front();
+		const double Last = BeatTable.back();
+
+		double Loop = std::floor(Elapsed / LoopDuration);
+		double Local = Elapsed - Loop * LoopDuration;
+		if (Local < First)
+		{
+			if (Loop == 0.0)
+				return GetTablePosition(Local);
+
+			// 前の周回の最後の拍の続き
+			Loop -= 1.0;
+			Local += LoopDuration;
+		}
+
+		if (Local >= Last)
+		{
+			const double WrapInterval = LoopDuration + First - Last;
+			return Loop * Num + (Num - 1.0) + (Local - Last) / WrapInterval;
+		}
+		return Loop * Num + GetTablePosition(Local);
+	}
+
+	double FBeatClock::GetSongBeatTime(int64_t Beat) const
+	{
+		if (!IsLooping() || Beat < 0)
+			return GetTableTime(Beat);
+
+		const int64_t Num = static_cast<int64_t>(BeatTable.size());
+		const int64_t Loop = Beat / Num;
+		return static_cast<double>(Loop) * LoopDuration + GetTableTime(Beat - Loop * Num);
+	}
+}
@@ -0,0 +1,123 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+// エンジンに依存しないビートの時計
+// BPM から次のビートを予測し、FMOD のマーカーで受けた実際のビートで位置を補正する
+// 拍の時刻の表（UBeatMapAsset）がある場合は、BPM の代わりに表から拍の位置を求める
+// 時刻はすべて呼び出し側の単調増加する秒（FPlatformTime::Seconds など）で扱う
+
+#include <cstdint>
+#include <vector>
+
+namespace Beat
+{
+	class FBeatClock
+	{
+	public:
+		/**
+		 * 指定した時刻を0拍目として時計を開始する
+		 * @param Now 現在時刻（秒）
+		 * @param BPM 曲のBPM
+		 */
+		void Start(double Now, float BPM);
+
+		// 時計を止める（再開は Start）
+		void Stop() { bRunning = false; }
+
+		bool IsRunning() const { return bRunning; }
+
+		// Start を呼んだ回数（拍の番号が0に戻ったことを利用側が知るため）
+		uint32_t GetStartCount() const { return StartCount; }
+
+		/**
+		 * 拍の時刻の表を設定する（2拍未満なら表を使わず BPM から予測する）
+		 * 次の Start から曲の先頭を0秒として表を使う
+		 * @param Times 曲の先頭からの拍の時刻（秒、昇順）
+		 * @param Num 拍の数
+		 * @param LoopDuration 曲の長さ（秒）。0より大きければ曲がこの長さでループするものとして、拍の番号を続けて数える
+		 */
+		void SetBeatTable(const float* Times, int32_t Num, double LoopDuration = 0.0);
+
+		// 拍の時刻の表を使っているか
+		bool HasBeatTable() const { return BeatTable.size() >= 2; }
+
+		/**
+		 * BPMを変更する（拍の位置が飛ばないよう、現在の位置を基準にし直す。表を使っている場合は何もしない）
+		 * @param BPM 新しいBPM
+		 * @param Now 現在時刻（秒）
+		 */
+		void SetBPM(float BPM, double Now);
+
+		/**
+		 * 実際に鳴ったビートで位置を補正する
+		 * 予測に最も近い拍に合わせ、前回の補正からの間隔が予測と近ければBPMも少しずつ合わせる
+		 * @param BeatTime ビートが鳴った時刻（秒）
+		 */
+		void ConfirmBeat(double BeatTime);
+
+		/**
+		 * 再生位置に合わせて曲の先頭の時刻を補正する（表を使っている場合のみ）
+		 * ループしている場合は、予測に最も近い周回の位置として扱う
+		 * @param SongTime 再生中の曲の位置（秒、ループで先頭に戻る）
+		 * @param Now 現在時刻（秒）
+		 * @param Tolerance 予測とのずれがこれ以下なら補正しない（再生位置の粒度で拍が揺れないように）
+		 * @return 補正した場合 true
+		 */
+		bool SyncSongTime(double SongTime, double Now, double Tolerance);
+
+		/** 開始からの拍数（小数部が拍の中の位置） @param Now 現在時刻（秒） */
+		double GetBeatPosition(double Now) const;
+
+		/** 拍の中の位置（0～1、拍の頭で0） @param Now 現在時刻（秒） */
+		float GetBeatPhase(double Now) const;
+
+		/** 現在の拍の番号（開始した拍が0） @param Now 現在時刻（秒） */
+		int64_t GetBeatIndex(double Now) const;
+
+		/** 次の拍の時刻（秒） @param Now 現在時刻（秒） */
+		double GetNextBeatTime(double Now) const;
+
+		// 1拍の長さ（秒）
+		double GetBeatInterval() const { return BeatInterval; }
+
+	private:
+		/** 表の上での拍数（表の外は最初・最後の間隔で延ばす） @param SongTime 曲の先頭からの秒 */
+		double GetTablePosition(double SongTime) const;
+
+		/** 表の上での拍の時刻（表の外は最初・最後の間隔で延ばす） @param Beat 拍の番号 */
+		double GetTableTime(int64_t Beat) const;
+
+		/** 曲の先頭からの経過秒での拍数（ループする場合は周回ごとに表の拍数を足す） @param Elapsed 曲の先頭からの秒 */
+		double GetSongPosition(double Elapsed) const;
+
+		/** 拍の、曲の先頭からの経過秒（ループする場合は周回分を足す） @param Beat 拍の番号 */
+		double GetSongBeatTime(int64_t Beat) const;
+
+		// 曲がループするか
+		bool IsLooping() const { return LoopDuration > 0.0 && HasBeatTable(); }
+
+	private:
+		// 拍の時刻の表（曲の先頭からの秒）と、曲の先頭の時刻
+		std::vector<float> BeatTable;
+		double SongStartTime = 0.0;
+
+		// 表の曲の長さ（秒、0ならループしない）
+		double LoopDuration = 0.0;
+
+		// 基準にした拍の時刻と番号
+		double AnchorTime = 0.0;
+		int64_t AnchorBeat = 0;
+
+		// 1拍の長さ（秒）
+		double BeatInterval = 0.5;
+
+		// 前回マーカーで補正した拍の時刻と番号（BPM の推定用）
+		double LastConfirmedTime = 0.0;
+		int64_t LastConfirmedBeat = 0;
+		bool bHasConfirmedBeat = false;
+
+		uint32_t StartCount = 0;
+		bool bRunning = false;
+	};
+}
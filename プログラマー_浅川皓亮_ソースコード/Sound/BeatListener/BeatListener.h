@@ -0,0 +1,44 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Interface.h"
+#include "BeatListener.generated.h"
+
+/**
+ * 拍の分割（1拍を何回に分けて通知するか）
+ */
+UENUM(BlueprintType)
+enum class EBeatSubdivision : uint8
+{
+	Whole	= 1 UMETA(DisplayName = "1拍"),
+	Half	= 2 UMETA(DisplayName = "半拍"),
+	Quarter	= 4 UMETA(DisplayName = "4分の1拍"),
+};
+
+// This class does not need to be modified.
+UINTERFACE(MinimalAPI, Blueprintable)
+class UBeatListener : public UInterface
+{
+	GENERATED_BODY()
+};
+
+/**
+ * UBeatDispatcherSubsystem に登録して拍を受け取るギミック用のインターフェース
+ * 同じ分割・オフセットのギミックはまとめて通知される（動的デリゲートを使わない）
+ * C++ では OnBeat_Implementation をオーバーライドし、Blueprint ではインターフェースのイベントとして実装する
+ */
+class PACHIO_API IBeatListener
+{
+	GENERATED_BODY()
+
+public:
+	/**
+	 * 登録した分割の拍が来た時に呼ばれる
+	 * @param Index BGM開始からの分割単位の番号
+	 * @param Subdivision 登録した分割
+	 */
+	UFUNCTION(BlueprintNativeEvent, BlueprintCallable, Category = "Beat")
+	void OnBeat(int64 Index, EBeatSubdivision Subdivision);
+};
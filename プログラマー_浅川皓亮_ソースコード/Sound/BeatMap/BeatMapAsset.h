@@ -0,0 +1,35 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "BeatMapAsset.generated.h"
+
+/**
+ * BGMの拍の時刻をまとめたアセット
+ * UBeatMapCommandlet がBGMの音声を解析して作成し、USoundManager のビート時計が実行時に読む
+ * （実行時は解析もマーカーの受け取りも行わない）
+ */
+UCLASS(BlueprintType)
+class PACHIO_API UBeatMapAsset : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	/* 解析したテンポ（拍の時刻を直線で当てはめたもの） */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Beat")
+	float BPM = 0.0f;
+
+	/* 拍の時刻（曲の先頭からの秒、昇順） */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Beat")
+	TArray<float> BeatTimes;
+
+	/* 曲の長さ（秒） */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Beat")
+	float Duration = 0.0f;
+
+	/* 解析した音声ファイル（再解析用） */
+	UPROPERTY(VisibleAnywhere, Category = "Beat")
+	FString SourceFile;
+};
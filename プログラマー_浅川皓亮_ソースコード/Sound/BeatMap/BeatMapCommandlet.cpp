@@ -0,0 +1,137 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Sound/BeatMapCommandlet.h"
+#include "Sound/BeatMapAsset.h"
+#include "Logic/Sound/BeatAnalysis.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/PackageName.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+#include "UObject/Package.h"
+#include "UObject/SavePackage.h"
+
+namespace
+{
+	// フォルダ指定で作るアセット名の接頭辞
+	static const TCHAR* BEAT_MAP_ASSET_PREFIX = TEXT("BM_");
+}
+
+UBeatMapCommandlet::UBeatMapCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+// 処理の流れ:
+// 1. -Wav と -Asset が指定されていれば、そのファイルを解析
+// 2. -WavDir と -AssetDir が指定されていれば、フォルダ内の WAV を全て解析
+// 3. 1つでも失敗すれば 1 を返す（ビルドスクリプトで止めるため）
+int32 UBeatMapCommandlet::Main(const FString& Params)
+{
+	FString WavFile;
+	FString AssetPath;
+	FString WavDir;
+	FString AssetDir;
+	FParse::Value(*Params, TEXT("Wav="), WavFile);
+	FParse::Value(*Params, TEXT("Asset="), AssetPath);
+	FParse::Value(*Params, TEXT("WavDir="), WavDir);
+	FParse::Value(*Params, TEXT("AssetDir="), AssetDir);
+
+	int32 NumBuilt = 0;
+	int32 NumFailed = 0;
+
+	if (!WavFile.IsEmpty() && !AssetPath.IsEmpty())
+	{
+		BuildBeatMap(WavFile, AssetPath) ? ++NumBuilt : ++NumFailed;
+	}
+
+	if (!WavDir.IsEmpty() && !AssetDir.IsEmpty())
+	{
+		TArray<FString> Files;
+		IFileManager::Get().FindFiles(Files, *(WavDir / TEXT("*.wav")), true, false);
+		for (const FString& File : Files)
+		{
+			const FString Path = AssetDir / (BEAT_MAP_ASSET_PREFIX + FPaths::GetBaseFilename(File));
+			BuildBeatMap(WavDir / File, Path) ? ++NumBuilt : ++NumFailed;
+		}
+	}
+
+	if (NumBuilt == 0 && NumFailed == 0)
+	{
+		UE_LOG(LogTemp, Error, TEXT("BeatMap: specify -Wav= -Asset= or -WavDir= -AssetDir="));
+		return 1;
+	}
+
+	UE_LOG(LogTemp, Display, TEXT("BeatMap: %d built, %d failed"), NumBuilt, NumFailed);
+	return NumFailed == 0 ? 0 : 1;
+}
+
+// 処理の流れ:
+// 1. WAVファイルを読み込んでモノラルに変換
+// 2. テンポと拍の時刻を解析
+// 3. パッケージを作成（既にあれば上書き）して保存
+bool UBeatMapCommandlet::BuildBeatMap(const FString& WavFile, const FString& AssetPath) const
+{
+	TArray<uint8> FileData;
+	if (!FFileHelper::LoadFileToArray(FileData, *WavFile))
+	{
+		UE_LOG(LogTemp, Error, TEXT("BeatMap: failed to read %s"), *WavFile);
+		return false;
+	}
+
+	Beat::FMonoAudio Audio;
+	if (!Beat::DecodeWav(FileData.GetData(), FileData.Num(), Audio))
+	{
+		UE_LOG(LogTemp, Error, TEXT("BeatMap: unsupported wav format %s"), *WavFile);
+		return false;
+	}
+
+	const Beat::FBeatAnalysisResult Result = Beat::AnalyzeBeats(Audio);
+	if (Result.BeatTimes.empty())
+	{
+		UE_LOG(LogTemp, Error, TEXT("BeatMap: no beats found in %s"), *WavFile);
+		return false;
+	}
+
+#if WITH_EDITOR
+	if (!FPackageName::IsValidLongPackageName(AssetPath))
+	{
+		UE_LOG(LogTemp, Error, TEXT("BeatMap: invalid asset path %s"), *AssetPath);
+		return false;
+	}
+
+	UPackage* Package = CreatePackage(*AssetPath);
+	Package->FullyLoad();
+
+	const FString AssetName = FPackageName::GetLongPackageAssetName(AssetPath);
+	UBeatMapAsset* BeatMap = FindObject<UBeatMapAsset>(Package, *AssetName);
+	if (!BeatMap)
+	{
+		BeatMap = NewObject<UBeatMapAsset>(Package, *AssetName, RF_Public | RF_Standalone);
+	}
+
+	BeatMap->BPM = Result.BPM;
+	BeatMap->BeatTimes = TArray<float>(Result.BeatTimes.data(), static_cast<int32>(Result.BeatTimes.size()));
+	BeatMap->Duration = static_cast<float>(Audio.Samples.size()) / static_cast<float>(Audio.SampleRate);
+	BeatMap->SourceFile = WavFile;
+	BeatMap->MarkPackageDirty();
+
+	const FString Filename = FPackageName::LongPackageNameToFilename(AssetPath, FPackageName::GetAssetPackageExtension());
+	FSavePackageArgs SaveArgs;
+	SaveArgs.TopLevelFlags = RF_Public | RF_Standalone;
+	if (!UPackage::SavePackage(Package, BeatMap, *Filename, SaveArgs))
+	{
+		UE_LOG(LogTemp, Error, TEXT("BeatMap: failed to save %s"), *Filename);
+		return false;
+	}
+
+	UE_LOG(LogTemp, Display, TEXT("BeatMap: %s -> %s (%.2f BPM, %d beats)"), *WavFile, *AssetPath, Result.BPM, BeatMap->BeatTimes.Num());
+	return true;
+#else
+	return false;
+#endif
+}
@@ -0,0 +1,36 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "BeatMapCommandlet.generated.h"
+
+/**
+ * BGMの音声（WAV）を解析して UBeatMapAsset を作るコマンドレット
+ * クック前にビルドスクリプトから実行する
+ *
+ * 使い方:
+ *   UnrealEditor-Cmd Pachio.uproject -run=BeatMap -Wav=<WAVファイル> -Asset=/Game/Sound/BeatMaps/BM_<名前>
+ *   UnrealEditor-Cmd Pachio.uproject -run=BeatMap -WavDir=<フォルダ> -AssetDir=/Game/Sound/BeatMaps
+ *   （フォルダ指定の場合は WAV ごとに BM_<ファイル名> を作る）
+ */
+UCLASS()
+class PACHIO_API UBeatMapCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UBeatMapCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+
+private:
+	/**
+	 * WAVファイルを1つ解析してアセットとして保存する
+	 * @param WavFile 解析するWAVファイル
+	 * @param AssetPath 保存するアセットのパッケージ名（/Game/...）
+	 * @return 成功したか
+	 */
+	bool BuildBeatMap(const FString& WavFile, const FString& AssetPath) const;
+};
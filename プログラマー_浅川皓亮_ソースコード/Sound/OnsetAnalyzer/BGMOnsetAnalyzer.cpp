@@ -0,0 +1,148 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Sound/BGMOnsetAnalyzer.h"
+
+#define FMOD_API_TRUE
+#define FMOD_STUDIO_API_TRUE
+
+#include "fmod.hpp"
+#include "fmod_dsp.h"
+
+namespace
+{
+	// ミキサースレッドから受けるオンセットのキューの大きさ（2の累乗、1つは空きとして使われる）
+	static constexpr uint32 ONSET_QUEUE_SIZE = 64;
+
+	// 1回のDSPの処理で検出するオンセットの上限（スタックに置く固定長の配列）
+	static constexpr int32 MAX_ONSETS_PER_READ = 8;
+}
+
+FBGMOnsetAnalyzer::FBGMOnsetAnalyzer()
+	: OnsetQueue(ONSET_QUEUE_SIZE)
+{
+}
+
+FBGMOnsetAnalyzer::~FBGMOnsetAnalyzer()
+{
+	Detach();
+}
+
+// 処理の流れ:
+// 1. イベントのチャンネルグループを取得（イベントが作られるまでは失敗する）
+// 2. ミキサーの形式から検出器を初期化し、音が出るまでの遅れを求める
+// 3. 音をそのまま通すDSPを作り、チャンネルグループの入力側（フェーダーの前）に挿す
+bool FBGMOnsetAnalyzer::Attach(FMOD::Studio::EventInstance* Instance)
+{
+	Detach();
+	if (!Instance)
+		return false;
+
+	FMOD::ChannelGroup* Group = nullptr;
+	if (Instance->getChannelGroup(&Group) != FMOD_OK || !Group)
+		return false;
+
+	FMOD::System* CoreSystem = nullptr;
+	if (Group->getSystemObject(&CoreSystem) != FMOD_OK || !CoreSystem)
+		return false;
+
+	int SampleRate = 0;
+	unsigned int BufferLength = 0;
+	int NumBuffers = 0;
+	CoreSystem->getSoftwareFormat(&SampleRate, nullptr, nullptr);
+	CoreSystem->getDSPBufferSize(&BufferLength, &NumBuffers);
+	if (!Detector.Init(SampleRate))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("BGMOnsetAnalyzer: unsupported sample rate %d"), SampleRate);
+		return false;
+	}
+	OutputLatency = static_cast<double>(BufferLength) * NumBuffers / SampleRate;
+
+	FMOD_DSP_DESCRIPTION Description = {};
+	Description.pluginsdkversion = FMOD_PLUGIN_SDK_VERSION;
+	FCStringAnsi::Strncpy(Description.name, "Pachio BGM Onset", sizeof(Description.name));
+	Description.version = 1;
+	Description.numinputbuffers = 1;
+	Description.numoutputbuffers = 1;
+	Description.read = &FBGMOnsetAnalyzer::OnDSPRead;
+	Description.userdata = this;
+
+	FMOD::DSP* NewDSP = nullptr;
+	if (CoreSystem->createDSP(&Description, &NewDSP) != FMOD_OK || !NewDSP)
+		return false;
+
+	if (Group->addDSP(FMOD_CHANNELCONTROL_DSP_TAIL, NewDSP) != FMOD_OK)
+	{
+		NewDSP->release();
+		return false;
+	}
+
+	DSP = NewDSP;
+	ChannelGroup = Group;
+	return true;
+}
+
+// DSPを外してから破棄する（取り外しはFMODがミキサーと同期して行うため、以降は OnDSPRead から呼ばれない）
+void FBGMOnsetAnalyzer::Detach()
+{
+	if (!DSP)
+		return;
+
+	if (ChannelGroup)
+	{
+		ChannelGroup->removeDSP(DSP);
+	}
+	DSP->release();
+	DSP = nullptr;
+	ChannelGroup = nullptr;
+
+	FBGMOnsetEvent Discarded;
+	while (OnsetQueue.Dequeue(Discarded)) {}
+}
+
+// 処理の流れ（FMODのミキサースレッドで呼ばれるため、メモリの確保やUObjectへのアクセスは行わない）:
+// 1. 入力をそのまま出力へコピー
+// 2. UserDataからアナライザーを取得して入力を解析
+FMOD_RESULT F_CALLBACK FBGMOnsetAnalyzer::OnDSPRead(FMOD_DSP_STATE* State, float* InBuffer, float* OutBuffer, unsigned int Length, int InChannels, int* OutChannels)
+{
+	const int Channels = OutChannels ? *OutChannels : InChannels;
+	for (unsigned int Sample = 0; Sample < Length; ++Sample)
+	{
+		for (int Channel = 0; Channel < Channels; ++Channel)
+		{
+			OutBuffer[Sample * Channels + Channel] = Channel < InChannels ? InBuffer[Sample * InChannels + Channel] : 0.0f;
+		}
+	}
+
+	void* UserData = nullptr;
+	State->functions->getuserdata(State, &UserData);
+	if (FBGMOnsetAnalyzer* Analyzer = static_cast<FBGMOnsetAnalyzer*>(UserData))
+	{
+		Analyzer->Analyze(InBuffer, Length, InChannels);
+	}
+	return FMOD_OK;
+}
+
+// 処理の流れ:
+// 1. 検出器に音声を渡す
+// 2. この処理の最後のサンプルが OutputLatency 後に聞こえるとして、各オンセットが聞こえる時刻を求める
+// 3. キューに積む（一杯の場合は捨てる。次のオンセットで補正される）
+void FBGMOnsetAnalyzer::Analyze(const float* Buffer, unsigned int Length, int Channels)
+{
+	Beat::FOnset Onsets[MAX_ONSETS_PER_READ];
+	const int32 NumOnsets = Detector.Process(Buffer, static_cast<int32>(Length), Channels, Onsets, MAX_ONSETS_PER_READ);
+	if (NumOnsets == 0)
+		return;
+
+	const double PlaybackTime = FPlatformTime::Seconds() + OutputLatency;
+	const double SampleRate = static_cast<double>(Detector.GetSampleRate());
+	const int64 ProcessedSamples = Detector.GetProcessedSamples();
+
+	for (int32 i = 0; i < NumOnsets; ++i)
+	{
+		FBGMOnsetEvent Event;
+		Event.Time = PlaybackTime - static_cast<double>(ProcessedSamples - Onsets[i].OnsetSample) / SampleRate;
+		Event.Strength = Onsets[i].Strength;
+		OnsetQueue.Enqueue(Event);
+	}
+}
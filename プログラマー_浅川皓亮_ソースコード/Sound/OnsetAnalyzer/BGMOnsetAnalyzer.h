@@ -0,0 +1,81 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/CircularQueue.h"
+#include "Logic/Sound/OnsetDetector.h"
+#include "fmod_studio.hpp"     // FMOD Studio APIのC++ラッパー
+
+/* FMODのミキサースレッドで検出したオンセット（ゲームスレッドへ渡す） */
+struct FBGMOnsetEvent
+{
+    /* オンセットが聞こえる時刻の推定（FPlatformTime::Seconds） */
+    double Time = 0.0;
+
+    /* 閾値に対する強さ（1より大きい） */
+    float Strength = 0.0f;
+};
+
+/**
+ * BGMのイベントにFMODのDSPを挿し、再生中の音声からオンセットを検出する
+ * DSPの処理はFMODのミキサースレッドで行い（メモリの確保もロックもしない）、
+ * 結果はロックの無いキューでゲームスレッドへ渡す
+ *
+ * 使い方:
+ *   Attach が成功するまで毎フレーム呼び（イベントが作られるまでは失敗する）、Dequeue で取り出す
+ */
+class PACHIO_API FBGMOnsetAnalyzer
+{
+public:
+    FBGMOnsetAnalyzer();
+    ~FBGMOnsetAnalyzer();
+
+    FBGMOnsetAnalyzer(const FBGMOnsetAnalyzer&) = delete;
+    FBGMOnsetAnalyzer& operator=(const FBGMOnsetAnalyzer&) = delete;
+
+    /**
+     * イベントのチャンネルグループにDSPを挿す（ゲームスレッドで呼ぶ）
+     * @param Instance BGMのイベント
+     * @return イベントの準備ができておらず挿せなかった場合は false
+     */
+    bool Attach(FMOD::Studio::EventInstance* Instance);
+
+    /* DSPを外して破棄する（キューに残ったオンセットは捨てる） */
+    void Detach();
+
+    /* DSPを挿しているか */
+    bool IsAttached() const { return DSP != nullptr; }
+
+    /**
+     * 検出したオンセットを1つ取り出す（ゲームスレッドで呼ぶ）
+     * @param OutEvent 取り出したオンセット
+     * @return 取り出せたか
+     */
+    bool Dequeue(FBGMOnsetEvent& OutEvent) { return OnsetQueue.Dequeue(OutEvent); }
+
+private:
+    /* FMODのミキサースレッドから呼ばれるDSPの処理（音はそのまま通す） */
+    static FMOD_RESULT F_CALLBACK OnDSPRead(FMOD_DSP_STATE* State, float* InBuffer, float* OutBuffer, unsigned int Length, int InChannels, int* OutChannels);
+
+    /*
+    * 受け取った音声からオンセットを検出してキューに積む（ミキサースレッド）
+    * @param Buffer チャンネルが交互に並んだ音声
+    * @param Length 1チャンネルあたりのサンプル数
+    * @param Channels チャンネル数
+    */
+    void Analyze(const float* Buffer, unsigned int Length, int Channels);
+
+    /* オンセットの検出器（Attach で初期化し、以降はミキサースレッドだけが触る） */
+    Beat::FOnsetDetector Detector;
+
+    /* ミキサースレッド -> ゲームスレッドへ渡すオンセット（単一生産者・単一消費者） */
+    TCircularQueue<FBGMOnsetEvent> OnsetQueue;
+
+    /* 挿したDSPと、挿した先のチャンネルグループ */
+    FMOD::DSP* DSP = nullptr;
+    FMOD::ChannelGroup* ChannelGroup = nullptr;
+
+    /* ミキサーで処理してから音が出るまでの時間（秒） */
+    double OutputLatency = 0.0;
+};
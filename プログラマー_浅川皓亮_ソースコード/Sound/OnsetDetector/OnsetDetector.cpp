@@ -0,0 +1,174 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Logic/Sound/OnsetDetector.h"
+#include "Logic/Sound/BeatAnalysis.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Beat
+{
+	namespace
+	{
+		// 窓の長さの下限
+		static constexpr int32_t MIN_FRAME_SIZE = 64;
+
+		// 音の立ち上がりでフラックスが最大になる窓の、窓の先頭から立ち上がりまでの位置（窓の長さに対する比）
+		// ハン窓のため、立ち上がりが窓の中央付近に入った時にフラックスが最大になる
+		static constexpr double ONSET_POSITION_IN_FRAME = 0.5;
+
+		bool IsPowerOfTwo(int32_t Value)
+		{
+			return Value > 0 && (Value & (Value - 1)) == 0;
+		}
+	}
+
+	// 処理の流れ:
+	// 1. 設定を確認
+	// 2. 入力・FFT・帯域・フラックスの履歴のバッファを確保
+	// 3. 状態をリセット
+	bool FOnsetDetector::Init(int32_t InSampleRate, const FOnsetDetectorSettings& InSettings)
+	{
+		SampleRate = 0;
+		if (InSampleRate <= 0
+			|| InSettings.FrameSize < MIN_FRAME_SIZE || !IsPowerOfTwo(InSettings.FrameSize)
+			|| InSettings.HopSize <= 0 || InSettings.HopSize > InSettings.FrameSize
+			|| InSettings.ThresholdWindow <= 0)
+			return false;
+
+		Settings = InSettings;
+		FrameSize = static_cast<size_t>(Settings.FrameSize);
+		HopSize = static_cast<size_t>(Settings.HopSize);
+
+		Input.assign(FrameSize, 0.0f);
+		Window.resize(FrameSize);
+		MakeHannWindow(Window.data(), FrameSize);
+		Spectrum.assign(FrameSize, std::complex<float>(0.0f, 0.0f));
+		BandEdges.resize(NUM_ONSET_BANDS + 1);
+		ComputeOnsetBandEdges(InSampleRate, FrameSize, BandEdges.data());
+		PrevMagnitudes.assign(NUM_ONSET_BANDS, 0.0f);
+		FluxHistory.assign(static_cast<size_t>(Settings.ThresholdWindow), 0.0f);
+
+		SampleRate = InSampleRate;
+		Reset();
+		return true;
+	}
+
+	void FOnsetDetector::Reset()
+	{
+		std::fill(Input.begin(), Input.end(), 0.0f);
+		std::fill(PrevMagnitudes.begin(), PrevMagnitudes.end(), 0.0f);
+		std::fill(FluxHistory.begin(), FluxHistory.end(), 0.0f);
+		InputPos = 0;
+		SamplesSinceHop = 0;
+		TotalSamples = 0;
+		FluxHistoryPos = 0;
+		FluxHistoryCount = 0;
+		PrevFlux = 0.0f;
+		PrevPrevFlux = 0.0f;
+		PrevThreshold = 0.0f;
+		NumAnalyzedFrames = 0;
+		LastOnsetFrame = -1;
+	}
+
+	// 処理の流れ:
+	// 1. チャンネルを平均してリングバッファに書き込む
+	// 2. HopSize 分たまるごとに最新の1窓を解析する
+	// 3. 見つかったオンセットを書き出す（書き込む先が一杯なら捨てる）
+	int32_t FOnsetDetector::Process(const float* Interleaved, int32_t NumFrames, int32_t NumChannels, FOnset* OutOnsets, int32_t MaxOnsets)
+	{
+		if (!IsInitialized() || !Interleaved || NumFrames <= 0 || NumChannels <= 0)
+			return 0;
+
+		const float ChannelScale = 1.0f / static_cast<float>(NumChannels);
+		int32_t NumOnsets = 0;
+
+		for (int32_t Frame = 0; Frame < NumFrames; ++Frame)
+		{
+			const float* Samples = Interleaved + static_cast<size_t>(Frame) * NumChannels;
+			float Mono = 0.0f;
+			for (int32_t Channel = 0; Channel < NumChannels; ++Channel)
+			{
+				Mono += Samples[Channel];
+			}
+
+			Input[InputPos] = Mono * ChannelScale;
+			InputPos = (InputPos + 1) % FrameSize;
+			++TotalSamples;
+
+			if (++SamplesSinceHop < HopSize)
+				continue;
+			SamplesSinceHop = 0;
+
+			FOnset Onset;
+			if (AnalyzeFrame(Onset) && OutOnsets && NumOnsets < MaxOnsets)
+			{
+				OutOnsets[NumOnsets++] = Onset;
+			}
+		}
+		return NumOnsets;
+	}
+
+	int64_t FOnsetDetector::GetAlgorithmLatency() const
+	{
+		// ピークの判定に次の窓を使うため、窓の中の立ち上がりの位置から窓の終わりまでに加えて1回分ずらす幅だけ遅れる
+		return static_cast<int64_t>(HopSize) + static_cast<int64_t>(FrameSize) - static_cast<int64_t>(FrameSize * ONSET_POSITION_IN_FRAME);
+	}
+
+	// 処理の流れ:
+	// 1. 最新の1窓に窓関数を掛けてFFTし、帯域ごとのスペクトルフラックスを求める
+	// 2. 過去のフラックスの平均と標準偏差から、この窓の閾値を求める
+	// 3. 1つ前の窓が前後より大きく閾値を超えていればオンセットとする（次の窓を見てから判定する）
+	// 4. 今の窓の値を履歴に入れる
+	bool FOnsetDetector::AnalyzeFrame(FOnset& OutOnset)
+	{
+		for (size_t i = 0; i < FrameSize; ++i)
+		{
+			Spectrum[i] = std::complex<float>(Input[(InputPos + i) % FrameSize] * Window[i], 0.0f);
+		}
+		FFTInPlace(Spectrum.data(), FrameSize);
+		const float Flux = ComputeBandFlux(Spectrum.data(), FrameSize, BandEdges.data(), PrevMagnitudes.data());
+
+		float Threshold = Settings.MinFlux;
+		if (FluxHistoryCount > 0)
+		{
+			double Sum = 0.0;
+			double SumSquares = 0.0;
+			for (size_t i = 0; i < FluxHistoryCount; ++i)
+			{
+				Sum += FluxHistory[i];
+				SumSquares += static_cast<double>(FluxHistory[i]) * FluxHistory[i];
+			}
+			const double Mean = Sum / static_cast<double>(FluxHistoryCount);
+			const double Deviation = std::sqrt(std::max(0.0, SumSquares / static_cast<double>(FluxHistoryCount) - Mean * Mean));
+			Threshold += static_cast<float>(Mean + Settings.ThresholdDeviations * Deviation);
+		}
+
+		bool bFound = false;
+		const int64_t PeakFrame = NumAnalyzedFrames - 1;
+		const double MinOnsetFrames = Settings.MinOnsetInterval * SampleRate / static_cast<double>(HopSize);
+		if (PeakFrame >= 1
+			&& PrevFlux > PrevPrevFlux && PrevFlux >= Flux && PrevFlux > PrevThreshold
+			&& (LastOnsetFrame < 0 || static_cast<double>(PeakFrame - LastOnsetFrame) >= MinOnsetFrames))
+		{
+			// 1つ前の窓は、今受け取ったところから HopSize 前に終わっている
+			const int64_t PeakFrameStart = TotalSamples - static_cast<int64_t>(HopSize + FrameSize);
+			OutOnset.OnsetSample = std::max<int64_t>(0, PeakFrameStart + static_cast<int64_t>(FrameSize * ONSET_POSITION_IN_FRAME));
+			OutOnset.DetectedSample = TotalSamples;
+			OutOnset.Strength = PrevFlux / PrevThreshold;
+			LastOnsetFrame = PeakFrame;
+			bFound = true;
+		}
+
+		FluxHistory[FluxHistoryPos] = Flux;
+		FluxHistoryPos = (FluxHistoryPos + 1) % FluxHistory.size();
+		FluxHistoryCount = std::min(FluxHistoryCount + 1, FluxHistory.size());
+
+		PrevPrevFlux = PrevFlux;
+		PrevFlux = Flux;
+		PrevThreshold = Threshold;
+		++NumAnalyzedFrames;
+		return bFound;
+	}
+}
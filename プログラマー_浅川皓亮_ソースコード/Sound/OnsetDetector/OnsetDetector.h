@@ -0,0 +1,128 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+// エンジンに依存しないリアルタイムのオンセット検出
+// 再生中の音声を少しずつ受け取り、窓ごとのスペクトルフラックスからオンセットを見つける
+// オーディオスレッドで使うため、Init 以降はメモリの確保もロックも行わない
+
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Beat
+{
+	// 検出の設定
+	struct FOnsetDetectorSettings
+	{
+		// FFTの窓の長さ（2の累乗）と、窓をずらす幅（サンプル数）
+		int32_t FrameSize = 1024;
+		int32_t HopSize = 256;
+
+		// 閾値を求めるのに使う過去の窓の数
+		int32_t ThresholdWindow = 32;
+
+		// 閾値 = 過去の平均 + ThresholdDeviations * 過去の標準偏差 + MinFlux
+		float ThresholdDeviations = 1.5f;
+		float MinFlux = 0.5f;
+
+		// 続けて検出しない間隔（秒）
+		float MinOnsetInterval = 0.1f;
+	};
+
+	// 検出したオンセット
+	struct FOnset
+	{
+		// オンセットの位置（入力の先頭からのサンプル数）
+		int64_t OnsetSample = 0;
+
+		// 検出した時点までに受け取ったサンプル数（OnsetSample との差が検出の遅れ）
+		int64_t DetectedSample = 0;
+
+		// スペクトルフラックスの閾値に対する比
+		float Strength = 0.0f;
+	};
+
+	/**
+	 * 音声を少しずつ受け取ってオンセットを検出する
+	 * 使い方:
+	 *   Init でサンプリング周波数を渡してから、オーディオスレッドで Process を繰り返し呼ぶ
+	 */
+	class FOnsetDetector
+	{
+	public:
+		/**
+		 * 必要なバッファを確保して状態をリセットする（オーディオスレッド以外で呼ぶ）
+		 * @param SampleRate 入力のサンプリング周波数
+		 * @param Settings 検出の設定
+		 * @return 設定が不正な場合は false
+		 */
+		bool Init(int32_t SampleRate, const FOnsetDetectorSettings& Settings = FOnsetDetectorSettings());
+
+		/* 受け取った音声と検出の状態を捨てる（バッファは残す） */
+		void Reset();
+
+		/* Init が成功しているか */
+		bool IsInitialized() const { return SampleRate > 0; }
+
+		/**
+		 * 音声を受け取り、見つかったオンセットを書き出す（メモリの確保はしない）
+		 * @param Interleaved チャンネルが交互に並んだ音声
+		 * @param NumFrames 1チャンネルあたりのサンプル数
+		 * @param NumChannels チャンネル数（平均してモノラルにする）
+		 * @param OutOnsets 見つかったオンセットを書き込む先
+		 * @param MaxOnsets OutOnsets の要素数（超えた分は捨てる）
+		 * @return 書き込んだオンセットの数
+		 */
+		int32_t Process(const float* Interleaved, int32_t NumFrames, int32_t NumChannels, FOnset* OutOnsets, int32_t MaxOnsets);
+
+		/* 入力からオンセットを検出するまでの最小の遅れ（サンプル数） */
+		int64_t GetAlgorithmLatency() const;
+
+		int32_t GetSampleRate() const { return SampleRate; }
+
+		/* これまでに受け取ったサンプル数（1チャンネルあたり） */
+		int64_t GetProcessedSamples() const { return TotalSamples; }
+
+	private:
+		/**
+		 * 入力の最新の1窓を解析する
+		 * @param OutOnset オンセットが見つかった場合に書き込む先
+		 * @return オンセットが見つかったか
+		 */
+		bool AnalyzeFrame(FOnset& OutOnset);
+
+		FOnsetDetectorSettings Settings;
+		int32_t SampleRate = 0;
+		size_t FrameSize = 0;
+		size_t HopSize = 0;
+
+		// 入力のリングバッファ（FrameSize 個）と書き込み位置
+		std::vector<float> Input;
+		size_t InputPos = 0;
+
+		// 前の解析から受け取ったサンプル数と、受け取った合計
+		size_t SamplesSinceHop = 0;
+		int64_t TotalSamples = 0;
+
+		std::vector<float> Window;
+		std::vector<std::complex<float>> Spectrum;
+		std::vector<size_t> BandEdges;
+		std::vector<float> PrevMagnitudes;
+
+		// 過去のスペクトルフラックス（ThresholdWindow 個のリングバッファ）
+		std::vector<float> FluxHistory;
+		size_t FluxHistoryPos = 0;
+		size_t FluxHistoryCount = 0;
+
+		// ピークの判定に使う直前2つの窓のフラックスと、その閾値
+		float PrevFlux = 0.0f;
+		float PrevPrevFlux = 0.0f;
+		float PrevThreshold = 0.0f;
+
+		// 解析した窓の数と、最後にオンセットを検出した窓
+		int64_t NumAnalyzedFrames = 0;
+		int64_t LastOnsetFrame = -1;
+	};
+}
@@ -0,0 +1,17 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * USoundManager に登録されたサウンドを指すハンドル
+ * ロード時に USoundManager::FindSound で一度だけ取得し、再生時は名前を引かずにこれを渡す
+ */
+struct FSoundHandle
+{
+	// USoundManager 内のサウンド番号（見つからなかった場合は INDEX_NONE）
+	int32 Index = INDEX_NONE;
+
+	bool IsValid() const { return Index != INDEX_NONE; }
+};